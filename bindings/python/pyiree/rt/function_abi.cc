@@ -14,8 +14,13 @@
 
 #include "bindings/python/pyiree/rt/function_abi.h"
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "bindings/python/pyiree/common/status_utils.h"
 #include "bindings/python/pyiree/rt/hal.h"
@@ -87,15 +92,86 @@ py::object PyRawUnpackResults(FunctionAbi* self, VmVariantList& f_args) {
   return py_result_tuple;
 }
 
+// Minimum alignment of python buffers that will be wrapped without copying.
+// numpy allocations are at least this aligned and the host kernels assume
+// buffers are suitably aligned for vector loads.
+constexpr uintptr_t kMinWrapAlignment = 16;
+
+// Releases Py_buffer views retained by wrapped HAL buffers.
+// HAL buffers may be destroyed on device worker threads and those threads must
+// not block on the GIL: device teardown joins them while holding it. Views
+// released without the GIL held are queued and released from a pending call
+// that the interpreter runs on the main thread with the GIL held, as well as
+// whenever new arguments are packed.
+class DeferredPyBufferReleaser {
+ public:
+  // Releases |view| now if the GIL is held and otherwise queues it.
+  // Safe to call from any thread.
+  static void Release(Py_buffer* view) {
+    if (PyGILState_Check()) {
+      ReleaseView(view);
+      return;
+    }
+    auto& releaser = Get();
+    bool schedule_flush = false;
+    {
+      absl::MutexLock lock(&releaser.mutex_);
+      releaser.pending_views_.push_back(view);
+      schedule_flush = !releaser.flush_scheduled_;
+      releaser.flush_scheduled_ = true;
+    }
+    // Py_AddPendingCall does not require the GIL. If the interpreter queue is
+    // full the views remain queued until the next flush.
+    if (schedule_flush && Py_AddPendingCall(&FlushPendingCall, nullptr) != 0) {
+      absl::MutexLock lock(&releaser.mutex_);
+      releaser.flush_scheduled_ = false;
+    }
+  }
+
+  // Releases all queued views. The GIL must be held.
+  static void Flush() {
+    auto& releaser = Get();
+    std::vector<Py_buffer*> views;
+    {
+      absl::MutexLock lock(&releaser.mutex_);
+      views.swap(releaser.pending_views_);
+      releaser.flush_scheduled_ = false;
+    }
+    for (auto* view : views) ReleaseView(view);
+  }
+
+ private:
+  static DeferredPyBufferReleaser& Get() {
+    static auto* releaser = new DeferredPyBufferReleaser();
+    return *releaser;
+  }
+
+  static int FlushPendingCall(void*) {
+    Flush();
+    return 0;
+  }
+
+  static void ReleaseView(Py_buffer* view) {
+    PyBuffer_Release(view);
+    delete view;
+  }
+
+  absl::Mutex mutex_;
+  std::vector<Py_buffer*> pending_views_ ABSL_GUARDED_BY(mutex_);
+  bool flush_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
 // RAII wrapper for a Py_buffer which calls PyBuffer_Release when it goes
-// out of scope.
+// out of scope, unless ownership has been released.
 class PyBufferReleaser {
  public:
-  PyBufferReleaser(Py_buffer& b) : b_(b) {}
-  ~PyBufferReleaser() { PyBuffer_Release(&b_); }
+  PyBufferReleaser(std::unique_ptr<Py_buffer>& b) : b_(b) {}
+  ~PyBufferReleaser() {
+    if (b_) PyBuffer_Release(b_.get());
+  }
 
  private:
-  Py_buffer& b_;
+  std::unique_ptr<Py_buffer>& b_;
 };
 
 pybind11::error_already_set RaiseBufferMismatchError(
@@ -226,6 +302,9 @@ void FunctionAbi::RawPack(absl::Span<const Description> descs,
     throw RaiseValueError("Mismatched RawPack() input arity");
   }
 
+  // Release the views of previously wrapped arguments that were deferred.
+  DeferredPyBufferReleaser::Flush();
+
   for (size_t i = 0, e = descs.size(); i < e; ++i) {
     const Description& desc = descs[i];
     switch (desc.type) {
@@ -335,66 +414,98 @@ void FunctionAbi::PackBuffer(const RawSignatureParser::Description& desc,
                              py::handle py_arg, VmVariantList& f_args,
                              bool writable) {
   // Request a view of the buffer (use the raw python C API to avoid some
-  // allocation and copying at the pybind level).
-  Py_buffer py_view;
-  // Note that only C-Contiguous ND-arrays are presently supported, so
-  // only request that via PyBUF_ND. Long term, we should consult an
-  // "oracle" in the runtime to determine the precise required format and
-  // set flags accordingly (and fallback/copy on failure).
-  int flags = PyBUF_FORMAT | PyBUF_ND;
+  // allocation and copying at the pybind level). Strided views are requested
+  // such that non-contiguous arrays can still be packed via a copy.
+  // Long term, we should consult an "oracle" in the runtime to determine the
+  // precise required format and set flags accordingly.
+  int flags = PyBUF_FORMAT | PyBUF_STRIDES;
   if (writable) {
     flags |= PyBUF_WRITABLE;
   }
 
-  // Acquire the backing buffer and setup RAII release.
-  if (PyObject_GetBuffer(py_arg.ptr(), &py_view, flags) != 0) {
+  // Acquire the backing buffer. Ownership of the view is transferred to the
+  // HAL buffer if it is wrapped directly and otherwise released on return.
+  auto py_view = absl::make_unique<Py_buffer>();
+  if (PyObject_GetBuffer(py_arg.ptr(), py_view.get(), flags) != 0) {
     // The GetBuffer call is required to set an appropriate error.
     throw py::error_already_set();
   }
   PyBufferReleaser py_view_releaser(py_view);
 
-  // Whether the py object needs to be retained with the argument.
-  // Should be set to true if directly mapping, false if copied.
-  bool depends_on_pyobject = false;
-
   // Verify compatibility.
   absl::InlinedVector<int, 2> dynamic_dims;
-  MapBufferAttrs(py_view, desc, dynamic_dims);
+  MapBufferAttrs(*py_view, desc, dynamic_dims);
   if (!dynamic_dims.empty()) {
     throw RaisePyError(PyExc_NotImplementedError,
                        "Dynamic argument dimensions not implemented");
   }
 
-  // Allocate a HalBuffer.
-  // This is hard-coded to C-contiguous right now.
+  auto memory_type = static_cast<iree_hal_memory_type_t>(
+      IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE);
+  iree_hal_buffer_t* raw_buffer = nullptr;
+
+  // Try to wrap the python memory directly. This requires that the memory be
+  // laid out as the HAL buffer expects (hard-coded to C-contiguous right now)
+  // and be aligned such that kernels can use it as if they had allocated it.
+  // The view (and with it a reference to the exporting object) is retained by
+  // the HAL buffer and released once the buffer is destroyed, which may
+  // happen on any thread after the invocation has completed. Releases from
+  // threads not holding the GIL are deferred to the main thread.
   // TODO(laurenzo): Expand to other layouts as needed.
-  // TODO(laurenzo): Wrap and retain original buffer (depends_on_pyobject=true).
-  iree_hal_buffer_t* raw_buffer;
-  CheckApiStatus(iree_hal_allocator_allocate_buffer(
-                     device_.allocator(),
-                     static_cast<iree_hal_memory_type_t>(
-                         IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
-                         IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE),
-                     IREE_HAL_BUFFER_USAGE_ALL, py_view.len, &raw_buffer),
-                 "Failed to allocate device visible buffer");
-  CheckApiStatus(
-      iree_hal_buffer_write_data(raw_buffer, 0, py_view.buf, py_view.len),
-      "Error writing to input buffer");
+  if (py_view->len > 0 && PyBuffer_IsContiguous(py_view.get(), 'C') &&
+      reinterpret_cast<uintptr_t>(py_view->buf) % kMinWrapAlignment == 0) {
+    iree_allocator_t view_allocator;
+    view_allocator.self = py_view.get();
+    view_allocator.alloc = nullptr;
+    view_allocator.free = +[](void* self, void* ptr) -> iree_status_t {
+      DeferredPyBufferReleaser::Release(static_cast<Py_buffer*>(self));
+      return IREE_STATUS_OK;
+    };
+    auto status = iree_hal_allocator_wrap_buffer_with_release(
+        device_.allocator(), memory_type,
+        writable ? IREE_HAL_MEMORY_ACCESS_ALL : IREE_HAL_MEMORY_ACCESS_READ,
+        IREE_HAL_BUFFER_USAGE_ALL,
+        iree_byte_span_t{static_cast<uint8_t*>(py_view->buf),
+                         static_cast<iree_host_size_t>(py_view->len)},
+        view_allocator, &raw_buffer);
+    if (iree_status_is_ok(status)) {
+      py_view.release();
+    } else if (!iree_status_is_unimplemented(status) &&
+               !iree_status_is_failed_precondition(status)) {
+      CheckApiStatus(status, "Failed to wrap host buffer");
+    }
+  }
+
+  // Fall back to allocating a device visible buffer and copying into it.
+  if (!raw_buffer) {
+    CheckApiStatus(iree_hal_allocator_allocate_buffer(
+                       device_.allocator(), memory_type,
+                       IREE_HAL_BUFFER_USAGE_ALL, py_view->len, &raw_buffer),
+                   "Failed to allocate device visible buffer");
+    if (PyBuffer_IsContiguous(py_view.get(), 'C')) {
+      CheckApiStatus(iree_hal_buffer_write_data(raw_buffer, 0, py_view->buf,
+                                                py_view->len),
+                     "Error writing to input buffer");
+    } else {
+      iree_hal_mapped_memory_t mapped_memory;
+      CheckApiStatus(iree_hal_buffer_map(raw_buffer,
+                                         IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+                                         0, py_view->len, &mapped_memory),
+                     "Error mapping input buffer");
+      int rc = PyBuffer_ToContiguous(mapped_memory.contents.data,
+                                     py_view.get(), py_view->len, 'C');
+      iree_hal_buffer_unmap(raw_buffer, &mapped_memory);
+      if (rc != 0) {
+        iree_hal_buffer_release(raw_buffer);
+        throw py::error_already_set();
+      }
+    }
+  }
+
   iree_vm_ref_t buffer_ref = iree_hal_buffer_move_ref(raw_buffer);
   CheckApiStatus(
       iree_vm_variant_list_append_ref_move(f_args.raw_ptr(), &buffer_ref),
       "Error moving buffer");
-
-  // Only capture the reference to the exporting object (incrementing it)
-  // once guaranteed successful.
-  if (depends_on_pyobject) {
-    // Note for future implementation: there needs to be a place to stash
-    // references to be kept alive which back a buffer. This is likely an
-    // additional bag of refs returned from this function, which can then
-    // be attached to an invocation.
-    throw RaisePyError(PyExc_NotImplementedError,
-                       "Dependent buffer arguments not implemented");
-  }
 }
 
 void SetupFunctionAbiBindings(pybind11::module m) {
@@ -15,6 +15,7 @@
 """Tests for the function abi."""
 
 import re
+import sys
 
 from absl.testing import absltest
 
@@ -72,6 +73,28 @@ class FunctionAbiTest(absltest.TestCase):
     print(packed)
     self.assertEqual("<VmVariantList(1): [HalBuffer(327680)]>", repr(packed))
 
+  def test_static_arg_noncontiguous_success(self):
+    fabi = rt.FunctionAbi(self.device, self.htf,
+                          ATTRS_1ARG_FLOAT32_10X128X64_TO_SINT32_32X8X64_V1)
+    arg = np.arange(10 * 128 * 128, dtype=np.float32).reshape(
+        (10, 128, 128))[:, :, ::2]
+    self.assertFalse(arg.flags["C_CONTIGUOUS"])
+    packed = fabi.raw_pack_inputs([arg])
+    print(packed)
+    self.assertEqual("<VmVariantList(1): [HalBuffer(327680)]>", repr(packed))
+
+  def test_static_arg_lifetime(self):
+    fabi = rt.FunctionAbi(self.device, self.htf,
+                          ATTRS_1ARG_FLOAT32_10X128X64_TO_SINT32_32X8X64_V1)
+    arg = np.zeros((10, 128, 64), dtype=np.float32)
+    refcount = sys.getrefcount(arg)
+    packed = fabi.raw_pack_inputs([arg])
+    # The aligned, contiguous array is wrapped directly and retained by the
+    # packed buffer.
+    self.assertGreater(sys.getrefcount(arg), refcount)
+    del packed
+    self.assertEqual(refcount, sys.getrefcount(arg))
+
   def test_static_result_success(self):
     fabi = rt.FunctionAbi(self.device, self.htf,
                           ATTRS_1ARG_FLOAT32_10X128X64_TO_SINT32_32X8X64_V1)
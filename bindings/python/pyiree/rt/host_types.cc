@@ -93,8 +93,13 @@ class PyMappedMemory {
         buf_(std::move(buffer)) {}
   ~PyMappedMemory() {
     if (buf_) {
-      CheckApiStatus(iree_hal_buffer_unmap(buf_.raw_ptr(), &mapped_memory_),
-                     "Error unmapping memory");
+      iree_hal_buffer_t* raw_buffer = buf_.raw_ptr();
+      iree_status_t status;
+      {
+        py::gil_scoped_release release;
+        status = iree_hal_buffer_unmap(raw_buffer, &mapped_memory_);
+      }
+      CheckApiStatus(status, "Error unmapping memory");
     }
   }
   PyMappedMemory(PyMappedMemory&& other)
@@ -106,11 +111,18 @@ class PyMappedMemory {
                                               HalBuffer buffer) {
     iree_device_size_t byte_length =
         iree_hal_buffer_byte_length(buffer.raw_ptr());
+    iree_hal_buffer_t* raw_buffer = buffer.raw_ptr();
     iree_hal_mapped_memory_t mapped_memory;
-    CheckApiStatus(iree_hal_buffer_map(
-                       buffer.raw_ptr(), IREE_HAL_MEMORY_ACCESS_READ,
-                       0 /* element_offset */, byte_length, &mapped_memory),
-                   "Could not map memory");
+    iree_status_t status;
+    {
+      // Mapping may need to wait for outstanding work producing the buffer
+      // so we let other python threads run in the meantime.
+      py::gil_scoped_release release;
+      status = iree_hal_buffer_map(raw_buffer, IREE_HAL_MEMORY_ACCESS_READ,
+                                   0 /* element_offset */, byte_length,
+                                   &mapped_memory);
+    }
+    CheckApiStatus(status, "Could not map memory");
     return absl::make_unique<PyMappedMemory>(std::move(desc), mapped_memory,
                                              std::move(buffer));
   }
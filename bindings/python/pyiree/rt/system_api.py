@@ -25,8 +25,10 @@ and functions.
 
 __all__ = ["load_module", "load_modules", "Config", "SystemContext"]
 
+import concurrent.futures
 import os
 import sys
+import threading
 
 from typing import Optional, Sequence, Tuple
 
@@ -110,6 +112,20 @@ def _get_global_config():
   return _global_config
 
 
+_invoke_executor = None
+_invoke_executor_lock = threading.Lock()
+
+
+def _get_invoke_executor() -> concurrent.futures.Executor:
+  """Returns the executor used for asynchronous invocations."""
+  global _invoke_executor
+  with _invoke_executor_lock:
+    if _invoke_executor is None:
+      _invoke_executor = concurrent.futures.ThreadPoolExecutor(
+          max_workers=os.cpu_count(), thread_name_prefix="iree-invoke")
+    return _invoke_executor
+
+
 class BoundFunction:
   """Wraps a VmFunction, VmContext and ABI into a pythonic function."""
 
@@ -120,10 +136,26 @@ class BoundFunction:
     self._abi = context.create_function_abi(vm_function)
 
   def __call__(self, *args):
-    # NOTE: This is just doing sync dispatch right now. In the future,
-    # this should default to async and potentially have some kind of policy
-    # flag that can allow it to be overriden.
     inputs = self._abi.raw_pack_inputs(args)
+    return self._invoke(inputs)
+
+  def call_async(self, *args) -> concurrent.futures.Future:
+    """Invokes the function on a worker thread.
+
+    Arguments are packed on the calling thread but may be used by the
+    invocation without copying and must not be modified until the returned
+    future has completed. The GIL is released while the function is
+    executing so multiple invocations may run concurrently with python code.
+    Invocations against the same context are serialized; use multiple
+    contexts to invoke in parallel.
+
+    Returns:
+      A future resolving to the results as returned by a synchronous call.
+    """
+    inputs = self._abi.raw_pack_inputs(args)
+    return _get_invoke_executor().submit(self._invoke, inputs)
+
+  def _invoke(self, inputs):
     results = self._abi.allocate_results(inputs, static_alloc=False)
     self._context._vm_context.invoke(self._vm_function, inputs, results)
     unpacked_results = self._abi.raw_unpack_results(results)
@@ -92,6 +92,14 @@ class SystemApiTest(absltest.TestCase):
     results = f(arg0, arg1)
     np.testing.assert_allclose(results, [4., 10., 18., 28.])
 
+  def test_async_invoke(self):
+    arithmetic = rt.load_module(create_simple_mul_module())
+    arg0 = np.array([1., 2., 3., 4.], dtype=np.float32)
+    arg1 = np.array([4., 5., 6., 7.], dtype=np.float32)
+    futures = [arithmetic.simple_mul.call_async(arg0, arg1) for _ in range(8)]
+    for future in futures:
+      np.testing.assert_allclose(future.result(), [4., 10., 18., 28.])
+
   def test_load_module(self):
     arithmetic = rt.load_module(create_simple_mul_module())
     arg0 = np.array([1., 2., 3., 4.], dtype=np.float32)
@@ -128,9 +128,18 @@ std::unique_ptr<FunctionAbi> VmContext::CreateFunctionAbi(
 
 void VmContext::Invoke(iree_vm_function_t f, VmVariantList& inputs,
                        VmVariantList& outputs) {
-  CheckApiStatus(iree_vm_invoke(raw_ptr(), f, nullptr, inputs.raw_ptr(),
-                                outputs.raw_ptr(), IREE_ALLOCATOR_SYSTEM),
-                 "Error invoking function");
+  iree_vm_context_t* context = raw_ptr();
+  iree_status_t status;
+  {
+    // NOTE: the GIL must be released prior to acquiring the invoke mutex as
+    // the thread currently invoking may need the GIL to release buffers that
+    // wrap python memory.
+    py::gil_scoped_release release;
+    absl::MutexLock lock(invoke_mutex_.get());
+    status = iree_vm_invoke(context, f, nullptr, inputs.raw_ptr(),
+                            outputs.raw_ptr(), IREE_ALLOCATOR_SYSTEM);
+  }
+  CheckApiStatus(status, "Error invoking function");
 }
 
 //------------------------------------------------------------------------------
@@ -193,7 +202,17 @@ std::string VmVariantList::DebugString() const {
     if (i > 0) absl::StrAppend(&s, ", ");
 
     if (IREE_VM_VARIANT_IS_VALUE(variant)) {
-      absl::StrAppend(&s, variant->i32);
+      switch (variant->value_type) {
+        case IREE_VM_VALUE_TYPE_I64:
+          absl::StrAppend(&s, variant->i64);
+          break;
+        case IREE_VM_VALUE_TYPE_F32:
+          absl::StrAppend(&s, variant->f32);
+          break;
+        default:
+          absl::StrAppend(&s, variant->i32);
+          break;
+      }
     } else if (IREE_VM_VARIANT_IS_REF(variant)) {
       // Pretty print a subset of ABI impacting known types.
       if (iree_hal_buffer_isa(&variant->ref)) {
@@ -15,6 +15,9 @@
 #ifndef IREE_BINDINGS_PYTHON_PYIREE_RT_VM_H_
 #define IREE_BINDINGS_PYTHON_PYIREE_RT_VM_H_
 
+#include <memory>
+
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "bindings/python/pyiree/common/binding.h"
 #include "bindings/python/pyiree/rt/host_types.h"
@@ -126,6 +129,13 @@ class VmModule : public ApiRefCounted<VmModule, iree_vm_module_t> {
   }
 };
 
+// A VM context that may be invoked from multiple python threads.
+//
+// Module state within a context is thread-compatible and as such invocations
+// against the same context are serialized. The GIL is released while invoking
+// so that other python threads (including those invoking other contexts) can
+// make progress. To run invocations in parallel create one context per thread;
+// modules and devices can be shared across contexts.
 class VmContext : public ApiRefCounted<VmContext, iree_vm_context_t> {
  public:
   // Creates a context, optionally with modules, which will make the context
@@ -142,6 +152,7 @@ class VmContext : public ApiRefCounted<VmContext, iree_vm_context_t> {
   int context_id() const { return iree_vm_context_id(raw_ptr()); }
 
   // Synchronously invokes the given function.
+  // The GIL is released for the duration of the invocation.
   void Invoke(iree_vm_function_t f, VmVariantList& inputs,
               VmVariantList& outputs);
 
@@ -149,6 +160,11 @@ class VmContext : public ApiRefCounted<VmContext, iree_vm_context_t> {
   std::unique_ptr<FunctionAbi> CreateFunctionAbi(
       HalDevice& device, std::shared_ptr<HostTypeFactory> host_type_factory,
       iree_vm_function_t f);
+
+ private:
+  // Serializes invocations against the context.
+  std::shared_ptr<absl::Mutex> invoke_mutex_ =
+      std::make_shared<absl::Mutex>();
 };
 
 class VmInvocation : public ApiRefCounted<VmInvocation, iree_vm_invocation_t> {
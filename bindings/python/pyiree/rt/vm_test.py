@@ -15,6 +15,8 @@
 
 # pylint: disable=unused-variable
 
+import threading
+
 from absl.testing import absltest
 import numpy as np
 from pyiree import compiler
@@ -99,6 +101,43 @@ class VmTest(absltest.TestCase):
     print("RESULTS:", results)
     np.testing.assert_allclose(results[0], [4., 10., 18., 28.])
 
+  def test_concurrent_invoke_function(self):
+    # Invocations on the same context from multiple threads are serialized
+    # by the context while invocations on separate contexts may run in
+    # parallel.
+    m = create_simple_mul_module()
+    instance = rt.VmInstance()
+    shared_context = rt.VmContext(instance, modules=[self.hal_module, m])
+    f = m.lookup_function("simple_mul")
+    errors = []
+
+    def invoke_many(context, scale):
+      try:
+        abi = context.create_function_abi(self.device, self.htf, f)
+        for _ in range(16):
+          arg0 = np.array([1., 2., 3., 4.], dtype=np.float32) * scale
+          arg1 = np.array([4., 5., 6., 7.], dtype=np.float32)
+          inputs = abi.raw_pack_inputs((arg0, arg1))
+          allocated_results = abi.allocate_results(inputs, static_alloc=False)
+          context.invoke(f, inputs, allocated_results)
+          results = abi.raw_unpack_results(allocated_results)
+          np.testing.assert_allclose(results[0],
+                                     np.array([4., 10., 18., 28.]) * scale)
+      except Exception as e:  # pylint: disable=broad-except
+        errors.append(e)
+
+    threads = []
+    for i in range(4):
+      threads.append(
+          threading.Thread(target=invoke_many, args=(shared_context, i + 1)))
+      context = rt.VmContext(instance, modules=[self.hal_module, m])
+      threads.append(threading.Thread(target=invoke_many, args=(context, -i)))
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+    self.assertEqual([], errors)
+
 
 if __name__ == "__main__":
   absltest.main()
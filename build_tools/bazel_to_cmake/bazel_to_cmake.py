@@ -106,7 +106,9 @@ class BuildFileFunctions(object):
     self.PLATFORM_VULKAN_TEST_DEPS = ["//iree/testing:gtest_main"]
     self.FLATBUFFER_SUPPORTS_REFLECTIONS = False
     self.PLATFORM_VULKAN_LOADER_COPTS = []
+    self.LLVM_NATIVE_CODEGEN_DEPS = ["${IREE_LLVM_NATIVE_CODEGEN_LIBS}"]
     self.IREE_DRIVER_MODULES = [
+        "//iree/hal/dylib:dylib_driver_module",
         "//iree/hal/interpreter:interpreter_driver_module",
         # TODO(b/142004903): enable when Dawn HAL implementation is functional
         # "//iree/hal/dawn:dawn_driver_module",
@@ -233,6 +235,9 @@ class BuildFileFunctions(object):
       # marked as ALWAYSLINK.
       # This drops deps in the local namespace ending with '_gen' and 'Gen'
       target = [""]
+    elif target.startswith("${"):
+      # CMake variable expanding to platform-specific targets. Passed through.
+      target = [target]
     elif not target.startswith(("//iree", ":")):
       # External target, call helper method for special case handling.
       target = bazel_to_cmake_targets.convert_external_target(target)
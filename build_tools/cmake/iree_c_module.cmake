@@ -0,0 +1,103 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+include(CMakeParseArguments)
+
+# iree_c_module()
+#
+# CMake function to imitate Bazel's iree_c_module rule.
+#
+# Parameters:
+# NAME: Name of target (see Note).
+# SRC: Source file containing the vm.module to compile to C.
+# FLAGS: Flags to pass to the translation tool (list of strings).
+# TRANSLATE_TOOL: Translation tool to invoke (CMake target).
+# PUBLIC: Add this so that this library will be exported under ${PACKAGE}::
+#     Also in IDE, target will appear in ${PACKAGE} folder while non PUBLIC
+#     will be in ${PACKAGE}/internal.
+# TESTONLY: When added, this target will only be built if user passes
+#    -DIREE_BUILD_TESTS=ON to CMake.
+#
+# Note:
+# iree_c_module will create a library named ${NAME} with the generated
+# ${NAME}.c and ${NAME}.h, and alias target iree::${NAME}. The header declares
+# `<module name>_c_module_create`.
+function(iree_c_module)
+  cmake_parse_arguments(
+    _RULE
+    "PUBLIC;TESTONLY"
+    "NAME;SRC;TRANSLATE_TOOL"
+    "FLAGS"
+    ${ARGN}
+  )
+
+  if(NOT _RULE_TESTONLY OR IREE_BUILD_TESTS)
+    # Set defaults for FLAGS and TRANSLATE_TOOL
+    if(DEFINED _RULE_FLAGS)
+      set(_FLAGS ${_RULE_FLAGS})
+    else()
+      set(_FLAGS "-iree-vm-ir-to-c-module")
+    endif()
+    if(DEFINED _RULE_TRANSLATE_TOOL)
+      set(_TRANSLATE_TOOL ${_RULE_TRANSLATE_TOOL})
+    else()
+      set(_TRANSLATE_TOOL "iree_tools_iree-translate")
+    endif()
+
+    # Resolve the executable binary path from the target name.
+    set(_TRANSLATE_TOOL_EXECUTABLE $<TARGET_FILE:${_TRANSLATE_TOOL}>)
+
+    add_custom_command(
+      OUTPUT "${_RULE_NAME}.c"
+      COMMAND ${_TRANSLATE_TOOL_EXECUTABLE} ${_FLAGS}
+          "-iree-vm-c-module-output-format=source"
+          "${CMAKE_CURRENT_SOURCE_DIR}/${_RULE_SRC}"
+          "-o" "${_RULE_NAME}.c"
+      DEPENDS ${_TRANSLATE_TOOL} "${_RULE_SRC}"
+    )
+    add_custom_command(
+      OUTPUT "${_RULE_NAME}.h"
+      COMMAND ${_TRANSLATE_TOOL_EXECUTABLE} ${_FLAGS}
+          "-iree-vm-c-module-output-format=header"
+          "${CMAKE_CURRENT_SOURCE_DIR}/${_RULE_SRC}"
+          "-o" "${_RULE_NAME}.h"
+      DEPENDS ${_TRANSLATE_TOOL} "${_RULE_SRC}"
+    )
+
+    if(_RULE_PUBLIC)
+      set(_PUBLIC_FLAG "PUBLIC")
+    endif()
+    if(_RULE_TESTONLY)
+      set(_TESTONLY_FLAG "TESTONLY")
+    endif()
+    iree_cc_library(
+      NAME
+        "${_RULE_NAME}"
+      HDRS
+        "${CMAKE_CURRENT_BINARY_DIR}/${_RULE_NAME}.h"
+      SRCS
+        "${CMAKE_CURRENT_BINARY_DIR}/${_RULE_NAME}.c"
+      DEPS
+        iree::base::alignment
+        iree::base::api
+        iree::vm::c_module
+        iree::vm::module
+        iree::vm::ref
+        iree::vm::stack
+        iree::vm::types
+      ${_PUBLIC_FLAG}
+      ${_TESTONLY_FLAG}
+    )
+  endif()
+endfunction()
@@ -18,6 +18,8 @@
 #include <cstring>
 #include <string>
 
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "iree/base/api_util.h"
 #include "iree/base/file_mapping.h"
 #include "iree/base/init.h"
@@ -90,6 +92,10 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_api_init(int* argc,
   return IREE_STATUS_OK;
 }
 
+IREE_API_EXPORT iree_time_t IREE_API_CALL iree_time_now() {
+  return absl::ToUnixNanos(absl::Now());
+}
+
 //===----------------------------------------------------------------------===//
 // iree_allocator_t
 //===----------------------------------------------------------------------===//
@@ -124,6 +124,13 @@ typedef int64_t iree_time_t;
 // Like absl::InfiniteFuture.
 #define IREE_TIME_INFINITE_FUTURE INT64_MAX
 
+#ifndef IREE_API_NO_PROTOTYPES
+
+// Returns the current system time in nanoseconds since the unix epoch.
+IREE_API_EXPORT iree_time_t IREE_API_CALL iree_time_now();
+
+#endif  // IREE_API_NO_PROTOTYPES
+
 // A span of mutable bytes (ala std::span of uint8_t).
 typedef struct {
   uint8_t* data;
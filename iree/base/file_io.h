@@ -17,6 +17,7 @@
 
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "iree/base/status.h"
 
 namespace iree {
@@ -45,6 +46,12 @@ Status DeleteFile(const std::string& path);
 Status MoveFile(const std::string& source_path,
                 const std::string& destination_path);
 
+// Creates a new empty file with a unique name starting with |base_name| in the
+// system temporary directory and returns its path.
+//
+// The caller owns the file and is responsible for deleting it.
+StatusOr<std::string> GetTempFile(absl::string_view base_name);
+
 }  // namespace file_io
 }  // namespace iree
 
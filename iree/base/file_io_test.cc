@@ -78,6 +78,20 @@ TEST(FileIo, MoveFile) {
   EXPECT_EQ(to_write, read);
 }
 
+TEST(FileIo, GetTempFile) {
+  ASSERT_OK_AND_ASSIGN(auto path_a, GetTempFile("GetTempFile"));
+  ASSERT_OK_AND_ASSIGN(auto path_b, GetTempFile("GetTempFile"));
+  EXPECT_NE(path_a, path_b);
+  ASSERT_OK(FileExists(path_a));
+  ASSERT_OK(FileExists(path_b));
+  auto to_write = GetUniqueContents("GetTempFile");
+  ASSERT_OK(SetFileContents(path_a, to_write));
+  ASSERT_OK_AND_ASSIGN(std::string read, GetFileContents(path_a));
+  EXPECT_EQ(to_write, read);
+  ASSERT_OK(DeleteFile(path_a));
+  ASSERT_OK(DeleteFile(path_b));
+}
+
 }  // namespace
 }  // namespace file_io
 }  // namespace iree
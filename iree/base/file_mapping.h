@@ -15,6 +15,8 @@
 #ifndef IREE_BASE_FILE_MAPPING_H_
 #define IREE_BASE_FILE_MAPPING_H_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -36,6 +38,30 @@ class FileMapping : public RefObject<FileMapping> {
   // Read-only contents of the file.
   inline absl::Span<const uint8_t> data() const noexcept { return data_; }
 
+  // Hints that the given byte range of the file will be accessed soon so that
+  // it may be read in ahead of first use. The range is clamped to the file.
+  // This is only a hint and is ignored on platforms that do not support it.
+  virtual void AdviseWillNeed(size_t offset, size_t length) const {}
+
+  // Touches each page in the given byte range of the file such that it is
+  // resident when this returns. The range is clamped to the file.
+  void Prefault(size_t offset, size_t length) const {
+    if (offset >= data_.size()) return;
+    length = std::min(length, data_.size() - offset);
+    // Strides by the smallest common page size; touching a page more than
+    // once is harmless.
+    constexpr size_t kPageStride = 4096;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i += kPageStride) {
+      sum += static_cast<const volatile uint8_t*>(data_.data())[offset + i];
+    }
+    if (length > 0) {
+      sum += static_cast<const volatile uint8_t*>(
+          data_.data())[offset + length - 1];
+    }
+    (void)sum;
+  }
+
  protected:
   explicit FileMapping(absl::Span<const uint8_t> data) : data_(data) {}
 
@@ -0,0 +1,104 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/base/file_mapping.h"
+
+#include <string>
+
+#include "iree/base/file_io.h"
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Returns contents spanning several pages (and a partial trailing page) with
+// a distinct value in each byte position modulo 251.
+std::string GetMultiPageContents() {
+  std::string contents(3 * 4096 + 17, '\0');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>(i % 251);
+  }
+  return contents;
+}
+
+void ExpectContents(const FileMapping& mapping, const std::string& expected) {
+  ASSERT_EQ(expected.size(), mapping.data().size());
+  EXPECT_EQ(expected, std::string(reinterpret_cast<const char*>(
+                                      mapping.data().data()),
+                                  mapping.data().size()));
+}
+
+TEST(FileMappingTest, OpenRead) {
+  ASSERT_OK_AND_ASSIGN(auto path, file_io::GetTempFile("OpenRead"));
+  auto contents = GetMultiPageContents();
+  ASSERT_OK(file_io::SetFileContents(path, contents));
+
+  ASSERT_OK_AND_ASSIGN(auto mapping, FileMapping::OpenRead(path));
+  ExpectContents(*mapping, contents);
+  ASSERT_OK(file_io::DeleteFile(path));
+}
+
+TEST(FileMappingTest, OpenReadMissing) {
+  ASSERT_OK_AND_ASSIGN(auto path, file_io::GetTempFile("OpenReadMissing"));
+  ASSERT_OK(file_io::DeleteFile(path));
+  EXPECT_THAT(FileMapping::OpenRead(path).status(),
+              StatusIs(StatusCode::kNotFound));
+}
+
+// Prefault and AdviseWillNeed must clamp their ranges to the file and never
+// modify the contents.
+TEST(FileMappingTest, PrefaultAndAdvise) {
+  ASSERT_OK_AND_ASSIGN(auto path, file_io::GetTempFile("PrefaultAndAdvise"));
+  auto contents = GetMultiPageContents();
+  ASSERT_OK(file_io::SetFileContents(path, contents));
+  ASSERT_OK_AND_ASSIGN(auto mapping, FileMapping::OpenRead(path));
+  size_t size = contents.size();
+
+  mapping->Prefault(0, size);
+  mapping->Prefault(4097, 1);
+  mapping->Prefault(4097, size * 2);
+  mapping->Prefault(size - 1, 1);
+  mapping->Prefault(size, 1);
+  mapping->Prefault(size + 4096, 4096);
+  mapping->Prefault(0, 0);
+
+  mapping->AdviseWillNeed(0, size);
+  mapping->AdviseWillNeed(4097, 1);
+  mapping->AdviseWillNeed(4097, size * 2);
+  mapping->AdviseWillNeed(size - 1, 1);
+  mapping->AdviseWillNeed(size, 1);
+  mapping->AdviseWillNeed(size + 4096, 4096);
+
+  ExpectContents(*mapping, contents);
+  ASSERT_OK(file_io::DeleteFile(path));
+}
+
+// The mapping must remain valid after the file it was opened from is deleted.
+TEST(FileMappingTest, OutlivesFile) {
+  ASSERT_OK_AND_ASSIGN(auto path, file_io::GetTempFile("OutlivesFile"));
+  auto contents = GetMultiPageContents();
+  ASSERT_OK(file_io::SetFileContents(path, contents));
+  ASSERT_OK_AND_ASSIGN(auto mapping, FileMapping::OpenRead(path));
+  ASSERT_OK(file_io::DeleteFile(path));
+
+  mapping->Prefault(0, contents.size());
+  ExpectContents(*mapping, contents);
+}
+
+}  // namespace
+}  // namespace iree
@@ -106,6 +106,21 @@ Status MoveFile(const std::string& source_path,
   return OkStatus();
 }
 
+StatusOr<std::string> GetTempFile(absl::string_view base_name) {
+  const char* temp_dir = ::getenv("TEST_TMPDIR");
+  if (!temp_dir) temp_dir = ::getenv("TMPDIR");
+  if (!temp_dir) temp_dir = "/tmp";
+  std::string path = absl::StrCat(temp_dir, "/", base_name, "_XXXXXX");
+  int fd = ::mkstemp(&path[0]);
+  if (fd == -1) {
+    return ErrnoToCanonicalStatusBuilder(
+        errno, absl::StrCat("Failed to create temp file '", path, "'"),
+        IREE_LOC);
+  }
+  ::close(fd);
+  return path;
+}
+
 }  // namespace file_io
 }  // namespace iree
 
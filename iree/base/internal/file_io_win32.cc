@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "absl/base/macros.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "iree/base/file_io.h"
@@ -81,6 +82,23 @@ Status MoveFile(const std::string& source_path,
   return OkStatus();
 }
 
+StatusOr<std::string> GetTempFile(absl::string_view base_name) {
+  char temp_path[MAX_PATH];
+  DWORD temp_path_length = ::GetTempPathA(ABSL_ARRAYSIZE(temp_path), temp_path);
+  if (temp_path_length == 0 || temp_path_length > ABSL_ARRAYSIZE(temp_path)) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to query temp path";
+  }
+  // NOTE: only the first 3 characters of the prefix are used.
+  std::string prefix(base_name);
+  char temp_file_name[MAX_PATH];
+  if (::GetTempFileNameA(temp_path, prefix.c_str(), 0, temp_file_name) == 0) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to create temp file in " << temp_path;
+  }
+  return std::string(temp_file_name);
+}
+
 }  // namespace file_io
 }  // namespace iree
 
@@ -25,6 +25,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 
 namespace iree {
@@ -78,6 +79,20 @@ class MMapMapping : public FileMapping {
       LOG(WARNING) << "Unable to unmap file: " << strerror(errno);
     }
   }
+
+  void AdviseWillNeed(size_t offset, size_t length) const override {
+    if (offset >= data_.size()) return;
+    length = std::min(length, data_.size() - offset);
+    // madvise requires a page-aligned start address. The mapping itself is
+    // page-aligned so aligning the offset down keeps us within it.
+    size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t aligned_offset = offset - (offset % page_size);
+    length += offset - aligned_offset;
+    if (::madvise(const_cast<uint8_t*>(data_.data()) + aligned_offset, length,
+                  MADV_WILLNEED) != 0) {
+      LOG(WARNING) << "Unable to advise file mapping: " << strerror(errno);
+    }
+  }
 };
 
 }  // namespace
@@ -14,6 +14,11 @@
 
 #include "iree/base/wait_handle.h"
 
+#include "iree/base/target_platform.h"
+
+// NOTE: wait_handle has no win32 implementation yet.
+#if !defined(IREE_PLATFORM_WINDOWS)
+
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
@@ -30,16 +35,14 @@
 #include "iree/base/source_location.h"
 #include "iree/base/status.h"
 
-// TODO(benvanik): organize these macros - they are terrible.
-
-#if !defined(__ANDROID__) && !defined(OS_IOS) && !defined(__EMSCRIPTEN__)
+#if defined(IREE_PLATFORM_LINUX) && !defined(IREE_PLATFORM_ANDROID)
 #define IREE_HAS_PPOLL 1
-#endif  // !__ANDROID__  && !__EMSCRIPTEN__
+#endif  // IREE_PLATFORM_LINUX && !IREE_PLATFORM_ANDROID
 #define IREE_HAS_POLL 1
 
-#if !defined(OS_IOS) && !defined(OS_MACOSX) && !defined(__EMSCRIPTEN__)
+#if defined(IREE_PLATFORM_LINUX)
 #define IREE_HAS_EVENTFD 1
-#endif
+#endif  // IREE_PLATFORM_LINUX
 #define IREE_HAS_PIPE 1
 // #define IREE_HAS_SYNC_FILE 1
 
@@ -530,3 +533,5 @@ Status ManualResetEvent::Reset() { return ClearFd(fd_type_, fd_); }
 WaitHandle ManualResetEvent::OnSet() { return WaitHandle(add_ref(this)); }
 
 }  // namespace iree
+
+#endif  // !IREE_PLATFORM_WINDOWS
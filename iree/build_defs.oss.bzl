@@ -60,8 +60,20 @@ PLATFORM_VULKAN_TEST_DEPS = [
     "//iree/testing:gtest_main",
 ]
 
+# The LLVM code generator for the host machine. Required by targets that call
+# llvm::InitializeNativeTarget.
+LLVM_NATIVE_CODEGEN_DEPS = select({
+    "@bazel_tools//src/conditions:linux_aarch64": [
+        "@llvm-project//llvm:aarch64_code_gen",
+    ],
+    "//conditions:default": [
+        "@llvm-project//llvm:x86_code_gen",
+    ],
+})
+
 # Driver modules that register themselves at link time.
 IREE_DRIVER_MODULES = [
+    "//iree/hal/dylib:dylib_driver_module",
     "//iree/hal/interpreter:interpreter_driver_module",
     # TODO(b/142004903): enable when Dawn HAL implementation is functional
     # "//iree/hal/dawn:dawn_driver_module",
@@ -101,6 +101,7 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager) {
 
   // Form streams.
   passManager.addPass(IREE::Flow::createFormStreamsPass());
+  passManager.addPass(IREE::Flow::createScheduleStreamsPass());
 
   // TODO(benvanik): run symbol DCE pass.
 
@@ -134,6 +134,10 @@ std::unique_ptr<OpPassBase<ModuleOp>> createOutlineReductionRegionsPass(
 // Identifies dispatches that can be grouped into streams within functions.
 std::unique_ptr<OpPassBase<FuncOp>> createFormStreamsPass();
 
+// Reorders ops within streams such that independent ops are grouped together
+// and may execute concurrently.
+std::unique_ptr<OpPassBase<FuncOp>> createScheduleStreamsPass();
+
 // TODO(benvanik): cross-function stream flows.
 
 //===----------------------------------------------------------------------===//
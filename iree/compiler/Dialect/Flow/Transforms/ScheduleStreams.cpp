@@ -0,0 +1,86 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "mlir/IR/Block.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+// Reorders the ops within stream fragments such that ops that do not depend on
+// each other are adjacent.
+//
+// Each op is assigned a level one greater than the deepest op in the stream it
+// consumes a value from (ASAP scheduling) and ops are then stably sorted by
+// level. Ops sharing a level are independent and can be recorded without
+// barriers between them, allowing backends with parallel executors to overlap
+// them. Barriers are only required between levels.
+class ScheduleStreamsPass : public FunctionPass<ScheduleStreamsPass> {
+ public:
+  void runOnFunction() override {
+    getFunction().walk(
+        [&](ExStreamFragmentOp streamOp) { scheduleStreamBlock(streamOp); });
+  }
+
+ private:
+  void scheduleStreamBlock(ExStreamFragmentOp streamOp) {
+    auto &block = streamOp.body().front();
+    auto *terminator = block.getTerminator();
+
+    // Ops are in SSA order so producers are always visited before consumers.
+    DenseMap<Operation *, int> levels;
+    SmallVector<Operation *, 8> ops;
+    for (auto &op : block.without_terminator()) {
+      int level = 0;
+      for (auto operand : op.getOperands()) {
+        auto *definingOp = operand.getDefiningOp();
+        if (!definingOp || definingOp->getBlock() != &block) continue;
+        level = std::max(level, levels[definingOp] + 1);
+      }
+      levels[&op] = level;
+      ops.push_back(&op);
+    }
+
+    std::stable_sort(ops.begin(), ops.end(),
+                     [&](Operation *lhs, Operation *rhs) {
+                       return levels[lhs] < levels[rhs];
+                     });
+    for (auto *op : ops) {
+      op->moveBefore(terminator);
+    }
+  }
+};
+
+std::unique_ptr<OpPassBase<FuncOp>> createScheduleStreamsPass() {
+  return std::make_unique<ScheduleStreamsPass>();
+}
+
+static PassRegistration<ScheduleStreamsPass> pass(
+    "iree-flow-schedule-streams",
+    "Reorders ops within streams to group independent ops together");
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,45 @@
+// RUN: iree-opt -split-input-file -iree-flow-schedule-streams %s | IreeFileCheck %s
+
+flow.executable @ex0 {
+  flow.dispatch.entry @entry0 attributes {
+    workload = dense<[4, 1, 1]> : vector<3xi32>
+  }
+  module {
+    func @entry0(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      %0 = xla_hlo.add %arg0, %arg0 : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+flow.executable @ex1 {
+  flow.dispatch.entry @entry1 attributes {
+    workload = dense<[4, 1, 1]> : vector<3xi32>
+  }
+  module {
+    func @entry1(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> tensor<4xf32> {
+      %0 = xla_hlo.mul %arg0, %arg1 : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+
+// CHECK-LABEL: func @independentDispatches
+func @independentDispatches(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+  %cst = constant dense<[4, 1, 1]> : vector<3xi32>
+  // CHECK: flow.ex.stream.fragment(%arg1 = %cst : vector<3xi32>, %arg2 = %arg0 : tensor<4xf32>)
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : vector<3xi32>, %arg2 = %arg0 : tensor<4xf32>) -> tensor<4xf32> {
+    // CHECK-NEXT: [[A0:%.+]] = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2)
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2) : (tensor<4xf32>) -> tensor<4xf32>
+    // CHECK-NEXT: [[B0:%.+]] = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2)
+    // CHECK-NEXT: [[A1:%.+]] = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>]([[A0]])
+    // CHECK-NEXT: [[B1:%.+]] = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>]([[B0]])
+    // CHECK-NEXT: [[C:%.+]] = flow.dispatch @ex1::@entry1[%arg1 : vector<3xi32>]([[A1]], [[B1]])
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%1) : (tensor<4xf32>) -> tensor<4xf32>
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2) : (tensor<4xf32>) -> tensor<4xf32>
+    %4 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%3) : (tensor<4xf32>) -> tensor<4xf32>
+    %5 = flow.dispatch @ex1::@entry1[%arg1 : vector<3xi32>](%2, %4) : (tensor<4xf32>, tensor<4xf32>) -> tensor<4xf32>
+    // CHECK-NEXT: flow.return [[C]]
+    flow.return %5 : tensor<4xf32>
+  }
+  return %0 : tensor<4xf32>
+}
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/HAL/Conversion/FlowToHAL/ConvertFlowToHAL.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
@@ -19,6 +21,9 @@
 #include "iree/compiler/Dialect/HAL/Utils/TypeUtils.h"
 #include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Analysis/CallInterfaces.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -145,20 +150,191 @@ static Value allocateTransientBuffer(Value streamValue, Value allocator,
   return buffer;
 }
 
+// Assigns each op in |streamBlock| to a barrier group. Commands within a group
+// do not depend on each other and may execute concurrently while groups are
+// separated by execution barriers.
+//
+// Groups are formed greedily in block order with a new group started whenever
+// an op consumes a value produced within the current group. Streams are
+// expected to have been scheduled by -iree-flow-schedule-streams such that
+// independent ops are adjacent and the number of barriers is minimized.
+static DenseMap<Operation *, int> computeBarrierGroups(Block &streamBlock) {
+  DenseMap<Operation *, int> barrierGroups;
+  int currentGroup = 0;
+  for (auto &op : streamBlock) {
+    for (auto operand : op.getOperands()) {
+      auto it = barrierGroups.find(operand.getDefiningOp());
+      if (it != barrierGroups.end() && it->second == currentGroup) {
+        ++currentGroup;
+        break;
+      }
+    }
+    barrierGroups[&op] = currentGroup;
+  }
+  return barrierGroups;
+}
+
+// Alignment of transient buffers suballocated from a slab, in bytes. This is
+// the largest minStorageBufferOffsetAlignment allowed by Vulkan and satisfies
+// the binding alignment requirements of all other HAL backends.
+static constexpr int64_t kTransientSlabAlignment = 256;
+
+// A statically-sized transient value and the range of ops within the stream
+// for which its storage must remain live.
+struct TransientInterval {
+  Value value;
+  int64_t byteLength = 0;
+  // Barrier group of the op defining the value.
+  int startIndex = 0;
+  // Barrier group of the last op using the value (inclusive).
+  int endIndex = 0;
+  // Assigned byte offset within the slab.
+  int64_t offset = 0;
+
+  bool overlapsLifetime(const TransientInterval &other) const {
+    return startIndex <= other.endIndex && other.startIndex <= endIndex;
+  }
+  bool overlapsRange(const TransientInterval &other, int64_t otherOffset,
+                     int64_t otherLength) const {
+    return offset < otherOffset + otherLength &&
+           otherOffset < offset + byteLength;
+  }
+};
+
+// Returns the byte length of |streamValue| if it has a static shape or -1 if
+// it must be sized at runtime. This matches hal.allocator.compute_size for the
+// dense layouts we currently use.
+static int64_t getStaticByteLength(Value streamValue) {
+  auto shapedType = streamValue.getType().dyn_cast<ShapedType>();
+  if (!shapedType || !shapedType.hasStaticShape()) return -1;
+  return shapedType.getNumElements() *
+         IREE::HAL::getRoundedElementByteWidth(shapedType.getElementType());
+}
+
+// Assigns slab offsets to each of the |intervals| such that values whose
+// lifetimes overlap never share storage. Returns the total slab size.
+//
+// This is the usual greedy interval packing: values are placed largest first
+// at the lowest aligned offset that does not collide with any
+// already-placed value that is live at the same time.
+static int64_t packTransientIntervals(
+    MutableArrayRef<TransientInterval> intervals) {
+  SmallVector<TransientInterval *, 8> order;
+  for (auto &interval : intervals) order.push_back(&interval);
+  std::stable_sort(order.begin(), order.end(),
+                   [](TransientInterval *lhs, TransientInterval *rhs) {
+                     return lhs->byteLength > rhs->byteLength;
+                   });
+
+  int64_t slabSize = 0;
+  SmallVector<TransientInterval *, 8> placed;
+  for (auto *interval : order) {
+    // Gather the live ranges we must avoid, sorted by offset.
+    SmallVector<TransientInterval *, 8> conflicts;
+    for (auto *other : placed) {
+      if (interval->overlapsLifetime(*other)) conflicts.push_back(other);
+    }
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](TransientInterval *lhs, TransientInterval *rhs) {
+                return lhs->offset < rhs->offset;
+              });
+
+    // Find the first gap large enough to hold the value.
+    int64_t offset = 0;
+    for (auto *other : conflicts) {
+      if (other->overlapsRange(*interval, offset, interval->byteLength)) {
+        offset = llvm::alignTo(other->offset + other->byteLength,
+                               kTransientSlabAlignment);
+      }
+    }
+    interval->offset = offset;
+    placed.push_back(interval);
+    slabSize = std::max(slabSize, offset + interval->byteLength);
+  }
+  return llvm::alignTo(slabSize, kTransientSlabAlignment);
+}
+
 // Allocates transient buffers to store the intra-stream results and populates
 // the |bufferSet| with the new mappings.
-static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
-                                     BufferSet &bufferSet,
-                                     ConversionPatternRewriter &rewriter) {
-  for (auto &op : streamOp.body().front()) {
+//
+// Statically-shaped transients are suballocated from a single slab with
+// offsets computed from their lifetimes in terms of the |barrierGroups| of the
+// stream such that storage is reused once a value is no longer needed. Values
+// live within the same group never share storage so that commands in the group
+// may execute concurrently. Dynamically-shaped transients are allocated
+// individually.
+static void allocateTransientBuffers(
+    IREE::Flow::ExStreamFragmentOp streamOp,
+    const DenseMap<Operation *, int> &barrierGroups, BufferSet &bufferSet,
+    ConversionPatternRewriter &rewriter) {
+  auto &block = streamOp.body().front();
+  SmallVector<TransientInterval, 8> intervals;
+  for (auto &op : block) {
     for (auto result : op.getResults()) {
       // If the result is an output buffer we can just use that directly.
       if (bufferSet.rangeMap[result].buffer) continue;
 
-      auto buffer =
-          allocateTransientBuffer(result, bufferSet.allocator, rewriter);
-      bufferSet.rangeMap[result] = BufferRange{buffer};
+      int64_t byteLength = getStaticByteLength(result);
+      if (byteLength <= 0) {
+        auto buffer =
+            allocateTransientBuffer(result, bufferSet.allocator, rewriter);
+        bufferSet.rangeMap[result] = BufferRange{buffer};
+        continue;
+      }
+
+      TransientInterval interval;
+      interval.value = result;
+      interval.byteLength = byteLength;
+      interval.startIndex = barrierGroups.lookup(&op);
+      interval.endIndex = interval.startIndex;
+      for (auto *user : result.getUsers()) {
+        auto *ancestor = block.findAncestorOpInBlock(*user);
+        if (!ancestor) continue;
+        interval.endIndex =
+            std::max(interval.endIndex, barrierGroups.lookup(ancestor));
+      }
+      intervals.push_back(interval);
+    }
+  }
+  if (intervals.empty()) return;
+
+  int64_t slabSize = packTransientIntervals(intervals);
+  auto loc = streamOp.getLoc();
+  auto slabBuffer =
+      rewriter
+          .create<IREE::HAL::AllocatorAllocateOp>(
+              loc, bufferSet.allocator,
+              IREE::HAL::MemoryTypeBitfield::DeviceLocal,
+              IREE::HAL::BufferUsageBitfield::Dispatch |
+                  IREE::HAL::BufferUsageBitfield::Transfer,
+              rewriter.createOrFold<mlir::ConstantOp>(
+                  loc, rewriter.getI32IntegerAttr(slabSize)))
+          .getResult();
+  // TODO(benvanik): implement resource sets.
+  rewriter.create<IREE::HAL::ExDeferReleaseOp>(loc, slabBuffer);
+
+  for (auto &interval : intervals) {
+    // Avoid the subspan indirection when a value covers the entire slab.
+    if (interval.offset == 0 &&
+        llvm::alignTo(interval.byteLength, kTransientSlabAlignment) ==
+            slabSize) {
+      bufferSet.rangeMap[interval.value] = BufferRange{slabBuffer};
+      continue;
     }
+    auto buffer = rewriter
+                      .create<IREE::HAL::BufferSubspanOp>(
+                          interval.value.getLoc(),
+                          IREE::HAL::BufferType::get(rewriter.getContext()),
+                          slabBuffer,
+                          rewriter.createOrFold<mlir::ConstantOp>(
+                              loc, rewriter.getI32IntegerAttr(interval.offset)),
+                          rewriter.createOrFold<mlir::ConstantOp>(
+                              loc, rewriter.getI32IntegerAttr(
+                                       interval.byteLength)))
+                      .getResult();
+    rewriter.create<IREE::HAL::ExDeferReleaseOp>(interval.value.getLoc(),
+                                                 buffer);
+    bufferSet.rangeMap[interval.value] = BufferRange{buffer};
   }
 }
 
@@ -266,11 +442,6 @@ static void recordDispatch(Value device, Value commandBuffer,
   rewriter.create<IREE::HAL::CommandBufferDispatchOp>(
       dispatchOp.getLoc(), commandBuffer, executable, entryPointOp,
       workgroupCounts[0], workgroupCounts[1], workgroupCounts[2]);
-
-  // Full barriers for now as we aren't scheduling things.
-  // TODO(benvanik): don't add at the end of the command buffer (we could
-  // also do a canonicalization step that removed trailing barriers).
-  recordFullExecutionBarrier(commandBuffer, dispatchOp.getLoc(), rewriter);
 }
 
 static void recordTensorUpdate(Value device, Value commandBuffer,
@@ -316,18 +487,25 @@ static void recordTensorUpdate(Value device, Value commandBuffer,
                                                updateBuffer.buffer);
   rewriter.create<IREE::HAL::ExDeferReleaseOp>(updateOp.getLoc(),
                                                resultBuffer.buffer);
-
-  // Full barriers for now as we aren't scheduling things.
-  // TODO(benvanik): don't add at the end of the command buffer (we could
-  // also do a canonicalization step that removed trailing barriers).
-  recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
 }
 
-static LogicalResult recordStreamCommands(Value device, Value commandBuffer,
-                                          Block &streamBlock,
-                                          BufferSet &bufferSet,
-                                          ConversionPatternRewriter &rewriter) {
+// Records all commands in |streamBlock|, inserting execution barriers only
+// between |barrierGroups|.
+static LogicalResult recordStreamCommands(
+    Value device, Value commandBuffer, Block &streamBlock,
+    const DenseMap<Operation *, int> &barrierGroups, BufferSet &bufferSet,
+    ConversionPatternRewriter &rewriter) {
+  int previousGroup = 0;
   for (auto &op : streamBlock) {
+    // Full barriers for now as the HAL has no finer-grained dependencies.
+    // Commands in the same group have no dependencies on each other and can
+    // overlap.
+    int group = barrierGroups.lookup(&op);
+    if (group != previousGroup && !op.isKnownTerminator()) {
+      recordFullExecutionBarrier(commandBuffer, op.getLoc(), rewriter);
+      previousGroup = group;
+    }
+
     if (auto dispatchOp = dyn_cast<IREE::Flow::DispatchOp>(op)) {
       recordDispatch(device, commandBuffer, dispatchOp, bufferSet, rewriter);
     } else if (auto updateOp = dyn_cast<IREE::Flow::TensorUpdateOp>(op)) {
@@ -341,6 +519,42 @@ static LogicalResult recordStreamCommands(Value device, Value commandBuffer,
   return success();
 }
 
+// Returns true if |op| may access the contents of buffers from the host (or
+// escape them to code that does) and must wait for submissions producing them
+// to complete.
+static bool mayAccessBuffersOnHost(Operation *op) {
+  if (op->isKnownTerminator() || op->getNumRegions() > 0 ||
+      isa<CallOpInterface>(op)) {
+    return true;
+  }
+  if (op->hasTrait<OpTrait::ConstantLike>()) return false;
+  auto isBufferLike = [](Type type) {
+    return type.isa<ShapedType>() || type.isa<IREE::HAL::BufferType>() ||
+           type.isa<IREE::HAL::BufferViewType>();
+  };
+  return llvm::any_of(op->getOperandTypes(), isBufferLike) ||
+         llvm::any_of(op->getResultTypes(), isBufferLike);
+}
+
+// Inserts a wait for prior submissions before the first op following
+// |streamOp| in its block that may access the stream results on the host.
+// Subsequent streams are submitted to the same queue and are ordered after
+// |streamOp| on the device, so no wait is required between them and the host
+// may continue recording commands while the prior streams execute.
+static void insertWaitBeforeHostAccess(IREE::Flow::ExStreamFragmentOp streamOp,
+                                       Value device,
+                                       ConversionPatternRewriter &rewriter) {
+  for (auto *op = streamOp.getOperation()->getNextNode(); op;
+       op = op->getNextNode()) {
+    if (isa<IREE::Flow::ExStreamFragmentOp>(op)) return;
+    if (!mayAccessBuffersOnHost(op)) continue;
+    OpBuilder::InsertionGuard insertionGuard(rewriter);
+    rewriter.setInsertionPoint(op);
+    rewriter.create<IREE::HAL::ExWaitIdleOp>(streamOp.getLoc(), device);
+    return;
+  }
+}
+
 class ExStreamFragmentOpConversion
     : public OpConversionPattern<IREE::Flow::ExStreamFragmentOp> {
  public:
@@ -377,8 +591,9 @@ class ExStreamFragmentOpConversion
     }
 
     // Allocate buffers for outputs and transient buffers.
+    auto barrierGroups = computeBarrierGroups(entryBlock);
     allocateOutputBuffers(streamOp, bufferSet, rewriter);
-    allocateTransientBuffers(streamOp, bufferSet, rewriter);
+    allocateTransientBuffers(streamOp, barrierGroups, bufferSet, rewriter);
 
     // Allocate and begin the command buffer.
     // In a real version we would want to pick the device based on the placement
@@ -391,17 +606,17 @@ class ExStreamFragmentOpConversion
 
     // Record all of the commands into the command buffer.
     if (failed(recordStreamCommands(device, commandBuffer, entryBlock,
-                                    bufferSet, rewriter))) {
+                                    barrierGroups, bufferSet, rewriter))) {
       return matchFailure();
     }
 
-    // End and submit the command buffer.
-    // In a real version we'd want to setup a semaphore chain instead of
-    // submitting and waiting.
+    // End and submit the command buffer. The submission runs asynchronously
+    // and we only wait for it once the host needs the results.
     rewriter.create<IREE::HAL::CommandBufferEndOp>(streamOp.getLoc(),
                                                    commandBuffer);
-    rewriter.create<IREE::HAL::ExSubmitAndWaitOp>(streamOp.getLoc(), device,
-                                                  commandBuffer);
+    rewriter.create<IREE::HAL::ExSubmitOp>(streamOp.getLoc(), device,
+                                           commandBuffer);
+    insertWaitBeforeHostAccess(streamOp, device, rewriter);
 
     // It's annoying, but we need to do this replacement at the very end as
     // otherwise we lose access to the original values (which we need for
@@ -51,18 +51,100 @@ func @multipleDispatches(%arg0: tensor<128xf32>) -> tensor<128xf32> {
     // CHECK-NEXT: hal.command_buffer.dispatch [[CMD]], {{.+}}, entry_point = 0, workgroup_xyz = [
     // CHECK-SAME:   [[C4]], [[C1]], [[C1]]
     // CHECK-SAME: ]
-    // CHECK: hal.command_buffer.execution_barrier
+    // CHECK-NOT: hal.command_buffer.execution_barrier
     %2 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%1) : (tensor<128xf32>) -> tensor<128xf32>
     flow.return %2 : tensor<128xf32>
   }
   // CHECK: hal.command_buffer.end [[CMD]]
-  // CHECK-NEXT: hal.ex.submit_and_wait {{.+}}, [[CMD]]
+  // CHECK-NEXT: hal.ex.submit [[DEV:%.+]], [[CMD]]
+  // CHECK-NEXT: hal.ex.wait_idle [[DEV]]
   // CHECK-NEXT: return [[RET_BUF]]
   return %0 : tensor<128xf32>
 }
 
 // -----
 
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.entry_point @entry0 attributes {
+    interface = @interface,
+    ordinal = 0 : i32,
+    signature = (tensor<128xf32>) -> tensor<128xf32>,
+    workgroup_size = dense<[32, 1, 1]> : vector<3xi32>
+  }
+}
+
+// CHECK-LABEL: func @transientSlab
+func @transientSlab(%arg0: tensor<128xf32>) -> tensor<128xf32> {
+  // CHECK-DAG: [[C0:%.+]] = constant 0 : i32
+  // CHECK-DAG: [[C512:%.+]] = constant 512 : i32
+  // CHECK-DAG: [[C1024:%.+]] = constant 1024 : i32
+  %cst = constant dense<[128, 1, 1]> : vector<3xi32>
+  // CHECK: [[RET_BUF:%.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal", "Constant|Transfer|Mapping|Dispatch"
+  // CHECK: [[SLAB:%.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Transfer|Dispatch", [[C1024]]
+  // CHECK-NEXT: hal.ex.defer_release [[SLAB]]
+  // CHECK-NOT: hal.allocator.allocate
+  // CHECK: [[TMP0:%.+]] = hal.buffer.subspan [[SLAB]], [[C0]], [[C512]]
+  // CHECK: [[TMP1:%.+]] = hal.buffer.subspan [[SLAB]], [[C512]], [[C512]]
+  // CHECK: [[TMP2:%.+]] = hal.buffer.subspan [[SLAB]], [[C0]], [[C512]]
+  // CHECK: hal.command_buffer.create
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : vector<3xi32>, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
+    // CHECK: hal.ex.push_binding {{.+}}, 1, [[TMP0]]
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.ex.push_binding {{.+}}, 0, [[TMP0]]
+    // CHECK: hal.ex.push_binding {{.+}}, 1, [[TMP1]]
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.ex.push_binding {{.+}}, 0, [[TMP1]]
+    // CHECK: hal.ex.push_binding {{.+}}, 1, [[TMP2]]
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.ex.push_binding {{.+}}, 0, [[TMP2]]
+    // CHECK: hal.ex.push_binding {{.+}}, 1, [[RET_BUF]]
+    %4 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%3) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %4 : tensor<128xf32>
+  }
+  return %0 : tensor<128xf32>
+}
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.entry_point @entry0 attributes {
+    interface = @interface,
+    ordinal = 0 : i32,
+    signature = (tensor<128xf32>) -> tensor<128xf32>,
+    workgroup_size = dense<[32, 1, 1]> : vector<3xi32>
+  }
+}
+
+// CHECK-LABEL: func @concurrentDispatches
+func @concurrentDispatches(%arg0: tensor<128xf32>) -> (tensor<128xf32>, tensor<128xf32>) {
+  %cst = constant dense<[128, 1, 1]> : vector<3xi32>
+  // CHECK: [[CMD:%.+]] = hal.command_buffer.create
+  %0:2 = flow.ex.stream.fragment(%arg1 = %cst : vector<3xi32>, %arg2 = %arg0 : tensor<128xf32>) -> (tensor<128xf32>, tensor<128xf32>) {
+    // CHECK: hal.command_buffer.dispatch [[CMD]]
+    // CHECK-NOT: hal.command_buffer.execution_barrier
+    // CHECK: hal.command_buffer.dispatch [[CMD]]
+    // CHECK: hal.command_buffer.execution_barrier
+    // CHECK: hal.command_buffer.dispatch [[CMD]]
+    // CHECK-NOT: hal.command_buffer.execution_barrier
+    // CHECK: hal.command_buffer.end [[CMD]]
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : vector<3xi32>](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %2, %3 : tensor<128xf32>, tensor<128xf32>
+  }
+  return %0#0, %0#1 : tensor<128xf32>, tensor<128xf32>
+}
+
+// -----
+
 // CHECK-LABEL: @tensorUpdate
 // CHECK-SAME: ([[UBUF:%.+]]:{{.+}}, [[TBUF:%.+]]:{{.+}})
 func @tensorUpdate(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> tensor<5x1x10xf32> {
@@ -82,6 +164,34 @@ func @tensorUpdate(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> te
     flow.return %1 : tensor<5x1x10xf32>
   }
   // CHECK: hal.command_buffer.end [[CMD]]
-  // CHECK: return [[RET_BUF]]
+  // CHECK-NEXT: hal.ex.submit
+  // CHECK-NEXT: hal.ex.wait_idle
+  // CHECK-NEXT: return [[RET_BUF]]
   return %0 : tensor<5x1x10xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @multipleStreams
+func @multipleStreams(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> tensor<5x1x10xf32> {
+  %c4 = constant 4 : i32
+  %c1 = constant 1 : i32
+  // CHECK: [[CMD0:%.+]] = hal.command_buffer.create
+  // CHECK: hal.command_buffer.end [[CMD0]]
+  // CHECK-NEXT: hal.ex.submit {{.+}}, [[CMD0]]
+  // CHECK-NOT: hal.ex.wait_idle
+  %0 = flow.ex.stream.fragment(%arg2 = %arg0 : tensor<1x1x10xf32>, %arg3 = %arg1 : tensor<5x1x10xf32>, %arg4 = %c4 : i32, %arg5 = %c1 : i32) -> tensor<5x1x10xf32> {
+    %2 = flow.tensor.update %arg2, %arg3[%arg4, %arg5, %arg5] : tensor<1x1x10xf32> -> tensor<5x1x10xf32>
+    flow.return %2 : tensor<5x1x10xf32>
+  }
+  // CHECK: [[CMD1:%.+]] = hal.command_buffer.create
+  // CHECK: hal.command_buffer.end [[CMD1]]
+  // CHECK-NEXT: hal.ex.submit {{.+}}, [[CMD1]]
+  // CHECK-NEXT: hal.ex.wait_idle
+  // CHECK-NEXT: return
+  %1 = flow.ex.stream.fragment(%arg2 = %arg0 : tensor<1x1x10xf32>, %arg3 = %0 : tensor<5x1x10xf32>, %arg4 = %c1 : i32, %arg5 = %c1 : i32) -> tensor<5x1x10xf32> {
+    %2 = flow.tensor.update %arg2, %arg3[%arg4, %arg5, %arg5] : tensor<1x1x10xf32> -> tensor<5x1x10xf32>
+    flow.return %2 : tensor<5x1x10xf32>
+  }
+  return %1 : tensor<5x1x10xf32>
+}
@@ -0,0 +1,246 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMAOTTarget.h"
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRUtil.h"
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMTarget.h"
+#include "iree/compiler/Dialect/HAL/Target/LegacyUtil.h"
+#include "iree/schemas/dylib_executable_def_generated.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Support/LogicalResult.h"
+#include "mlir/Target/LLVMIR.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+static llvm::cl::opt<std::string> clTargetTriple(
+    "iree-hal-llvm-aot-target-triple",
+    llvm::cl::desc("Target triple to compile dylib executables for "
+                   "(defaults to the host)"),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> clTargetCPU(
+    "iree-hal-llvm-aot-target-cpu",
+    llvm::cl::desc("Target CPU to compile dylib executables for ('host' to "
+                   "match the compiling machine)"),
+    llvm::cl::init("generic"));
+
+static llvm::cl::opt<std::string> clTargetCPUFeatures(
+    "iree-hal-llvm-aot-target-cpu-features",
+    llvm::cl::desc("Comma separated list of CPU features to enable when "
+                   "compiling dylib executables"),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> clLinkerPath(
+    "iree-hal-llvm-aot-linker-path",
+    llvm::cl::desc("Linker used to produce shared libraries from compiled "
+                   "dylib executable objects"),
+    llvm::cl::init("ld"));
+
+LLVMAOTTargetOptions getLLVMAOTTargetOptionsFromFlags() {
+  LLVMAOTTargetOptions targetOptions;
+  targetOptions.targetTriple = clTargetTriple.empty()
+                                   ? llvm::sys::getProcessTriple()
+                                   : std::string(clTargetTriple);
+  targetOptions.targetCPU = clTargetCPU == "host"
+                                ? std::string(llvm::sys::getHostCPUName())
+                                : std::string(clTargetCPU);
+  targetOptions.targetCPUFeatures = clTargetCPUFeatures;
+  targetOptions.linkerPath = clLinkerPath;
+  return targetOptions;
+}
+
+// Creates a target machine for the given options, returning nullptr and
+// setting |errorMessage| on failure.
+static std::unique_ptr<llvm::TargetMachine> createTargetMachine(
+    const LLVMAOTTargetOptions& targetOptions, std::string& errorMessage) {
+  static bool initialized = [] {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    return true;
+  }();
+  (void)initialized;
+
+  auto target = llvm::TargetRegistry::lookupTarget(targetOptions.targetTriple,
+                                                   errorMessage);
+  if (!target) return nullptr;
+  // Shared libraries require position independent code.
+  return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+      targetOptions.targetTriple, targetOptions.targetCPU,
+      targetOptions.targetCPUFeatures, llvm::TargetOptions(),
+      llvm::Reloc::PIC_));
+}
+
+// Links |objectPath| into a shared library at |libraryPath|.
+static LogicalResult linkSharedLibrary(Location loc,
+                                       const LLVMAOTTargetOptions& options,
+                                       StringRef objectPath,
+                                       StringRef libraryPath) {
+  auto linkerPath = llvm::sys::findProgramByName(options.linkerPath);
+  if (!linkerPath) {
+    return emitError(loc) << "unable to find linker '" << options.linkerPath
+                          << "': " << linkerPath.getError().message();
+  }
+  SmallVector<StringRef, 8> args = {
+      *linkerPath, "-shared", "-o", libraryPath, objectPath,
+  };
+  std::string errorMessage;
+  int result = llvm::sys::ExecuteAndWait(*linkerPath, args, llvm::None, {},
+                                         /*SecondsToWait=*/0,
+                                         /*MemoryLimit=*/0, &errorMessage);
+  if (result != 0) {
+    return emitError(loc) << "linking shared library failed with exit code "
+                          << result << ": " << errorMessage;
+  }
+  return success();
+}
+
+LogicalResult translateToLLVMAOTExecutable(
+    IREE::HAL::ExecutableOp executableOp,
+    ExecutableTargetOptions executableOptions,
+    LLVMAOTTargetOptions targetOptions) {
+  // Clone the module containing the things we want to translate. We do this so
+  // that multiple targets can pull from the same source without conflicting.
+  auto sourceOp = executableOp.getSourceOp().clone();
+  auto sourceOpErase =
+      llvm::make_scope_exit([&sourceOp]() { sourceOp.erase(); });
+  auto flowExecutableOp =
+      *sourceOp.getInnerModule().getOps<IREE::Flow::ExecutableOp>().begin();
+  auto moduleOp = flowExecutableOp.getInnerModule();
+  if (failed(makeLegacyExecutableABI(sourceOp))) {
+    return failure();
+  }
+
+  // Lower module to LLVM Dialect.
+  PassManager conversionPassManager(moduleOp.getContext());
+  buildLLVMTransformPassPipeline(conversionPassManager);
+  if (failed(conversionPassManager.run(moduleOp)))
+    return moduleOp.emitError()
+           << "failed to run IREE -> LLVM conversion passes";
+
+  // At this moment we are leaving MLIR LLVM dialect land translating module
+  // into target independent LLVMIR.
+  auto llvmModule = mlir::translateModuleToLLVMIR(moduleOp);
+  if (!llvmModule) {
+    return moduleOp.emitError() << "failed to translate module to LLVMIR";
+  }
+
+  // Create an invocation function for each entry point.
+  auto entryPointNames = populateEntryPointNames(flowExecutableOp);
+  for (const auto& entryPointName : entryPointNames) {
+    createLLVMInvocationFunc(entryPointName, llvmModule.get());
+  }
+
+  // Compile the module to a native object for the target machine.
+  std::string errorMessage;
+  auto targetMachine = createTargetMachine(targetOptions, errorMessage);
+  if (!targetMachine) {
+    return moduleOp.emitError() << "unable to create target machine for '"
+                                << targetOptions.targetTriple
+                                << "': " << errorMessage;
+  }
+  llvmModule->setDataLayout(targetMachine->createDataLayout());
+  llvmModule->setTargetTriple(targetMachine->getTargetTriple().str());
+
+  llvm::SmallString<128> objectPath;
+  llvm::SmallString<128> libraryPath;
+  if (llvm::sys::fs::createTemporaryFile("iree-dylib", "o", objectPath) ||
+      llvm::sys::fs::createTemporaryFile("iree-dylib", "so", libraryPath)) {
+    return moduleOp.emitError() << "unable to create temporary files";
+  }
+  llvm::FileRemover objectRemover(objectPath);
+  llvm::FileRemover libraryRemover(libraryPath);
+  {
+    std::error_code errorCode;
+    llvm::raw_fd_ostream objectStream(objectPath, errorCode);
+    if (errorCode) {
+      return moduleOp.emitError()
+             << "unable to open object file: " << errorCode.message();
+    }
+    llvm::legacy::PassManager codegenPassManager;
+    if (targetMachine->addPassesToEmitFile(codegenPassManager, objectStream,
+                                           /*DwoOut=*/nullptr,
+                                           llvm::CGFT_ObjectFile)) {
+      return moduleOp.emitError() << "target machine can't emit object files";
+    }
+    codegenPassManager.run(*llvmModule);
+  }
+
+  // Link the object into a shared library and read it back for embedding.
+  if (failed(linkSharedLibrary(moduleOp.getLoc(), targetOptions, objectPath,
+                               libraryPath))) {
+    return failure();
+  }
+  auto libraryBuffer = llvm::MemoryBuffer::getFile(libraryPath);
+  if (!libraryBuffer) {
+    return moduleOp.emitError() << "unable to read linked shared library: "
+                                << libraryBuffer.getError().message();
+  }
+
+  // Creates executable bytes.
+  iree::DyLibExecutableDefT dyLibExecutableDef;
+  dyLibExecutableDef.entry_points = std::move(entryPointNames);
+  dyLibExecutableDef.library_embedded = {
+      (*libraryBuffer)->getBufferStart(), (*libraryBuffer)->getBufferEnd()};
+  ::flatbuffers::FlatBufferBuilder fbb;
+  auto executableOffset =
+      iree::DyLibExecutableDef::Pack(fbb, &dyLibExecutableDef);
+  iree::FinishDyLibExecutableDefBuffer(fbb, executableOffset);
+  std::vector<uint8_t> bytes;
+  bytes.resize(fbb.GetSize());
+  std::memcpy(bytes.data(), fbb.GetBufferPointer(), bytes.size());
+
+  // Add the binary data to the target executable.
+  OpBuilder targetBuilder(&executableOp.getBlock());
+  targetBuilder.setInsertionPoint(&executableOp.getBlock().back());
+  auto binaryOp = targetBuilder.create<IREE::HAL::ExecutableBinaryOp>(
+      executableOp.getLoc(),
+      static_cast<uint32_t>(IREE::HAL::ExecutableFormat::DyLib),
+      std::move(bytes));
+  OpBuilder binaryBuilder(&binaryOp.getBlock().back());
+  binaryBuilder.clone(*moduleOp.getOperation());
+  return success();
+}
+
+static ExecutableTargetRegistration targetRegistration(
+    "dylib-llvm-aot", +[](IREE::HAL::ExecutableOp executableOp,
+                          ExecutableTargetOptions executableOptions) {
+      return translateToLLVMAOTExecutable(executableOp, executableOptions,
+                                          getLLVMAOTTargetOptionsFromFlags());
+    });
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
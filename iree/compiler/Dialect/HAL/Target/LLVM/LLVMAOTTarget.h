@@ -0,0 +1,56 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_AOT_TARGET_H_
+#define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_AOT_TARGET_H_
+
+#include <string>
+
+#include "iree/compiler/Dialect/HAL/Target/ExecutableTarget.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Options controlling ahead-of-time compilation of LLVM executables into
+// shared libraries.
+struct LLVMAOTTargetOptions {
+  // Target triple to generate code for.
+  std::string targetTriple;
+  // Target CPU name (such as 'skylake') or 'host' to match the compiling host.
+  std::string targetCPU;
+  // Comma separated list of CPU features (such as '+avx2,+fma').
+  std::string targetCPUFeatures;
+  // Path to the linker used to produce shared libraries from objects.
+  std::string linkerPath;
+};
+
+// Returns LLVMAOTTargetOptions struct initialized with the
+// iree-hal-llvm-aot-* flags.
+LLVMAOTTargetOptions getLLVMAOTTargetOptionsFromFlags();
+
+// Translates an executable to a shared library loadable by the dylib HAL
+// driver with the given options.
+LogicalResult translateToLLVMAOTExecutable(
+    IREE::HAL::ExecutableOp executableOp,
+    ExecutableTargetOptions executableOptions,
+    LLVMAOTTargetOptions targetOptions);
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_AOT_TARGET_H_
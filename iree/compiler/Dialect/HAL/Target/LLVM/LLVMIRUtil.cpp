@@ -0,0 +1,75 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRUtil.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/IRBuilder.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+std::vector<std::string> populateEntryPointNames(
+    IREE::Flow::ExecutableOp executableOp) {
+  std::vector<std::string> entryPointNames;
+  for (auto& op : executableOp.getBlock().getOperations()) {
+    if (auto entryOp = dyn_cast<IREE::Flow::DispatchEntryOp>(op)) {
+      entryPointNames.push_back(std::string(entryOp.function_ref()));
+    } else if (auto entryOp = dyn_cast<IREE::Flow::ReductionEntryOp>(op)) {
+      entryPointNames.push_back(std::string(entryOp.function_ref()));
+    }
+  }
+  return entryPointNames;
+}
+
+void createLLVMInvocationFunc(const std::string& name, llvm::Module* module) {
+  auto& ctx = module->getContext();
+  llvm::IRBuilder<> builder(ctx);
+  auto varFunc = module->getFunction(name);
+
+  auto newType = llvm::FunctionType::get(
+      builder.getVoidTy(), builder.getInt8PtrTy()->getPointerTo(),
+      /*isVarArg=*/false);
+  auto newName = "invoke_" + name;
+  auto funcCst = module->getOrInsertFunction(newName, newType);
+  llvm::Function* interfaceFunc =
+      llvm::cast<llvm::Function>(funcCst.getCallee());
+
+  auto bb = llvm::BasicBlock::Create(ctx);
+  bb->insertInto(interfaceFunc);
+  builder.SetInsertPoint(bb);
+  llvm::Value* argList = interfaceFunc->arg_begin();
+  llvm::SmallVector<llvm::Value*, 8> args;
+  args.reserve(llvm::size(varFunc->args()));
+  for (auto& indexedArg : llvm::enumerate(varFunc->args())) {
+    llvm::Value* argIndex = llvm::Constant::getIntegerValue(
+        builder.getInt64Ty(), llvm::APInt(64, indexedArg.index()));
+    llvm::Value* argPtrPtr = builder.CreateGEP(argList, argIndex);
+    llvm::Value* argPtr = builder.CreateLoad(argPtrPtr);
+    argPtr = builder.CreateBitCast(
+        argPtr, indexedArg.value().getType()->getPointerTo());
+    llvm::Value* arg = builder.CreateLoad(argPtr);
+    args.push_back(arg);
+  }
+  builder.CreateCall(varFunc, args);
+  builder.CreateRetVoid();
+}
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
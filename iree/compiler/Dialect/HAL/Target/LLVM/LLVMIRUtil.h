@@ -0,0 +1,43 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMIRUTIL_H_
+#define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMIRUTIL_H_
+
+#include <string>
+#include <vector>
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "llvm/IR/Module.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Returns a list of entry point names matching the expected export ordinals.
+std::vector<std::string> populateEntryPointNames(
+    IREE::Flow::ExecutableOp executableOp);
+
+// Creates an `invoke_<name>` function that unpacks a `void**` argument list
+// and calls the entry point `name` with the loaded arguments. This is the
+// calling convention expected by the llvmjit and dylib HAL drivers.
+void createLLVMInvocationFunc(const std::string& name, llvm::Module* module);
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMIRUTIL_H_
@@ -15,6 +15,7 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMTarget.h"
 
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRUtil.h"
 #include "iree/compiler/Dialect/HAL/Target/LegacyUtil.h"
 #include "iree/compiler/Translation/XLAToLinalg/Passes.h"
 #include "iree/compiler/Translation/XLAToLinalg/ReductionLowering.h"
@@ -42,21 +43,6 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
   return targetOptions;
 }
 
-// TODO(ataei) Move this to utils ?
-// Returns a list of entry point names matching the expected export ordinals.
-static std::vector<std::string> populateEntryPointNames(
-    IREE::Flow::ExecutableOp executableOp) {
-  std::vector<std::string> entryPointNames;
-  for (auto& op : executableOp.getBlock().getOperations()) {
-    if (auto entryOp = dyn_cast<IREE::Flow::DispatchEntryOp>(op)) {
-      entryPointNames.push_back(std::string(entryOp.function_ref()));
-    } else if (auto entryOp = dyn_cast<IREE::Flow::ReductionEntryOp>(op)) {
-      entryPointNames.push_back(std::string(entryOp.function_ref()));
-    }
-  }
-  return entryPointNames;
-}
-
 // Adds a sequence of passess to a given pass manager that progressively lower
 // from HLO to LLVM throught linalg dialect.
 void buildLLVMTransformPassPipeline(OpPassManager& pm) {
@@ -118,6 +104,15 @@ LogicalResult translateToLLVMExecutable(
   // At this moment we are leaving MLIR LLVM dialect land translating module
   // into target independent LLVMIR.
   auto llvmModule = mlir::translateModuleToLLVMIR(moduleOp);
+  if (!llvmModule) {
+    return moduleOp.emitError() << "failed to translate module to LLVMIR";
+  }
+
+  // Create an invocation function for each entry point.
+  auto entryPointNames = populateEntryPointNames(flowExecutableOp);
+  for (const auto& entryPointName : entryPointNames) {
+    createLLVMInvocationFunc(entryPointName, llvmModule.get());
+  }
 
   // Serialize LLVM module.
   std::string bufferString;
@@ -129,7 +124,7 @@ LogicalResult translateToLLVMExecutable(
   iree::LLVMIRExecutableDefT llvmIrExecutableDef;
   llvmIrExecutableDef.llvmir_module = {bufferString.begin(),
                                        bufferString.end()};
-  llvmIrExecutableDef.entry_points = populateEntryPointNames(flowExecutableOp);
+  llvmIrExecutableDef.entry_points = std::move(entryPointNames);
   ::flatbuffers::FlatBufferBuilder fbb;
   auto executableOffset =
       iree::LLVMIRExecutableDef::Pack(fbb, &llvmIrExecutableDef);
@@ -17,6 +17,7 @@
 #define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_TARGET_H_
 
 #include "iree/compiler/Dialect/HAL/Target/ExecutableTarget.h"
+#include "mlir/Pass/PassManager.h"
 
 namespace mlir {
 namespace iree_compiler {
@@ -31,6 +32,10 @@ struct LLVMTargetOptions {
 // iree-hal-llvm-ir-* flags.
 LLVMTargetOptions getLLVMTargetOptionsFromFlags();
 
+// Adds a sequence of passes to a given pass manager that progressively lower
+// from HLO to the LLVM dialect through the linalg dialect.
+void buildLLVMTransformPassPipeline(OpPassManager& pm);
+
 // Translates an executable to the LLVM backends with the given options.
 LogicalResult translateToLLVMExecutable(
     IREE::HAL::ExecutableOp executableOp,
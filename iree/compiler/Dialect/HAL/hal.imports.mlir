@@ -41,6 +41,17 @@ vm.import @ex.defer_release(
   %operand : !vm.ref<?>
 )
 
+// Submits the command buffer without waiting for it to complete.
+vm.import @ex.submit(
+  %device : !vm.ref<!hal.device>,
+  %command_buffer : !vm.ref<!hal.command_buffer>
+)
+
+// Waits for all prior submissions to complete.
+vm.import @ex.wait_idle(
+  %device : !vm.ref<!hal.device>
+)
+
 vm.import @ex.submit_and_wait(
   %device : !vm.ref<!hal.device>,
   %command_buffer : !vm.ref<!hal.command_buffer>
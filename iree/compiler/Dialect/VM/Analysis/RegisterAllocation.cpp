@@ -118,16 +118,24 @@ struct RegisterUsage {
 
   Optional<uint8_t> allocateRegister(Type type) {
     if (type.isSignlessIntOrIndexOrFloat()) {
+      // Find the first run of unused registers large enough for the value.
+      int slotCount = getRegisterSlotCount(type);
       int ordinal = intRegisters.find_first_unset();
-      if (ordinal >= kIntRegisterCount) {
+      while (ordinal != -1 && ordinal + slotCount <= kIntRegisterCount) {
+        int nextUsed = intRegisters.find_next(ordinal);
+        if (nextUsed == -1 || nextUsed >= ordinal + slotCount) break;
+        ordinal = intRegisters.find_next_unset(nextUsed);
+      }
+      if (ordinal == -1 || ordinal + slotCount > kIntRegisterCount) {
         return {};
       }
-      intRegisters.set(ordinal);
-      maxI32RegisterOrdinal = std::max(ordinal, maxI32RegisterOrdinal);
+      intRegisters.set(ordinal, ordinal + slotCount);
+      maxI32RegisterOrdinal =
+          std::max(ordinal + slotCount - 1, maxI32RegisterOrdinal);
       return makeRegisterByte(type, ordinal, /*isMove=*/false);
     } else {
       int ordinal = refRegisters.find_first_unset();
-      if (ordinal >= kRefRegisterCount) {
+      if (ordinal >= kRefRegisterCount || ordinal == -1) {
         return {};
       }
       refRegisters.set(ordinal);
@@ -136,22 +144,25 @@ struct RegisterUsage {
     }
   }
 
-  void markRegisterUsed(uint8_t reg) {
+  void markRegisterUsed(uint8_t reg, Type type) {
     int ordinal = getRegisterOrdinal(reg);
     if (isRefRegister(reg)) {
       refRegisters.set(ordinal);
       maxRefRegisterOrdinal = std::max(ordinal, maxRefRegisterOrdinal);
     } else {
-      intRegisters.set(ordinal);
-      maxI32RegisterOrdinal = std::max(ordinal, maxI32RegisterOrdinal);
+      int slotCount = getRegisterSlotCount(type);
+      intRegisters.set(ordinal, ordinal + slotCount);
+      maxI32RegisterOrdinal =
+          std::max(ordinal + slotCount - 1, maxI32RegisterOrdinal);
     }
   }
 
-  void releaseRegister(uint8_t reg) {
+  void releaseRegister(uint8_t reg, Type type) {
     if (isRefRegister(reg)) {
       refRegisters.reset(reg & 0x3F);
     } else {
-      intRegisters.reset(reg & 0x7F);
+      int ordinal = reg & 0x7F;
+      intRegisters.reset(ordinal, ordinal + getRegisterSlotCount(type));
     }
   }
 };
@@ -212,7 +223,8 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
     // only working with the minimal set.
     RegisterUsage registerUsage;
     for (auto liveInValue : liveness_.getBlockLiveIns(block)) {
-      registerUsage.markRegisterUsed(mapToRegister(liveInValue));
+      registerUsage.markRegisterUsed(mapToRegister(liveInValue),
+                                     liveInValue.getType());
     }
 
     // Allocate arguments first from left-to-right.
@@ -231,14 +243,15 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
     // removes unused block arguments would prevent this from happening.
     for (auto blockArg : block->getArguments()) {
       if (blockArg.use_empty()) {
-        registerUsage.releaseRegister(map_[blockArg]);
+        registerUsage.releaseRegister(map_[blockArg], blockArg.getType());
       }
     }
 
     for (auto &op : block->getOperations()) {
       for (auto &operand : op.getOpOperands()) {
         if (liveness_.isLastValueUse(operand.get(), &op)) {
-          registerUsage.releaseRegister(map_[operand.get()]);
+          registerUsage.releaseRegister(map_[operand.get()],
+                                      operand.get().getType());
         }
       }
       for (auto result : op.getResults()) {
@@ -249,7 +262,7 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
         }
         map_[result] = reg.getValue();
         if (result.use_empty()) {
-          registerUsage.releaseRegister(reg.getValue());
+          registerUsage.releaseRegister(reg.getValue(), result.getType());
         }
       }
     }
@@ -261,17 +274,9 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
         std::max(maxRefRegisterOrdinal_, registerUsage.maxRefRegisterOrdinal);
   }
 
-  // Always allocate one register of each type more for scratch space.
-  // These scratch registers are used during remapping registers during branches
-  // that may have hazards (such as a remap set of 0->1 and 1->0). If we
-  // precomputed whether remappings were required here then we could avoid this
-  // but it doesn't seem worth it for a single register (yet).
-  if (maxI32RegisterOrdinal_ > 0) {
-    ++maxI32RegisterOrdinal_;
-  }
-  if (maxRefRegisterOrdinal_ > 0) {
-    ++maxRefRegisterOrdinal_;
-  }
+  // Allocate scratch registers used during remapping registers during branches
+  // that may have hazards (such as a remap set of 0->1 and 1->0).
+  reserveScratchRegisters(funcOp);
 
   // We currently don't check during the allocation above. If we implement
   // spilling we could use this max information to reserve space for spilling.
@@ -328,7 +333,9 @@ struct FeedbackArcSet {
       int indegree = 0;
       int outdegree = 0;
     };
+    // Reserved up-front as |nodes| points into the storage.
     SmallVector<FASNode, 8> nodeStorage;
+    nodeStorage.reserve(inputEdges.size() * 2);
     llvm::SmallDenseMap<NodeID, FASNode *> nodes;
     for (auto &edge : inputEdges) {
       NodeID sourceID = getBaseRegister(edge.first);
@@ -487,10 +494,7 @@ struct FeedbackArcSet {
 };
 
 SmallVector<std::pair<uint8_t, uint8_t>, 8>
-RegisterAllocation::remapSuccessorRegisters(Operation *op, int successorIndex) {
-  // Compute the initial directed graph of register movements.
-  // This may contain cycles ([reg 0->1], [reg 1->0], ...) that would not be
-  // possible to evaluate as a direct remapping.
+RegisterAllocation::computeSuccessorMoves(Operation *op, int successorIndex) {
   SmallVector<std::pair<uint8_t, uint8_t>, 8> srcDstRegs;
   auto *targetBlock = op->getSuccessor(successorIndex);
   auto operands = op->getSuccessorOperands(successorIndex);
@@ -498,11 +502,61 @@ RegisterAllocation::remapSuccessorRegisters(Operation *op, int successorIndex) {
     uint8_t srcReg = mapToRegister(it.value());
     BlockArgument targetArg = targetBlock->getArgument(it.index());
     uint8_t dstReg = mapToRegister(targetArg);
-    if (!compareRegistersEqual(srcReg, dstReg)) {
-      srcDstRegs.push_back({srcReg, dstReg});
+    if (compareRegistersEqual(srcReg, dstReg)) continue;
+    // 64-bit values are moved as their two 32-bit halves.
+    for (int i = 0; i < getRegisterSlotCount(targetArg.getType()); ++i) {
+      srcDstRegs.push_back({static_cast<uint8_t>(srcReg + i),
+                            static_cast<uint8_t>(dstReg + i)});
+    }
+  }
+  return srcDstRegs;
+}
+
+void RegisterAllocation::reserveScratchRegisters(IREE::VM::FuncOp funcOp) {
+  // Each edge in the feedback arc set of a remapping needs its own scratch
+  // register as they are all held across the remaining moves. Remappings may
+  // contain multiple independent cycles, such as when swapping two 64-bit
+  // values that move as two pairs of 32-bit halves.
+  // We always reserve at least one register of each type.
+  int i32ScratchCount = 1;
+  int refScratchCount = 1;
+  for (auto &block : funcOp.getBlocks()) {
+    Operation *terminatorOp = block.getTerminator();
+    for (int i = 0; i < terminatorOp->getNumSuccessors(); ++i) {
+      auto feedbackArcSet =
+          FeedbackArcSet::compute(computeSuccessorMoves(terminatorOp, i));
+      int i32FeedbackCount = 0;
+      int refFeedbackCount = 0;
+      for (auto &feedbackEdge : feedbackArcSet.feedbackEdges) {
+        if (isRefRegister(feedbackEdge.first)) {
+          ++refFeedbackCount;
+        } else {
+          ++i32FeedbackCount;
+        }
+      }
+      i32ScratchCount = std::max(i32ScratchCount, i32FeedbackCount);
+      refScratchCount = std::max(refScratchCount, refFeedbackCount);
     }
   }
 
+  // Banks with a single register never need to remap.
+  if (maxI32RegisterOrdinal_ > 0) {
+    scratchI32RegisterOrdinal_ = maxI32RegisterOrdinal_ + 1;
+    maxI32RegisterOrdinal_ += i32ScratchCount;
+  }
+  if (maxRefRegisterOrdinal_ > 0) {
+    scratchRefRegisterOrdinal_ = maxRefRegisterOrdinal_ + 1;
+    maxRefRegisterOrdinal_ += refScratchCount;
+  }
+}
+
+SmallVector<std::pair<uint8_t, uint8_t>, 8>
+RegisterAllocation::remapSuccessorRegisters(Operation *op, int successorIndex) {
+  // Compute the initial directed graph of register movements.
+  // This may contain cycles ([reg 0->1], [reg 1->0], ...) that would not be
+  // possible to evaluate as a direct remapping.
+  auto srcDstRegs = computeSuccessorMoves(op, successorIndex);
+
   // Compute the feedback arc set to determine which edges are the ones inducing
   // cycles, if any. This also provides us a DAG that we can trivially remap
   // without worrying about cycles.
@@ -517,16 +571,21 @@ RegisterAllocation::remapSuccessorRegisters(Operation *op, int successorIndex) {
     return feedbackArcSet.acyclicEdges;
   }
 
-  assert(feedbackArcSet.feedbackEdges.size() == 1 &&
-         "liveness tracking of scratch registers not yet implemented");
-
-  // The last register in each bank is reserved for swapping, when required.
-  uint8_t scratchI32Reg = maxI32RegisterOrdinal_;
-  uint8_t scratchRefReg = kRefRegisterTypeBit | maxRefRegisterOrdinal_;
-
+  // The source of each feedback edge is saved to its own scratch register
+  // before the DAG is remapped and then restored to its target afterward.
+  int nextScratchI32Ordinal = scratchI32RegisterOrdinal_;
+  int nextScratchRefOrdinal = scratchRefRegisterOrdinal_;
   for (auto feedbackEdge : feedbackArcSet.feedbackEdges) {
-    uint8_t scratchReg =
-        isRefRegister(feedbackEdge.first) ? scratchRefReg : scratchI32Reg;
+    uint8_t scratchReg;
+    if (isRefRegister(feedbackEdge.first)) {
+      assert(nextScratchRefOrdinal <= maxRefRegisterOrdinal_ &&
+             "insufficient ref scratch registers reserved");
+      scratchReg = kRefRegisterTypeBit | nextScratchRefOrdinal++;
+    } else {
+      assert(nextScratchI32Ordinal <= maxI32RegisterOrdinal_ &&
+             "insufficient i32 scratch registers reserved");
+      scratchReg = nextScratchI32Ordinal++;
+    }
     feedbackArcSet.acyclicEdges.insert(feedbackArcSet.acyclicEdges.begin(),
                                        {feedbackEdge.first, scratchReg});
     feedbackArcSet.acyclicEdges.push_back({scratchReg, feedbackEdge.second});
@@ -24,12 +24,17 @@ namespace mlir {
 namespace iree_compiler {
 
 // The VM contains multiple register banks:
-// - 128 32-bit integer registers
+// - 128 32-bit primitive registers
 //   - may be aliased as 32 128-bit registers
+//   - 64-bit values (i64) use two adjacent registers
+//   - 32-bit floating-point values (f32) are stored bitwise
 // - 64 ref_ptr registers
 //
 // Registers are represented in bytecode as an 8-bit integer with the high bit
-// indicating whether it is from the integer (0b0) or ref_ptr bank (0b1).
+// indicating whether it is from the primitive (0b0) or ref_ptr bank (0b1).
+// 64-bit values are referenced by their first (low word) register ordinal and
+// the high word is always stored in the register immediately following it.
+// Register lists (such as call arguments) include both registers.
 //
 // ref_ptr register bytes also include a bit denoting whether the register
 // reference has move semantics. When set the VM can assume that the value is
@@ -42,6 +47,11 @@ constexpr int kRefRegisterCount = 64;
 constexpr uint8_t kRefRegisterTypeBit = 0x80;
 constexpr uint8_t kRefRegisterMoveBit = 0x40;
 
+// Returns the number of consecutive registers used to store a value of |type|.
+inline int getRegisterSlotCount(Type type) {
+  return type.isIntOrFloat() && type.getIntOrFloatBitWidth() == 64 ? 2 : 1;
+}
+
 // Returns true if |reg| is a register in the ref_ptr bank.
 constexpr bool isRefRegister(uint8_t reg) {
   return (reg & kRefRegisterTypeBit) == kRefRegisterTypeBit;
@@ -112,9 +122,23 @@ class RegisterAllocation {
       Operation *op, int successorIndex);
 
  private:
+  // Computes the register moves required to pass branch successor operands to
+  // the target block arguments. The moves may contain cycles.
+  SmallVector<std::pair<uint8_t, uint8_t>, 8> computeSuccessorMoves(
+      Operation *op, int successorIndex);
+
+  // Reserves the scratch registers needed to break cycles in the successor
+  // remappings of all branches in |funcOp|.
+  void reserveScratchRegisters(IREE::VM::FuncOp funcOp);
+
   int maxI32RegisterOrdinal_ = -1;
   int maxRefRegisterOrdinal_ = -1;
 
+  // First ordinal of the scratch registers reserved in each bank, or -1 if
+  // none were reserved.
+  int scratchI32RegisterOrdinal_ = -1;
+  int scratchRefRegisterOrdinal_ = -1;
+
   // Cached liveness information.
   ValueLiveness liveness_;
 
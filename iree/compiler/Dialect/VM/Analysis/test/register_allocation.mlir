@@ -186,3 +186,54 @@ vm.module @module {
     vm.return %ie : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @i64_registers
+vm.module @i64_registers {
+  // CHECK-LABEL: @i64_result_pair
+  vm.func @i64_result_pair(%arg0 : i32) -> (i64, i32) {
+    // CHECK: vm.ext.i32.i64.s
+    // CHECK-SAME: block_registers = ["0"]
+    // CHECK-SAME: result_registers = ["1"]
+    %0 = vm.ext.i32.i64.s %arg0 : i32 -> i64
+    // CHECK: vm.const.i32.zero
+    // CHECK-SAME: result_registers = ["3"]
+    %zero = vm.const.i32.zero : i32
+    %1 = vm.add.i32 %arg0, %zero : i32
+    vm.return %0, %1 : i64, i32
+  }
+
+  // CHECK-LABEL: @i64_arg_pair
+  vm.func @i64_arg_pair(%arg0 : i64, %arg1 : i32) -> i32 {
+    // CHECK: vm.trunc.i64.i32
+    // CHECK-SAME: block_registers = ["0", "2"]
+    // CHECK-SAME: result_registers = ["0"]
+    %0 = vm.trunc.i64.i32 %arg0 : i64 -> i32
+    // CHECK: vm.add.i32
+    // CHECK-SAME: result_registers = ["0"]
+    %1 = vm.add.i32 %0, %arg1 : i32
+    vm.return %1 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @i64_branch_args
+vm.module @i64_branch_args {
+  // Each half of a swapped i64 pair forms its own cycle and must be broken
+  // using its own scratch register.
+  // CHECK-LABEL: @branch_args_i64_swap
+  vm.func @branch_args_i64_swap(%arg0 : i64, %arg1 : i64) -> i64 {
+    // CHECK: vm.br
+    // CHECK-SAME: block_registers = ["0", "2"]
+    // CHECK-SAME: remap_registers = [
+    // CHECK-SAME:   ["3->5", "2->4", "1->3", "0->2", "4->0", "5->1"]
+    // CHECK-SAME: ]
+    vm.br ^bb1(%arg1, %arg0 : i64, i64)
+  ^bb1(%0 : i64, %1 : i64):
+    // CHECK: vm.return
+    // CHECK-SAME: block_registers = ["0", "2"]
+    vm.return %0 : i64
+  }
+}
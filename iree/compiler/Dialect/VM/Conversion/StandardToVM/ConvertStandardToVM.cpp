@@ -154,14 +154,34 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
   PatternMatchResult matchAndRewrite(
       ConstantOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
+    if (auto floatAttr = srcOp.getValue().dyn_cast<FloatAttr>()) {
+      if (!floatAttr.getType().isF32()) {
+        srcOp.emitRemark() << "unsupported float type for dialect constant";
+        return matchFailure();
+      }
+      if (floatAttr.getValue().isPosZero()) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32Op>(srcOp, floatAttr);
+      }
+      return matchSuccess();
+    }
+
     auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
-    // Only 32bit integer supported for now.
     if (!integerAttr) {
       srcOp.emitRemark() << "unsupported const type for dialect";
       return matchFailure();
     }
     int numBits = integerAttr.getType().getIntOrFloatBitWidth();
-    if (numBits != 1 && numBits != 32) {
+    if (numBits == 64) {
+      auto intValue = integerAttr.getInt();
+      if (intValue == 0) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstI64ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstI64Op>(srcOp, intValue);
+      }
+      return matchSuccess();
+    } else if (numBits != 1 && numBits != 32) {
       srcOp.emitRemark() << "unsupported bit width for dialect constant";
       return matchFailure();
     }
@@ -183,64 +203,115 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
       CmpIOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
     CmpIOpOperandAdaptor srcAdapter(operands);
-    auto returnType = rewriter.getIntegerType(32);
     switch (srcOp.getPredicate()) {
       case CmpIPredicate::eq:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQI32Op>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpEQI32Op, IREE::VM::CmpEQI64Op>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::ne:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEI32Op>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpNEI32Op, IREE::VM::CmpNEI64Op>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::slt:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTI32SOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpLTI32SOp, IREE::VM::CmpLTI64SOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::sle:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEI32SOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpLTEI32SOp, IREE::VM::CmpLTEI64SOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::sgt:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTI32SOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpGTI32SOp, IREE::VM::CmpGTI64SOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::sge:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTEI32SOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpGTEI32SOp, IREE::VM::CmpGTEI64SOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::ult:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTI32UOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpLTI32UOp, IREE::VM::CmpLTI64UOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::ule:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEI32UOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpLTEI32UOp, IREE::VM::CmpLTEI64UOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::ugt:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTI32UOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
-        return matchSuccess();
+        return replaceWithCmpOp<IREE::VM::CmpGTI32UOp, IREE::VM::CmpGTI64UOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
       case CmpIPredicate::uge:
-        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTEI32UOp>(
-            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return replaceWithCmpOp<IREE::VM::CmpGTEI32UOp, IREE::VM::CmpGTEI64UOp>(
+            srcOp, srcAdapter.lhs(), srcAdapter.rhs(), rewriter);
+    }
+  }
+
+  // Replaces |srcOp| with the comparison op matching the operand bit width.
+  template <typename I32OpTy, typename I64OpTy>
+  PatternMatchResult replaceWithCmpOp(
+      CmpIOp srcOp, Value lhs, Value rhs,
+      ConversionPatternRewriter &rewriter) const {
+    auto resultType = rewriter.getIntegerType(32);
+    if (lhs.getType().isSignlessInteger(64)) {
+      rewriter.replaceOpWithNewOp<I64OpTy>(srcOp, resultType, lhs, rhs);
+    } else {
+      rewriter.replaceOpWithNewOp<I32OpTy>(srcOp, resultType, lhs, rhs);
+    }
+    return matchSuccess();
+  }
+};
+
+class CmpFOpConversion : public OpConversionPattern<CmpFOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  PatternMatchResult matchAndRewrite(
+      CmpFOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    CmpFOpOperandAdaptor srcAdapter(operands);
+    auto lhs = srcAdapter.lhs();
+    auto rhs = srcAdapter.rhs();
+    if (!lhs.getType().isF32()) return matchFailure();
+    auto resultType = rewriter.getIntegerType(32);
+    switch (srcOp.getPredicate()) {
+      case CmpFPredicate::OEQ:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQF32Op>(srcOp, resultType,
+                                                         lhs, rhs);
+        return matchSuccess();
+      case CmpFPredicate::UNE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEF32Op>(srcOp, resultType,
+                                                         lhs, rhs);
         return matchSuccess();
+      case CmpFPredicate::OLT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32Op>(srcOp, resultType,
+                                                         lhs, rhs);
+        return matchSuccess();
+      case CmpFPredicate::OLE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32Op>(srcOp, resultType,
+                                                          lhs, rhs);
+        return matchSuccess();
+      case CmpFPredicate::OGT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTF32Op>(srcOp, resultType,
+                                                         lhs, rhs);
+        return matchSuccess();
+      case CmpFPredicate::OGE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTEF32Op>(srcOp, resultType,
+                                                          lhs, rhs);
+        return matchSuccess();
+      default:
+        // TODO(benvanik): unordered/mixed predicates.
+        srcOp.emitRemark() << "unsupported float comparison predicate";
+        return matchFailure();
     }
   }
 };
 
-template <typename SrcOpTy, typename DstOpTy>
+template <typename SrcOpTy, typename DstOpTy, unsigned kBits = 32>
 class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+  using OpConversionPattern<SrcOpTy>::matchFailure;
   using OpConversionPattern<SrcOpTy>::matchSuccess;
 
   PatternMatchResult matchAndRewrite(
       SrcOpTy srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
     typename SrcOpTy::OperandAdaptor srcAdapter(operands);
-
-    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, srcOp.getType(),
-                                         srcAdapter.lhs(), srcAdapter.rhs());
+    auto type = srcAdapter.lhs().getType();
+    if (!type.isIntOrFloat() || type.getIntOrFloatBitWidth() != kBits) {
+      return matchFailure();
+    }
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, type, srcAdapter.lhs(),
+                                         srcAdapter.rhs());
     return matchSuccess();
   }
 };
@@ -273,21 +344,52 @@ class ShiftArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   }
 };
 
-class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
+template <typename SrcOpTy, typename DstOpTy, unsigned kSrcBits,
+          unsigned kDstBits>
+class CastOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+  using OpConversionPattern<SrcOpTy>::matchFailure;
+  using OpConversionPattern<SrcOpTy>::matchSuccess;
+
+  PatternMatchResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto srcType = operands[0].getType();
+    auto dstType = srcOp.getType();
+    if (!srcType.isIntOrFloat() ||
+        srcType.getIntOrFloatBitWidth() != kSrcBits ||
+        !dstType.isIntOrFloat() ||
+        dstType.getIntOrFloatBitWidth() != kDstBits) {
+      return matchFailure();
+    }
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, dstType, operands[0]);
+    return matchSuccess();
+  }
+};
+
+class SelectOpConversion : public OpConversionPattern<SelectOp> {
   using OpConversionPattern::OpConversionPattern;
-  static constexpr unsigned kBits = 32;
 
   PatternMatchResult matchAndRewrite(
       SelectOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
     SelectOpOperandAdaptor srcAdaptor(operands);
-    IntegerType requiredType = IntegerType::get(kBits, srcOp.getContext());
-    if (srcAdaptor.true_value().getType() != requiredType)
+    auto type = srcAdaptor.true_value().getType();
+    if (type.isSignlessInteger(32)) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectI32Op>(
+          srcOp, type, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+    } else if (type.isSignlessInteger(64)) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectI64Op>(
+          srcOp, type, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+    } else if (type.isF32()) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectF32Op>(
+          srcOp, type, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+    } else {
       return matchFailure();
-
-    rewriter.replaceOpWithNewOp<IREE::VM::SelectI32Op>(
-        srcOp, requiredType, srcAdaptor.condition(), srcAdaptor.true_value(),
-        srcAdaptor.false_value());
+    }
     return matchSuccess();
   }
 };
@@ -351,11 +453,11 @@ class CallOpConversion : public OpConversionPattern<CallOp> {
 
 void populateStandardToVMPatterns(MLIRContext *context,
                                   OwningRewritePatternList &patterns) {
-  patterns.insert<BranchOpConversion, CallOpConversion, CmpIOpConversion,
-                  CondBranchOpConversion, ConstantOpConversion,
-                  ModuleOpConversion, ModuleTerminatorOpConversion,
-                  FuncOpConversion, ReturnOpConversion, SelectI32OpConversion>(
-      context);
+  patterns.insert<BranchOpConversion, CallOpConversion, CmpFOpConversion,
+                  CmpIOpConversion, CondBranchOpConversion,
+                  ConstantOpConversion, ModuleOpConversion,
+                  ModuleTerminatorOpConversion, FuncOpConversion,
+                  ReturnOpConversion, SelectOpConversion>(context);
 
   // Binary arithmetic ops
   patterns
@@ -369,11 +471,35 @@ void populateStandardToVMPatterns(MLIRContext *context,
               BinaryArithmeticOpConversion<AndOp, IREE::VM::AndI32Op>,
               BinaryArithmeticOpConversion<OrOp, IREE::VM::OrI32Op>,
               BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op>>(context);
+  patterns.insert<
+      BinaryArithmeticOpConversion<AddIOp, IREE::VM::AddI64Op, 64>,
+      BinaryArithmeticOpConversion<SignedDivIOp, IREE::VM::DivI64SOp, 64>,
+      BinaryArithmeticOpConversion<UnsignedDivIOp, IREE::VM::DivI64UOp, 64>,
+      BinaryArithmeticOpConversion<MulIOp, IREE::VM::MulI64Op, 64>,
+      BinaryArithmeticOpConversion<SignedRemIOp, IREE::VM::RemI64SOp, 64>,
+      BinaryArithmeticOpConversion<UnsignedRemIOp, IREE::VM::RemI64UOp, 64>,
+      BinaryArithmeticOpConversion<SubIOp, IREE::VM::SubI64Op, 64>,
+      BinaryArithmeticOpConversion<AndOp, IREE::VM::AndI64Op, 64>,
+      BinaryArithmeticOpConversion<OrOp, IREE::VM::OrI64Op, 64>,
+      BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI64Op, 64>>(context);
+  patterns.insert<BinaryArithmeticOpConversion<AddFOp, IREE::VM::AddF32Op>,
+                  BinaryArithmeticOpConversion<SubFOp, IREE::VM::SubF32Op>,
+                  BinaryArithmeticOpConversion<MulFOp, IREE::VM::MulF32Op>,
+                  BinaryArithmeticOpConversion<DivFOp, IREE::VM::DivF32Op>>(
+      context);
 
   // Shift ops
   // TODO(laurenzo): The standard dialect is missing shr ops. Add once in place.
-  patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>>(
-      context);
+  patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>,
+                  ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI64Op,
+                                              64>>(context);
+
+  // Cast ops
+  patterns.insert<
+      CastOpConversion<SignExtendIOp, IREE::VM::ExtI32I64SOp, 32, 64>,
+      CastOpConversion<ZeroExtendIOp, IREE::VM::ExtI32I64UOp, 32, 64>,
+      CastOpConversion<TruncateIOp, IREE::VM::TruncI64I32Op, 64, 32>,
+      CastOpConversion<SIToFPOp, IREE::VM::CastSI32F32Op, 32, 32>>(context);
 }
 
 }  // namespace iree_compiler
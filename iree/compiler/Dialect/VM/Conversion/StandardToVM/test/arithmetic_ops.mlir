@@ -186,3 +186,57 @@ module {
 }
 
 }
+
+// -----
+// CHECK-LABEL: @t011_addi_i64
+module @t011_addi_i64 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+  // CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+  func @my_fn(%arg0: i64, %arg1: i64) -> (i64) {
+    // CHECK: vm.add.i64 [[ARG0]], [[ARG1]]
+    %0 = addi %arg0, %arg1 : i64
+    return %0 : i64
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t012_addf
+module @t012_addf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+  // CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: vm.add.f32 [[ARG0]], [[ARG1]]
+    %0 = addf %arg0, %arg1 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t013_casts
+module @t013_casts {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+  func @my_fn(%arg0: i32) -> (i32, f32) {
+    // CHECK: [[EXT:%[a-zA-Z0-9]+]] = vm.ext.i32.i64.s [[ARG0]] : i32 -> i64
+    %0 = sexti %arg0 : i32 to i64
+    // CHECK: vm.trunc.i64.i32 [[EXT]] : i64 -> i32
+    %1 = trunci %0 : i64 to i32
+    // CHECK: vm.cast.si32.f32 [[ARG0]] : i32 -> f32
+    %2 = sitofp %arg0 : i32 to f32
+    return %1, %2 : i32, f32
+  }
+}
+
+}
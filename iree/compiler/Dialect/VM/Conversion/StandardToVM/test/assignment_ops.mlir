@@ -20,3 +20,22 @@ module @my_module {
 }
 
 }
+
+// -----
+// CHECK-LABEL: @t002_cmp_select_f32
+module @t002_cmp_select_f32 {
+
+module @my_module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+  // CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+  func @my_fn(%arg0 : f32, %arg1 : f32) -> (f32) {
+    // CHECK: [[CMP:%[a-zA-Z0-9]+]] = vm.cmp.lt.f32
+    %1 = cmpf "olt", %arg0, %arg1 : f32
+    // CHECK: vm.select.f32 [[CMP]], [[ARG0]], [[ARG1]] : f32
+    %2 = select %1, %arg0, %arg1 : f32
+    return %2 : f32
+  }
+}
+
+}
@@ -27,3 +27,33 @@ module {
 }
 
 }
+
+// -----
+// CHECK-LABEL: @t002_const.i64.nonzero
+module @t002_const.i64.nonzero {
+
+module {
+  func @non_zero() -> (i64) {
+    // CHECK: vm.const.i64 4294967296
+    %1 = constant 4294967296 : i64
+    return %1 : i64
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_const.f32
+module @t003_const.f32 {
+
+module {
+  func @non_zero() -> (f32, f32) {
+    // CHECK: vm.const.f32 1.5{{.*}} : f32
+    %1 = constant 1.5 : f32
+    // CHECK: vm.const.f32.zero : f32
+    %2 = constant 0.0 : f32
+    return %1, %2 : f32, f32
+  }
+}
+
+}
@@ -34,7 +34,8 @@ VMTypeConverter::VMTypeConverter() {
   });
   // Convert integer types.
   addConversion([](IntegerType integerType) -> Optional<Type> {
-    if (integerType.isSignlessInteger(32)) {
+    if (integerType.isSignlessInteger(32) ||
+        integerType.isSignlessInteger(64)) {
       return integerType;
     } else if (integerType.isInteger(1)) {
       // Promote i1 -> i32.
@@ -46,6 +47,13 @@ VMTypeConverter::VMTypeConverter() {
     }
     return llvm::None;
   });
+  // Convert floating-point types.
+  addConversion([](FloatType floatType) -> Optional<Type> {
+    if (floatType.isF32()) {
+      return floatType;
+    }
+    return llvm::None;
+  });
   // All ref_ptr types are passed through unmodified.
   addConversion([this](IREE::PtrType type) -> Type {
     // Recursively handle pointer target types (we want to convert ptr<index> to
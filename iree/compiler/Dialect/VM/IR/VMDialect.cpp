@@ -54,10 +54,12 @@ struct VMOpAsmInterface : public OpAsmDialectInterface {
       os << globalLoadOp.global();
     } else if (isa<ConstRefZeroOp>(op)) {
       os << "null";
-    } else if (isa<ConstI32ZeroOp>(op)) {
+    } else if (isa<ConstI32ZeroOp>(op) || isa<ConstI64ZeroOp>(op) ||
+               isa<ConstF32ZeroOp>(op)) {
       os << "zero";
-    } else if (auto constOp = dyn_cast<ConstI32Op>(op)) {
-      if (auto intAttr = constOp.value().dyn_cast<IntegerAttr>()) {
+    } else if (isa<ConstI32Op>(op) || isa<ConstI64Op>(op)) {
+      auto valueAttr = op->getAttr("value");
+      if (auto intAttr = valueAttr.dyn_cast<IntegerAttr>()) {
         if (intAttr.getValue() == 0) {
           os << "zero";
         } else {
@@ -66,30 +68,42 @@ struct VMOpAsmInterface : public OpAsmDialectInterface {
       } else {
         os << 'c';
       }
+    } else if (isa<ConstF32Op>(op)) {
+      os << 'c';
     } else if (auto rodataOp = dyn_cast<ConstRefRodataOp>(op)) {
       os << rodataOp.rodata();
     } else if (op->getResult(0).getType().isa<IREE::VM::RefType>()) {
       os << "ref";
-    } else if (isa<CmpEQI32Op>(op)) {
+    } else if (isa<CmpEQI32Op>(op) || isa<CmpEQI64Op>(op) ||
+               isa<CmpEQF32Op>(op)) {
       os << "eq";
-    } else if (isa<CmpNEI32Op>(op)) {
+    } else if (isa<CmpNEI32Op>(op) || isa<CmpNEI64Op>(op) ||
+               isa<CmpNEF32Op>(op)) {
       os << "ne";
-    } else if (isa<CmpLTI32SOp>(op)) {
+    } else if (isa<CmpLTI32SOp>(op) || isa<CmpLTI64SOp>(op)) {
       os << "slt";
-    } else if (isa<CmpLTI32UOp>(op)) {
+    } else if (isa<CmpLTI32UOp>(op) || isa<CmpLTI64UOp>(op)) {
       os << "ult";
-    } else if (isa<CmpLTEI32SOp>(op)) {
+    } else if (isa<CmpLTEI32SOp>(op) || isa<CmpLTEI64SOp>(op)) {
       os << "slte";
-    } else if (isa<CmpLTEI32UOp>(op)) {
+    } else if (isa<CmpLTEI32UOp>(op) || isa<CmpLTEI64UOp>(op)) {
       os << "ulte";
-    } else if (isa<CmpGTI32SOp>(op)) {
+    } else if (isa<CmpGTI32SOp>(op) || isa<CmpGTI64SOp>(op)) {
       os << "sgt";
-    } else if (isa<CmpGTI32UOp>(op)) {
+    } else if (isa<CmpGTI32UOp>(op) || isa<CmpGTI64UOp>(op)) {
       os << "ugt";
-    } else if (isa<CmpGTEI32SOp>(op)) {
+    } else if (isa<CmpGTEI32SOp>(op) || isa<CmpGTEI64SOp>(op)) {
       os << "sgte";
-    } else if (isa<CmpGTEI32UOp>(op)) {
+    } else if (isa<CmpGTEI32UOp>(op) || isa<CmpGTEI64UOp>(op)) {
       os << "ugte";
+    } else if (isa<CmpLTF32Op>(op)) {
+      os << "lt";
+    } else if (isa<CmpLTEF32Op>(op)) {
+      os << "lte";
+    } else if (isa<CmpGTF32Op>(op)) {
+      os << "gt";
+    } else if (isa<CmpGTEF32Op>(op)) {
+      os << "gte";
     } else if (isa<CmpEQRefOp>(op)) {
       os << "req";
     } else if (isa<CmpNERefOp>(op)) {
@@ -248,6 +262,18 @@ Operation *VMDialect::materializeConstant(OpBuilder &builder, Attribute value,
       return builder.create<VM::ConstI32ZeroOp>(loc);
     }
     return builder.create<VM::ConstI32Op>(loc, convertedValue);
+  } else if (ConstI64Op::isBuildableWith(value, type)) {
+    auto convertedValue = ConstI64Op::convertConstValue(value);
+    if (convertedValue.cast<IntegerAttr>().getValue() == 0) {
+      return builder.create<VM::ConstI64ZeroOp>(loc);
+    }
+    return builder.create<VM::ConstI64Op>(loc, convertedValue);
+  } else if (ConstF32Op::isBuildableWith(value, type)) {
+    auto convertedValue = ConstF32Op::convertConstValue(value);
+    if (convertedValue.cast<FloatAttr>().getValue().isPosZero()) {
+      return builder.create<VM::ConstF32ZeroOp>(loc);
+    }
+    return builder.create<VM::ConstF32Op>(loc, convertedValue);
   } else if (type.isa<IREE::VM::RefType>()) {
     // The only constant type we support for ref_ptrs is null so we can just
     // emit that here.
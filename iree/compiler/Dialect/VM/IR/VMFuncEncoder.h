@@ -56,6 +56,10 @@ class VMFuncEncoder {
   // Encodes an integer attribute as a fixed byte length based on bitwidth.
   virtual LogicalResult encodeIntAttr(IntegerAttr value) = 0;
 
+  // Encodes a floating-point attribute as a fixed byte length based on
+  // bitwidth.
+  virtual LogicalResult encodeFloatAttr(FloatAttr value) = 0;
+
   // Encodes a variable-length integer array attribute.
   virtual LogicalResult encodeIntArrayAttr(DenseIntElementsAttr value) = 0;
 
@@ -73,6 +77,11 @@ class VMFuncEncoder {
   // Encodes a variable list of operands (by reference), including a count.
   virtual LogicalResult encodeOperands(Operation::operand_range values) = 0;
 
+  // Encodes a variable list of operands (by reference) grouped by register
+  // bank, including a total count and the count of leading i32 registers.
+  virtual LogicalResult encodeSplitOperands(
+      Operation::operand_range values) = 0;
+
   // Encodes a result value (by reference).
   virtual LogicalResult encodeResult(Value value) = 0;
 
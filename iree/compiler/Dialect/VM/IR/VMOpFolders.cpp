@@ -16,6 +16,7 @@
 
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/StringExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -275,6 +276,18 @@ OpFoldResult ConstI32ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
 
+OpFoldResult ConstI64Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
+OpFoldResult ConstI64ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return IntegerAttr::get(getResult().getType(), 0);
+}
+
+OpFoldResult ConstF32Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
+OpFoldResult ConstF32ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
 OpFoldResult ConstRefZeroOp::fold(ArrayRef<Attribute> operands) {
   // TODO(b/144027097): relace unit attr with a proper null ref_ptr attr.
   return UnitAttr::get(getContext());
@@ -307,6 +320,14 @@ OpFoldResult SelectI32Op::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
 
+OpFoldResult SelectI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
+OpFoldResult SelectF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
 OpFoldResult SelectRefOp::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
@@ -383,173 +404,327 @@ Attribute constFoldBinaryOp(ArrayRef<Attribute> operands,
 
 }  // namespace
 
-OpFoldResult AddI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldAddOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x + 0 = x or 0 + y = y (commutative)
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a + b; });
 }
 
-OpFoldResult SubI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult AddI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldAddOp(*this, operands);
+}
+
+OpFoldResult AddI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldAddOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldSubOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x - 0 = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a - b; });
 }
 
-OpFoldResult MulI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult SubI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSubOp(*this, operands);
+}
+
+OpFoldResult SubI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldSubOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldMulOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x * 0 = 0 or 0 * y = 0 (commutative)
-    return zerosOfType(getType());
-  } else if (matchPattern(rhs(), m_One())) {
+    return zerosOfType(op.getType());
+  } else if (matchPattern(op.rhs(), m_One())) {
     // x * 1 = x or 1 * y = y (commutative)
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a * b; });
 }
 
-OpFoldResult DivI32SOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult MulI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldMulOp(*this, operands);
+}
+
+OpFoldResult MulI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldMulOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldDivSOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x / 0 = death
-    emitOpError() << "is a divide by constant zero";
+    op.emitOpError() << "is a divide by constant zero";
     return {};
-  } else if (matchPattern(lhs(), m_Zero())) {
+  } else if (matchPattern(op.lhs(), m_Zero())) {
     // 0 / y = 0
-    return zerosOfType(getType());
-  } else if (matchPattern(rhs(), m_One())) {
+    return zerosOfType(op.getType());
+  } else if (matchPattern(op.rhs(), m_One())) {
     // x / 1 = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.sdiv(b); });
 }
 
-OpFoldResult DivI32UOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult DivI32SOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivSOp(*this, operands);
+}
+
+OpFoldResult DivI64SOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivSOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldDivUOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x / 0 = death
-    emitOpError() << "is a divide by constant zero";
+    op.emitOpError() << "is a divide by constant zero";
     return {};
-  } else if (matchPattern(lhs(), m_Zero())) {
+  } else if (matchPattern(op.lhs(), m_Zero())) {
     // 0 / y = 0
-    return zerosOfType(getType());
-  } else if (matchPattern(rhs(), m_One())) {
+    return zerosOfType(op.getType());
+  } else if (matchPattern(op.rhs(), m_One())) {
     // x / 1 = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.udiv(b); });
 }
 
-OpFoldResult RemI32SOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult DivI32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivUOp(*this, operands);
+}
+
+OpFoldResult DivI64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivUOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldRemSOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x % 0 = death
-    emitOpError() << "is a remainder by constant zero";
+    op.emitOpError() << "is a remainder by constant zero";
     return {};
-  } else if (matchPattern(lhs(), m_Zero()) || matchPattern(rhs(), m_One())) {
+  } else if (matchPattern(op.lhs(), m_Zero()) ||
+             matchPattern(op.rhs(), m_One())) {
     // x % 1 = 0
     // 0 % y = 0
-    return zerosOfType(getType());
+    return zerosOfType(op.getType());
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.srem(b); });
 }
 
-OpFoldResult RemI32UOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(lhs(), m_Zero()) || matchPattern(rhs(), m_One())) {
+OpFoldResult RemI32SOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemSOp(*this, operands);
+}
+
+OpFoldResult RemI64SOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemSOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldRemUOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.lhs(), m_Zero()) || matchPattern(op.rhs(), m_One())) {
     // x % 1 = 0
     // 0 % y = 0
-    return zerosOfType(getType());
+    return zerosOfType(op.getType());
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.urem(b); });
 }
 
-OpFoldResult NotI32Op::fold(ArrayRef<Attribute> operands) {
+OpFoldResult RemI32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemUOp(*this, operands);
+}
+
+OpFoldResult RemI64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemUOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldNotOp(T op, ArrayRef<Attribute> operands) {
   return constFoldUnaryOp<IntegerAttr>(operands, [](APInt a) {
     a.flipAllBits();
     return a;
   });
 }
 
-OpFoldResult AndI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult NotI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldNotOp(*this, operands);
+}
+
+OpFoldResult NotI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldNotOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldAndOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x & 0 = 0 or 0 & y = 0 (commutative)
-    return zerosOfType(getType());
-  } else if (lhs() == rhs()) {
+    return zerosOfType(op.getType());
+  } else if (op.lhs() == op.rhs()) {
     // x & x = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a & b; });
 }
 
-OpFoldResult OrI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult AndI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldAndOp(*this, operands);
+}
+
+OpFoldResult AndI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldAndOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldOrOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x | 0 = x or 0 | y = y (commutative)
-    return lhs();
-  } else if (lhs() == rhs()) {
+    return op.lhs();
+  } else if (op.lhs() == op.rhs()) {
     // x | x = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a | b; });
 }
 
-OpFoldResult XorI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+OpFoldResult OrI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldOrOp(*this, operands);
+}
+
+OpFoldResult OrI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldOrOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldXorOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x ^ 0 = x or 0 ^ y = y (commutative)
-    return lhs();
-  } else if (lhs() == rhs()) {
+    return op.lhs();
+  } else if (op.lhs() == op.rhs()) {
     // x ^ x = 0
-    return zerosOfType(getType());
+    return zerosOfType(op.getType());
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a ^ b; });
 }
 
+OpFoldResult XorI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldXorOp(*this, operands);
+}
+
+OpFoldResult XorI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldXorOp(*this, operands);
+}
+
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+
+// NOTE: identities such as x + 0 = x do not hold for all floating-point values
+// (-0, NaN, etc) and so only constant operands are folded.
+
+OpFoldResult AddF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a + b; });
+}
+
+OpFoldResult SubF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a - b; });
+}
+
+OpFoldResult MulF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a * b; });
+}
+
+OpFoldResult DivF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a / b; });
+}
+
 //===----------------------------------------------------------------------===//
 // Native bitwise shifts and rotates
 //===----------------------------------------------------------------------===//
 
-OpFoldResult ShlI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(operand(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldShlOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.operand(), m_Zero())) {
     // 0 << y = 0
-    return zerosOfType(getType());
-  } else if (amount() == 0) {
+    return zerosOfType(op.getType());
+  } else if (op.amount() == 0) {
     // x << 0 = x
-    return operand();
+    return op.operand();
   }
   return constFoldUnaryOp<IntegerAttr>(
-      operands, [&](APInt a) { return a.shl(amount()); });
+      operands, [&](APInt a) { return a.shl(op.amount()); });
 }
 
-OpFoldResult ShrI32SOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(operand(), m_Zero())) {
+OpFoldResult ShlI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldShlOp(*this, operands);
+}
+
+OpFoldResult ShlI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldShlOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldShrSOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.operand(), m_Zero())) {
     // 0 >> y = 0
-    return zerosOfType(getType());
-  } else if (amount() == 0) {
+    return zerosOfType(op.getType());
+  } else if (op.amount() == 0) {
     // x >> 0 = x
-    return operand();
+    return op.operand();
   }
   return constFoldUnaryOp<IntegerAttr>(
-      operands, [&](APInt a) { return a.ashr(amount()); });
+      operands, [&](APInt a) { return a.ashr(op.amount()); });
 }
 
-OpFoldResult ShrI32UOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(operand(), m_Zero())) {
+OpFoldResult ShrI32SOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrSOp(*this, operands);
+}
+
+OpFoldResult ShrI64SOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrSOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldShrUOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.operand(), m_Zero())) {
     // 0 >> y = 0
-    return zerosOfType(getType());
-  } else if (amount() == 0) {
+    return zerosOfType(op.getType());
+  } else if (op.amount() == 0) {
     // x >> 0 = x
-    return operand();
+    return op.operand();
   }
   return constFoldUnaryOp<IntegerAttr>(
-      operands, [&](APInt a) { return a.lshr(amount()); });
+      operands, [&](APInt a) { return a.lshr(op.amount()); });
+}
+
+OpFoldResult ShrI32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrUOp(*this, operands);
+}
+
+OpFoldResult ShrI64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrUOp(*this, operands);
 }
 
 //===----------------------------------------------------------------------===//
@@ -576,6 +751,75 @@ OpFoldResult ExtI16I32SOp::fold(ArrayRef<Attribute> operands) {
       operands, [&](APInt a) { return a.trunc(16).sext(32); });
 }
 
+namespace {
+
+/// Performs const folding `calculate` on the scalar attribute in `operands`
+/// producing a value of `resultType`, which may differ from the operand type.
+template <class AttrElementT, class CalculationT>
+Attribute constFoldConversionOp(ArrayRef<Attribute> operands, Type resultType,
+                                const CalculationT &calculate) {
+  assert(operands.size() == 1 && "conversion op takes one operand");
+  if (auto operand = operands[0].dyn_cast_or_null<AttrElementT>()) {
+    return calculate(operand.getValue(), resultType);
+  }
+  return {};
+}
+
+}  // namespace
+
+OpFoldResult ExtI32I64SOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr>(
+      operands, getType(), [](APInt a, Type type) -> Attribute {
+        return IntegerAttr::get(type, a.sext(64));
+      });
+}
+
+OpFoldResult ExtI32I64UOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr>(
+      operands, getType(), [](APInt a, Type type) -> Attribute {
+        return IntegerAttr::get(type, a.zext(64));
+      });
+}
+
+OpFoldResult TruncI64I32Op::fold(ArrayRef<Attribute> operands) {
+  if (auto extOp = dyn_cast_or_null<ExtI32I64SOp>(operand().getDefiningOp())) {
+    // trunc(sext(x)) = x
+    return extOp.operand();
+  } else if (auto extOp =
+                 dyn_cast_or_null<ExtI32I64UOp>(operand().getDefiningOp())) {
+    // trunc(zext(x)) = x
+    return extOp.operand();
+  }
+  return constFoldConversionOp<IntegerAttr>(
+      operands, getType(), [](APInt a, Type type) -> Attribute {
+        return IntegerAttr::get(type, a.trunc(32));
+      });
+}
+
+OpFoldResult CastSI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr>(
+      operands, getType(), [](APInt a, Type type) -> Attribute {
+        APFloat value(APFloat::IEEEsingle());
+        value.convertFromAPInt(a, /*IsSigned=*/true,
+                               APFloat::rmNearestTiesToEven);
+        return FloatAttr::get(type, value);
+      });
+}
+
+OpFoldResult CastF32SI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<FloatAttr>(
+      operands, getType(), [](APFloat a, Type type) -> Attribute {
+        llvm::APSInt value(32, /*isUnsigned=*/false);
+        bool isExact = false;
+        if (a.convertToInteger(value, APFloat::rmTowardZero, &isExact) &
+            APFloat::opInvalidOp) {
+          // Out of range conversions are undefined; leave them to runtime.
+          return {};
+        }
+        return IntegerAttr::get(type, value);
+      });
+}
+
 //===----------------------------------------------------------------------===//
 // Native reduction (horizontal) arithmetic
 //===----------------------------------------------------------------------===//
@@ -674,6 +918,161 @@ OpFoldResult CmpGTEI32UOp::fold(ArrayRef<Attribute> operands) {
       operands, [&](APInt a, APInt b) { return a.uge(b); });
 }
 
+namespace {
+
+/// Performs const folding of a comparison `predicate` on the two scalar
+/// attributes in `operands` and returns the i32 boolean result if possible.
+template <class AttrElementT, class PredicateT>
+Attribute constFoldCmpOp(ArrayRef<Attribute> operands, Type resultType,
+                         const PredicateT &predicate) {
+  assert(operands.size() == 2 && "comparison op takes two operands");
+  auto lhs = operands[0].dyn_cast_or_null<AttrElementT>();
+  auto rhs = operands[1].dyn_cast_or_null<AttrElementT>();
+  if (!lhs || !rhs) return {};
+  return IntegerAttr::get(resultType,
+                          predicate(lhs.getValue(), rhs.getValue()) ? 1 : 0);
+}
+
+}  // namespace
+
+OpFoldResult CmpEQI64Op::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x == x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.eq(b); });
+}
+
+OpFoldResult CmpNEI64Op::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x != x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.ne(b); });
+}
+
+OpFoldResult CmpLTI64SOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x < x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.slt(b); });
+}
+
+OpFoldResult CmpLTI64UOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x < x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.ult(b); });
+}
+
+OpFoldResult CmpLTEI64SOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x <= x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.sle(b); });
+}
+
+OpFoldResult CmpLTEI64UOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x <= x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.ule(b); });
+}
+
+OpFoldResult CmpGTI64SOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x > x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.sgt(b); });
+}
+
+OpFoldResult CmpGTI64UOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x > x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.ugt(b); });
+}
+
+OpFoldResult CmpGTEI64SOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x >= x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.sge(b); });
+}
+
+OpFoldResult CmpGTEI64UOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x >= x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      operands, getType(), [](APInt a, APInt b) { return a.uge(b); });
+}
+
+// NOTE: x == x does not hold for NaN and so only constant operands are folded.
+// All comparisons besides ne are ordered and return false if either operand is
+// NaN, matching the C comparison operators used at runtime.
+
+OpFoldResult CmpEQF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      operands, getType(), [](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpEqual;
+      });
+}
+
+OpFoldResult CmpNEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      operands, getType(), [](APFloat a, APFloat b) {
+        return a.compare(b) != APFloat::cmpEqual;
+      });
+}
+
+OpFoldResult CmpLTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      operands, getType(), [](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpLessThan;
+      });
+}
+
+OpFoldResult CmpLTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      operands, getType(), [](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpLessThan ||
+               a.compare(b) == APFloat::cmpEqual;
+      });
+}
+
+OpFoldResult CmpGTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      operands, getType(), [](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpGreaterThan;
+      });
+}
+
+OpFoldResult CmpGTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      operands, getType(), [](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpGreaterThan ||
+               a.compare(b) == APFloat::cmpEqual;
+      });
+}
+
 OpFoldResult CmpEQRefOp::fold(ArrayRef<Attribute> operands) {
   if (lhs() == rhs()) {
     // x == x = true
@@ -826,12 +1225,124 @@ struct SwapInvertedCondBranchOpTargets : public OpRewritePattern<CondBranchOp> {
   }
 };
 
+/// Fuses a single-use i32 comparison into the cond_br consuming it to form a
+/// compare-and-branch superinstruction. Predicates without a fused form are
+/// matched by swapping the comparison operands and/or the branch targets.
+struct FuseCmpI32CondBranch : public OpRewritePattern<CondBranchOp> {
+  using OpRewritePattern<CondBranchOp>::OpRewritePattern;
+  PatternMatchResult matchAndRewrite(CondBranchOp op,
+                                     PatternRewriter &rewriter) const override {
+    auto *cmpOp = op.getCondition().getDefiningOp();
+    if (!cmpOp || !op.getCondition().hasOneUse()) {
+      return matchFailure();
+    }
+    if (isa<CmpEQI32Op>(cmpOp)) {
+      return fuse<CondBranchCmpEQI32Op>(op, cmpOp, false, false, rewriter);
+    } else if (isa<CmpNEI32Op>(cmpOp)) {
+      return fuse<CondBranchCmpEQI32Op>(op, cmpOp, false, true, rewriter);
+    } else if (isa<CmpLTI32SOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32SOp>(op, cmpOp, false, false, rewriter);
+    } else if (isa<CmpLTEI32SOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32SOp>(op, cmpOp, true, true, rewriter);
+    } else if (isa<CmpGTI32SOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32SOp>(op, cmpOp, true, false, rewriter);
+    } else if (isa<CmpGTEI32SOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32SOp>(op, cmpOp, false, true, rewriter);
+    } else if (isa<CmpLTI32UOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32UOp>(op, cmpOp, false, false, rewriter);
+    } else if (isa<CmpLTEI32UOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32UOp>(op, cmpOp, true, true, rewriter);
+    } else if (isa<CmpGTI32UOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32UOp>(op, cmpOp, true, false, rewriter);
+    } else if (isa<CmpGTEI32UOp>(cmpOp)) {
+      return fuse<CondBranchCmpLTI32UOp>(op, cmpOp, false, true, rewriter);
+    }
+    return matchFailure();
+  }
+
+ private:
+  template <typename FusedOpTy>
+  PatternMatchResult fuse(CondBranchOp op, Operation *cmpOp, bool swapOperands,
+                          bool swapTargets, PatternRewriter &rewriter) const {
+    Value lhs = cmpOp->getOperand(swapOperands ? 1 : 0);
+    Value rhs = cmpOp->getOperand(swapOperands ? 0 : 1);
+    Block *trueDest = op.getTrueDest();
+    Block *falseDest = op.getFalseDest();
+    auto trueOperands = llvm::to_vector<4>(op.getTrueOperands());
+    auto falseOperands = llvm::to_vector<4>(op.getFalseOperands());
+    if (swapTargets) {
+      std::swap(trueDest, falseDest);
+      std::swap(trueOperands, falseOperands);
+    }
+    rewriter.replaceOpWithNewOp<FusedOpTy>(op, lhs, rhs, trueDest, trueOperands,
+                                           falseDest, falseOperands);
+    rewriter.eraseOp(cmpOp);
+    return matchSuccess();
+  }
+};
+
 }  // namespace
 
 void CondBranchOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<SimplifyConstCondBranchPred, SimplifySameTargetCondBranchOp,
-                 SwapInvertedCondBranchOpTargets>(context);
+                 SwapInvertedCondBranchOpTargets, FuseCmpI32CondBranch>(
+      context);
+}
+
+namespace {
+
+/// Simplifies a fused compare-and-branch with constant operands to an
+/// unconditional branch.
+template <typename T, typename CompareFn>
+struct SimplifyConstCondBranchCmp : public OpRewritePattern<T> {
+  using OpRewritePattern<T>::OpRewritePattern;
+  PatternMatchResult matchAndRewrite(T op,
+                                     PatternRewriter &rewriter) const override {
+    APInt lhs, rhs;
+    if (!matchPattern(op.lhs(), m_ConstantInt(&lhs)) ||
+        !matchPattern(op.rhs(), m_ConstantInt(&rhs))) {
+      return this->matchFailure();
+    }
+    if (CompareFn()(lhs, rhs)) {
+      rewriter.replaceOpWithNewOp<BranchOp>(op, op.getTrueDest(),
+                                            op.getTrueOperands());
+    } else {
+      rewriter.replaceOpWithNewOp<BranchOp>(op, op.getFalseDest(),
+                                            op.getFalseOperands());
+    }
+    return this->matchSuccess();
+  }
+};
+
+struct CompareEQ {
+  bool operator()(const APInt &lhs, const APInt &rhs) { return lhs.eq(rhs); }
+};
+struct CompareSLT {
+  bool operator()(const APInt &lhs, const APInt &rhs) { return lhs.slt(rhs); }
+};
+struct CompareULT {
+  bool operator()(const APInt &lhs, const APInt &rhs) { return lhs.ult(rhs); }
+};
+
+}  // namespace
+
+void CondBranchCmpEQI32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SimplifyConstCondBranchCmp<CondBranchCmpEQI32Op, CompareEQ>>(
+      context);
+}
+
+void CondBranchCmpLTI32SOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SimplifyConstCondBranchCmp<CondBranchCmpLTI32SOp, CompareSLT>>(
+      context);
+}
+
+void CondBranchCmpLTI32UOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SimplifyConstCondBranchCmp<CondBranchCmpLTI32UOp, CompareULT>>(
+      context);
 }
 
 namespace {
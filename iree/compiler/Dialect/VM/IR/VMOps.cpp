@@ -25,6 +25,7 @@
 #include "mlir/IR/OpImplementation.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Support/STLExtras.h"
@@ -552,19 +553,19 @@ static LogicalResult verifyGlobalStoreOp(Operation *op) {
 // Constants
 //===----------------------------------------------------------------------===//
 
-static ParseResult parseConstI32Op(OpAsmParser &parser,
-                                   OperationState *result) {
+template <typename T>
+static ParseResult parseConstOp(OpAsmParser &parser, OperationState *result) {
   Attribute valueAttr;
   SmallVector<NamedAttribute, 1> dummyAttrs;
   if (failed(parser.parseAttribute(valueAttr, "value", dummyAttrs))) {
     return parser.emitError(parser.getCurrentLocation())
            << "Invalid attribute encoding";
   }
-  if (!ConstI32Op::isBuildableWith(valueAttr, valueAttr.getType())) {
+  if (!T::isBuildableWith(valueAttr, valueAttr.getType())) {
     return parser.emitError(parser.getCurrentLocation())
            << "Incompatible type or invalid type value formatting";
   }
-  valueAttr = ConstI32Op::convertConstValue(valueAttr);
+  valueAttr = T::convertConstValue(valueAttr);
   result->addAttribute("value", valueAttr);
   if (failed(parser.parseOptionalAttrDict(result->attributes))) {
     return parser.emitError(parser.getCurrentLocation())
@@ -573,14 +574,45 @@ static ParseResult parseConstI32Op(OpAsmParser &parser,
   return parser.addTypeToList(valueAttr.getType(), result->types);
 }
 
-static void printConstI32Op(OpAsmPrinter &p, ConstI32Op &op) {
+template <typename T>
+static void printConstOp(OpAsmPrinter &p, T &op) {
   p << op.getOperationName() << ' ';
   p.printAttribute(op.value());
   p.printOptionalAttrDict(op.getAttrs(), /*elidedAttrs=*/{"value"});
 }
 
-// static
-bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
+static ParseResult parseConstI32Op(OpAsmParser &parser,
+                                   OperationState *result) {
+  return parseConstOp<ConstI32Op>(parser, result);
+}
+
+static void printConstI32Op(OpAsmPrinter &p, ConstI32Op &op) {
+  printConstOp(p, op);
+}
+
+static ParseResult parseConstI64Op(OpAsmParser &parser,
+                                   OperationState *result) {
+  return parseConstOp<ConstI64Op>(parser, result);
+}
+
+static void printConstI64Op(OpAsmPrinter &p, ConstI64Op &op) {
+  printConstOp(p, op);
+}
+
+static ParseResult parseConstF32Op(OpAsmParser &parser,
+                                   OperationState *result) {
+  return parseConstOp<ConstF32Op>(parser, result);
+}
+
+static void printConstF32Op(OpAsmPrinter &p, ConstF32Op &op) {
+  printConstOp(p, op);
+}
+
+// Returns true if |value| is an integer attribute (or elements attribute of
+// integers) of |type| with a bit width in [|minBitWidth|, |maxBitWidth|].
+static bool isBuildableIntegerConst(Attribute value, Type type,
+                                    unsigned minBitWidth,
+                                    unsigned maxBitWidth) {
   // FlatSymbolRefAttr can only be used with a function type.
   if (value.isa<FlatSymbolRefAttr>()) {
     return false;
@@ -589,6 +621,17 @@ bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
   if (value.getType() != type) {
     return false;
   }
+  // The element type must fit within the storage of the constant.
+  Type elementType = getElementTypeOrSelf(type);
+  if (auto integerType = elementType.dyn_cast<IntegerType>()) {
+    if (integerType.getWidth() < minBitWidth ||
+        integerType.getWidth() > maxBitWidth) {
+      return false;
+    }
+  } else if (minBitWidth > 32) {
+    // Index types are converted to i32.
+    return false;
+  }
   // Finally, check that the attribute kind is handled.
   return value.isa<UnitAttr>() || value.isa<BoolAttr>() ||
          value.isa<IntegerAttr>() ||
@@ -598,22 +641,21 @@ bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
                                            .isSignlessInteger());
 }
 
-// static
-Attribute ConstI32Op::convertConstValue(Attribute value) {
-  assert(isBuildableWith(value, value.getType()));
+// Converts an integer |value| to an attribute of the given |bitWidth|.
+static Attribute convertIntegerConstValue(Attribute value, unsigned bitWidth) {
   Builder builder(value.getContext());
+  auto integerType = builder.getIntegerType(bitWidth);
   int32_t dims = 1;
   if (value.isa<UnitAttr>()) {
-    return builder.getI32IntegerAttr(1);
+    return builder.getIntegerAttr(integerType, 1);
   } else if (auto v = value.dyn_cast<BoolAttr>()) {
-    return builder.getI32IntegerAttr(v.getValue() ? 1 : 0);
+    return builder.getIntegerAttr(integerType, v.getValue() ? 1 : 0);
   } else if (auto v = value.dyn_cast<IntegerAttr>()) {
-    return builder.getI32IntegerAttr(
-        static_cast<int32_t>(v.getValue().getLimitedValue()));
+    return builder.getIntegerAttr(integerType,
+                                  v.getValue().zextOrTrunc(bitWidth));
   } else if (auto v = value.dyn_cast<ElementsAttr>()) {
     dims = v.getNumElements();
-    ShapedType adjustedType =
-        VectorType::get({dims}, builder.getIntegerType(32));
+    ShapedType adjustedType = VectorType::get({dims}, integerType);
     if (auto elements = v.dyn_cast<SplatElementsAttr>()) {
       return SplatElementsAttr::get(adjustedType, elements.getSplatValue());
     } else {
@@ -625,6 +667,18 @@ Attribute ConstI32Op::convertConstValue(Attribute value) {
   return Attribute();
 }
 
+// static
+bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
+  return isBuildableIntegerConst(value, type, /*minBitWidth=*/1,
+                                 /*maxBitWidth=*/32);
+}
+
+// static
+Attribute ConstI32Op::convertConstValue(Attribute value) {
+  assert(isBuildableWith(value, value.getType()));
+  return convertIntegerConstValue(value, 32);
+}
+
 void ConstI32Op::build(Builder *builder, OperationState &result,
                        Attribute value) {
   Attribute newValue = convertConstValue(value);
@@ -641,6 +695,74 @@ void ConstI32ZeroOp::build(Builder *builder, OperationState &result) {
   result.addTypes(builder->getIntegerType(32));
 }
 
+// static
+bool ConstI64Op::isBuildableWith(Attribute value, Type type) {
+  return isBuildableIntegerConst(value, type, /*minBitWidth=*/64,
+                                 /*maxBitWidth=*/64);
+}
+
+// static
+Attribute ConstI64Op::convertConstValue(Attribute value) {
+  assert(isBuildableWith(value, value.getType()));
+  return convertIntegerConstValue(value, 64);
+}
+
+void ConstI64Op::build(Builder *builder, OperationState &result,
+                       Attribute value) {
+  Attribute newValue = convertConstValue(value);
+  result.addAttribute("value", newValue);
+  result.addTypes(newValue.getType());
+}
+
+void ConstI64Op::build(Builder *builder, OperationState &result,
+                       int64_t value) {
+  return build(builder, result, builder->getI64IntegerAttr(value));
+}
+
+void ConstI64ZeroOp::build(Builder *builder, OperationState &result) {
+  result.addTypes(builder->getIntegerType(64));
+}
+
+// static
+bool ConstF32Op::isBuildableWith(Attribute value, Type type) {
+  if (value.getType() != type || !getElementTypeOrSelf(type).isF32()) {
+    return false;
+  }
+  return value.isa<FloatAttr>() || value.isa<ElementsAttr>();
+}
+
+// static
+Attribute ConstF32Op::convertConstValue(Attribute value) {
+  assert(isBuildableWith(value, value.getType()));
+  if (auto v = value.dyn_cast<ElementsAttr>()) {
+    int64_t dims = v.getNumElements();
+    ShapedType adjustedType =
+        VectorType::get({dims}, v.getType().getElementType());
+    if (auto elements = v.dyn_cast<SplatElementsAttr>()) {
+      return SplatElementsAttr::get(adjustedType, elements.getSplatValue());
+    } else {
+      return DenseElementsAttr::get(
+          adjustedType, llvm::to_vector<4>(v.getValues<Attribute>()));
+    }
+  }
+  return value;
+}
+
+void ConstF32Op::build(Builder *builder, OperationState &result,
+                       Attribute value) {
+  Attribute newValue = convertConstValue(value);
+  result.addAttribute("value", newValue);
+  result.addTypes(newValue.getType());
+}
+
+void ConstF32Op::build(Builder *builder, OperationState &result, float value) {
+  return build(builder, result, builder->getF32FloatAttr(value));
+}
+
+void ConstF32ZeroOp::build(Builder *builder, OperationState &result) {
+  result.addTypes(builder->getF32Type());
+}
+
 void ConstRefZeroOp::build(Builder *builder, OperationState &result,
                            Type objectType) {
   result.addTypes(objectType);
@@ -652,7 +774,8 @@ static ParseResult parseRodataOp(OpAsmParser &parser, OperationState *result) {
   if (failed(parser.parseSymbolName(nameAttr,
                                     mlir::SymbolTable::getSymbolAttrName(),
                                     result->attributes)) ||
-      failed(parser.parseAttribute(valueAttr, "value", result->attributes))) {
+      failed(parser.parseAttribute(valueAttr, "value", result->attributes)) ||
+      failed(parser.parseOptionalAttrDict(result->attributes))) {
     return failure();
   }
   return success();
@@ -663,6 +786,24 @@ static void printRodataOp(OpAsmPrinter &p, RodataOp &op) {
   p.printSymbolName(op.sym_name());
   p << ' ';
   p.printAttribute(op.value());
+  p.printOptionalAttrDict(op.getAttrs(), /*elidedAttrs=*/{
+                              mlir::SymbolTable::getSymbolAttrName(),
+                              "value",
+                              "ordinal",
+                          });
+}
+
+static LogicalResult verifyRodataOp(RodataOp op) {
+  if (auto alignmentAttr = op.getAttrOfType<IntegerAttr>("alignment")) {
+    int64_t alignment = alignmentAttr.getInt();
+    if (alignment <= 0 || alignment > 4096 ||
+        (alignment & (alignment - 1)) != 0) {
+      return op.emitOpError()
+             << "alignment must be a power of two no greater than 4096; got "
+             << alignment;
+    }
+  }
+  return success();
 }
 
 void RodataOp::build(Builder *builder, OperationState &result, StringRef name,
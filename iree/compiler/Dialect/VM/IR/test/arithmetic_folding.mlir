@@ -370,3 +370,41 @@ vm.module @shr_i32_u_folds {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @add_i64_folds
+vm.module @add_i64_folds {
+  // CHECK-LABEL: @add_i64_x_0
+  vm.func @add_i64_x_0(%arg0 : i64) -> i64 {
+    // CHECK: vm.return %arg0 : i64
+    %zero = vm.const.i64.zero : i64
+    %0 = vm.add.i64 %arg0, %zero : i64
+    vm.return %0 : i64
+  }
+
+  // CHECK-LABEL: @add_i64_const
+  vm.func @add_i64_const() -> i64 {
+    // CHECK: %c4294967296 = vm.const.i64 4294967296
+    // CHECK-NEXT: vm.return %c4294967296 : i64
+    %c1 = vm.const.i64 4294967295 : i64
+    %c2 = vm.const.i64 1 : i64
+    %0 = vm.add.i64 %c1, %c2 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @mul_f32_folds
+vm.module @mul_f32_folds {
+  // CHECK-LABEL: @mul_f32_const
+  vm.func @mul_f32_const() -> f32 {
+    // CHECK: %c = vm.const.f32 3.0{{.*}} : f32
+    // CHECK-NEXT: vm.return %c : f32
+    %c1 = vm.const.f32 1.5 : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %0 = vm.mul.f32 %c1, %c2 : f32
+    vm.return %0 : f32
+  }
+}
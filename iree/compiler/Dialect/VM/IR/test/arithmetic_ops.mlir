@@ -153,3 +153,69 @@ vm.module @my_module {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @add_i64
+vm.module @my_module {
+  vm.func @add_i64(%arg0 : i64, %arg1 : i64) -> i64 {
+    // CHECK: %0 = vm.add.i64 %arg0, %arg1 : i64
+    %0 = vm.add.i64 %arg0, %arg1 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @div_i64_u
+vm.module @my_module {
+  vm.func @div_i64_u(%arg0 : i64, %arg1 : i64) -> i64 {
+    // CHECK: %0 = vm.div.i64.u %arg0, %arg1 : i64
+    %0 = vm.div.i64.u %arg0, %arg1 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @xor_i64
+vm.module @my_module {
+  vm.func @xor_i64(%arg0 : i64, %arg1 : i64) -> i64 {
+    // CHECK: %0 = vm.xor.i64 %arg0, %arg1 : i64
+    %0 = vm.xor.i64 %arg0, %arg1 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @shr_i64_s
+vm.module @my_module {
+  vm.func @shr_i64_s(%arg0 : i64) -> i64 {
+    // CHECK: %0 = vm.shr.i64.s %arg0, 2 : i64
+    %0 = vm.shr.i64.s %arg0, 2 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @add_f32
+vm.module @my_module {
+  vm.func @add_f32(%arg0 : f32, %arg1 : f32) -> f32 {
+    // CHECK: %0 = vm.add.f32 %arg0, %arg1 : f32
+    %0 = vm.add.f32 %arg0, %arg1 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @div_f32
+vm.module @my_module {
+  vm.func @div_f32(%arg0 : f32, %arg1 : f32) -> f32 {
+    // CHECK: %0 = vm.div.f32 %arg0, %arg1 : f32
+    %0 = vm.div.f32 %arg0, %arg1 : f32
+    vm.return %0 : f32
+  }
+}
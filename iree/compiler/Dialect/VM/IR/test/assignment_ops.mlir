@@ -23,3 +23,25 @@ vm.module @my_module {
     vm.return %ref : !vm.ref<?>
   }
 }
+
+// -----
+
+// CHECK-LABEL: @select_i64
+vm.module @my_module {
+  vm.func @select_i64(%arg0 : i32, %arg1 : i64, %arg2 : i64) -> i64 {
+    // CHECK: %0 = vm.select.i64 %arg0, %arg1, %arg2 : i64
+    %0 = vm.select.i64 %arg0, %arg1, %arg2 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @select_f32
+vm.module @my_module {
+  vm.func @select_f32(%arg0 : i32, %arg1 : f32, %arg2 : f32) -> f32 {
+    // CHECK: %0 = vm.select.f32 %arg0, %arg1, %arg2 : f32
+    %0 = vm.select.f32 %arg0, %arg1, %arg2 : f32
+    vm.return %0 : f32
+  }
+}
@@ -417,3 +417,41 @@ vm.module @cmp_nz_ref_folds {
     vm.return %ne : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_i64_folds
+vm.module @cmp_i64_folds {
+  // CHECK-LABEL: @always_eq
+  vm.func @always_eq(%arg0 : i64) -> i32 {
+    // CHECK: %c1 = vm.const.i32 1 : i32
+    // CHECK-NEXT: vm.return %c1 : i32
+    %eq = vm.cmp.eq.i64 %arg0, %arg0 : i64
+    vm.return %eq : i32
+  }
+
+  // CHECK-LABEL: @const_lt_u
+  vm.func @const_lt_u() -> i32 {
+    // CHECK: %zero = vm.const.i32.zero : i32
+    // CHECK-NEXT: vm.return %zero : i32
+    %c1 = vm.const.i64 -1 : i64
+    %c2 = vm.const.i64 1 : i64
+    %ult = vm.cmp.lt.i64.u %c1, %c2 : i64
+    vm.return %ult : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_f32_folds
+vm.module @cmp_f32_folds {
+  // CHECK-LABEL: @const_lt
+  vm.func @const_lt() -> i32 {
+    // CHECK: %c1 = vm.const.i32 1 : i32
+    // CHECK-NEXT: vm.return %c1 : i32
+    %c1 = vm.const.f32 -1.0 : f32
+    %c2 = vm.const.f32 1.0 : f32
+    %lt = vm.cmp.lt.f32 %c1, %c2 : f32
+    vm.return %lt : i32
+  }
+}
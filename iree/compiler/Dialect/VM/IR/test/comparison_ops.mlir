@@ -144,3 +144,58 @@ vm.module @my_module {
     vm.return %rnz : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_eq_i64
+vm.module @my_module {
+  vm.func @cmp_eq_i64(%arg0 : i64, %arg1 : i64) -> i32 {
+    // CHECK: %eq = vm.cmp.eq.i64 %arg0, %arg1 : i64
+    %eq = vm.cmp.eq.i64 %arg0, %arg1 : i64
+    vm.return %eq : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_lt_i64_s
+vm.module @my_module {
+  vm.func @cmp_lt_i64_s(%arg0 : i64, %arg1 : i64) -> i32 {
+    // CHECK: %slt = vm.cmp.lt.i64.s %arg0, %arg1 : i64
+    %slt = vm.cmp.lt.i64.s %arg0, %arg1 : i64
+    vm.return %slt : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_gte_i64_u
+vm.module @my_module {
+  vm.func @cmp_gte_i64_u(%arg0 : i64, %arg1 : i64) -> i32 {
+    // CHECK: %ugte = vm.cmp.gte.i64.u %arg0, %arg1 : i64
+    %ugte = vm.cmp.gte.i64.u %arg0, %arg1 : i64
+    vm.return %ugte : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_ne_f32
+vm.module @my_module {
+  vm.func @cmp_ne_f32(%arg0 : f32, %arg1 : f32) -> i32 {
+    // CHECK: %ne = vm.cmp.ne.f32 %arg0, %arg1 : f32
+    %ne = vm.cmp.ne.f32 %arg0, %arg1 : f32
+    vm.return %ne : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_lte_f32
+vm.module @my_module {
+  vm.func @cmp_lte_f32(%arg0 : f32, %arg1 : f32) -> i32 {
+    // CHECK: %lte = vm.cmp.lte.f32 %arg0, %arg1 : f32
+    %lte = vm.cmp.lte.f32 %arg0, %arg1 : f32
+    vm.return %lte : i32
+  }
+}
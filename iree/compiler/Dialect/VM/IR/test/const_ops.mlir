@@ -44,3 +44,54 @@ vm.module @my_module {
     vm.return %buf0 : !vm.ref<!iree.byte_buffer>
   }
 }
+
+// -----
+
+vm.module @my_module {
+  // CHECK: vm.rodata @aligned_buf dense<[0, 1, 2]> : tensor<3xi8> {alignment = 4096 : i64}
+  vm.rodata @aligned_buf dense<[0, 1, 2]> : tensor<3xi8> {alignment = 4096 : i64}
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_i64_zero
+  vm.func @const_i64_zero() -> i64 {
+    // CHECK: %zero = vm.const.i64.zero : i64
+    %zero = vm.const.i64.zero : i64
+    vm.return %zero : i64
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_i64
+  vm.func @const_i64() -> i64 {
+    // CHECK: %c4294967296 = vm.const.i64 4294967296
+    %c4294967296 = vm.const.i64 4294967296 : i64
+    vm.return %c4294967296 : i64
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f32_zero
+  vm.func @const_f32_zero() -> f32 {
+    // CHECK: %zero = vm.const.f32.zero : f32
+    %zero = vm.const.f32.zero : f32
+    vm.return %zero : f32
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f32
+  vm.func @const_f32() -> f32 {
+    // CHECK: %c = vm.const.f32 1.5{{.*}} : f32
+    %c = vm.const.f32 1.5 : f32
+    vm.return %c : f32
+  }
+}
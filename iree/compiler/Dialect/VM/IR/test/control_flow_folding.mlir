@@ -54,6 +54,61 @@ vm.module @cond_br_folds {
     vm.return %1 : i32
   }
 
+  // CHECK-LABEL: @fuse_cmp_cond_br
+  vm.func @fuse_cmp_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: vm.cond_br.cmp.lt.i32.s %arg0, %arg1, ^bb1(%arg0 : i32), ^bb2(%arg1 : i32)
+    %cmp = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %cmp, ^bb1(%arg0 : i32), ^bb2(%arg1 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  ^bb2(%1 : i32):
+    vm.return %1 : i32
+  }
+
+  // CHECK-LABEL: @fuse_swapped_cmp_cond_br
+  vm.func @fuse_swapped_cmp_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: vm.cond_br.cmp.lt.i32.u %arg1, %arg0, ^bb2(%arg1 : i32), ^bb1(%arg0 : i32)
+    %cmp = vm.cmp.lte.i32.u %arg0, %arg1 : i32
+    vm.cond_br %cmp, ^bb1(%arg0 : i32), ^bb2(%arg1 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  ^bb2(%1 : i32):
+    vm.return %1 : i32
+  }
+
+  // CHECK-LABEL: @fuse_ne_cmp_cond_br
+  vm.func @fuse_ne_cmp_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: vm.cond_br.cmp.eq.i32 %arg0, %arg1, ^bb2(%arg1 : i32), ^bb1(%arg0 : i32)
+    %cmp = vm.cmp.ne.i32 %arg0, %arg1 : i32
+    vm.cond_br %cmp, ^bb1(%arg0 : i32), ^bb2(%arg1 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  ^bb2(%1 : i32):
+    vm.return %1 : i32
+  }
+
+  // CHECK-LABEL: @no_fuse_multi_use_cmp_cond_br
+  vm.func @no_fuse_multi_use_cmp_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: %[[CMP:.+]] = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    // CHECK-NEXT: vm.cond_br %[[CMP]], ^bb1(%[[CMP]] : i32), ^bb1(%arg1 : i32)
+    %cmp = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %cmp, ^bb1(%cmp : i32), ^bb1(%arg1 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: @const_cond_br_cmp
+  vm.func @const_cond_br_cmp(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: vm.br ^bb1(%arg0 : i32)
+    %c1 = vm.const.i32 1 : i32
+    %c2 = vm.const.i32 2 : i32
+    vm.cond_br.cmp.lt.i32.s %c1, %c2, ^bb1(%arg0 : i32), ^bb2(%arg1 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  ^bb2(%1 : i32):
+    vm.return %1 : i32
+  }
+
   // CHECK-LABEL: @erase_unused_pure_call
   vm.func @erase_unused_pure_call(%arg0 : i32) {
     %0 = vm.call @nonvariadic_pure_func(%arg0) : (i32) -> i32
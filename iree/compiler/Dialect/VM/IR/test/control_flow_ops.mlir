@@ -54,6 +54,24 @@ vm.module @my_module {
 
 // -----
 
+// CHECK-LABEL: @cond_branch_cmp
+vm.module @my_module {
+  vm.func @cond_branch_cmp(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: vm.cond_br.cmp.eq.i32 %arg0, %arg1, ^bb1, ^bb2(%arg0 : i32)
+    vm.cond_br.cmp.eq.i32 %arg0, %arg1, ^bb1, ^bb2(%arg0 : i32)
+  ^bb1:
+    // CHECK: vm.cond_br.cmp.lt.i32.s %arg0, %arg1, ^bb2(%arg1 : i32), ^bb3
+    vm.cond_br.cmp.lt.i32.s %arg0, %arg1, ^bb2(%arg1 : i32), ^bb3
+  ^bb2(%0 : i32):
+    vm.return %0 : i32
+  ^bb3:
+    // CHECK: vm.cond_br.cmp.lt.i32.u %arg1, %arg0, ^bb2(%arg0 : i32), ^bb2(%arg1 : i32)
+    vm.cond_br.cmp.lt.i32.u %arg1, %arg0, ^bb2(%arg0 : i32), ^bb2(%arg1 : i32)
+  }
+}
+
+// -----
+
 // CHECK-LABEL: @call_fn
 vm.module @my_module {
   vm.import @import_fn(%arg0 : i32) -> i32
@@ -41,3 +41,24 @@ vm.module @ext_folds {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @ext_i64_folds
+vm.module @ext_i64_folds {
+  // CHECK-LABEL: @ext_i32_i64_u_const
+  vm.func @ext_i32_i64_u_const() -> i64 {
+    // CHECK: vm.const.i64 4294967295
+    %c = vm.const.i32 -1 : i32
+    %0 = vm.ext.i32.i64.u %c : i32 -> i64
+    vm.return %0 : i64
+  }
+
+  // CHECK-LABEL: @trunc_ext
+  vm.func @trunc_ext(%arg0 : i32) -> i32 {
+    // CHECK: vm.return %arg0 : i32
+    %0 = vm.ext.i32.i64.s %arg0 : i32 -> i64
+    %1 = vm.trunc.i64.i32 %0 : i64 -> i32
+    vm.return %1 : i32
+  }
+}
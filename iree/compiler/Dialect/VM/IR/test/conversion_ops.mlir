@@ -25,3 +25,31 @@ vm.module @my_module {
     vm.return %1 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @ext_i64
+vm.module @my_module {
+  vm.func @ext_i64(%arg0 : i32) -> i64 {
+    // CHECK: %0 = vm.ext.i32.i64.s %arg0 : i32 -> i64
+    %0 = vm.ext.i32.i64.s %arg0 : i32 -> i64
+    // CHECK-NEXT: %1 = vm.trunc.i64.i32 %0 : i64 -> i32
+    %1 = vm.trunc.i64.i32 %0 : i64 -> i32
+    // CHECK-NEXT: %2 = vm.ext.i32.i64.u %1 : i32 -> i64
+    %2 = vm.ext.i32.i64.u %1 : i32 -> i64
+    vm.return %2 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cast_f32
+vm.module @my_module {
+  vm.func @cast_f32(%arg0 : i32) -> i32 {
+    // CHECK: %0 = vm.cast.si32.f32 %arg0 : i32 -> f32
+    %0 = vm.cast.si32.f32 %arg0 : i32 -> f32
+    // CHECK-NEXT: %1 = vm.cast.f32.si32 %0 : f32 -> i32
+    %1 = vm.cast.f32.si32 %0 : f32 -> i32
+    vm.return %1 : i32
+  }
+}
@@ -14,6 +14,8 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeEncoder.h"
 
+#include <algorithm>
+
 #include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "iree/compiler/Dialect/VM/Analysis/RegisterAllocation.h"
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
@@ -103,6 +105,20 @@ class V0BytecodeEncoder : public BytecodeEncoder {
         return writeUint16(static_cast<uint16_t>(limitedValue));
       case 32:
         return writeUint32(static_cast<uint32_t>(limitedValue));
+      case 64:
+        return writeUint64(static_cast<uint64_t>(limitedValue));
+      default:
+        return currentOp_->emitOpError()
+               << "attribute of bitwidth " << bitWidth << " not supported";
+    }
+  }
+
+  LogicalResult encodeFloatAttr(FloatAttr value) override {
+    int bitWidth = value.getType().getIntOrFloatBitWidth();
+    APInt bits = value.getValue().bitcastToAPInt();
+    switch (bitWidth) {
+      case 32:
+        return writeUint32(static_cast<uint32_t>(bits.getZExtValue()));
       default:
         return currentOp_->emitOpError()
                << "attribute of bitwidth " << bitWidth << " not supported";
@@ -144,9 +160,20 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     // Compute required remappings - we only need to emit them when the source
     // and dest registers differ. Hopefully the allocator did a good job and
     // this list is small :)
+    //
+    // The list is split by register bank with all i32 moves preceding the ref
+    // moves so that the runtime can process each without per-register checks.
+    // The banks don't alias and the relative order of moves within each bank
+    // is preserved so the split retains the parallel move semantics.
     auto srcDstRegs = registerAllocation_->remapSuccessorRegisters(
         currentOp_, successorIndex);
+    auto refBegin = std::stable_partition(
+        srcDstRegs.begin(), srcDstRegs.end(),
+        [](std::pair<uint8_t, uint8_t> srcDstReg) {
+          return !isRefRegister(srcDstReg.first);
+        });
     writeUint8(srcDstRegs.size());
+    writeUint8(std::distance(srcDstRegs.begin(), refBegin));
     for (auto srcDstReg : srcDstRegs) {
       if (failed(writeUint8(srcDstReg.first)) ||
           failed(writeUint8(srcDstReg.second))) {
@@ -164,27 +191,66 @@ class V0BytecodeEncoder : public BytecodeEncoder {
   }
 
   LogicalResult encodeOperands(Operation::operand_range values) override {
-    writeUint8(std::distance(values.begin(), values.end()));
+    // 64-bit values occupy two adjacent registers and are listed as both.
+    int registerCount = 0;
+    for (auto value : values) {
+      registerCount += getRegisterSlotCount(value.getType());
+    }
+    if (registerCount > UINT8_MAX || failed(writeUint8(registerCount))) {
+      return currentOp_->emitOpError() << "operand list too large";
+    }
     for (auto it : llvm::enumerate(values)) {
       uint8_t reg = registerAllocation_->mapUseToRegister(
           it.value(), currentOp_, it.index());
-      if (failed(writeUint8(reg))) {
+      if (failed(writeRegisterSlots(reg, it.value().getType()))) {
         return failure();
       }
     }
     return success();
   }
 
+  LogicalResult encodeSplitOperands(Operation::operand_range values) override {
+    // Registers are listed i32 bank first (including both slots of 64-bit
+    // values) followed by the ref bank, preserving the relative order within
+    // each bank as that defines the argument ABI register assignment.
+    SmallVector<uint8_t, 8> i32Regs;
+    SmallVector<uint8_t, 8> refRegs;
+    for (auto it : llvm::enumerate(values)) {
+      uint8_t reg = registerAllocation_->mapUseToRegister(
+          it.value(), currentOp_, it.index());
+      if (isRefRegister(reg)) {
+        refRegs.push_back(reg);
+      } else {
+        for (int i = 0; i < getRegisterSlotCount(it.value().getType()); ++i) {
+          i32Regs.push_back(reg + i);
+        }
+      }
+    }
+    size_t registerCount = i32Regs.size() + refRegs.size();
+    if (registerCount > UINT8_MAX || failed(writeUint8(registerCount)) ||
+        failed(writeUint8(i32Regs.size()))) {
+      return currentOp_->emitOpError() << "operand list too large";
+    }
+    return failure(failed(writeBytes(i32Regs.data(), i32Regs.size())) ||
+                   failed(writeBytes(refRegs.data(), refRegs.size())));
+  }
+
   LogicalResult encodeResult(Value value) override {
     uint8_t reg = registerAllocation_->mapUseToRegister(value, currentOp_, 0);
     return writeUint8(reg);
   }
 
   LogicalResult encodeResults(Operation::result_range values) override {
-    writeUint8(std::distance(values.begin(), values.end()));
+    int registerCount = 0;
+    for (auto value : values) {
+      registerCount += getRegisterSlotCount(value.getType());
+    }
+    if (registerCount > UINT8_MAX || failed(writeUint8(registerCount))) {
+      return currentOp_->emitOpError() << "result list too large";
+    }
     for (auto value : values) {
       uint8_t reg = registerAllocation_->mapToRegister(value);
-      if (failed(writeUint8(reg))) {
+      if (failed(writeRegisterSlots(reg, value.getType()))) {
         return failure();
       }
     }
@@ -234,6 +300,20 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return writeBytes(&value, sizeof(value));
   }
 
+  LogicalResult writeUint64(uint64_t value) {
+    return writeBytes(&value, sizeof(value));
+  }
+
+  // Writes |reg| followed by any additional registers used by |type|.
+  LogicalResult writeRegisterSlots(uint8_t reg, Type type) {
+    for (int i = 0; i < getRegisterSlotCount(type); ++i) {
+      if (failed(writeUint8(reg + i))) {
+        return failure();
+      }
+    }
+    return success();
+  }
+
   LogicalResult fixupOffsets() {
     for (const auto &fixup : blockOffsetFixups_) {
       auto blockOffset = blockOffsets_.find(fixup.first);
@@ -257,6 +257,62 @@ static Offset<iree::vm::FunctionSignatureDef> makeFunctionSignatureDef(
 // fill the end of the file meaning that when memory-mapping the file most will
 // not need to be paged in to do the initial module preparation.
 //
+// Alignment of rodata segments that do not specify one in the module.
+static constexpr uint32_t kDefaultRodataAlignment = 16;
+
+// A rodata segment that has been written to the FlatBuffer.
+struct SerializedRodata {
+  Offset<Vector<uint8_t>> dataOffset;
+  uint32_t alignment = kDefaultRodataAlignment;
+  iree::vm::CompressionTypeDef compressionType =
+      iree::vm::CompressionTypeDef::NONE;
+  uint64_t uncompressedSize = 0;
+};
+
+// Serializes the contents of |rodataOp| into |fbb|, compressing it if allowed
+// by |targetOptions| and beneficial.
+static Optional<SerializedRodata> serializeRodata(
+    BytecodeTargetOptions targetOptions, IREE::VM::RodataOp rodataOp,
+    FlatBufferBuilder &fbb) {
+  SerializedRodata result;
+  result.alignment = std::max(
+      kDefaultRodataAlignment,
+      static_cast<uint32_t>(targetOptions.rodataAlignment));
+
+  // Segments requesting an explicit alignment are intended to be used in-place
+  // and are never compressed.
+  auto alignmentAttr = rodataOp.getAttrOfType<IntegerAttr>("alignment");
+  if (alignmentAttr) {
+    result.alignment = std::max(
+        result.alignment, static_cast<uint32_t>(alignmentAttr.getInt()));
+  } else if (targetOptions.rodataCompression ==
+             BytecodeRodataCompression::kRunLength) {
+    std::vector<uint8_t> bytes;
+    if (failed(serializeConstant(rodataOp.getLoc(), rodataOp.value(), bytes))) {
+      return llvm::None;
+    }
+    auto compressedBytes = compressRunLength(bytes);
+    // Only keep the compressed form when it saves at least 1/8th of the
+    // size; otherwise it is not worth losing the ability to map in-place.
+    if (compressedBytes.size() <= bytes.size() - bytes.size() / 8) {
+      result.compressionType =
+          iree::vm::CompressionTypeDef::RunLengthEncodedDataDef;
+      result.uncompressedSize = bytes.size();
+      result.dataOffset = fbb.CreateVector(compressedBytes);
+    } else {
+      fbb.ForceVectorAlignment(bytes.size(), sizeof(uint8_t),
+                               result.alignment);
+      result.dataOffset = fbb.CreateVector(bytes);
+    }
+    return result;
+  }
+
+  result.dataOffset = serializeConstant(rodataOp.getLoc(), rodataOp.value(),
+                                        result.alignment, fbb);
+  if (result.dataOffset.IsNull()) return llvm::None;
+  return result;
+}
+
 // To keep the actual BytecodeModuleDef and resulting parsing code simple a lot
 // has been packed into the top-level table. This results in a messier function
 // here during serialization but a much more trivial (and cache-friendly)
@@ -291,16 +347,15 @@ static Offset<iree::vm::BytecodeModuleDef> buildFlatBufferModule(
   // Serialize read-only data first so that it ends up at the end of the file.
   // This is where large things like parameters live and we don't want that to
   // get paged in until it is needed.
-  std::vector<Offset<Vector<uint8_t>>> rodataContentOffsets;
-  rodataContentOffsets.reserve(rodataOps.size());
+  std::vector<SerializedRodata> serializedRodatas;
+  serializedRodatas.reserve(rodataOps.size());
   for (auto rodataOp : rodataOps) {
-    auto dataOffset =
-        serializeConstant(rodataOp.getLoc(), rodataOp.value(), fbb);
-    if (dataOffset.IsNull()) {
+    auto serializedRodata = serializeRodata(targetOptions, rodataOp, fbb);
+    if (!serializedRodata.hasValue()) {
       rodataOp.emitOpError() << "failed to encode";
       return {};
     }
-    rodataContentOffsets.push_back(dataOffset);
+    serializedRodatas.push_back(serializedRodata.getValue());
   }
 
   // Find all types in the module to build the type table.
@@ -347,9 +402,23 @@ static Offset<iree::vm::BytecodeModuleDef> buildFlatBufferModule(
   // Serialize metadata that should be near the front of the file.
   std::vector<Offset<iree::vm::RodataSegmentDef>> rodataSegmentOffsets;
   rodataSegmentOffsets.reserve(rodataOps.size());
-  for (auto rodataContentOffset : rodataContentOffsets) {
+  for (auto &serializedRodata : serializedRodatas) {
+    Offset<void> compressionOffset;
+    if (serializedRodata.compressionType !=
+        iree::vm::CompressionTypeDef::NONE) {
+      compressionOffset = iree::vm::CreateRunLengthEncodedDataDef(
+                              fbb, serializedRodata.uncompressedSize)
+                              .Union();
+    }
     iree::vm::RodataSegmentDefBuilder rsd(fbb);
-    rsd.add_data(rodataContentOffset);
+    if (!compressionOffset.IsNull()) {
+      rsd.add_compression_type_type(serializedRodata.compressionType);
+      rsd.add_compression_type(compressionOffset);
+    }
+    if (serializedRodata.alignment != kDefaultRodataAlignment) {
+      rsd.add_alignment(serializedRodata.alignment);
+    }
+    rsd.add_data(serializedRodata.dataOffset);
     rodataSegmentOffsets.push_back(rsd.Finish());
   }
   std::vector<Offset<iree::vm::RwdataSegmentDef>> rwdataSegmentOffsets;
@@ -473,6 +542,15 @@ LogicalResult translateModuleToBytecode(IREE::VM::ModuleOp moduleOp,
     return success();
   }
 
+  if (targetOptions.rodataAlignment <= 0 ||
+      targetOptions.rodataAlignment > 4096 ||
+      (targetOptions.rodataAlignment & (targetOptions.rodataAlignment - 1))) {
+    return moduleOp.emitError()
+           << "rodata alignment must be a power of two no greater than 4096; "
+              "got "
+           << targetOptions.rodataAlignment;
+  }
+
   // NOTE: we order things so that all of the metadata is close to the start of
   // the module header in memory. This ensures that when we map the file only
   // the first few pages need to be accessed to get the metadata and the rest
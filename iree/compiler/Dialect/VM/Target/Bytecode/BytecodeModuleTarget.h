@@ -39,6 +39,15 @@ enum class BytecodeOutputFormat {
   kAnnotatedMlirText,
 };
 
+// Defines the compression applied to rodata segments.
+enum class BytecodeRodataCompression {
+  // All segments are stored uncompressed and can be used in-place.
+  kNone,
+  // Segments are run-length encoded when it reduces their size. Compressed
+  // segments are decoded into memory on first access at runtime.
+  kRunLength,
+};
+
 // Options that can be provided to bytecode translation.
 struct BytecodeTargetOptions {
   // Format of the module written to the output stream.
@@ -53,6 +62,14 @@ struct BytecodeTargetOptions {
   bool stripSourceMap = false;
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Default byte alignment of rodata segments. Segments may request a larger
+  // alignment with the vm.rodata alignment attribute.
+  int rodataAlignment = 16;
+  // Compression applied to rodata segments that do not request an explicit
+  // alignment. Explicitly aligned segments are always left uncompressed.
+  BytecodeRodataCompression rodataCompression =
+      BytecodeRodataCompression::kNone;
 };
 
 // Translates a vm.module to a bytecode module flatbuffer.
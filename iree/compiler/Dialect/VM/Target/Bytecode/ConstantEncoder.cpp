@@ -15,6 +15,8 @@
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ConstantEncoder.h"
 
 #include "flatbuffers/flatbuffers.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/StandardTypes.h"
@@ -34,110 +36,168 @@ using flatbuffers::Vector;
 
 // TODO(benvanik): switch to LLVM's BinaryStreamWriter to handle endianness.
 
-static Offset<Vector<uint8_t>> serializeConstantI8Array(
-    DenseIntElementsAttr attr, FlatBufferBuilder &fbb) {
-  uint8_t *bytePtr = nullptr;
-  auto byteVector =
-      fbb.CreateUninitializedVector(attr.getNumElements() * 1, &bytePtr);
+static void serializeConstantI8Array(DenseIntElementsAttr attr,
+                                     uint8_t *bytePtr) {
   for (APInt value : attr.getIntValues()) {
     *(bytePtr++) = value.extractBitsAsZExtValue(8, 0) & UINT8_MAX;
   }
-  return byteVector;
 }
 
-static Offset<Vector<uint8_t>> serializeConstantI16Array(
-    DenseIntElementsAttr attr, FlatBufferBuilder &fbb) {
-  uint8_t *bytePtr = nullptr;
-  auto byteVector =
-      fbb.CreateUninitializedVector(attr.getNumElements() * 2, &bytePtr);
+static void serializeConstantI16Array(DenseIntElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint16_t *nativePtr = reinterpret_cast<uint16_t *>(bytePtr);
   for (APInt value : attr.getIntValues()) {
     *(nativePtr++) = value.extractBitsAsZExtValue(16, 0) & UINT16_MAX;
   }
-  return byteVector;
 }
 
-static Offset<Vector<uint8_t>> serializeConstantI32Array(
-    DenseIntElementsAttr attr, FlatBufferBuilder &fbb) {
-  uint8_t *bytePtr = nullptr;
-  auto byteVector =
-      fbb.CreateUninitializedVector(attr.getNumElements() * 4, &bytePtr);
+static void serializeConstantI32Array(DenseIntElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint32_t *nativePtr = reinterpret_cast<uint32_t *>(bytePtr);
   for (APInt value : attr.getIntValues()) {
     *(nativePtr++) = value.extractBitsAsZExtValue(32, 0) & UINT32_MAX;
   }
-  return byteVector;
 }
 
-static Offset<Vector<uint8_t>> serializeConstantI64Array(
-    DenseIntElementsAttr attr, FlatBufferBuilder &fbb) {
-  uint8_t *bytePtr = nullptr;
-  auto byteVector =
-      fbb.CreateUninitializedVector(attr.getNumElements() * 8, &bytePtr);
+static void serializeConstantI64Array(DenseIntElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint64_t *nativePtr = reinterpret_cast<uint64_t *>(bytePtr);
   for (APInt value : attr.getIntValues()) {
     *(nativePtr++) = value.extractBitsAsZExtValue(64, 0) & UINT64_MAX;
   }
-  return byteVector;
 }
 
-static Offset<Vector<uint8_t>> serializeConstantF32Array(
-    DenseFPElementsAttr attr, FlatBufferBuilder &fbb) {
-  uint8_t *bytePtr = nullptr;
-  auto byteVector =
-      fbb.CreateUninitializedVector(attr.getNumElements() * 4, &bytePtr);
+static void serializeConstantF32Array(DenseFPElementsAttr attr,
+                                      uint8_t *bytePtr) {
   float *nativePtr = reinterpret_cast<float *>(bytePtr);
   for (APFloat value : attr.getFloatValues()) {
     *(nativePtr++) = value.convertToFloat();
   }
-  return byteVector;
 }
 
-static Offset<Vector<uint8_t>> serializeConstantF64Array(
-    DenseFPElementsAttr attr, FlatBufferBuilder &fbb) {
-  uint8_t *bytePtr = nullptr;
-  auto byteVector =
-      fbb.CreateUninitializedVector(attr.getNumElements() * 8, &bytePtr);
+static void serializeConstantF64Array(DenseFPElementsAttr attr,
+                                      uint8_t *bytePtr) {
   double *nativePtr = reinterpret_cast<double *>(bytePtr);
   for (APFloat value : attr.getFloatValues()) {
     *(nativePtr++) = value.convertToDouble();
   }
-  return byteVector;
 }
 
-Offset<Vector<uint8_t>> serializeConstant(Location loc,
-                                          ElementsAttr elementsAttr,
-                                          FlatBufferBuilder &fbb) {
+// Returns the total serialized byte length of |elementsAttr| or None if the
+// attribute cannot be serialized (with an error emitted at |loc|).
+static Optional<size_t> getConstantByteLength(Location loc,
+                                              ElementsAttr elementsAttr) {
   if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
       case 8:
-        return serializeConstantI8Array(attr, fbb);
       case 16:
-        return serializeConstantI16Array(attr, fbb);
       case 32:
-        return serializeConstantI32Array(attr, fbb);
       case 64:
-        return serializeConstantI64Array(attr, fbb);
+        return attr.getNumElements() *
+               (attr.getType().getElementTypeBitWidth() / 8);
       default:
         emitError(loc) << "unhandled element bitwidth "
                        << attr.getType().getElementTypeBitWidth();
-        return {};
+        return llvm::None;
     }
   } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
       case 32:
-        return serializeConstantF32Array(attr, fbb);
       case 64:
-        return serializeConstantF64Array(attr, fbb);
+        return attr.getNumElements() *
+               (attr.getType().getElementTypeBitWidth() / 8);
       default:
         emitError(loc) << "unhandled element bitwidth "
                        << attr.getType().getElementTypeBitWidth();
-        return {};
+        return llvm::None;
     }
   }
   emitError(loc) << "unimplemented attribute encoding: "
                  << elementsAttr.getType();
-  return {};
+  return llvm::None;
+}
+
+// Writes |elementsAttr| to |bytePtr|, which must have storage for at least
+// getConstantByteLength bytes.
+static void serializeConstantData(ElementsAttr elementsAttr,
+                                  uint8_t *bytePtr) {
+  if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
+    switch (attr.getType().getElementTypeBitWidth()) {
+      case 8:
+        return serializeConstantI8Array(attr, bytePtr);
+      case 16:
+        return serializeConstantI16Array(attr, bytePtr);
+      case 32:
+        return serializeConstantI32Array(attr, bytePtr);
+      case 64:
+        return serializeConstantI64Array(attr, bytePtr);
+    }
+  } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
+    switch (attr.getType().getElementTypeBitWidth()) {
+      case 32:
+        return serializeConstantF32Array(attr, bytePtr);
+      case 64:
+        return serializeConstantF64Array(attr, bytePtr);
+    }
+  }
+  llvm_unreachable("unhandled constant type; must be checked first");
+}
+
+Offset<Vector<uint8_t>> serializeConstant(Location loc,
+                                          ElementsAttr elementsAttr,
+                                          size_t alignment,
+                                          FlatBufferBuilder &fbb) {
+  auto byteLength = getConstantByteLength(loc, elementsAttr);
+  if (!byteLength.hasValue()) return {};
+  fbb.ForceVectorAlignment(byteLength.getValue(), sizeof(uint8_t), alignment);
+  uint8_t *bytePtr = nullptr;
+  auto byteVector =
+      fbb.CreateUninitializedVector(byteLength.getValue(), &bytePtr);
+  serializeConstantData(elementsAttr, bytePtr);
+  return byteVector;
+}
+
+LogicalResult serializeConstant(Location loc, ElementsAttr elementsAttr,
+                                std::vector<uint8_t> &bytes) {
+  auto byteLength = getConstantByteLength(loc, elementsAttr);
+  if (!byteLength.hasValue()) return failure();
+  bytes.resize(byteLength.getValue());
+  serializeConstantData(elementsAttr, bytes.data());
+  return success();
+}
+
+std::vector<uint8_t> compressRunLength(ArrayRef<uint8_t> data) {
+  // Runs of 3 or more bytes are encoded as repeats and everything else is
+  // gathered into literal spans. Both are limited to 128 bytes.
+  static constexpr size_t kMaxSpanLength = 128;
+  auto runLengthAt = [&](size_t i) {
+    size_t length = 1;
+    while (i + length < data.size() && length < kMaxSpanLength &&
+           data[i + length] == data[i]) {
+      ++length;
+    }
+    return length;
+  };
+  std::vector<uint8_t> result;
+  result.reserve(data.size() / 2);
+  size_t i = 0;
+  while (i < data.size()) {
+    size_t runLength = runLengthAt(i);
+    if (runLength >= 3) {
+      result.push_back(static_cast<uint8_t>(257 - runLength));
+      result.push_back(data[i]);
+      i += runLength;
+      continue;
+    }
+    size_t literalStart = i;
+    while (i < data.size() && i - literalStart < kMaxSpanLength &&
+           runLengthAt(i) < 3) {
+      ++i;
+    }
+    result.push_back(static_cast<uint8_t>(i - literalStart - 1));
+    result.insert(result.end(), data.begin() + literalStart, data.begin() + i);
+  }
+  return result;
 }
 
 }  // namespace VM
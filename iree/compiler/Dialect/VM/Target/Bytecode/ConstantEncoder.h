@@ -15,9 +15,13 @@
 #ifndef IREE_COMPILER_DIALECT_VM_TARGET_BYTECODE_CONSTANTENCODER_H_
 #define IREE_COMPILER_DIALECT_VM_TARGET_BYTECODE_CONSTANTENCODER_H_
 
+#include <vector>
+
 #include "flatbuffers/flatbuffers.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Location.h"
+#include "mlir/Support/LogicalResult.h"
 
 namespace mlir {
 namespace iree_compiler {
@@ -25,10 +29,20 @@ namespace IREE {
 namespace VM {
 
 // Serializes a constant attribute to the FlatBuffer as a binary blob.
+// The blob contents will be aligned to |alignment| bytes relative to the end
+// of the FlatBuffer (which becomes the start once finished).
 flatbuffers::Offset<flatbuffers::Vector<uint8_t>> serializeConstant(
-    Location loc, ElementsAttr elementsAttr,
+    Location loc, ElementsAttr elementsAttr, size_t alignment,
     flatbuffers::FlatBufferBuilder &fbb);
 
+// Serializes a constant attribute into |bytes| as a binary blob.
+LogicalResult serializeConstant(Location loc, ElementsAttr elementsAttr,
+                                std::vector<uint8_t> &bytes);
+
+// Compresses |data| with the PackBits run-length encoding used by
+// RunLengthEncodedDataDef.
+std::vector<uint8_t> compressRunLength(ArrayRef<uint8_t> data);
+
 }  // namespace VM
 }  // namespace IREE
 }  // namespace iree_compiler
@@ -66,6 +66,23 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<int> rodataAlignmentFlag{
+    "iree-vm-bytecode-module-rodata-alignment",
+    llvm::cl::desc("Default byte alignment of rodata segments (up to 4096)"),
+    llvm::cl::init(16),
+};
+
+static llvm::cl::opt<BytecodeRodataCompression> rodataCompressionFlag{
+    "iree-vm-bytecode-module-rodata-compression",
+    llvm::cl::desc("Compression applied to unaligned rodata segments"),
+    llvm::cl::init(BytecodeRodataCompression::kNone),
+    llvm::cl::values(
+        clEnumValN(BytecodeRodataCompression::kNone, "none",
+                   "Uncompressed; segments are used in-place"),
+        clEnumValN(BytecodeRodataCompression::kRunLength, "rle",
+                   "Run-length encoded; decoded on first access")),
+};
+
 BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   BytecodeTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
@@ -73,6 +90,8 @@ BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   targetOptions.stripSymbols = stripSymbolsFlag;
   targetOptions.stripSourceMap = stripSourceMapFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.rodataAlignment = rodataAlignmentFlag;
+  targetOptions.rodataCompression = rodataCompressionFlag;
   return targetOptions;
 }
 
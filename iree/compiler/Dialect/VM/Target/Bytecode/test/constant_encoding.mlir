@@ -18,3 +18,18 @@ vm.module @constants {
   // CHECK: data: [ 0, 0, 128, 63, 0, 0, 128, 63, 0, 0, 128, 63 ]
   vm.rodata @splat_float32s dense<1.000000e+00> : tensor<3xf32>
 }
+
+// -----
+
+// CHECK: name: "aligned_constants"
+vm.module @aligned_constants {
+  vm.export @func
+  vm.func @func() {
+    vm.return
+  }
+
+  // CHECK: rodata_segments: [ {
+  // CHECK: alignment: 4096,
+  // CHECK: data: [ 1, 2, 3 ]
+  vm.rodata @page_aligned dense<[1, 2, 3]> : tensor<3xi8> {alignment = 4096 : i64}
+}
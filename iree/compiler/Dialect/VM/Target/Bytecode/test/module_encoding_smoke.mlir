@@ -22,3 +22,21 @@ vm.module @simple_module {
   // CHECK-NEXT: ref_register_count: 0
   // CHECK: bytecode_data: [ 84, 1, 0 ]
 }
+
+// -----
+
+// CHECK: name: "i64_module"
+vm.module @i64_module {
+  vm.export @func
+  vm.func @func(%arg0 : i64) -> i64 {
+    vm.return %arg0 : i64
+  }
+
+  // i64 values occupy a register pair and both registers are encoded.
+  // CHECK: function_descriptors:
+  // CHECK-NEXT: bytecode_offset: 0
+  // CHECK-NEXT: bytecode_length: 4
+  // CHECK-NEXT: i32_register_count: 2
+  // CHECK-NEXT: ref_register_count: 0
+  // CHECK: bytecode_data: [ 84, 2, 0, 1 ]
+}
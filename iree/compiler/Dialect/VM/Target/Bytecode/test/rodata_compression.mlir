@@ -0,0 +1,28 @@
+// RUN: iree-translate -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-output-format=flatbuffer-text -iree-vm-bytecode-module-rodata-compression=rle %s | IreeFileCheck %s
+
+// CHECK: name: "compressed_constants"
+vm.module @compressed_constants {
+  vm.export @func
+  vm.func @func() {
+    vm.return
+  }
+
+  // CHECK: rodata_segments: [ {
+  // CHECK: compression_type_type: RunLengthEncodedDataDef,
+  // CHECK: uncompressed_size: 64
+  // CHECK: data: [ 193, 0 ]
+  vm.rodata @zeros dense<0> : tensor<64xi8>
+
+  // Incompressible data is stored as-is.
+  // CHECK: }, {
+  // CHECK-NOT: compression_type_type
+  // CHECK: data: [ 1, 2, 3 ]
+  vm.rodata @dense_i8s dense<[1, 2, 3]> : tensor<3xi8>
+
+  // Explicitly aligned segments are never compressed.
+  // CHECK: }, {
+  // CHECK-NOT: compression_type_type
+  // CHECK: alignment: 64,
+  // CHECK: data: [ 0, 0, 0, 0, 0, 0, 0, 0 ]
+  vm.rodata @aligned_zeros dense<0> : tensor<8xi8> {alignment = 64 : i64}
+}
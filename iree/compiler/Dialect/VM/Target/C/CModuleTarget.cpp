@@ -0,0 +1,1269 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/VM/Target/C/CModuleTarget.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
+#include "iree/compiler/Dialect/VM/IR/VMDialect.h"
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "iree/compiler/Dialect/VM/IR/VMTypes.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Format.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Module.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/Passes.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+namespace {
+
+// Module-level symbols indexed by ordinal along with the C identifiers used
+// for them in the emitted source.
+struct ModuleSymbols {
+  // Prefix of all emitted identifiers, derived from the module name.
+  std::string prefix;
+
+  std::vector<IREE::VM::ImportOp> importFuncOps;
+  std::vector<IREE::VM::ExportOp> exportFuncOps;
+  std::vector<IREE::VM::FuncOp> internalFuncOps;
+  std::vector<IREE::VM::RodataOp> rodataOps;
+  int globalBytes = 0;
+  int globalRefs = 0;
+
+  // C function identifier of each internal function, indexed by ordinal.
+  std::vector<std::string> funcIdentifiers;
+};
+
+// Binary ops lowered to `result = (resultType)((operandType)lhs OP
+// (operandType)rhs)`. Two's complement wrapping arithmetic is performed on
+// unsigned types to avoid undefined behavior on overflow.
+struct BinaryOpInfo {
+  const char *name;
+  const char *operandType;
+  const char *op;
+  const char *resultType;
+};
+const BinaryOpInfo kBinaryOps[] = {
+    {"add.i32", "uint32_t", "+", "int32_t"},
+    {"sub.i32", "uint32_t", "-", "int32_t"},
+    {"mul.i32", "uint32_t", "*", "int32_t"},
+    {"div.i32.s", "int32_t", "/", "int32_t"},
+    {"div.i32.u", "uint32_t", "/", "int32_t"},
+    {"rem.i32.s", "int32_t", "%", "int32_t"},
+    {"rem.i32.u", "uint32_t", "%", "int32_t"},
+    {"and.i32", "uint32_t", "&", "int32_t"},
+    {"or.i32", "uint32_t", "|", "int32_t"},
+    {"xor.i32", "uint32_t", "^", "int32_t"},
+    {"add.i64", "uint64_t", "+", "int64_t"},
+    {"sub.i64", "uint64_t", "-", "int64_t"},
+    {"mul.i64", "uint64_t", "*", "int64_t"},
+    {"div.i64.s", "int64_t", "/", "int64_t"},
+    {"div.i64.u", "uint64_t", "/", "int64_t"},
+    {"rem.i64.s", "int64_t", "%", "int64_t"},
+    {"rem.i64.u", "uint64_t", "%", "int64_t"},
+    {"and.i64", "uint64_t", "&", "int64_t"},
+    {"or.i64", "uint64_t", "|", "int64_t"},
+    {"xor.i64", "uint64_t", "^", "int64_t"},
+    {"add.f32", "float", "+", "float"},
+    {"sub.f32", "float", "-", "float"},
+    {"mul.f32", "float", "*", "float"},
+    {"div.f32", "float", "/", "float"},
+    {"cmp.eq.i32", "int32_t", "==", "int32_t"},
+    {"cmp.ne.i32", "int32_t", "!=", "int32_t"},
+    {"cmp.lt.i32.s", "int32_t", "<", "int32_t"},
+    {"cmp.lt.i32.u", "uint32_t", "<", "int32_t"},
+    {"cmp.lte.i32.s", "int32_t", "<=", "int32_t"},
+    {"cmp.lte.i32.u", "uint32_t", "<=", "int32_t"},
+    {"cmp.gt.i32.s", "int32_t", ">", "int32_t"},
+    {"cmp.gt.i32.u", "uint32_t", ">", "int32_t"},
+    {"cmp.gte.i32.s", "int32_t", ">=", "int32_t"},
+    {"cmp.gte.i32.u", "uint32_t", ">=", "int32_t"},
+    {"cmp.eq.i64", "int64_t", "==", "int32_t"},
+    {"cmp.ne.i64", "int64_t", "!=", "int32_t"},
+    {"cmp.lt.i64.s", "int64_t", "<", "int32_t"},
+    {"cmp.lt.i64.u", "uint64_t", "<", "int32_t"},
+    {"cmp.lte.i64.s", "int64_t", "<=", "int32_t"},
+    {"cmp.lte.i64.u", "uint64_t", "<=", "int32_t"},
+    {"cmp.gt.i64.s", "int64_t", ">", "int32_t"},
+    {"cmp.gt.i64.u", "uint64_t", ">", "int32_t"},
+    {"cmp.gte.i64.s", "int64_t", ">=", "int32_t"},
+    {"cmp.gte.i64.u", "uint64_t", ">=", "int32_t"},
+    {"cmp.eq.f32", "float", "==", "int32_t"},
+    {"cmp.ne.f32", "float", "!=", "int32_t"},
+    {"cmp.lt.f32", "float", "<", "int32_t"},
+    {"cmp.lte.f32", "float", "<=", "int32_t"},
+    {"cmp.gt.f32", "float", ">", "int32_t"},
+    {"cmp.gte.f32", "float", ">=", "int32_t"},
+};
+
+// Unary ops lowered to `result = (resultType)(OP((operandType)operand))`.
+// Casts use an empty OP.
+struct UnaryOpInfo {
+  const char *name;
+  const char *operandType;
+  const char *op;
+  const char *resultType;
+};
+const UnaryOpInfo kUnaryOps[] = {
+    {"not.i32", "uint32_t", "~", "int32_t"},
+    {"not.i64", "uint64_t", "~", "int64_t"},
+    {"trunc.i8", "uint8_t", "", "int32_t"},
+    {"trunc.i16", "uint16_t", "", "int32_t"},
+    {"ext.i8.i32.s", "int8_t", "", "int32_t"},
+    {"ext.i16.i32.s", "int16_t", "", "int32_t"},
+    {"ext.i32.i64.s", "int32_t", "", "int64_t"},
+    {"ext.i32.i64.u", "uint32_t", "", "int64_t"},
+    {"trunc.i64.i32", "uint64_t", "", "int32_t"},
+    {"cast.si32.f32", "int32_t", "", "float"},
+    {"cast.f32.si32", "float", "", "int32_t"},
+};
+
+// Shifts lowered to `result = (resultType)((operandType)operand OP amount)`.
+const BinaryOpInfo kShiftOps[] = {
+    {"shl.i32", "uint32_t", "<<", "int32_t"},
+    {"shr.i32.s", "int32_t", ">>", "int32_t"},
+    {"shr.i32.u", "uint32_t", ">>", "int32_t"},
+    {"shl.i64", "uint64_t", "<<", "int64_t"},
+    {"shr.i64.s", "int64_t", ">>", "int64_t"},
+    {"shr.i64.u", "uint64_t", ">>", "int64_t"},
+};
+
+// Fused compare-and-branch ops lowered to `if ((operandType)lhs OP
+// (operandType)rhs)`.
+const BinaryOpInfo kCondBranchCmpOps[] = {
+    {"cond_br.cmp.eq.i32", "int32_t", "==", ""},
+    {"cond_br.cmp.lt.i32.s", "int32_t", "<", ""},
+    {"cond_br.cmp.lt.i32.u", "uint32_t", "<", ""},
+};
+
+template <typename T, size_t N>
+const T *lookupOpInfo(const T (&table)[N], StringRef name) {
+  for (const auto &info : table) {
+    if (name == info.name) return &info;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+// Returns |name| with all characters that are not valid in C identifiers
+// replaced with underscores.
+static std::string makeCIdentifier(StringRef name) {
+  std::string result;
+  result.reserve(name.size() + 1);
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    result.push_back('_');
+  }
+  for (char c : name) {
+    result.push_back(std::isalnum(static_cast<unsigned char>(c)) ? c : '_');
+  }
+  return result;
+}
+
+// Returns |str| as a quoted C string literal.
+static std::string makeCStringLiteral(StringRef str) {
+  std::string result = "\"";
+  llvm::raw_string_ostream os(result);
+  for (unsigned char c : str) {
+    if (c == '\\' || c == '"') {
+      os << '\\' << c;
+    } else if (std::isprint(c)) {
+      os << c;
+    } else {
+      os << llvm::format("\\%03o", c);
+    }
+  }
+  os << '"';
+  return os.str();
+}
+
+static bool isRefType(Type type) { return type.isa<IREE::VM::RefType>(); }
+
+// Returns the C type used to hold values of |type| or an empty string if the
+// type cannot be represented.
+static StringRef getCType(Type type) {
+  if (isRefType(type)) return "iree_vm_ref_t";
+  if (type.isa<IREE::PtrType>()) return "int32_t";
+  if (type.isInteger(32)) return "int32_t";
+  if (type.isInteger(64)) return "int64_t";
+  if (type.isF32()) return "float";
+  return "";
+}
+
+// Returns the number of i32 registers used to pass a primitive of |type| across
+// the module ABI. 64-bit values occupy a (lo, hi) register pair.
+static int getI32RegisterSlotCount(Type type) {
+  return type.isInteger(64) ? 2 : 1;
+}
+
+// Returns the frame accessor suffix (iree_vm_c_get_<suffix>) for |type|.
+static StringRef getRegisterAccessorSuffix(Type type) {
+  if (type.isInteger(64)) return "i64";
+  if (type.isF32()) return "f32";
+  return "i32";
+}
+
+// Returns the ordinal assigned to the symbol |name| referenced from |op|.
+static Optional<int32_t> lookupSymbolOrdinal(SymbolTable &symbolTable,
+                                             Operation *op, StringRef name) {
+  auto *symbolOp = symbolTable.lookup(name);
+  if (!symbolOp) {
+    op->emitOpError() << "target symbol not found: " << name;
+    return llvm::None;
+  }
+  auto ordinalAttr = symbolOp->getAttrOfType<IntegerAttr>("ordinal");
+  if (!ordinalAttr) {
+    symbolOp->emitOpError() << "missing ordinal";
+    return llvm::None;
+  }
+  return static_cast<int32_t>(ordinalAttr.getInt());
+}
+
+// Canonicalizes the module to its final form prior to emission.
+// This verifies that we only have ops we can emit and performs any of the
+// required transformations (such as debug op stripping).
+static LogicalResult canonicalizeModule(CTargetOptions targetOptions,
+                                        IREE::VM::ModuleOp moduleOp) {
+  OwningRewritePatternList patterns;
+  ConversionTarget target(*moduleOp.getContext());
+  target.addLegalDialect<IREE::VM::VMDialect>();
+
+  if (targetOptions.stripDebugOps) {
+    // TODO(benvanik): add RemoveDisabledDebugOp pattern.
+    target.addIllegalOp<IREE::VM::TraceOp, IREE::VM::PrintOp, IREE::VM::BreakOp,
+                        IREE::VM::CondBreakOp>();
+  }
+
+  if (failed(applyFullConversion(moduleOp, target, patterns))) {
+    return moduleOp.emitError() << "unable to fully apply conversion to module";
+  }
+
+  PassManager passManager(moduleOp.getContext());
+  auto &modulePasses = passManager.nest<IREE::VM::ModuleOp>();
+
+  if (targetOptions.optimize) {
+    modulePasses.addPass(mlir::createInlinerPass());
+    modulePasses.addPass(mlir::createCSEPass());
+    modulePasses.addPass(mlir::createCanonicalizerPass());
+  }
+
+  // Ordinals index the tables in the emitted module def and globals are
+  // addressed by their ordinals just as in bytecode modules.
+  modulePasses.addPass(IREE::VM::createOrdinalAllocationPass());
+
+  if (failed(passManager.run(moduleOp.getParentOfType<mlir::ModuleOp>()))) {
+    return moduleOp.emitError() << "failed during transform passes";
+  }
+
+  return success();
+}
+
+// Gathers the module-level symbols of |moduleOp| in ordinal order.
+//
+// Preconditions:
+//  - OrdinalAllocationPass has run on the module
+//  - All ordinals start from 0 and are contiguous
+static ModuleSymbols gatherModuleSymbols(CTargetOptions targetOptions,
+                                         IREE::VM::ModuleOp moduleOp) {
+  ModuleSymbols symbols;
+  symbols.prefix = makeCIdentifier(
+      moduleOp.sym_name().empty() ? "module" : moduleOp.sym_name());
+
+  auto getOrdinal = [](Operation *op) {
+    return op->getAttrOfType<IntegerAttr>("ordinal").getInt();
+  };
+  auto place = [](auto &ops, int64_t ordinal, auto op) {
+    if (static_cast<int64_t>(ops.size()) <= ordinal) ops.resize(ordinal + 1);
+    ops[ordinal] = op;
+  };
+  for (auto &op : moduleOp.getBlock().getOperations()) {
+    if (auto funcOp = dyn_cast<IREE::VM::FuncOp>(op)) {
+      place(symbols.internalFuncOps, getOrdinal(&op), funcOp);
+    } else if (auto exportOp = dyn_cast<IREE::VM::ExportOp>(op)) {
+      place(symbols.exportFuncOps, getOrdinal(&op), exportOp);
+    } else if (auto importOp = dyn_cast<IREE::VM::ImportOp>(op)) {
+      place(symbols.importFuncOps, getOrdinal(&op), importOp);
+    } else if (auto rodataOp = dyn_cast<IREE::VM::RodataOp>(op)) {
+      place(symbols.rodataOps, getOrdinal(&op), rodataOp);
+    } else if (isa<IREE::VM::GlobalI32Op>(op)) {
+      symbols.globalBytes =
+          std::max(symbols.globalBytes, static_cast<int>(getOrdinal(&op) +
+                                                         sizeof(int32_t)));
+    } else if (isa<IREE::VM::GlobalRefOp>(op)) {
+      ++symbols.globalRefs;
+    }
+  }
+
+  // Function identifiers must be unique even if sanitizing the names collides.
+  llvm::StringSet<> usedIdentifiers;
+  for (auto funcOp : llvm::enumerate(symbols.internalFuncOps)) {
+    std::string identifier =
+        symbols.prefix + "_" + makeCIdentifier(funcOp.value().getName());
+    if (targetOptions.stripSymbols ||
+        !usedIdentifiers.insert(identifier).second) {
+      identifier = symbols.prefix + "_func_" + std::to_string(funcOp.index());
+    }
+    symbols.funcIdentifiers.push_back(identifier);
+  }
+
+  return symbols;
+}
+
+// Serializes the contents of a rodata segment into |bytes| in the same layout
+// used by bytecode modules.
+static LogicalResult serializeRodata(IREE::VM::RodataOp rodataOp,
+                                     std::vector<uint8_t> &bytes) {
+  auto elementsAttr = rodataOp.value();
+  auto appendBits = [&](uint64_t bits, int byteWidth) {
+    // TODO(benvanik): handle big-endian hosts.
+    for (int i = 0; i < byteWidth; ++i) {
+      bytes.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+    }
+  };
+  if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
+    int bitWidth = attr.getType().getElementTypeBitWidth();
+    if (bitWidth != 8 && bitWidth != 16 && bitWidth != 32 && bitWidth != 64) {
+      return rodataOp.emitOpError()
+             << "unhandled element bitwidth " << bitWidth;
+    }
+    for (APInt value : attr.getIntValues()) {
+      appendBits(value.extractBitsAsZExtValue(bitWidth, 0), bitWidth / 8);
+    }
+    return success();
+  } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
+    int bitWidth = attr.getType().getElementTypeBitWidth();
+    if (bitWidth != 32 && bitWidth != 64) {
+      return rodataOp.emitOpError()
+             << "unhandled element bitwidth " << bitWidth;
+    }
+    for (APFloat value : attr.getFloatValues()) {
+      appendBits(value.bitcastToAPInt().getZExtValue(), bitWidth / 8);
+    }
+    return success();
+  }
+  return rodataOp.emitOpError()
+         << "unimplemented attribute encoding: " << elementsAttr.getType();
+}
+
+namespace {
+
+// Emits a single vm.func as a C function.
+//
+// SSA values and block arguments are mapped to C locals declared at the top of
+// the function and blocks become labels. Ref locals hold a retained reference
+// that is released when the local is reassigned or the function returns;
+// unlike the bytecode interpreter there is no move analysis and values may be
+// kept alive until the end of the function.
+class FunctionEmitter {
+ public:
+  FunctionEmitter(ModuleSymbols &symbols, SymbolTable &symbolTable,
+                  IREE::VM::FuncOp funcOp, llvm::raw_ostream &os)
+      : symbols_(symbols),
+        symbolTable_(symbolTable),
+        funcOp_(funcOp),
+        os_(os) {}
+
+  // Emits the prototype of the function identified by |identifier|.
+  static LogicalResult emitPrototype(IREE::VM::FuncOp funcOp,
+                                     StringRef identifier,
+                                     llvm::raw_ostream &os) {
+    auto functionType = funcOp.getType();
+    os << "static iree_status_t " << identifier
+       << "(\n    iree_vm_stack_t* stack, iree_vm_c_module_state_t* state";
+    for (auto input : llvm::enumerate(functionType.getInputs())) {
+      StringRef cType = getCType(input.value());
+      if (cType.empty()) {
+        return funcOp.emitError()
+               << "argument " << input.index() << " type " << input.value()
+               << " not supported by the C target";
+      }
+      os << ",\n    " << cType << (isRefType(input.value()) ? "* a" : " a")
+         << input.index();
+    }
+    for (auto result : llvm::enumerate(functionType.getResults())) {
+      StringRef cType = getCType(result.value());
+      if (cType.empty()) {
+        return funcOp.emitError()
+               << "result " << result.index() << " type " << result.value()
+               << " not supported by the C target";
+      }
+      os << ",\n    " << cType << "* r" << result.index();
+    }
+    os << ")";
+    return success();
+  }
+
+  LogicalResult emit(StringRef identifier) {
+    if (failed(emitPrototype(funcOp_, identifier, os_))) return failure();
+    os_ << " {\n";
+    os_ << "  iree_status_t status = IREE_STATUS_OK;\n";
+
+    // Declare locals for all values.
+    for (auto &block : funcOp_.getBlocks()) {
+      for (auto arg : block.getArguments()) {
+        if (failed(declareLocal(arg))) return failure();
+      }
+      for (auto &op : block.getOperations()) {
+        for (auto result : op.getResults()) {
+          if (failed(declareLocal(result))) return failure();
+        }
+        for (int i = 0; i < op.getNumSuccessors(); ++i) {
+          branchTargets_.insert(op.getSuccessor(i));
+        }
+      }
+    }
+
+    // Copy arguments into the entry block locals.
+    auto &entryBlock = funcOp_.getBlocks().front();
+    for (auto arg : llvm::enumerate(entryBlock.getArguments())) {
+      if (isRefType(arg.value().getType())) {
+        os_ << "  iree_vm_c_ref_assign(a" << arg.index() << ", &"
+            << getName(arg.value()) << ");\n";
+      } else {
+        os_ << "  " << getName(arg.value()) << " = a" << arg.index() << ";\n";
+      }
+    }
+
+    int blockOrdinal = 0;
+    for (auto &block : funcOp_.getBlocks()) {
+      blockLabels_[&block] = "bb" + std::to_string(blockOrdinal++);
+    }
+    for (auto &block : funcOp_.getBlocks()) {
+      if (branchTargets_.count(&block)) {
+        os_ << blockLabels_[&block] << ":\n";
+      }
+      for (auto &op : block.getOperations()) {
+        if (failed(emitOp(&op))) return failure();
+      }
+    }
+
+    os_ << "cleanup:\n";
+    for (auto value : refLocals_) {
+      os_ << "  iree_vm_ref_release(&" << getName(value) << ");\n";
+    }
+    os_ << "  return status;\n";
+    os_ << "}\n";
+    return success();
+  }
+
+ private:
+  LogicalResult declareLocal(Value value) {
+    StringRef cType = getCType(value.getType());
+    if (cType.empty()) {
+      return funcOp_.emitError() << "type " << value.getType()
+                                 << " not supported by the C target";
+    }
+    std::string name = "v" + std::to_string(valueNames_.size());
+    valueNames_[value] = name;
+    if (isRefType(value.getType())) {
+      os_ << "  iree_vm_ref_t " << name << " = {0};\n";
+      refLocals_.push_back(value);
+    } else {
+      os_ << "  " << cType << " " << name << " = 0;\n";
+    }
+    return success();
+  }
+
+  StringRef getName(Value value) { return valueNames_[value]; }
+
+  std::string operand(Operation *op, int i) {
+    return getName(op->getOperand(i)).str();
+  }
+  std::string result(Operation *op, int i = 0) {
+    return getName(op->getResult(i)).str();
+  }
+
+  // Emits a branch to successor |index| of |op| assigning the block arguments
+  // from the successor operands.
+  void emitBranch(Operation *op, int index, StringRef indent) {
+    Block *dest = op->getSuccessor(index);
+    auto operands = op->getSuccessorOperands(index);
+
+    // Block arguments are assigned as a parallel copy. If any operand is itself
+    // an argument of the destination (such as in loops) stage all values
+    // through temporaries first.
+    bool needsTemporaries = llvm::any_of(operands, [&](Value value) {
+      auto blockArg = value.dyn_cast<BlockArgument>();
+      return blockArg && blockArg.getOwner() == dest;
+    });
+    if (needsTemporaries) {
+      os_ << indent << "{\n";
+      for (auto it : llvm::enumerate(operands)) {
+        Value value = it.value();
+        if (isRefType(value.getType())) {
+          os_ << indent << "  iree_vm_ref_t t" << it.index() << " = {0};\n";
+          os_ << indent << "  iree_vm_c_ref_assign(&" << getName(value)
+              << ", &t" << it.index() << ");\n";
+        } else {
+          os_ << indent << "  " << getCType(value.getType()) << " t"
+              << it.index() << " = " << getName(value) << ";\n";
+        }
+      }
+      for (auto it : llvm::enumerate(operands)) {
+        Value arg = dest->getArgument(it.index());
+        if (isRefType(arg.getType())) {
+          os_ << indent << "  iree_vm_c_ref_move(&t" << it.index() << ", &"
+              << getName(arg) << ");\n";
+        } else {
+          os_ << indent << "  " << getName(arg) << " = t" << it.index()
+              << ";\n";
+        }
+      }
+      os_ << indent << "}\n";
+    } else {
+      for (auto it : llvm::enumerate(operands)) {
+        Value value = it.value();
+        Value arg = dest->getArgument(it.index());
+        if (isRefType(arg.getType())) {
+          os_ << indent << "iree_vm_c_ref_assign(&" << getName(value) << ", &"
+              << getName(arg) << ");\n";
+        } else {
+          os_ << indent << getName(arg) << " = " << getName(value) << ";\n";
+        }
+      }
+    }
+    os_ << indent << "goto " << blockLabels_[dest] << ";\n";
+  }
+
+  // Emits `if (condition) { branch 0 } else { branch 1 }`.
+  void emitCondBranch(Operation *op, StringRef condition) {
+    os_ << "  if (" << condition << ") {\n";
+    emitBranch(op, 0, "    ");
+    os_ << "  } else {\n";
+    emitBranch(op, 1, "    ");
+    os_ << "  }\n";
+  }
+
+  Optional<int32_t> symbolOrdinal(Operation *op, StringRef attrName) {
+    auto symbolAttr = op->getAttrOfType<FlatSymbolRefAttr>(attrName);
+    if (!symbolAttr) {
+      op->emitOpError() << "missing symbol reference '" << attrName << "'";
+      return llvm::None;
+    }
+    return lookupSymbolOrdinal(symbolTable_, op, symbolAttr.getValue());
+  }
+
+  LogicalResult emitOp(Operation *op) {
+    StringRef name = op->getName().getStringRef();
+    if (!name.consume_front("vm.")) {
+      return op->emitOpError() << "not supported by the C target";
+    }
+
+    if (auto *info = lookupOpInfo(kBinaryOps, name)) {
+      os_ << "  " << result(op) << " = (" << info->resultType << ")(("
+          << info->operandType << ")" << operand(op, 0) << " " << info->op
+          << " (" << info->operandType << ")" << operand(op, 1) << ");\n";
+      return success();
+    } else if (auto *info = lookupOpInfo(kUnaryOps, name)) {
+      os_ << "  " << result(op) << " = (" << info->resultType << ")("
+          << info->op << "(" << info->operandType << ")" << operand(op, 0)
+          << ");\n";
+      return success();
+    } else if (auto *info = lookupOpInfo(kShiftOps, name)) {
+      auto amount = op->getAttrOfType<IntegerAttr>("amount").getInt();
+      os_ << "  " << result(op) << " = (" << info->resultType << ")(("
+          << info->operandType << ")" << operand(op, 0) << " " << info->op
+          << " " << amount << ");\n";
+      return success();
+    } else if (auto *info = lookupOpInfo(kCondBranchCmpOps, name)) {
+      std::string condition = std::string("(") + info->operandType + ")" +
+                              operand(op, 0) + " " + info->op + " (" +
+                              info->operandType + ")" + operand(op, 1);
+      emitCondBranch(op, condition);
+      return success();
+    }
+
+    if (name == "const.i32" || name == "const.i64") {
+      auto value = op->getAttrOfType<IntegerAttr>("value").getValue();
+      bool is64 = name == "const.i64";
+      int64_t intValue = value.getSExtValue();
+      os_ << "  " << result(op) << " = ";
+      if (is64 && intValue == INT64_MIN) {
+        os_ << "INT64_MIN";
+      } else if (!is64 && intValue == INT32_MIN) {
+        os_ << "INT32_MIN";
+      } else if (is64) {
+        os_ << "INT64_C(" << intValue << ")";
+      } else {
+        os_ << intValue;
+      }
+      os_ << ";\n";
+    } else if (name == "const.f32") {
+      auto value = op->getAttrOfType<FloatAttr>("value").getValue();
+      os_ << "  " << result(op) << " = iree_vm_c_f32_from_bits("
+          << llvm::format("0x%08XU", static_cast<uint32_t>(
+                                         value.bitcastToAPInt().getZExtValue()))
+          << ");\n";
+    } else if (name == "const.i32.zero" || name == "const.i64.zero" ||
+               name == "const.f32.zero") {
+      os_ << "  " << result(op) << " = 0;\n";
+    } else if (name == "const.ref.zero") {
+      os_ << "  iree_vm_ref_release(&" << result(op) << ");\n";
+    } else if (name == "const.ref.rodata") {
+      auto ordinal = symbolOrdinal(op, "rodata");
+      if (!ordinal) return failure();
+      os_ << "  IREE_VM_C_CHECK(iree_vm_ref_wrap_retain(\n"
+          << "      &state->rodata_ref_table[" << *ordinal
+          << "].ref, iree_vm_ro_byte_buffer_type_id(),\n"
+          << "      &" << result(op) << "));\n";
+    } else if (name == "global.load.i32") {
+      auto ordinal = symbolOrdinal(op, "global");
+      if (!ordinal) return failure();
+      os_ << "  " << result(op)
+          << " = *(int32_t*)(state->rwdata_storage.data + " << *ordinal
+          << ");\n";
+    } else if (name == "global.store.i32") {
+      auto ordinal = symbolOrdinal(op, "global");
+      if (!ordinal) return failure();
+      os_ << "  *(int32_t*)(state->rwdata_storage.data + " << *ordinal
+          << ") = " << operand(op, 0) << ";\n";
+    } else if (name == "global.load.indirect.i32") {
+      os_ << "  {\n"
+          << "    int32_t* global = iree_vm_c_global_i32(state, "
+          << operand(op, 0) << ");\n"
+          << "    if (!global) {\n"
+          << "      status = IREE_STATUS_OUT_OF_RANGE;\n"
+          << "      goto cleanup;\n"
+          << "    }\n"
+          << "    " << result(op) << " = *global;\n"
+          << "  }\n";
+    } else if (name == "global.store.indirect.i32") {
+      os_ << "  {\n"
+          << "    int32_t* global = iree_vm_c_global_i32(state, "
+          << operand(op, 1) << ");\n"
+          << "    if (!global) {\n"
+          << "      status = IREE_STATUS_OUT_OF_RANGE;\n"
+          << "      goto cleanup;\n"
+          << "    }\n"
+          << "    *global = " << operand(op, 0) << ";\n"
+          << "  }\n";
+    } else if (name == "global.load.ref") {
+      auto ordinal = symbolOrdinal(op, "global");
+      if (!ordinal) return failure();
+      os_ << "  iree_vm_c_ref_assign(&state->global_ref_table[" << *ordinal
+          << "], &" << result(op) << ");\n";
+    } else if (name == "global.store.ref") {
+      auto ordinal = symbolOrdinal(op, "global");
+      if (!ordinal) return failure();
+      os_ << "  iree_vm_c_ref_assign(&" << operand(op, 0)
+          << ", &state->global_ref_table[" << *ordinal << "]);\n";
+    } else if (name == "global.load.indirect.ref" ||
+               name == "global.store.indirect.ref") {
+      bool isLoad = name == "global.load.indirect.ref";
+      os_ << "  {\n"
+          << "    iree_vm_ref_t* global = iree_vm_c_global_ref(state, "
+          << operand(op, isLoad ? 0 : 1) << ");\n"
+          << "    if (!global) {\n"
+          << "      status = IREE_STATUS_OUT_OF_RANGE;\n"
+          << "      goto cleanup;\n"
+          << "    }\n";
+      if (isLoad) {
+        os_ << "    iree_vm_c_ref_assign(global, &" << result(op) << ");\n";
+      } else {
+        os_ << "    iree_vm_c_ref_assign(&" << operand(op, 0)
+            << ", global);\n";
+      }
+      os_ << "  }\n";
+    } else if (name == "global.address") {
+      // Normally replaced with constants by ordinal allocation.
+      auto ordinal = symbolOrdinal(op, "global");
+      if (!ordinal) return failure();
+      os_ << "  " << result(op) << " = " << *ordinal << ";\n";
+    } else if (name == "select.i32" || name == "select.i64" ||
+               name == "select.f32") {
+      os_ << "  " << result(op) << " = " << operand(op, 0) << " ? "
+          << operand(op, 1) << " : " << operand(op, 2) << ";\n";
+    } else if (name == "select.ref") {
+      os_ << "  iree_vm_c_ref_assign(" << operand(op, 0) << " ? &"
+          << operand(op, 1) << " : &" << operand(op, 2) << ", &" << result(op)
+          << ");\n";
+    } else if (name == "cmp.eq.ref" || name == "cmp.ne.ref") {
+      os_ << "  " << result(op) << " = " << (name == "cmp.ne.ref" ? "!" : "")
+          << "iree_vm_ref_equal(&" << operand(op, 0) << ", &" << operand(op, 1)
+          << ");\n";
+    } else if (name == "cmp.nz.ref") {
+      os_ << "  " << result(op) << " = " << operand(op, 0)
+          << ".ptr != NULL;\n";
+    } else if (name == "br") {
+      emitBranch(op, 0, "  ");
+    } else if (name == "cond_br") {
+      emitCondBranch(op, operand(op, 0));
+    } else if (name == "break" || name == "cond_break") {
+      // Debuggers cannot attach to native modules so execution continues at
+      // the target block, as it does in the interpreter without a debugger.
+      if (name == "cond_break") {
+        os_ << "  (void)" << operand(op, 0) << ";\n";
+      }
+      emitBranch(op, 0, "  ");
+    } else if (name == "call" || name == "call.variadic") {
+      return emitCall(op, name == "call.variadic");
+    } else if (name == "return") {
+      for (auto operand : llvm::enumerate(op->getOperands())) {
+        if (isRefType(operand.value().getType())) {
+          os_ << "  iree_vm_c_ref_assign(&" << getName(operand.value())
+              << ", r" << operand.index() << ");\n";
+        } else {
+          os_ << "  *r" << operand.index() << " = "
+              << getName(operand.value()) << ";\n";
+        }
+      }
+      os_ << "  goto cleanup;\n";
+    } else if (name == "yield") {
+      // Native frames cannot be suspended and execution continues
+      // immediately; callers observe the function as having run to completion.
+      os_ << "  /* vm.yield */\n";
+    } else if (name == "trace" || name == "print") {
+      return emitPrint(op, name == "trace" ? "event_name" : "message");
+    } else {
+      return op->emitOpError() << "not supported by the C target";
+    }
+    return success();
+  }
+
+  // Emits a call to iree_vm_c_module_print with the string attribute
+  // |attrName| and the operand values of |op|.
+  LogicalResult emitPrint(Operation *op, StringRef attrName) {
+    auto messageAttr = op->getAttrOfType<StringAttr>(attrName);
+    if (!messageAttr) {
+      return op->emitOpError() << "missing '" << attrName << "' attribute";
+    }
+    std::string valueTypes;
+    for (auto operand : op->getOperands()) {
+      Type type = operand.getType();
+      if (isRefType(type)) {
+        valueTypes += 'r';
+      } else if (type.isInteger(64)) {
+        valueTypes += 'l';
+      } else if (type.isF32()) {
+        valueTypes += 'f';
+      } else {
+        valueTypes += 'i';
+      }
+    }
+    os_ << "  iree_vm_c_module_print("
+        << makeCStringLiteral(messageAttr.getValue()) << ", "
+        << makeCStringLiteral(valueTypes);
+    for (auto operand : op->getOperands()) {
+      os_ << ", " << (isRefType(operand.getType()) ? "&" : "")
+          << getName(operand);
+    }
+    os_ << ");\n";
+    return success();
+  }
+
+  LogicalResult emitCall(Operation *op, bool isVariadic) {
+    auto calleeAttr = op->getAttrOfType<FlatSymbolRefAttr>("callee");
+    auto *calleeOp = symbolTable_.lookup(calleeAttr.getValue());
+    if (!calleeOp) {
+      return op->emitOpError()
+             << "target symbol not found: " << calleeAttr.getValue();
+    }
+    auto ordinal = lookupSymbolOrdinal(symbolTable_, op, calleeAttr.getValue());
+    if (!ordinal) return failure();
+
+    if (!isa<IREE::VM::ImportOp>(calleeOp)) {
+      if (isVariadic) {
+        // Matches the bytecode module restriction.
+        return op->emitOpError()
+               << "variadic calls are only supported for imports";
+      }
+      // Direct call to the C function of the callee.
+      os_ << "  IREE_VM_C_CHECK(" << symbols_.funcIdentifiers[*ordinal]
+          << "(stack, state";
+      for (auto operand : op->getOperands()) {
+        os_ << ", " << (isRefType(operand.getType()) ? "&" : "")
+            << getName(operand);
+      }
+      for (auto result : op->getResults()) {
+        os_ << ", &" << getName(result);
+      }
+      os_ << "));\n";
+      return success();
+    }
+
+    // Imports are called through a stack frame with arguments left-aligned in
+    // each register bank.
+    os_ << "  {\n";
+    if (isVariadic) {
+      auto segmentSizes =
+          op->getAttrOfType<DenseIntElementsAttr>("segment_sizes");
+      os_ << "    static const uint8_t kSegmentSizes[] = {"
+          << segmentSizes.getNumElements();
+      for (APInt size : segmentSizes.getIntValues()) {
+        os_ << ", " << size.getZExtValue();
+      }
+      os_ << "};\n";
+    }
+    os_ << "    iree_vm_stack_frame_t* frame = NULL;\n"
+        << "    IREE_VM_C_CHECK(iree_vm_c_module_enter_import(stack, state, "
+        << *ordinal << ", &frame));\n";
+    int i32Reg = 0;
+    int refReg = 0;
+    for (auto operand : op->getOperands()) {
+      Type type = operand.getType();
+      if (isRefType(type)) {
+        os_ << "    iree_vm_c_set_ref(&frame->registers, " << refReg++ << ", &"
+            << getName(operand) << ");\n";
+      } else {
+        os_ << "    iree_vm_c_set_" << getRegisterAccessorSuffix(type)
+            << "(&frame->registers, " << i32Reg << ", " << getName(operand)
+            << ");\n";
+        i32Reg += getI32RegisterSlotCount(type);
+      }
+    }
+    int resultRegisterCount = 0;
+    for (auto result : op->getResults()) {
+      Type type = result.getType();
+      resultRegisterCount +=
+          isRefType(type) ? 1 : getI32RegisterSlotCount(type);
+    }
+    os_ << "    IREE_VM_C_CHECK(iree_vm_c_module_call_import(\n"
+        << "        stack, frame,\n"
+        << "        "
+        << (isVariadic ? "(const iree_vm_register_list_t*)kSegmentSizes"
+                       : "NULL")
+        << ", " << resultRegisterCount << "));\n";
+    int resultIndex = 0;
+    for (auto result : op->getResults()) {
+      Type type = result.getType();
+      if (isRefType(type)) {
+        os_ << "    iree_vm_c_get_ref(&frame->registers,\n"
+            << "                      iree_vm_c_module_import_result(frame, "
+            << resultIndex << "),\n"
+            << "                      &" << getName(result) << ");\n";
+        ++resultIndex;
+      } else {
+        os_ << "    " << getName(result) << " = iree_vm_c_get_"
+            << getRegisterAccessorSuffix(type) << "(\n"
+            << "        &frame->registers,\n"
+            << "        iree_vm_c_module_import_result(frame, " << resultIndex
+            << "));\n";
+        resultIndex += getI32RegisterSlotCount(type);
+      }
+    }
+    os_ << "    iree_vm_stack_function_leave(stack);\n";
+    os_ << "  }\n";
+    return success();
+  }
+
+  ModuleSymbols &symbols_;
+  SymbolTable &symbolTable_;
+  IREE::VM::FuncOp funcOp_;
+  llvm::raw_ostream &os_;
+
+  llvm::DenseMap<Value, std::string> valueNames_;
+  llvm::SmallVector<Value, 8> refLocals_;
+  llvm::DenseMap<Block *, std::string> blockLabels_;
+  llvm::DenseSet<Block *> branchTargets_;
+};
+
+}  // namespace
+
+// Emits the entry point called through the module interface for the function
+// with |ordinal|. Arguments are read from the frame, the C function is called,
+// and results are written back to the frame along with the register list
+// describing them.
+static void emitFunctionEntry(ModuleSymbols &symbols, int ordinal,
+                              llvm::raw_ostream &os) {
+  auto funcOp = symbols.internalFuncOps[ordinal];
+  auto functionType = funcOp.getType();
+  const std::string &identifier = symbols.funcIdentifiers[ordinal];
+
+  os << "static iree_status_t " << identifier << "_entry(\n"
+     << "    iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,\n"
+     << "    iree_vm_c_module_state_t* state) {\n";
+
+  // Results are left-aligned in each bank just as arguments are.
+  std::vector<int> resultRegisters;
+  int i32Reg = 0;
+  int refReg = 0;
+  for (auto type : functionType.getResults()) {
+    if (isRefType(type)) {
+      // Results are moved out of the frame by the caller.
+      resultRegisters.push_back(0x80 | 0x40 | refReg++);
+    } else {
+      for (int i = 0; i < getI32RegisterSlotCount(type); ++i) {
+        resultRegisters.push_back(i32Reg++);
+      }
+    }
+  }
+  os << "  static const uint8_t kResultRegisters[] = {"
+     << resultRegisters.size();
+  for (int reg : resultRegisters) {
+    os << ", " << llvm::format("0x%02X", reg);
+  }
+  os << "};\n";
+  os << "  iree_vm_registers_t* regs = &frame->registers;\n";
+  for (auto result : llvm::enumerate(functionType.getResults())) {
+    if (isRefType(result.value())) {
+      os << "  iree_vm_ref_t r" << result.index() << " = {0};\n";
+    } else {
+      os << "  " << getCType(result.value()) << " r" << result.index()
+         << " = 0;\n";
+    }
+  }
+
+  os << "  iree_status_t status = " << identifier << "(\n      stack, state";
+  i32Reg = 0;
+  refReg = 0;
+  for (auto type : functionType.getInputs()) {
+    if (isRefType(type)) {
+      os << ",\n      iree_vm_c_ref_ptr(regs, " << refReg++ << ")";
+    } else {
+      os << ",\n      iree_vm_c_get_" << getRegisterAccessorSuffix(type)
+         << "(regs, " << i32Reg << ")";
+      i32Reg += getI32RegisterSlotCount(type);
+    }
+  }
+  for (int i = 0; i < functionType.getNumResults(); ++i) {
+    os << ", &r" << i;
+  }
+  os << ");\n";
+
+  os << "  if (iree_status_is_ok(status)) {\n";
+  i32Reg = 0;
+  refReg = 0;
+  for (auto result : llvm::enumerate(functionType.getResults())) {
+    Type type = result.value();
+    if (isRefType(type)) {
+      os << "    iree_vm_c_ref_move(&r" << result.index()
+         << ", iree_vm_c_ref_ptr(regs, " << refReg++ << "));\n";
+    } else {
+      os << "    iree_vm_c_set_" << getRegisterAccessorSuffix(type) << "(regs, "
+         << i32Reg << ", r" << result.index() << ");\n";
+      i32Reg += getI32RegisterSlotCount(type);
+    }
+  }
+  os << "    frame->return_registers =\n"
+     << "        (const iree_vm_register_list_t*)kResultRegisters;\n";
+  os << "  }\n";
+  for (auto result : llvm::enumerate(functionType.getResults())) {
+    if (isRefType(result.value())) {
+      os << "  iree_vm_ref_release(&r" << result.index() << ");\n";
+    }
+  }
+  os << "  return status;\n";
+  os << "}\n";
+}
+
+// Returns the number of registers in each bank needed to pass the arguments and
+// results of |functionType| across the module ABI.
+// Returns the calling convention of |functionType| as described by
+// iree_vm_function_signature_t::calling_convention.
+static std::string getCallingConvention(FunctionType functionType) {
+  auto appendTypes = [](ArrayRef<Type> types, std::string &callingConvention) {
+    for (auto type : types) {
+      if (isRefType(type)) {
+        callingConvention += 'r';
+      } else if (type.isInteger(64)) {
+        callingConvention += 'I';
+      } else if (type.isF32()) {
+        callingConvention += 'f';
+      } else {
+        callingConvention += 'i';
+      }
+    }
+  };
+  std::string callingConvention;
+  appendTypes(functionType.getInputs(), callingConvention);
+  callingConvention += '_';
+  appendTypes(functionType.getResults(), callingConvention);
+  return callingConvention;
+}
+
+static std::pair<int, int> computeABIRegisterCounts(
+    FunctionType functionType) {
+  auto countTypes = [](ArrayRef<Type> types) {
+    std::pair<int, int> counts = {0, 0};
+    for (auto type : types) {
+      if (isRefType(type)) {
+        ++counts.second;
+      } else {
+        counts.first += getI32RegisterSlotCount(type);
+      }
+    }
+    return counts;
+  };
+  auto inputCounts = countTypes(functionType.getInputs());
+  auto resultCounts = countTypes(functionType.getResults());
+  return {std::max(inputCounts.first, resultCounts.first),
+          std::max(inputCounts.second, resultCounts.second)};
+}
+
+static LogicalResult emitSource(CTargetOptions targetOptions,
+                                IREE::VM::ModuleOp moduleOp,
+                                ModuleSymbols &symbols,
+                                llvm::raw_ostream &os) {
+  SymbolTable symbolTable(moduleOp);
+  const std::string &prefix = symbols.prefix;
+
+  os << "// Generated by the IREE VM C target (-iree-vm-ir-to-c-module).\n"
+     << "// Do not edit.\n\n"
+     << "#include <stdint.h>\n\n"
+     << "#include \"iree/base/alignment.h\"\n"
+     << "#include \"iree/base/api.h\"\n"
+     << "#include \"iree/vm/c_module.h\"\n"
+     << "#include \"iree/vm/module.h\"\n"
+     << "#include \"iree/vm/ref.h\"\n"
+     << "#include \"iree/vm/stack.h\"\n"
+     << "#include \"iree/vm/types.h\"\n\n";
+
+  // Read-only data.
+  for (auto rodataOp : llvm::enumerate(symbols.rodataOps)) {
+    std::vector<uint8_t> bytes;
+    if (failed(serializeRodata(rodataOp.value(), bytes))) return failure();
+    int64_t alignment = 16;
+    if (auto alignmentAttr =
+            rodataOp.value().getAttrOfType<IntegerAttr>("alignment")) {
+      alignment = std::max(alignment, alignmentAttr.getInt());
+    }
+    os << "iree_alignas(" << alignment << ") static const uint8_t " << prefix
+       << "_rodata_" << rodataOp.index() << "[] = {";
+    if (bytes.empty()) os << "0";
+    for (size_t i = 0; i < bytes.size(); ++i) {
+      if (i % 12 == 0) os << "\n   ";
+      os << " " << llvm::format("0x%02X", bytes[i])
+         << (i + 1 < bytes.size() ? "," : "");
+    }
+    os << "\n};\n";
+    os << "#define " << prefix << "_rodata_" << rodataOp.index()
+       << "_size " << bytes.size() << "\n";
+  }
+  if (!symbols.rodataOps.empty()) {
+    os << "static const iree_const_byte_span_t " << prefix
+       << "_rodata_segments[] = {\n";
+    for (int i = 0; i < symbols.rodataOps.size(); ++i) {
+      os << "    {" << prefix << "_rodata_" << i << ", " << prefix << "_rodata_"
+         << i << "_size},\n";
+    }
+    os << "};\n";
+  }
+  os << "\n";
+
+  // Prototypes so that functions may call each other in any order.
+  for (auto funcOp : llvm::enumerate(symbols.internalFuncOps)) {
+    if (failed(FunctionEmitter::emitPrototype(
+            funcOp.value(), symbols.funcIdentifiers[funcOp.index()], os))) {
+      return failure();
+    }
+    os << ";\n";
+  }
+  os << "\n";
+
+  // Function bodies and their module interface entry points.
+  for (auto funcOp : llvm::enumerate(symbols.internalFuncOps)) {
+    FunctionEmitter emitter(symbols, symbolTable, funcOp.value(), os);
+    if (failed(emitter.emit(symbols.funcIdentifiers[funcOp.index()]))) {
+      return funcOp.value().emitError() << "failed to emit function";
+    }
+    os << "\n";
+    emitFunctionEntry(symbols, funcOp.index(), os);
+    os << "\n";
+  }
+
+  // Module tables.
+  if (!symbols.importFuncOps.empty()) {
+    os << "static const iree_vm_c_import_def_t " << prefix
+       << "_imports[] = {\n";
+    for (auto importOp : symbols.importFuncOps) {
+      auto importType = importOp.getType();
+      os << "    {" << makeCStringLiteral(importOp.getName()) << ", "
+         << importType.getNumInputs() << ", " << importType.getNumResults()
+         << ", " << (importOp.isVariadic() ? "true" : "false") << "},\n";
+    }
+    os << "};\n";
+  }
+  if (!symbols.exportFuncOps.empty()) {
+    os << "static const iree_vm_c_export_def_t " << prefix
+       << "_exports[] = {\n";
+    for (auto exportOp : symbols.exportFuncOps) {
+      auto ordinal = lookupSymbolOrdinal(symbolTable, exportOp,
+                                         exportOp.function_ref());
+      if (!ordinal) return failure();
+      os << "    {" << makeCStringLiteral(exportOp.export_name()) << ", "
+         << *ordinal << "},\n";
+    }
+    os << "};\n";
+  }
+  // Reflection attributes are stripped along with symbols, as in the bytecode
+  // target.
+  std::vector<int> reflectionAttrCounts(symbols.internalFuncOps.size(), 0);
+  if (!targetOptions.stripSymbols) {
+    for (auto funcOp : llvm::enumerate(symbols.internalFuncOps)) {
+      auto reflectionAttrs =
+          funcOp.value().getAttrOfType<DictionaryAttr>("iree.reflection");
+      if (!reflectionAttrs) continue;
+      int &count = reflectionAttrCounts[funcOp.index()];
+      for (auto reflectionAttr : reflectionAttrs) {
+        auto key = reflectionAttr.first.strref();
+        auto value = reflectionAttr.second.dyn_cast<StringAttr>();
+        if (!value || key.empty()) continue;
+        if (count++ == 0) {
+          os << "static const iree_vm_c_reflection_attr_def_t "
+             << symbols.funcIdentifiers[funcOp.index()]
+             << "_reflection_attrs[] = {\n";
+        }
+        os << "    {" << makeCStringLiteral(key) << ", "
+           << makeCStringLiteral(value.getValue()) << "},\n";
+      }
+      if (count > 0) os << "};\n";
+    }
+  }
+  if (!symbols.internalFuncOps.empty()) {
+    os << "static const iree_vm_c_function_def_t " << prefix
+       << "_functions[] = {\n";
+    for (auto funcOp : llvm::enumerate(symbols.internalFuncOps)) {
+      auto functionType = funcOp.value().getType();
+      auto registerCounts = computeABIRegisterCounts(functionType);
+      int reflectionAttrCount = reflectionAttrCounts[funcOp.index()];
+      os << "    {"
+         << (targetOptions.stripSymbols
+                 ? std::string("NULL")
+                 : makeCStringLiteral(funcOp.value().getName()))
+         << ", " << symbols.funcIdentifiers[funcOp.index()] << "_entry, "
+         << registerCounts.first << ", " << registerCounts.second << ", "
+         << functionType.getNumInputs() << ", "
+         << functionType.getNumResults() << ", "
+         << makeCStringLiteral(getCallingConvention(functionType)) << ", "
+         << reflectionAttrCount
+         << ", "
+         << (reflectionAttrCount > 0
+                 ? symbols.funcIdentifiers[funcOp.index()] +
+                       "_reflection_attrs"
+                 : std::string("NULL"))
+         << "},\n";
+    }
+    os << "};\n";
+  }
+
+  auto tableOrNull = [&](bool empty, StringRef suffix) {
+    return empty ? std::string("NULL") : prefix + "_" + suffix.str();
+  };
+  os << "static const iree_vm_c_module_def_t " << prefix << "_module_def = {\n"
+     << "    "
+     << makeCStringLiteral(moduleOp.sym_name().empty() ? "module"
+                                                       : moduleOp.sym_name())
+     << ",\n"
+     << "    " << symbols.importFuncOps.size() << ", "
+     << tableOrNull(symbols.importFuncOps.empty(), "imports") << ",\n"
+     << "    " << symbols.exportFuncOps.size() << ", "
+     << tableOrNull(symbols.exportFuncOps.empty(), "exports") << ",\n"
+     << "    " << symbols.internalFuncOps.size() << ", "
+     << tableOrNull(symbols.internalFuncOps.empty(), "functions") << ",\n"
+     << "    " << symbols.rodataOps.size() << ", "
+     << tableOrNull(symbols.rodataOps.empty(), "rodata_segments") << ",\n"
+     << "    " << symbols.globalBytes << ", " << symbols.globalRefs << ",\n"
+     << "};\n\n";
+
+  os << "iree_status_t " << prefix << "_c_module_create(\n"
+     << "    iree_allocator_t allocator, iree_vm_module_t** out_module) {\n"
+     << "  return iree_vm_c_module_create(&" << prefix
+     << "_module_def, allocator,\n"
+     << "                                 out_module);\n"
+     << "}\n";
+  return success();
+}
+
+static LogicalResult emitHeader(ModuleSymbols &symbols,
+                                llvm::raw_ostream &os) {
+  std::string guard = StringRef(symbols.prefix).upper() + "_C_MODULE_H_";
+  os << "// Generated by the IREE VM C target (-iree-vm-ir-to-c-module).\n"
+     << "// Do not edit.\n\n"
+     << "#ifndef " << guard << "\n"
+     << "#define " << guard << "\n\n"
+     << "#include \"iree/base/api.h\"\n"
+     << "#include \"iree/vm/module.h\"\n\n"
+     << "#ifdef __cplusplus\n"
+     << "extern \"C\" {\n"
+     << "#endif  // __cplusplus\n\n"
+     << "// Creates a new instance of the '" << symbols.prefix
+     << "' VM module.\n"
+     << "iree_status_t " << symbols.prefix << "_c_module_create(\n"
+     << "    iree_allocator_t allocator, iree_vm_module_t** out_module);\n\n"
+     << "#ifdef __cplusplus\n"
+     << "}  // extern \"C\"\n"
+     << "#endif  // __cplusplus\n\n"
+     << "#endif  // " << guard << "\n";
+  return success();
+}
+
+LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output) {
+  if (failed(canonicalizeModule(targetOptions, moduleOp))) {
+    return moduleOp.emitError()
+           << "failed to canonicalize vm.module to an emittable form";
+  }
+
+  if (targetOptions.outputFormat == COutputFormat::kMlirText) {
+    // Use the standard MLIR text printer.
+    moduleOp.getOperation()->print(output);
+    output << "\n";
+    return success();
+  }
+
+  auto symbols = gatherModuleSymbols(targetOptions, moduleOp);
+  switch (targetOptions.outputFormat) {
+    case COutputFormat::kSource:
+      if (failed(emitSource(targetOptions, moduleOp, symbols, output))) {
+        return moduleOp.emitError() << "failed to emit C module source";
+      }
+      break;
+    case COutputFormat::kHeader:
+      if (failed(emitHeader(symbols, output))) {
+        return moduleOp.emitError() << "failed to emit C module header";
+      }
+      break;
+    default:
+      llvm_unreachable("unimplemented output format");
+  }
+
+  output.flush();
+  return success();
+}
+
+LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output) {
+  auto moduleOps = outerModuleOp.getOps<IREE::VM::ModuleOp>();
+  if (moduleOps.empty()) {
+    return outerModuleOp.emitError()
+           << "outer module does not contain a vm.module op";
+  }
+  return translateModuleToC(*moduleOps.begin(), targetOptions, output);
+}
+
+}  // namespace VM
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
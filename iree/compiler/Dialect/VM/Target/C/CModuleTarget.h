@@ -0,0 +1,72 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_COMPILER_DIALECT_VM_TARGET_C_CMODULETARGET_H_
+#define IREE_COMPILER_DIALECT_VM_TARGET_C_CMODULETARGET_H_
+
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/Module.h"
+#include "mlir/Support/LogicalResult.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+// Defines the output format of the C module.
+enum class COutputFormat {
+  // C source implementing the module and its create function.
+  kSource,
+  // C header declaring the module create function.
+  kHeader,
+  // MLIR text of the VM module as it is prior to emitting C.
+  kMlirText,
+};
+
+// Options that can be provided to C translation.
+struct CTargetOptions {
+  // Format of the module written to the output stream.
+  COutputFormat outputFormat = COutputFormat::kSource;
+
+  // Run basic CSE/inlining/etc passes prior to emission.
+  bool optimize = true;
+
+  // Strips all internal symbol names. Import and export names will remain.
+  bool stripSymbols = false;
+  // Strips vm ops with the VM_DebugOnly trait.
+  bool stripDebugOps = false;
+};
+
+// Translates a vm.module to C source implementing iree_vm_module_t.
+// Each vm.func becomes a native C function operating on C locals and the
+// module is described by a static iree_vm_c_module_def_t that is instantiated
+// with iree_vm_c_module_create. The module can be created with the emitted
+// `<module name>_c_module_create` function. See iree/vm/c_module.h for the
+// runtime support.
+//
+// Exposed via the --iree-vm-ir-to-c-module translation.
+LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output);
+LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output);
+
+}  // namespace VM
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_VM_TARGET_C_CMODULETARGET_H_
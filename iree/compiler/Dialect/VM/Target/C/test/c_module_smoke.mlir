@@ -0,0 +1,84 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @simple_module {
+  vm.export @func
+
+  // CHECK: static iree_status_t simple_module_func(
+  // CHECK-NEXT: iree_vm_stack_t* stack, iree_vm_c_module_state_t* state,
+  // CHECK-NEXT: int32_t a0,
+  // CHECK-NEXT: int32_t* r0)
+  vm.func @func(%arg0 : i32) -> i32 {
+    // CHECK: = (int32_t)((uint32_t)v0 + (uint32_t)v0);
+    %0 = vm.add.i32 %arg0, %arg0 : i32
+    // CHECK: *r0 = v1;
+    // CHECK-NEXT: goto cleanup;
+    vm.return %0 : i32
+  }
+
+  // CHECK: static iree_status_t simple_module_func_entry(
+  // CHECK: static const uint8_t kResultRegisters[] = {1, 0x00};
+  // CHECK: iree_vm_c_get_i32(regs, 0)
+
+  // CHECK: static const iree_vm_c_export_def_t simple_module_exports[] = {
+  // CHECK-NEXT: {"func", 0},
+  // CHECK: static const iree_vm_c_function_def_t simple_module_functions[] = {
+  // CHECK-NEXT: {"func", simple_module_func_entry, 1, 0, 1, 1, "i_i", 0, NULL},
+
+  // CHECK: iree_status_t simple_module_c_module_create(
+  // CHECK-NEXT: iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  // CHECK-NEXT: return iree_vm_c_module_create(&simple_module_module_def,
+}
+
+// -----
+
+vm.module @refs_and_imports {
+  vm.import @other.func(%arg0 : i64, %arg1 : !vm.ref<?>) -> !vm.ref<?>
+
+  vm.export @call_import
+  // CHECK: static iree_status_t refs_and_imports_call_import(
+  // CHECK-NEXT: iree_vm_stack_t* stack, iree_vm_c_module_state_t* state,
+  // CHECK-NEXT: int64_t a0,
+  // CHECK-NEXT: iree_vm_ref_t* a1,
+  // CHECK-NEXT: iree_vm_ref_t* r0)
+  vm.func @call_import(%arg0 : i64, %arg1 : !vm.ref<?>) -> !vm.ref<?> {
+    // CHECK: IREE_VM_C_CHECK(iree_vm_c_module_enter_import(stack, state, 0, &frame));
+    // CHECK-NEXT: iree_vm_c_set_i64(&frame->registers, 0, v0);
+    // CHECK-NEXT: iree_vm_c_set_ref(&frame->registers, 0, &v1);
+    // CHECK: iree_vm_c_module_import_result(frame, 0),
+    // CHECK: iree_vm_stack_function_leave(stack);
+    %0 = vm.call @other.func(%arg0, %arg1) : (i64, !vm.ref<?>) -> !vm.ref<?>
+    // CHECK: iree_vm_c_ref_assign(&v2, r0);
+    vm.return %0 : !vm.ref<?>
+  }
+  // CHECK: cleanup:
+  // CHECK-NEXT: iree_vm_ref_release(&v1);
+  // CHECK-NEXT: iree_vm_ref_release(&v2);
+
+  // CHECK: static const uint8_t kResultRegisters[] = {1, 0xC0};
+  // CHECK: iree_vm_c_ref_move(&r0, iree_vm_c_ref_ptr(regs, 0));
+  // CHECK: static const iree_vm_c_import_def_t refs_and_imports_imports[] = {
+  // CHECK-NEXT: {"other.func", 2, 1, false},
+}
+
+// -----
+
+vm.module @debug_ops {
+  vm.export @debug
+  vm.func @debug(%arg0 : i32, %arg1 : f32) -> i32
+      attributes {iree.reflection = {f = "I1!R1!"}} {
+    // CHECK: iree_vm_c_module_print("message", "if", [[ARG0:v[0-9]+]], [[ARG1:v[0-9]+]]);
+    vm.print "message"(%arg0, %arg1) : i32, f32
+    // CHECK: iree_vm_c_module_print("event", "i", [[ARG0]]);
+    vm.trace "event"(%arg0) : i32
+    // CHECK: (void)[[ARG0]];
+    // CHECK-NEXT: goto
+    vm.cond_break %arg0, ^bb1
+  ^bb1:
+    vm.return %arg0 : i32
+  }
+
+  // CHECK: static const iree_vm_c_reflection_attr_def_t debug_ops_debug_reflection_attrs[] = {
+  // CHECK-NEXT: {"f", "I1!R1!"},
+  // CHECK: static const iree_vm_c_function_def_t debug_ops_functions[] = {
+  // CHECK-NEXT: {"debug", debug_ops_debug_entry, 2, 0, 2, 1, "if_i", 1, debug_ops_debug_reflection_attrs},
+}
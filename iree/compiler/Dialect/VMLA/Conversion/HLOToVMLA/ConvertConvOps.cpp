@@ -0,0 +1,122 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
+#include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/ConversionTarget.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/HLOToVMLA/ConvertHLOToVMLA.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLADialect.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLATypes.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Function.h"
+#include "mlir/IR/Module.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "tensorflow/compiler/mlir/xla/ir/hlo_ops.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// Converts a 2D xla_hlo.conv to the builtin VMLA convolution op.
+//
+// Only supports NHWC inputs/outputs with HWIO filters as produced by the
+// TensorFlow importer. Other layouts must be transposed prior to conversion.
+struct ConvOpConversion : public OpConversionPattern<xla_hlo::ConvOp> {
+  ConvOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern(context), typeConverter(typeConverter) {}
+
+  PatternMatchResult matchAndRewrite(
+      xla_hlo::ConvOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto dimensionNumbers = srcOp.dimension_numbers();
+    auto isDims = [](DenseIntElementsAttr attr, ArrayRef<int64_t> dims) {
+      if (attr.getNumElements() != dims.size()) return false;
+      for (auto value : llvm::enumerate(attr.getIntValues())) {
+        if (value.value().getSExtValue() != dims[value.index()]) return false;
+      }
+      return true;
+    };
+    if (dimensionNumbers.input_batch_dimension().getInt() != 0 ||
+        dimensionNumbers.input_feature_dimension().getInt() != 3 ||
+        !isDims(dimensionNumbers.input_spatial_dimensions(), {1, 2}) ||
+        dimensionNumbers.kernel_input_feature_dimension().getInt() != 2 ||
+        dimensionNumbers.kernel_output_feature_dimension().getInt() != 3 ||
+        !isDims(dimensionNumbers.kernel_spatial_dimensions(), {0, 1}) ||
+        dimensionNumbers.output_batch_dimension().getInt() != 0 ||
+        dimensionNumbers.output_feature_dimension().getInt() != 3 ||
+        !isDims(dimensionNumbers.output_spatial_dimensions(), {1, 2})) {
+      srcOp.emitRemark() << "only NHWC/HWIO 2D convolutions are supported";
+      return matchFailure();
+    }
+    if (!isAllOnes(srcOp.lhs_dilationAttr())) {
+      srcOp.emitRemark() << "lhs (transposed convolution) dilation is not "
+                            "supported";
+      return matchFailure();
+    }
+    if (srcOp.batch_group_count().getZExtValue() != 1) {
+      srcOp.emitRemark() << "batch group counts other than 1 are not supported";
+      return matchFailure();
+    }
+
+    const int kSpatialDims = 2;
+    auto input = operands[0];
+    auto inputShape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.lhs(), typeConverter, rewriter);
+    auto filter = operands[1];
+    auto filterShape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.rhs(), typeConverter, rewriter);
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    auto dstShape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+
+    rewriter.create<IREE::VMLA::ConvOp>(
+        srcOp.getLoc(), input, inputShape, filter, filterShape, dst, dstShape,
+        getI32ElementsAttrOr(srcOp.window_stridesAttr(), kSpatialDims, 1,
+                             rewriter),
+        getI32ElementsAttrOr(srcOp.paddingAttr(), kSpatialDims * 2, 0,
+                             rewriter),
+        getI32ElementsAttrOr(srcOp.lhs_dilationAttr(), kSpatialDims, 1,
+                             rewriter),
+        getI32ElementsAttrOr(srcOp.rhs_dilationAttr(), kSpatialDims, 1,
+                             rewriter),
+        rewriter.getI32IntegerAttr(
+            srcOp.feature_group_count().getZExtValue()),
+        rewriter.getI32IntegerAttr(srcOp.batch_group_count().getZExtValue()),
+        TypeAttr::get(getElementTypeOrSelf(srcOp.lhs().getType())),
+        TypeAttr::get(getElementTypeOrSelf(srcOp.rhs().getType())),
+        TypeAttr::get(getElementTypeOrSelf(srcOp.getType())));
+
+    rewriter.replaceOp(srcOp, {dst});
+    return matchSuccess();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+}  // namespace
+
+void populateHLOConvToVMLAPatterns(MLIRContext *context,
+                                   OwningRewritePatternList &patterns,
+                                   TypeConverter &typeConverter) {
+  patterns.insert<ConvOpConversion>(context, typeConverter);
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
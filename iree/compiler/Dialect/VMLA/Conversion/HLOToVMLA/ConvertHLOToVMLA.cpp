@@ -37,10 +37,35 @@
 namespace mlir {
 namespace iree_compiler {
 
+void populateHLOConvToVMLAPatterns(MLIRContext *context,
+                                   OwningRewritePatternList &patterns,
+                                   TypeConverter &typeConverter);
 void populateHLOReductionToVMLAPatterns(MLIRContext *context,
                                         OwningRewritePatternList &patterns,
                                         TypeConverter &typeConverter);
 
+DenseIntElementsAttr getI32ElementsAttrOr(DenseIntElementsAttr attr,
+                                          int64_t count, int32_t defaultValue,
+                                          Builder &builder) {
+  SmallVector<int32_t, 8> values;
+  if (attr) {
+    for (auto value : attr.getIntValues()) {
+      values.push_back(static_cast<int32_t>(value.getSExtValue()));
+    }
+  } else {
+    values.resize(count, defaultValue);
+  }
+  return builder.getI32VectorAttr(values);
+}
+
+bool isAllOnes(DenseIntElementsAttr attr) {
+  if (!attr) return true;
+  for (auto value : attr.getIntValues()) {
+    if (value.getSExtValue() != 1) return false;
+  }
+  return true;
+}
+
 namespace {
 
 // Clones operand[0] and returns the result.
@@ -417,6 +442,9 @@ void populateHLOToVMLAPatterns(MLIRContext *context,
   // xla_hlo.reduce and xla_hlo.reduce_window.
   populateHLOReductionToVMLAPatterns(context, patterns, typeConverter);
 
+  // xla_hlo.conv.
+  populateHLOConvToVMLAPatterns(context, patterns, typeConverter);
+
   // Simple 1:1 conversion patterns using the automated trait-based converter.
   // Used for HLO ops that have equivalent VMLA ops such as most arithmetic ops.
   patterns.insert<VMLAOpConversion<xla_hlo::AddOp, IREE::VMLA::AddOp>>(
@@ -502,9 +530,6 @@ void populateHLOToVMLAPatterns(MLIRContext *context,
   patterns.insert<GatherOpConversion>(context, typeConverter);
   patterns.insert<SliceOpConversion>(context, typeConverter);
   patterns.insert<DynamicSliceOpConversion>(context, typeConverter);
-
-  // TODO(benvanik): add missing ops:
-  // - ConvOp
 }
 
 }  // namespace iree_compiler
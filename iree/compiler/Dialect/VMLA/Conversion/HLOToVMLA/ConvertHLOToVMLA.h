@@ -15,6 +15,8 @@
 #ifndef IREE_COMPILER_DIALECT_VMLA_CONVERSION_HLOTOVMLA_CONVERTHLOTOVMLA_H_
 #define IREE_COMPILER_DIALECT_VMLA_CONVERSION_HLOTOVMLA_CONVERTHLOTOVMLA_H_
 
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
@@ -26,6 +28,15 @@ void populateHLOToVMLAPatterns(MLIRContext *context,
                                OwningRewritePatternList &patterns,
                                TypeConverter &typeConverter);
 
+// Returns |attr| as an i32 elements attribute or |defaultValue| repeated
+// |count| times if it is not present.
+DenseIntElementsAttr getI32ElementsAttrOr(DenseIntElementsAttr attr,
+                                          int64_t count, int32_t defaultValue,
+                                          Builder &builder);
+
+// Returns true if all values in |attr| are 1 (or |attr| is not present).
+bool isAllOnes(DenseIntElementsAttr attr);
+
 }  // namespace iree_compiler
 }  // namespace mlir
 
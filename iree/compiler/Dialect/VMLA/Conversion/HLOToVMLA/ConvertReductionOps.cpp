@@ -199,6 +199,81 @@ struct BuiltinReduceOpConversion
   TypeConverter &typeConverter;
 };
 
+// Converts an xla_hlo.reduce_window with a single sum/min/max op in its body
+// to a builtin VMLA pooling op. Padded window elements take the init value
+// such that max pooling with -inf and sum pooling with 0 behave as expected.
+struct BuiltinReduceWindowOpConversion
+    : public OpConversionPattern<xla_hlo::ReduceWindowOp> {
+  BuiltinReduceWindowOpConversion(MLIRContext *context,
+                                  TypeConverter &typeConverter)
+      : OpConversionPattern(context, /*benefit=*/1000),
+        typeConverter(typeConverter) {}
+
+  PatternMatchResult matchAndRewrite(
+      xla_hlo::ReduceWindowOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (srcOp.body().getBlocks().size() > 1) {
+      // Control flow within the computation is not supported.
+      return matchFailure();
+    } else if (srcOp.body().front().getOperations().size() > 2) {
+      // Only a single compute op and the terminator are supported.
+      return matchFailure();
+    } else if (!isAllOnes(srcOp.base_dilationsAttr()) ||
+               !isAllOnes(srcOp.window_dilationsAttr())) {
+      srcOp.emitRemark() << "dilated pooling windows are not supported";
+      return matchFailure();
+    }
+
+    auto operand = operands[0];
+    auto operandShape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.operand(), typeConverter, rewriter);
+    auto initValue = operands[1];
+    auto initValueShape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.init_value(), typeConverter, rewriter);
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    auto dstShape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    auto elementType =
+        srcOp.operand().getType().cast<ShapedType>().getElementType();
+
+    int64_t rank = srcOp.window_dimensions().getNumElements();
+    auto windowDimensions = getI32ElementsAttrOr(srcOp.window_dimensions(),
+                                                 rank, 1, rewriter);
+    auto windowStrides =
+        getI32ElementsAttrOr(srcOp.window_stridesAttr(), rank, 1, rewriter);
+    auto padding =
+        getI32ElementsAttrOr(srcOp.paddingAttr(), rank * 2, 0, rewriter);
+
+    auto &computeOp = *srcOp.body().front().begin();
+    if (isa<mlir::AddIOp>(computeOp) || isa<mlir::AddFOp>(computeOp) ||
+        isa<xla_hlo::AddOp>(computeOp)) {
+      rewriter.create<IREE::VMLA::PoolingSumOp>(
+          srcOp.getLoc(), operand, operandShape, initValue, initValueShape,
+          dst, dstShape, windowDimensions, windowStrides, padding,
+          TypeAttr::get(elementType));
+    } else if (isa<xla_hlo::MinOp>(computeOp)) {
+      rewriter.create<IREE::VMLA::PoolingMinOp>(
+          srcOp.getLoc(), operand, operandShape, initValue, initValueShape,
+          dst, dstShape, windowDimensions, windowStrides, padding,
+          TypeAttr::get(elementType));
+    } else if (isa<xla_hlo::MaxOp>(computeOp)) {
+      rewriter.create<IREE::VMLA::PoolingMaxOp>(
+          srcOp.getLoc(), operand, operandShape, initValue, initValueShape,
+          dst, dstShape, windowDimensions, windowStrides, padding,
+          TypeAttr::get(elementType));
+    } else {
+      computeOp.emitRemark() << "unsupported builtin pooling operation";
+      return matchFailure();
+    }
+
+    rewriter.replaceOp(srcOp, {dst});
+    return matchSuccess();
+  }
+
+  TypeConverter &typeConverter;
+};
+
 // Converts a generic xla_hlo.reduce to a VM loop.
 //
 // Only supports single dimensional reductions and assumes that unrolling has
@@ -233,6 +308,7 @@ void populateHLOReductionToVMLAPatterns(MLIRContext *context,
                                                          typeConverter);
   patterns.insert<BuiltinReduceOpConversion>(context, typeConverter);
   patterns.insert<GenericReduceOpConversion>(context, typeConverter);
+  patterns.insert<BuiltinReduceWindowOpConversion>(context, typeConverter);
 }
 
 }  // namespace iree_compiler
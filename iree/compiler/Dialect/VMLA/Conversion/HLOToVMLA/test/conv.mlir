@@ -0,0 +1,37 @@
+// RUN: iree-opt -split-input-file -iree-vmla-conversion -cse %s | IreeFileCheck %s
+
+// CHECK-LABEL: @conv
+func @conv(%arg0: tensor<1x4x5x2xf32>, %arg1: tensor<3x2x2x1xf32>) -> tensor<1x2x3x1xf32> attributes { sym_visibility = "private" } {
+  //  CHECK-DAG: [[INPUT_SHAPE:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,5,2],i32>
+  //  CHECK-DAG: [[FILTER_SHAPE:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[3,2,2,1],i32>
+  //  CHECK-DAG: [[DST:%.+]] = "vmla.buffer.alloc"
+  //  CHECK-DAG: [[DST_SHAPE:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[1,2,3,1],i32>
+  // CHECK-NEXT: "vmla.conv"(%arg0, [[INPUT_SHAPE]], %arg1, [[FILTER_SHAPE]], [[DST]], [[DST_SHAPE]])
+  // CHECK-SAME: batch_group_count = 1 : i32
+  // CHECK-SAME: dst_type = f32
+  // CHECK-SAME: feature_group_count = 1 : i32
+  // CHECK-SAME: filter_type = f32
+  // CHECK-SAME: input_type = f32
+  // CHECK-SAME: lhs_dilation = dense<1> : vector<2xi32>
+  // CHECK-SAME: padding = dense<0> : vector<4xi32>
+  // CHECK-SAME: rhs_dilation = dense<1> : vector<2xi32>
+  // CHECK-SAME: window_strides = dense<[1, 2]> : vector<2xi32>
+  %0 = "xla_hlo.conv"(%arg0, %arg1) {
+    batch_group_count = 1 : i64,
+    dimension_numbers = {
+      input_batch_dimension = 0 : i64,
+      input_feature_dimension = 3 : i64,
+      input_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>,
+      kernel_input_feature_dimension = 2 : i64,
+      kernel_output_feature_dimension = 3 : i64,
+      kernel_spatial_dimensions = dense<[0, 1]> : tensor<2xi64>,
+      output_batch_dimension = 0 : i64,
+      output_feature_dimension = 3 : i64,
+      output_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>
+    },
+    feature_group_count = 1 : i64,
+    window_strides = dense<[1, 2]> : tensor<2xi64>
+  } : (tensor<1x4x5x2xf32>, tensor<3x2x2x1xf32>) -> tensor<1x2x3x1xf32>
+  // CHECK-NEXT: return [[DST]] : !vmla.buffer
+  return %0 : tensor<1x2x3x1xf32>
+}
@@ -0,0 +1,48 @@
+// RUN: iree-opt -split-input-file -iree-vmla-conversion -cse %s | IreeFileCheck %s
+
+// CHECK-LABEL: @max_pool
+func @max_pool(%arg0: tensor<1x4x6x1xf32>) -> tensor<1x2x3x1xf32> attributes { sym_visibility = "private" } {
+  // CHECK-DAG: [[INIT:%.+]] = "vmla.constant"() {value = dense<0xFF800000> : tensor<f32>} : () -> !vmla.buffer
+  %cst = constant dense<0xFF800000> : tensor<f32>
+  //  CHECK-DAG: [[SRC_SHAPE:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,6,1],i32>
+  //  CHECK-DAG: [[INIT_SHAPE:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[],i32>
+  //  CHECK-DAG: [[DST:%.+]] = "vmla.buffer.alloc"
+  //  CHECK-DAG: [[DST_SHAPE:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[1,2,3,1],i32>
+  // CHECK-NEXT: "vmla.pooling.max"(%arg0, [[SRC_SHAPE]], [[INIT]], [[INIT_SHAPE]], [[DST]], [[DST_SHAPE]])
+  // CHECK-SAME: element_type = f32
+  // CHECK-SAME: padding = dense<0> : vector<8xi32>
+  // CHECK-SAME: window_dimensions = dense<[1, 2, 2, 1]> : vector<4xi32>
+  // CHECK-SAME: window_strides = dense<[1, 2, 2, 1]> : vector<4xi32>
+  %0 = "xla_hlo.reduce_window"(%arg0, %cst) ( {
+  ^bb0(%arg1: tensor<f32>, %arg2: tensor<f32>):	// no predecessors
+    %1 = xla_hlo.max %arg1, %arg2 : tensor<f32>
+    "xla_hlo.return"(%1) : (tensor<f32>) -> ()
+  }) {
+    window_dimensions = dense<[1, 2, 2, 1]> : tensor<4xi64>,
+    window_strides = dense<[1, 2, 2, 1]> : tensor<4xi64>
+  } : (tensor<1x4x6x1xf32>, tensor<f32>) -> tensor<1x2x3x1xf32>
+  // CHECK-NEXT: return [[DST]] : !vmla.buffer
+  return %0 : tensor<1x2x3x1xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @sum_pool_padded
+func @sum_pool_padded(%arg0: tensor<4x4xi32>) -> tensor<2x2xi32> attributes { sym_visibility = "private" } {
+  %cst = constant dense<0> : tensor<i32>
+  // CHECK: "vmla.pooling.sum"
+  // CHECK-SAME: element_type = i32
+  // CHECK-SAME: padding = dense<[0, 1, 0, 1]> : vector<4xi32>
+  // CHECK-SAME: window_dimensions = dense<3> : vector<2xi32>
+  // CHECK-SAME: window_strides = dense<2> : vector<2xi32>
+  %0 = "xla_hlo.reduce_window"(%arg0, %cst) ( {
+  ^bb0(%arg1: tensor<i32>, %arg2: tensor<i32>):	// no predecessors
+    %1 = xla_hlo.add %arg1, %arg2 : tensor<i32>
+    "xla_hlo.return"(%1) : (tensor<i32>) -> ()
+  }) {
+    padding = dense<[[0, 1], [0, 1]]> : tensor<2x2xi64>,
+    window_dimensions = dense<3> : tensor<2xi64>,
+    window_strides = dense<2> : tensor<2xi64>
+  } : (tensor<4x4xi32>, tensor<i32>) -> tensor<2x2xi32>
+  return %0 : tensor<2x2xi32>
+}
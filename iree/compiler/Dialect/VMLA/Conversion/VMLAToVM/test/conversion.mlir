@@ -82,3 +82,61 @@ func @matmul(
        !shapex.ranked_shape<[4,4],i32>) -> ()
   return
 }
+
+// -----
+
+// CHECK-LABEL: vm.func @conv
+func @conv(
+    %input : !vmla.buffer,
+    %input_shape : !shapex.ranked_shape<[1,4,5,2],i32>,
+    %filter : !vmla.buffer,
+    %filter_shape : !shapex.ranked_shape<[3,2,2,1],i32>,
+    %dst : !vmla.buffer,
+    %dst_shape : !shapex.ranked_shape<[1,2,3,1],i32>) {
+  // CHECK: vm.call.variadic @vmla.conv.f32f32.f32(
+  // CHECK-SAME: %arg0, [%c1, %c4, %c5, %c2],
+  // CHECK-SAME: %arg1, [%c3, %c2, %c2, %c1],
+  // CHECK-SAME: %arg2, [%c1, %c2, %c3, %c1],
+  // CHECK-SAME: [%c1, %c2], [%zero, %zero, %zero, %zero], [%c1, %c1], [%c1, %c1], %c1, %c1)
+  "vmla.conv"(%input, %input_shape, %filter, %filter_shape, %dst, %dst_shape)
+      { window_strides = dense<[1, 2]> : vector<2xi32>,
+        padding = dense<0> : vector<4xi32>,
+        lhs_dilation = dense<1> : vector<2xi32>,
+        rhs_dilation = dense<1> : vector<2xi32>,
+        feature_group_count = 1 : i32, batch_group_count = 1 : i32,
+        input_type = f32, filter_type = f32, dst_type = f32 } :
+      (!vmla.buffer,
+       !shapex.ranked_shape<[1,4,5,2],i32>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[3,2,2,1],i32>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[1,2,3,1],i32>) -> ()
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @pooling_max
+func @pooling_max(
+    %src : !vmla.buffer,
+    %src_shape : !shapex.ranked_shape<[4,6],i32>,
+    %init : !vmla.buffer,
+    %init_shape : !shapex.ranked_shape<[],i32>,
+    %dst : !vmla.buffer,
+    %dst_shape : !shapex.ranked_shape<[2,3],i32>) {
+  // CHECK: vm.call.variadic @vmla.pooling.max.f32(
+  // CHECK-SAME: %arg0, [%c4, %c6], %arg1, [], %arg2, [%c2, %c3],
+  // CHECK-SAME: [%c2, %c2], [%c2, %c2], [%zero, %zero, %zero, %zero])
+  "vmla.pooling.max"(%src, %src_shape, %init, %init_shape, %dst, %dst_shape)
+      { window_dimensions = dense<2> : vector<2xi32>,
+        window_strides = dense<2> : vector<2xi32>,
+        padding = dense<0> : vector<4xi32>,
+        element_type = f32 } :
+      (!vmla.buffer,
+       !shapex.ranked_shape<[4,6],i32>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[],i32>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[2,3],i32>) -> ()
+  return
+}
@@ -311,6 +311,22 @@ vm.import @matmul.f32f32.f32(
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
 
+//===----------------------------------------------------------------------===//
+// VMLA Ops: convolution
+//===----------------------------------------------------------------------===//
+
+vm.import @conv.f32f32.f32(
+  %input : !vm.ref<!vmla.buffer>, %input_shape : i32 ...,
+  %filter : !vm.ref<!vmla.buffer>, %filter_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...,
+  %lhs_dilation : i32 ...,
+  %rhs_dilation : i32 ...,
+  %feature_group_count : i32,
+  %batch_group_count : i32
+)
+
 //===----------------------------------------------------------------------===//
 // VMLA Ops: reduction
 //===----------------------------------------------------------------------===//
@@ -390,4 +406,107 @@ vm.import @reduce.max.f32(
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
 
+//===----------------------------------------------------------------------===//
+// VMLA Ops: pooling
+//===----------------------------------------------------------------------===//
+
+vm.import @pooling.sum.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.sum.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.sum.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.sum.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+
+vm.import @pooling.min.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.min.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.min.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.min.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+
+vm.import @pooling.max.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.max.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.max.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+vm.import @pooling.max.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions : i32 ...,
+  %window_strides : i32 ...,
+  %padding : i32 ...
+)
+
 }  // module
@@ -16,6 +16,7 @@
 #define IREE_HAL_ALLOCATOR_H_
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 
 #include "absl/types/span.h"
@@ -114,6 +115,20 @@ class Allocator : public RefObject<Allocator> {
                                         MemoryAccessBitfield allowed_access,
                                         BufferUsageBitfield buffer_usage,
                                         absl::Span<T> data);
+
+  // Wraps an existing host allocation in a buffer as with WrapMutable and
+  // calls |release_callback| once the buffer has been destroyed and the memory
+  // is no longer in use. This allows callers to tie the lifetime of the host
+  // allocation to the buffer instead of having to guarantee it externally.
+  //
+  // |release_callback| may be called from any thread. It is not called if the
+  // wrap fails.
+  //
+  // Fails if the allocator cannot access host memory in this way.
+  virtual StatusOr<ref_ptr<Buffer>> WrapMutableWithRelease(
+      MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+      BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+      std::function<void()> release_callback);
 };
 
 // Inline functions and template definitions follow:
@@ -473,6 +473,21 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_allocator_wrap_buffer(
     iree_hal_buffer_usage_t buffer_usage, iree_byte_span_t data,
     iree_hal_buffer_t** out_buffer);
 
+// Wraps an existing host allocation in a buffer and transfers ownership of the
+// allocation to the buffer. |data_allocator| will be used to free |data| once
+// the buffer has been destroyed and the memory is no longer in use; the free
+// may happen on any thread. If the wrap fails ownership remains with the
+// caller and |data_allocator| is not used.
+//
+// Fails if the allocator cannot access host memory in this way.
+// |out_buffer| must be released by the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_allocator_wrap_buffer_with_release(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t buffer_usage, iree_byte_span_t data,
+    iree_allocator_t data_allocator, iree_hal_buffer_t** out_buffer);
+
 #endif  // IREE_API_NO_PROTOTYPES
 
 //===----------------------------------------------------------------------===//
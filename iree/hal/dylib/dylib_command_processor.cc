@@ -0,0 +1,78 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_command_processor.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/buffer.h"
+#include "iree/hal/dylib/dylib_executable.h"
+#include "iree/hal/llvmjit/memref_runtime.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+using llvmjit::allocUnrankedDescriptor;
+using llvmjit::freeUnrankedDescriptor;
+using llvmjit::UnrankedMemRefType;
+
+DyLibCommandProcessor::DyLibCommandProcessor(
+    Allocator* allocator, CommandBufferModeBitfield mode,
+    CommandCategoryBitfield command_categories)
+    : HostLocalCommandProcessor(allocator, mode, command_categories) {}
+
+DyLibCommandProcessor::~DyLibCommandProcessor() = default;
+
+Status DyLibCommandProcessor::Dispatch(
+    const DispatchRequest& dispatch_request) {
+  IREE_TRACE_SCOPE0("DyLibCommandProcessor::Dispatch");
+  auto* executable = static_cast<DyLibExecutable*>(dispatch_request.executable);
+
+  // Entry points use the same memref descriptor ABI as the llvmjit backend.
+  using Descriptor = UnrankedMemRefType<uint32_t>;
+  using DescriptorPtr = std::unique_ptr<Descriptor, void (*)(Descriptor*)>;
+  const auto& bindings = dispatch_request.bindings;
+  std::vector<MappedMemory<uint32_t>> mappings;
+  std::vector<DescriptorPtr> descriptors;
+  absl::InlinedVector<void*, 4> args;
+  mappings.reserve(bindings.size());
+  descriptors.reserve(bindings.size());
+  args.reserve(bindings.size());
+  for (const auto& binding : bindings) {
+    // Constant operands may be backed by read-only buffers (such as module
+    // rodata) and must not be mapped for writing.
+    ASSIGN_OR_RETURN(auto memory,
+                     binding.buffer->MapMemory<uint32_t>(
+                         binding.access & binding.buffer->allowed_access() &
+                         (MemoryAccess::kRead | MemoryAccess::kWrite)));
+    mappings.push_back(std::move(memory));
+    const std::vector<int64_t> shape(binding.shape.begin(),
+                                     binding.shape.end());
+    descriptors.emplace_back(allocUnrankedDescriptor<uint32_t>(
+                                 mappings.back().unsafe_data(), shape),
+                             &freeUnrankedDescriptor<uint32_t>);
+    args.push_back(descriptors.back()->descriptor);
+  }
+
+  return executable->Invoke(dispatch_request.entry_point,
+                            absl::MakeSpan(args));
+}
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,125 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_command_processor.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/hal/dylib/dylib_executable.h"
+#include "iree/hal/dylib/dylib_executable_test_data.h"
+#include "iree/hal/executable_format.h"
+#include "iree/hal/host/host_local_allocator.h"
+#include "iree/schemas/dylib_executable_def_generated.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+namespace {
+
+constexpr MemoryTypeBitfield kMemoryType =
+    MemoryType::kHostLocal | MemoryType::kDeviceVisible;
+
+class DyLibCommandProcessorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const auto* library_toc = dylib_executable_test_data_create();
+    DyLibExecutableDefT executable_def;
+    executable_def.entry_points = {"add_memref"};
+    executable_def.library_embedded.assign(
+        reinterpret_cast<const uint8_t*>(library_toc->data),
+        reinterpret_cast<const uint8_t*>(library_toc->data) +
+            library_toc->size);
+    ::flatbuffers::FlatBufferBuilder fbb;
+    FinishDyLibExecutableDefBuffer(
+        fbb, DyLibExecutableDef::Pack(fbb, &executable_def));
+    ExecutableSpec spec;
+    spec.format = kExecutableFormatDyLib;
+    spec.executable_data = {fbb.GetBufferPointer(), fbb.GetSize()};
+    ASSERT_OK_AND_ASSIGN(executable_, DyLibExecutable::Load(spec));
+  }
+
+  // Dispatches add_memref with |lhs| and |rhs| and returns the result.
+  StatusOr<int32_t> DispatchAdd(Buffer* lhs, Buffer* rhs) {
+    ASSIGN_OR_RETURN(auto result,
+                     allocator_.Allocate(kMemoryType, BufferUsage::kAll,
+                                         sizeof(int32_t)));
+    DispatchRequest dispatch_request;
+    dispatch_request.executable = executable_.get();
+    dispatch_request.entry_point = 0;
+    dispatch_request.workload = {1, 1, 1};
+    BufferBinding bindings[] = {
+        {MemoryAccess::kAll, lhs, {}, sizeof(int32_t)},
+        {MemoryAccess::kAll, rhs, {}, sizeof(int32_t)},
+        {MemoryAccess::kAll, result.get(), {}, sizeof(int32_t)},
+    };
+    dispatch_request.bindings = bindings;
+
+    DyLibCommandProcessor command_processor(
+        &allocator_, CommandBufferMode::kOneShot, CommandCategory::kDispatch);
+    RETURN_IF_ERROR(command_processor.Begin());
+    RETURN_IF_ERROR(command_processor.Dispatch(dispatch_request));
+    RETURN_IF_ERROR(command_processor.End());
+
+    int32_t value = 0;
+    RETURN_IF_ERROR(result->ReadData(0, &value, sizeof(value)));
+    return value;
+  }
+
+  HostLocalAllocator allocator_;
+  ref_ptr<DyLibExecutable> executable_;
+};
+
+TEST_F(DyLibCommandProcessorTest, Dispatch) {
+  int32_t lhs_value = 40;
+  int32_t rhs_value = 2;
+  ASSERT_OK_AND_ASSIGN(
+      auto lhs, allocator_.WrapMutable(kMemoryType, MemoryAccess::kAll,
+                                       BufferUsage::kAll, &lhs_value,
+                                       sizeof(lhs_value)));
+  ASSERT_OK_AND_ASSIGN(
+      auto rhs, allocator_.WrapMutable(kMemoryType, MemoryAccess::kAll,
+                                       BufferUsage::kAll, &rhs_value,
+                                       sizeof(rhs_value)));
+  ASSERT_OK_AND_ASSIGN(int32_t result, DispatchAdd(lhs.get(), rhs.get()));
+  EXPECT_EQ(42, result);
+}
+
+// Constant operands (such as module rodata) are wrapped read-only and must
+// still be usable as dispatch inputs.
+TEST_F(DyLibCommandProcessorTest, DispatchWithConstantOperand) {
+  static const int32_t kConstant = 40;
+  int32_t rhs_value = 2;
+  ASSERT_OK_AND_ASSIGN(
+      auto lhs, allocator_.Wrap(kMemoryType, BufferUsage::kAll, &kConstant,
+                                sizeof(kConstant)));
+  ASSERT_FALSE(AnyBitSet(lhs->allowed_access() & MemoryAccess::kWrite));
+  ASSERT_OK_AND_ASSIGN(
+      auto rhs, allocator_.WrapMutable(kMemoryType, MemoryAccess::kAll,
+                                       BufferUsage::kAll, &rhs_value,
+                                       sizeof(rhs_value)));
+  ASSERT_OK_AND_ASSIGN(int32_t result, DispatchAdd(lhs.get(), rhs.get()));
+  EXPECT_EQ(42, result);
+  EXPECT_EQ(40, kConstant);
+}
+
+}  // namespace
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
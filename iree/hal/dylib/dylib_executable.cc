@@ -0,0 +1,115 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_executable.h"
+
+#include "absl/strings/str_cat.h"
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/file_io.h"
+#include "iree/base/tracing.h"
+#include "iree/schemas/dylib_executable_def_generated.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+// static
+StatusOr<ref_ptr<DyLibExecutable>> DyLibExecutable::Load(ExecutableSpec spec) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::Load");
+  auto executable = make_ref<DyLibExecutable>();
+  RETURN_IF_ERROR(executable->Initialize(spec));
+  return executable;
+}
+
+DyLibExecutable::DyLibExecutable() = default;
+
+DyLibExecutable::~DyLibExecutable() {
+  IREE_TRACE_SCOPE0("DyLibExecutable::dtor");
+  // The library must be unloaded before the backing file can be deleted on
+  // some platforms.
+  executable_library_.reset();
+  if (!library_temp_path_.empty()) {
+    file_io::DeleteFile(library_temp_path_).IgnoreError();
+  }
+}
+
+Status DyLibExecutable::Initialize(ExecutableSpec spec) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::Initialize");
+
+  if (spec.executable_data.size() < 8 ||
+      !DyLibExecutableDefBufferHasIdentifier(spec.executable_data.data())) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Executable data does not have a DyLibExecutableDef identifier";
+  }
+  ::flatbuffers::Verifier verifier(spec.executable_data.data(),
+                                   spec.executable_data.size());
+  if (!VerifyDyLibExecutableDefBuffer(verifier)) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "DyLibExecutableDef failed verification";
+  }
+  auto executable_def =
+      ::flatbuffers::GetRoot<DyLibExecutableDef>(spec.executable_data.data());
+  if (!executable_def->entry_points() ||
+      executable_def->entry_points()->size() == 0) {
+    return InvalidArgumentErrorBuilder(IREE_LOC) << "No entry points defined";
+  }
+  if (!executable_def->library_embedded() ||
+      executable_def->library_embedded()->size() == 0) {
+    return InvalidArgumentErrorBuilder(IREE_LOC) << "No embedded library";
+  }
+
+  // The system loader can only load libraries from files so we write the
+  // embedded library out to a temporary one. The data is copied so it is not
+  // aliased after loading.
+  ASSIGN_OR_RETURN(library_temp_path_,
+                   file_io::GetTempFile("dylib_executable"));
+  std::string library_data(
+      reinterpret_cast<const char*>(executable_def->library_embedded()->data()),
+      executable_def->library_embedded()->size());
+  RETURN_IF_ERROR(file_io::SetFileContents(library_temp_path_, library_data));
+  ASSIGN_OR_RETURN(executable_library_,
+                   DynamicLibrary::Load(library_temp_path_.c_str()));
+
+  const auto& entry_points = *executable_def->entry_points();
+  entry_functions_.resize(entry_points.size());
+  for (int i = 0; i < entry_functions_.size(); ++i) {
+    std::string symbol_name =
+        absl::StrCat("invoke_", entry_points[i]->str());
+    void* symbol = executable_library_->GetSymbol(symbol_name.c_str());
+    if (!symbol) {
+      return NotFoundErrorBuilder(IREE_LOC)
+             << "Could not find symbol '" << symbol_name << "' in library";
+    }
+    entry_functions_[i] = symbol;
+  }
+
+  return OkStatus();
+}
+
+Status DyLibExecutable::Invoke(int entry_ordinal,
+                               absl::Span<void*> args) const {
+  IREE_TRACE_SCOPE0("DyLibExecutable::Invoke");
+  if (entry_ordinal < 0 || entry_ordinal >= entry_functions_.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Entry point ordinal " << entry_ordinal << " out of range";
+  }
+  auto entry_function = reinterpret_cast<void (*)(void**)>(
+      entry_functions_[entry_ordinal]);
+  entry_function(args.data());
+  return OkStatus();
+}
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,113 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_executable.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/hal/dylib/dylib_executable_test_data.h"
+#include "iree/hal/executable_format.h"
+#include "iree/schemas/dylib_executable_def_generated.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+namespace {
+
+// Packs a DyLibExecutableDef embedding the test library with |entry_points|.
+std::vector<uint8_t> CreateExecutableData(
+    std::vector<std::string> entry_points) {
+  const auto* library_toc = dylib_executable_test_data_create();
+  DyLibExecutableDefT executable_def;
+  executable_def.entry_points = std::move(entry_points);
+  executable_def.library_embedded.assign(
+      reinterpret_cast<const uint8_t*>(library_toc->data),
+      reinterpret_cast<const uint8_t*>(library_toc->data) + library_toc->size);
+  ::flatbuffers::FlatBufferBuilder fbb;
+  FinishDyLibExecutableDefBuffer(
+      fbb, DyLibExecutableDef::Pack(fbb, &executable_def));
+  return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+StatusOr<ref_ptr<DyLibExecutable>> LoadExecutable(
+    absl::Span<const uint8_t> executable_data) {
+  ExecutableSpec spec;
+  spec.format = kExecutableFormatDyLib;
+  spec.executable_data = executable_data;
+  return DyLibExecutable::Load(spec);
+}
+
+TEST(DyLibExecutableTest, InvokeEntryPoint) {
+  auto executable_data = CreateExecutableData({"add_one"});
+  ASSERT_OK_AND_ASSIGN(auto executable, LoadExecutable(executable_data));
+
+  int32_t input = 41;
+  int32_t output = 0;
+  void* args[] = {&input, &output};
+  ASSERT_OK(executable->Invoke(0, absl::MakeSpan(args)));
+  EXPECT_EQ(42, output);
+}
+
+TEST(DyLibExecutableTest, ExecutableDataNotAliased) {
+  auto executable_data = CreateExecutableData({"add_one"});
+  ASSERT_OK_AND_ASSIGN(auto executable, LoadExecutable(executable_data));
+  // The library must remain loaded after the source data is gone.
+  executable_data.clear();
+  executable_data.shrink_to_fit();
+
+  int32_t input = 1;
+  int32_t output = 0;
+  void* args[] = {&input, &output};
+  ASSERT_OK(executable->Invoke(0, absl::MakeSpan(args)));
+  EXPECT_EQ(2, output);
+}
+
+TEST(DyLibExecutableTest, EntryPointOrdinalOutOfRange) {
+  auto executable_data = CreateExecutableData({"add_one"});
+  ASSERT_OK_AND_ASSIGN(auto executable, LoadExecutable(executable_data));
+
+  int32_t input = 0;
+  int32_t output = 0;
+  void* args[] = {&input, &output};
+  EXPECT_TRUE(IsInvalidArgument(executable->Invoke(1, absl::MakeSpan(args))));
+  EXPECT_TRUE(IsInvalidArgument(executable->Invoke(-1, absl::MakeSpan(args))));
+  EXPECT_EQ(0, output);
+}
+
+TEST(DyLibExecutableTest, MissingEntryPointSymbol) {
+  auto executable_data = CreateExecutableData({"add_one", "missing"});
+  EXPECT_TRUE(IsNotFound(LoadExecutable(executable_data).status()));
+}
+
+TEST(DyLibExecutableTest, NoEntryPoints) {
+  auto executable_data = CreateExecutableData({});
+  EXPECT_TRUE(IsInvalidArgument(LoadExecutable(executable_data).status()));
+}
+
+TEST(DyLibExecutableTest, InvalidExecutableData) {
+  std::vector<uint8_t> executable_data(64, 0xCD);
+  EXPECT_TRUE(IsInvalidArgument(LoadExecutable(executable_data).status()));
+}
+
+}  // namespace
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,44 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Shared library embedded into executables by dylib_executable_test.
+//
+// Exports entry points with the `invoke_<name>(void** args)` calling
+// convention of ahead-of-time compiled dylib executables.
+
+#include <stdint.h>
+
+// Rank-0 memref descriptor as passed for each binding by
+// DyLibCommandProcessor.
+typedef struct {
+  int32_t* base_ptr;
+  int32_t* data;
+  int64_t offset;
+} memref_0d_i32_t;
+
+// Each argument points to a single int32_t.
+void invoke_add_one(void** args) {
+  const int32_t* input = (const int32_t*)args[0];
+  int32_t* output = (int32_t*)args[1];
+  *output = *input + 1;
+}
+
+// Each argument points to a rank-0 memref descriptor.
+void invoke_add_memref(void** args) {
+  const memref_0d_i32_t* lhs = (const memref_0d_i32_t*)args[0];
+  const memref_0d_i32_t* rhs = (const memref_0d_i32_t*)args[1];
+  const memref_0d_i32_t* result = (const memref_0d_i32_t*)args[2];
+  result->data[result->offset] =
+      lhs->data[lhs->offset] + rhs->data[rhs->offset];
+}
@@ -23,21 +23,42 @@ namespace hal {
 
 AsyncCommandQueue::AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue)
     : CommandQueue(target_queue->name(), target_queue->supported_categories()),
-      target_queue_(std::move(target_queue)) {
+      target_queue_(std::move(target_queue)),
+      submission_queue_(this) {
   IREE_TRACE_SCOPE0("AsyncCommandQueue::ctor");
   thread_ = std::thread([this]() { ThreadMain(); });
 }
 
+AsyncCommandQueue::AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue,
+                                     WorkStealingThreadPool* thread_pool)
+    : CommandQueue(target_queue->name(), target_queue->supported_categories()),
+      target_queue_(std::move(target_queue)),
+      thread_pool_(thread_pool),
+      submission_queue_(this) {
+  IREE_TRACE_SCOPE0("AsyncCommandQueue::ctor");
+}
+
 AsyncCommandQueue::~AsyncCommandQueue() {
   IREE_TRACE_SCOPE0("AsyncCommandQueue::dtor");
   {
-    // Signal to thread that we want to stop. Note that the thread may have
-    // already been stopped and that's ok (as we'll Join right away).
-    // The thread will finish processing any queued submissions.
+    // Signal that we want to stop. Note that the thread may have already been
+    // stopped and that's ok (as we'll Join right away).
+    // Any queued submissions that are ready will still be processed.
     absl::MutexLock lock(&submission_mutex_);
     submission_queue_.SignalShutdown();
   }
-  thread_.join();
+  Wake();
+  if (thread_pool_) {
+    // Wait for the last drain task to finish with the queue.
+    absl::MutexLock lock(&submission_mutex_);
+    submission_mutex_.Await(absl::Condition(
+        +[](std::atomic<int>* pending_wake_count) {
+          return pending_wake_count->load(std::memory_order_acquire) == 0;
+        },
+        &pending_wake_count_));
+  } else {
+    thread_.join();
+  }
 
   // Ensure we shut down OK.
   {
@@ -47,61 +68,95 @@ AsyncCommandQueue::~AsyncCommandQueue() {
   }
 }
 
+void AsyncCommandQueue::Wake() {
+  if (thread_pool_) {
+    if (pending_wake_count_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+      thread_pool_->Schedule([this]() { DrainTask(); });
+    }
+  } else {
+    absl::MutexLock lock(&wake_mutex_);
+    wake_pending_ = true;
+  }
+}
+
 void AsyncCommandQueue::ThreadMain() {
   // TODO(benvanik): make this safer (may die if trace is flushed late).
   IREE_TRACE_THREAD_ENABLE(target_queue_->name().c_str());
 
   bool is_exiting = false;
   while (!is_exiting) {
-    // Block until we are either requested to exit or there are pending
-    // submissions.
-    submission_mutex_.Lock();
-    submission_mutex_.Await(absl::Condition(
-        +[](HostSubmissionQueue* queue) {
-          return queue->has_shutdown() || !queue->empty();
-        },
-        &submission_queue_));
-    if (!submission_queue_.empty()) {
-      // Run all ready submissions (this may be called many times).
-      submission_mutex_.AssertHeld();
-      submission_queue_
-          .ProcessBatches(
-              [this](absl::Span<CommandBuffer* const> command_buffers)
-                  ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_) {
-                    // Release the lock while we perform the processing so that
-                    // other threads can submit more work.
-                    submission_mutex_.AssertHeld();
-                    submission_mutex_.Unlock();
-
-                    // Relay the command buffers to the target queue.
-                    // Since we are taking care of all synchronization they
-                    // don't need any waiters or fences.
-                    auto status = target_queue_->Submit(
-                        {{}, command_buffers, {}}, {nullptr, 0u});
-
-                    // Take back the lock so we can manipulate the queue safely.
-                    submission_mutex_.Lock();
-                    submission_mutex_.AssertHeld();
-
-                    return status;
-                  })
-          .IgnoreError();
-      submission_mutex_.AssertHeld();
+    {
+      // Block until there are new submissions, a semaphore we are waiting on
+      // was signaled, or we are requested to exit.
+      absl::MutexLock lock(&wake_mutex_);
+      wake_mutex_.Await(absl::Condition(&wake_pending_));
+      wake_pending_ = false;
     }
+    absl::MutexLock lock(&submission_mutex_);
+    ProcessReadyBatches();
     if (submission_queue_.has_shutdown()) {
       // Exit when there are no more submissions to process and an exit was
       // requested (or we errored out).
       is_exiting = true;
     }
-    submission_mutex_.Unlock();
   }
 }
 
+void AsyncCommandQueue::DrainTask() {
+  IREE_TRACE_SCOPE0("AsyncCommandQueue::DrainTask");
+  absl::MutexLock lock(&submission_mutex_);
+  int wake_count = pending_wake_count_.load(std::memory_order_acquire);
+  while (true) {
+    ProcessReadyBatches();
+    // Retire the wakes we have handled. Any that arrived while we were
+    // processing may have made more batches ready so we go around again.
+    int remaining_count =
+        pending_wake_count_.fetch_sub(wake_count, std::memory_order_acq_rel) -
+        wake_count;
+    if (remaining_count == 0) break;
+    wake_count = remaining_count;
+  }
+}
+
+void AsyncCommandQueue::ProcessReadyBatches() {
+  if (submission_queue_.empty()) return;
+
+  // Run all ready submissions (this may be called many times).
+  submission_mutex_.AssertHeld();
+  submission_queue_
+      .ProcessBatches(
+          [this](absl::Span<CommandBuffer* const> command_buffers)
+              ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_) {
+                // Release the lock while we perform the processing so that
+                // other threads can submit more work.
+                submission_mutex_.AssertHeld();
+                submission_mutex_.Unlock();
+
+                // Relay the command buffers to the target queue.
+                // Since we are taking care of all synchronization they
+                // don't need any waiters or fences.
+                auto status = target_queue_->Submit(
+                    {{}, command_buffers, {}}, {nullptr, 0u});
+
+                // Take back the lock so we can manipulate the queue safely.
+                submission_mutex_.Lock();
+                submission_mutex_.AssertHeld();
+
+                return status;
+              })
+      .IgnoreError();
+  submission_mutex_.AssertHeld();
+}
+
 Status AsyncCommandQueue::Submit(absl::Span<const SubmissionBatch> batches,
                                  FenceValue fence) {
   IREE_TRACE_SCOPE0("AsyncCommandQueue::Submit");
-  absl::MutexLock lock(&submission_mutex_);
-  return submission_queue_.Enqueue(batches, fence);
+  {
+    absl::MutexLock lock(&submission_mutex_);
+    RETURN_IF_ERROR(submission_queue_.Enqueue(batches, fence));
+  }
+  Wake();
+  return OkStatus();
 }
 
 Status AsyncCommandQueue::WaitIdle(absl::Time deadline) {
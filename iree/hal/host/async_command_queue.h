@@ -15,6 +15,7 @@
 #ifndef IREE_HAL_HOST_ASYNC_COMMAND_QUEUE_H_
 #define IREE_HAL_HOST_ASYNC_COMMAND_QUEUE_H_
 
+#include <atomic>
 #include <memory>
 #include <thread>  // NOLINT
 
@@ -23,25 +24,40 @@
 #include "iree/hal/command_queue.h"
 #include "iree/hal/fence.h"
 #include "iree/hal/host/host_submission_queue.h"
+#include "iree/hal/host/work_stealing_thread_pool.h"
 
 namespace iree {
 namespace hal {
 
 // Asynchronous command queue wrapper.
-// This creates a single thread to perform all CommandQueue operations. Any
-// submitted CommandBuffer is dispatched in FIFO order on the queue thread
-// against the provided |target_queue|.
+// Submissions are processed off of the submitting thread, either on a single
+// thread dedicated to the queue or as tasks on a thread pool shared with other
+// queues. Any submitted CommandBuffer is dispatched in FIFO order against the
+// provided |target_queue|.
 //
 // Target queues will receive submissions containing only command buffers as
 // all semaphore synchronization is handled by the wrapper. Fences will also be
 // omitted and code should safely handle nullptr.
 //
+// Batches waiting on semaphores signaled by other queues are picked up as soon
+// as the signal happens: the signaling queue wakes the waiting one directly.
+//
 // AsyncCommandQueue (as with CommandQueue) is thread-safe. Multiple threads
 // may submit command buffers concurrently, though the order of execution in
 // such a case depends entirely on the synchronization primitives provided.
-class AsyncCommandQueue final : public CommandQueue {
+class AsyncCommandQueue final : public CommandQueue,
+                                private HostSemaphoreWaiter {
  public:
+  // Creates a queue that processes submissions on its own thread.
   explicit AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue);
+
+  // Creates a queue that processes submissions as tasks on |thread_pool|.
+  // Multiple queues may share the same pool: each queue processes its own
+  // submissions in order while submissions to different queues run
+  // concurrently. |thread_pool| must outlive the queue.
+  AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue,
+                    WorkStealingThreadPool* thread_pool);
+
   ~AsyncCommandQueue() override;
 
   Status Submit(absl::Span<const SubmissionBatch> batches,
@@ -50,15 +66,38 @@ class AsyncCommandQueue final : public CommandQueue {
   Status WaitIdle(absl::Time deadline) override;
 
  private:
-  // Thread entry point for the async worker thread.
-  // Waits for submissions to be queued up and processes them eagerly.
+  // HostSemaphoreWaiter:
+  void OnSemaphoreSignaled() override { Wake(); }
+
+  // Schedules the queue to process any newly-ready submissions.
+  void Wake();
+
+  // Thread entry point for the dedicated worker thread.
+  // Waits for wakes and processes submissions eagerly.
   void ThreadMain();
 
+  // Thread pool task that processes submissions until no wakes remain.
+  void DrainTask();
+
+  // Runs all ready submissions against the target queue.
+  void ProcessReadyBatches() ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_);
+
   // CommandQueue that the async queue relays submissions into.
   std::unique_ptr<CommandQueue> target_queue_;
 
-  // Thread that runs the ThreadMain() function and processes submissions.
+  // Shared pool the queue processes submissions on or nullptr if the queue
+  // has a dedicated thread.
+  WorkStealingThreadPool* thread_pool_ = nullptr;
+
+  // Thread that runs the ThreadMain() function and processes submissions when
+  // not using a thread pool.
   std::thread thread_;
+  absl::Mutex wake_mutex_;
+  bool wake_pending_ ABSL_GUARDED_BY(wake_mutex_) = false;
+
+  // Number of wakes not yet handled by a DrainTask. A task is scheduled on the
+  // transition from 0 so that only one processes the queue at a time.
+  std::atomic<int> pending_wake_count_{0};
 
   // Queue that manages submission ordering.
   mutable absl::Mutex submission_mutex_;
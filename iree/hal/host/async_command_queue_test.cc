@@ -14,11 +14,13 @@
 
 #include "iree/hal/host/async_command_queue.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "iree/base/status.h"
@@ -26,6 +28,7 @@
 #include "iree/base/time.h"
 #include "iree/hal/command_queue.h"
 #include "iree/hal/host/host_submission_queue.h"
+#include "iree/hal/host/work_stealing_thread_pool.h"
 #include "iree/hal/testing/mock_command_buffer.h"
 #include "iree/hal/testing/mock_command_queue.h"
 #include "iree/testing/gtest.h"
@@ -35,6 +38,7 @@ namespace hal {
 namespace {
 
 using ::testing::_;
+using ::testing::Return;
 
 using testing::MockCommandBuffer;
 using testing::MockCommandQueue;
@@ -227,6 +231,141 @@ TEST_F(AsyncCommandQueueTest, FailuresCascadeAcrossSubmits) {
   EXPECT_TRUE(IsDataLoss(command_queue->WaitIdle()));
 }
 
+// Tests that a batch waiting on a semaphore signaled by another queue is woken
+// up and run when the signal happens.
+TEST_F(AsyncCommandQueueTest, WaitOnSemaphoreFromOtherQueue) {
+  auto other_mock_queue = absl::make_unique<MockCommandQueue>(
+      "other", CommandCategory::kTransfer | CommandCategory::kDispatch);
+  auto* other_mock_target_queue = other_mock_queue.get();
+  std::unique_ptr<CommandQueue> other_command_queue =
+      absl::make_unique<AsyncCommandQueue>(std::move(other_mock_queue));
+
+  EXPECT_CALL(*other_mock_target_queue, Submit(_, _))
+      .WillOnce(
+          [](absl::Span<const SubmissionBatch> batches, FenceValue fence) {
+            Sleep(absl::Milliseconds(100));
+            return OkStatus();
+          });
+  EXPECT_CALL(*mock_target_queue, Submit(_, _)).WillOnce(Return(OkStatus()));
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+
+  // Queue the waiting batch first so that it must be woken by the signal.
+  HostBinarySemaphore semaphore_0_1(false);
+  HostFence fence_1(0u);
+  ASSERT_OK(command_queue->Submit({{&semaphore_0_1}, {cmd_buffer_1.get()}, {}},
+                                  {&fence_1, 1u}));
+  HostFence fence_0(0u);
+  ASSERT_OK(other_command_queue->Submit(
+      {{}, {cmd_buffer_0.get()}, {&semaphore_0_1}}, {&fence_0, 1u}));
+
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+}
+
+struct PooledAsyncCommandQueueTest : public ::testing::Test {
+  static constexpr int kQueueCount = 2;
+
+  std::unique_ptr<WorkStealingThreadPool> thread_pool;
+  MockCommandQueue* mock_target_queues[kQueueCount];
+  std::unique_ptr<CommandQueue> command_queues[kQueueCount];
+
+  void SetUp() override {
+    thread_pool = absl::make_unique<WorkStealingThreadPool>("test", 2);
+    for (int i = 0; i < kQueueCount; ++i) {
+      auto mock_queue = absl::make_unique<MockCommandQueue>(
+          "mock", CommandCategory::kTransfer | CommandCategory::kDispatch);
+      mock_target_queues[i] = mock_queue.get();
+      command_queues[i] = absl::make_unique<AsyncCommandQueue>(
+          std::move(mock_queue), thread_pool.get());
+    }
+  }
+
+  void TearDown() override {
+    for (int i = 0; i < kQueueCount; ++i) {
+      command_queues[i].reset();
+      mock_target_queues[i] = nullptr;
+    }
+    thread_pool.reset();
+  }
+};
+
+// Tests that submissions to different queues sharing a pool run concurrently:
+// the second queue must make progress while the first is blocked.
+TEST_F(PooledAsyncCommandQueueTest, IndependentQueuesRunConcurrently) {
+  absl::Notification release_queue_0;
+  EXPECT_CALL(*mock_target_queues[0], Submit(_, _))
+      .WillOnce(
+          [&](absl::Span<const SubmissionBatch> batches, FenceValue fence) {
+            release_queue_0.WaitForNotification();
+            return OkStatus();
+          });
+  EXPECT_CALL(*mock_target_queues[1], Submit(_, _))
+      .WillOnce(Return(OkStatus()));
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+
+  HostFence fence_0(0u);
+  ASSERT_OK(command_queues[0]->Submit({{}, {cmd_buffer_0.get()}, {}},
+                                      {&fence_0, 1u}));
+  HostFence fence_1(0u);
+  ASSERT_OK(command_queues[1]->Submit({{}, {cmd_buffer_1.get()}, {}},
+                                      {&fence_1, 1u}));
+
+  // Completes while queue 0 is still blocked.
+  ASSERT_OK(HostFence::WaitForFences({{&fence_1, 1u}}, /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+  ASSERT_OK_AND_ASSIGN(uint64_t value_0, fence_0.QueryValue());
+  EXPECT_EQ(0u, value_0);
+
+  release_queue_0.Notify();
+  ASSERT_OK(command_queues[0]->WaitIdle());
+  ASSERT_OK_AND_ASSIGN(value_0, fence_0.QueryValue());
+  EXPECT_EQ(1u, value_0);
+}
+
+// Tests that semaphores order work across pooled queues.
+TEST_F(PooledAsyncCommandQueueTest, WaitOnSemaphoreFromOtherQueue) {
+  std::atomic<bool> queue_0_done{false};
+  EXPECT_CALL(*mock_target_queues[0], Submit(_, _))
+      .WillOnce(
+          [&](absl::Span<const SubmissionBatch> batches, FenceValue fence) {
+            Sleep(absl::Milliseconds(100));
+            queue_0_done = true;
+            return OkStatus();
+          });
+  EXPECT_CALL(*mock_target_queues[1], Submit(_, _))
+      .WillOnce(
+          [&](absl::Span<const SubmissionBatch> batches, FenceValue fence) {
+            EXPECT_TRUE(queue_0_done);
+            return OkStatus();
+          });
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+
+  HostBinarySemaphore semaphore_0_1(false);
+  HostFence fence_1(0u);
+  ASSERT_OK(command_queues[1]->Submit(
+      {{&semaphore_0_1}, {cmd_buffer_1.get()}, {}}, {&fence_1, 1u}));
+  HostFence fence_0(0u);
+  ASSERT_OK(command_queues[0]->Submit(
+      {{}, {cmd_buffer_0.get()}, {&semaphore_0_1}}, {&fence_0, 1u}));
+
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
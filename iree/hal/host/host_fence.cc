@@ -14,6 +14,7 @@
 
 #include "iree/hal/host/host_fence.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 
@@ -47,6 +48,11 @@ Status HostFence::Signal(uint64_t value) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "Fence values must be monotonically increasing";
   }
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+  RETURN_IF_ERROR(NotifyValueWaiters(value));
+#else
+  NotifyFallbackWaiters();
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
   return OkStatus();
 }
 
@@ -54,9 +60,62 @@ Status HostFence::Fail(Status status) {
   absl::MutexLock lock(&mutex_);
   status_ = status;
   value_.store(UINT64_MAX, std::memory_order_release);
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+  // Failure wakes all waiters so that they can observe the status.
+  RETURN_IF_ERROR(NotifyValueWaiters(UINT64_MAX));
+#else
+  NotifyFallbackWaiters();
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
   return OkStatus();
 }
 
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+
+WaitHandle HostFence::OnValue(uint64_t value) {
+  absl::MutexLock lock(&mutex_);
+  if (value_.load(std::memory_order_acquire) >= value) {
+    return WaitHandle::AlwaysSignaling();
+  }
+  for (auto& value_waiter : value_waiters_) {
+    if (value_waiter.value == value) {
+      return value_waiter.event->OnSet();
+    }
+  }
+  auto event = make_ref<ManualResetEvent>();
+  WaitHandle wait_handle = event->OnSet();
+  value_waiters_.push_back({value, std::move(event)});
+  return wait_handle;
+}
+
+Status HostFence::NotifyValueWaiters(uint64_t value) {
+  auto reached_it = std::partition(
+      value_waiters_.begin(), value_waiters_.end(),
+      [value](const ValueWaiter& value_waiter) {
+        return value_waiter.value > value;
+      });
+  for (auto it = reached_it; it != value_waiters_.end(); ++it) {
+    RETURN_IF_ERROR(it->event->Set());
+  }
+  value_waiters_.erase(reached_it, value_waiters_.end());
+  return OkStatus();
+}
+
+#else
+
+// static
+absl::Mutex* HostFence::FallbackWaitMutex() {
+  static absl::Mutex* mutex = new absl::Mutex();
+  return mutex;
+}
+
+// static
+void HostFence::NotifyFallbackWaiters() {
+  // Releasing the mutex re-evaluates the conditions of all waiters.
+  absl::MutexLock lock(FallbackWaitMutex());
+}
+
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
+
 // static
 Status HostFence::WaitForFences(absl::Span<const FenceValue> fences,
                                 bool wait_all, absl::Time deadline) {
@@ -76,34 +135,83 @@ Status HostFence::WaitForFences(absl::Span<const FenceValue> fences,
     } else if (current_value < fence_value.second) {
       // Fence has not yet hit the required value; wait for it.
       waitable_fences.push_back({fence, fence_value.second});
+    } else if (!wait_all) {
+      // Fence has already hit the required value and that's all we need.
+      return OkStatus();
     }
   }
+  if (waitable_fences.empty()) {
+    return OkStatus();
+  }
 
-  // TODO(benvanik): maybe sort fences by value in case we are waiting on
-  // multiple values from the same fence.
-
-  // Loop over the fences and wait for them to complete.
-  // TODO(b/140026716): add WaitHandle support for !wait_all (wait any).
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+  // Wait on all of the fences at once with a single poll.
+  absl::InlinedVector<WaitHandle, 4> wait_handles;
+  absl::InlinedVector<WaitHandle*, 4> wait_handle_ptrs;
+  wait_handles.reserve(waitable_fences.size());
+  wait_handle_ptrs.reserve(waitable_fences.size());
   for (auto& fence_value : waitable_fences) {
-    auto* fence = fence_value.first;
-    absl::MutexLock lock(&fence->mutex_);
-    if (!fence->mutex_.AwaitWithDeadline(
+    wait_handles.push_back(fence_value.first->OnValue(fence_value.second));
+    wait_handle_ptrs.push_back(&wait_handles.back());
+  }
+  if (wait_all) {
+    Status wait_status = WaitHandle::WaitAll(wait_handle_ptrs, deadline);
+    if (IsDeadlineExceeded(wait_status)) {
+      return DeadlineExceededErrorBuilder(IREE_LOC)
+             << "Deadline exceeded waiting for fences";
+    }
+    RETURN_IF_ERROR(wait_status);
+    for (auto& fence_value : waitable_fences) {
+      RETURN_IF_ERROR(fence_value.first->status());
+    }
+    return OkStatus();
+  } else {
+    auto index_or = WaitHandle::WaitAny(wait_handle_ptrs, deadline);
+    if (IsDeadlineExceeded(index_or.status())) {
+      return DeadlineExceededErrorBuilder(IREE_LOC)
+             << "Deadline exceeded waiting for fences";
+    }
+    ASSIGN_OR_RETURN(int index, std::move(index_or));
+    return waitable_fences[index].first->status();
+  }
+#else
+  // Wait for any (or all) of the fences with a single condition evaluated
+  // across all of them under the shared wait mutex.
+  struct WaitState {
+    absl::Span<const HostFenceValue> fences;
+    bool wait_all;
+  } wait_state = {absl::MakeConstSpan(waitable_fences), wait_all};
+  {
+    // Fence mutexes must not be acquired while holding the wait mutex as
+    // signaling acquires them in the opposite order.
+    absl::MutexLock lock(FallbackWaitMutex());
+    if (!FallbackWaitMutex()->AwaitWithDeadline(
             absl::Condition(
-                +[](HostFenceValue* fence_value) {
-                  return fence_value->first->value_.load(
-                             std::memory_order_acquire) >= fence_value->second;
+                +[](WaitState* wait_state) {
+                  for (auto& fence_value : wait_state->fences) {
+                    bool reached = fence_value.first->value_.load(
+                                       std::memory_order_acquire) >=
+                                   fence_value.second;
+                    if (reached != wait_state->wait_all) return reached;
+                  }
+                  return wait_state->wait_all;
                 },
-                &fence_value),
+                &wait_state),
             deadline)) {
       return DeadlineExceededErrorBuilder(IREE_LOC)
              << "Deadline exceeded waiting for fences";
     }
-    if (!fence->status_.ok()) {
-      return fence->status_;
+  }
+  for (auto& fence_value : waitable_fences) {
+    auto* fence = fence_value.first;
+    if (fence->value_.load(std::memory_order_acquire) < fence_value.second) {
+      continue;
     }
+    RETURN_IF_ERROR(fence->status());
+    if (!wait_all) return OkStatus();
   }
-
   return OkStatus();
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
 }
 
 }  // namespace hal
@@ -17,18 +17,32 @@
 
 #include <atomic>
 #include <cstdint>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
+#include "iree/base/target_platform.h"
+#include "iree/base/wait_handle.h"
 #include "iree/hal/fence.h"
 
+// NOTE: wait_handle has no win32 implementation yet so Windows waits on
+// mutex conditions instead.
+#if !defined(IREE_PLATFORM_WINDOWS)
+#define IREE_HAL_HOST_FENCE_WAIT_HANDLES 1
+#endif  // !IREE_PLATFORM_WINDOWS
+
 namespace iree {
 namespace hal {
 
-// TODO(b/140026716): add WaitHandle support for better multi-wait.
-// Simple host-only fence semaphore implemented with a mutex.
+// Simple host-only fence semaphore.
+// Waits are performed on fd-backed WaitHandles (eventfds where available) so
+// that waiting on any number of fences is a single poll and so that
+// applications can multiplex fence completion with their own fds. Platforms
+// without fd support fall back to a single mutex shared by all fences that
+// waiters await conditions on.
 //
 // Thread-safe (as instances may be imported and used by others).
 class HostFence final : public Fence {
@@ -46,6 +60,14 @@ class HostFence final : public Fence {
   Status Signal(uint64_t value);
   Status Fail(Status status);
 
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+  // Returns a WaitHandle that is signaled once the fence reaches or exceeds
+  // |value| or fails. The underlying fd may be polled directly (such as in an
+  // epoll loop alongside sockets) via WaitHandle::object(). The fence status
+  // must be checked after waking to distinguish success from failure.
+  WaitHandle OnValue(uint64_t value);
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
+
  private:
   // The mutex is not required to query the value; this lets us quickly check if
   // a required value has been exceeded. The mutex is only used to update and
@@ -56,6 +78,26 @@ class HostFence final : public Fence {
   // changes.
   mutable absl::Mutex mutex_;
   Status status_ ABSL_GUARDED_BY(mutex_);
+
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+  // Sets and removes all value waiters at or below |value|.
+  Status NotifyValueWaiters(uint64_t value)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Events pending the fence reaching a value. Waits for the same value share
+  // a single event.
+  struct ValueWaiter {
+    uint64_t value;
+    ref_ptr<ManualResetEvent> event;
+  };
+  std::vector<ValueWaiter> value_waiters_ ABSL_GUARDED_BY(mutex_);
+#else
+  // Mutex shared by all fences that waiters await value conditions on.
+  static absl::Mutex* FallbackWaitMutex();
+
+  // Wakes all waiters to re-evaluate their conditions.
+  static void NotifyFallbackWaiters();
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
 };
 
 }  // namespace hal
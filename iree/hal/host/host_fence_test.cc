@@ -142,6 +142,83 @@ TEST(HostFenceTest, FailNotifies) {
   ASSERT_TRUE(got_failure);
 }
 
+// Tests waiting on multiple fences signaled from another thread.
+TEST(HostFenceTest, WaitAllMultiple) {
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  std::thread thread([&]() {
+    ASSERT_OK(fence_1.Signal(2u));
+    ASSERT_OK(fence_0.Signal(1u));
+  });
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 2u}},
+                                     /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+  thread.join();
+}
+
+// Tests that waiting on any fence returns as soon as one has been signaled.
+TEST(HostFenceTest, WaitAny) {
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  // Already signaled.
+  ASSERT_OK(fence_1.Signal(1u));
+  EXPECT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/false,
+                                     absl::InfinitePast()));
+  // Signaled from another thread while fence_0 never reaches its value.
+  std::thread thread([&]() { ASSERT_OK(fence_1.Signal(2u)); });
+  EXPECT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 2u}},
+                                     /*wait_all=*/false,
+                                     absl::InfiniteFuture()));
+  thread.join();
+  EXPECT_TRUE(IsDeadlineExceeded(HostFence::WaitForFences(
+      {{&fence_0, 1u}, {&fence_1, 3u}}, /*wait_all=*/false,
+      absl::InfinitePast())));
+}
+
+#if defined(IREE_HAL_HOST_FENCE_WAIT_HANDLES)
+
+// Tests that value wait handles are signaled only once the value is reached.
+TEST(HostFenceTest, OnValue) {
+  HostFence fence(1u);
+  WaitHandle reached = fence.OnValue(1u);
+  ASSERT_OK_AND_ASSIGN(bool reached_signaled, reached.TryWait());
+  EXPECT_TRUE(reached_signaled);
+
+  WaitHandle wait_2 = fence.OnValue(2u);
+  WaitHandle wait_3 = fence.OnValue(3u);
+  ASSERT_OK_AND_ASSIGN(bool wait_2_signaled, wait_2.TryWait());
+  EXPECT_FALSE(wait_2_signaled);
+
+  ASSERT_OK(fence.Signal(2u));
+  ASSERT_OK_AND_ASSIGN(wait_2_signaled, wait_2.TryWait());
+  EXPECT_TRUE(wait_2_signaled);
+  ASSERT_OK_AND_ASSIGN(bool wait_3_signaled, wait_3.TryWait());
+  EXPECT_FALSE(wait_3_signaled);
+
+  // Failure wakes all remaining waiters.
+  ASSERT_OK(fence.Fail(UnknownErrorBuilder(IREE_LOC)));
+  ASSERT_OK_AND_ASSIGN(wait_3_signaled, wait_3.TryWait());
+  EXPECT_TRUE(wait_3_signaled);
+  EXPECT_TRUE(IsUnknown(fence.status()));
+}
+
+// Tests that fence wait handles can be multiplexed with other wait handles.
+TEST(HostFenceTest, OnValueWaitAnyWithEvent) {
+  HostFence fence(0u);
+  auto event = make_ref<ManualResetEvent>();
+  WaitHandle fence_wait = fence.OnValue(1u);
+  WaitHandle event_wait = event->OnSet();
+  std::thread thread([&]() { ASSERT_OK(fence.Signal(1u)); });
+  ASSERT_OK_AND_ASSIGN(int index, WaitHandle::WaitAny(
+                                      {&event_wait, &fence_wait},
+                                      absl::InfiniteFuture()));
+  EXPECT_EQ(1, index);
+  thread.join();
+}
+
+#endif  // IREE_HAL_HOST_FENCE_WAIT_HANDLES
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
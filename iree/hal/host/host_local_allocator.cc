@@ -14,10 +14,10 @@
 
 #include "iree/hal/host/host_local_allocator.h"
 
-#include <cstdlib>
 #include <string>
 #include <utility>
 
+#include "iree/base/logging.h"
 #include "iree/base/source_location.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
@@ -26,9 +26,62 @@
 namespace iree {
 namespace hal {
 
-HostLocalAllocator::HostLocalAllocator() = default;
+namespace {
 
-HostLocalAllocator::~HostLocalAllocator() = default;
+// A host buffer returning its memory to the pool it was allocated from.
+class PooledHostBuffer final : public HostBuffer {
+ public:
+  PooledHostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+                   BufferUsageBitfield usage, device_size_t allocation_size,
+                   void* data, std::shared_ptr<HostMemoryPool> memory_pool)
+      : HostBuffer(allocator, memory_type, MemoryAccess::kAll, usage,
+                   allocation_size, data, /*owns_data=*/false),
+        memory_pool_(std::move(memory_pool)) {}
+
+  ~PooledHostBuffer() override {
+    memory_pool_->Free(mutable_data(), allocation_size());
+  }
+
+ private:
+  std::shared_ptr<HostMemoryPool> memory_pool_;
+};
+
+// A host buffer wrapping external memory that notifies the owner of the memory
+// when the buffer is destroyed.
+class WrappedHostBuffer final : public HostBuffer {
+ public:
+  WrappedHostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+                    MemoryAccessBitfield allowed_access,
+                    BufferUsageBitfield usage, device_size_t allocation_size,
+                    void* data, std::function<void()> release_callback)
+      : HostBuffer(allocator, memory_type, allowed_access, usage,
+                   allocation_size, data, /*owns_data=*/false),
+        release_callback_(std::move(release_callback)) {}
+
+  ~WrappedHostBuffer() override {
+    if (release_callback_) release_callback_();
+  }
+
+ private:
+  std::function<void()> release_callback_;
+};
+
+}  // namespace
+
+HostLocalAllocator::HostLocalAllocator()
+    : HostLocalAllocator(HostMemoryPool::Options()) {}
+
+HostLocalAllocator::HostLocalAllocator(HostMemoryPool::Options pool_options)
+    : memory_pool_(HostMemoryPool::Create(std::move(pool_options))) {}
+
+HostLocalAllocator::~HostLocalAllocator() {
+  auto stats = memory_pool_->stats();
+  VLOG(1) << "Host memory pool: " << stats.allocation_count
+          << " allocations (" << stats.cache_hit_count
+          << " reused), high water mark " << stats.high_water_mark
+          << " bytes, peak allocated " << stats.peak_bytes_allocated
+          << " bytes, fragmentation " << stats.fragmentation();
+}
 
 bool HostLocalAllocator::CanUseBufferLike(
     Allocator* source_allocator, MemoryTypeBitfield memory_type,
@@ -92,20 +145,53 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
            << ", allocation_size=" << allocation_size;
   }
 
+  // Transient buffers have undefined contents and are always fully written
+  // before they are read so we can skip clearing them. Buffers the caller did
+  // not request kMapping for are only ever accessed via command buffers and,
+  // like device memory on other backends, their initial contents are
+  // undefined. This must be decided before MakeCompatible adds kMapping.
+  bool zero_fill = !AnyBitSet(memory_type & MemoryType::kTransient) &&
+                   AnyBitSet(buffer_usage & BufferUsage::kMapping);
+
   // Make compatible with our requirements.
   RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
-
-  void* malloced_data = std::calloc(1, allocation_size);
-  if (!malloced_data) {
+  void* data = memory_pool_->Allocate(allocation_size, zero_fill);
+  if (!data) {
     return ResourceExhaustedErrorBuilder(IREE_LOC)
-           << "Failed to malloc " << allocation_size << " bytes";
+           << "Failed to allocate " << allocation_size << " bytes";
   }
 
-  auto buffer =
-      make_ref<HostBuffer>(this, memory_type, MemoryAccess::kAll, buffer_usage,
-                           allocation_size, malloced_data, true);
+  auto buffer = make_ref<PooledHostBuffer>(this, memory_type, buffer_usage,
+                                           allocation_size, data, memory_pool_);
   return buffer;
 }
 
+StatusOr<ref_ptr<Buffer>> HostLocalAllocator::WrapMutable(
+    MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+    BufferUsageBitfield buffer_usage, void* data, size_t data_length) {
+  return WrapMutableWithRelease(memory_type, allowed_access, buffer_usage,
+                                data, data_length, nullptr);
+}
+
+StatusOr<ref_ptr<Buffer>> HostLocalAllocator::WrapMutableWithRelease(
+    MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+    BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+    std::function<void()> release_callback) {
+  IREE_TRACE_SCOPE0("HostLocalAllocator::WrapMutableWithRelease");
+
+  if (!AnyBitSet(memory_type & MemoryType::kDeviceVisible)) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Wrapping not supported; memory_type="
+           << MemoryTypeString(memory_type);
+  }
+
+  // Make compatible with our requirements.
+  RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
+
+  return make_ref<WrappedHostBuffer>(this, memory_type, allowed_access,
+                                     buffer_usage, data_length, data,
+                                     std::move(release_callback));
+}
+
 }  // namespace hal
 }  // namespace iree
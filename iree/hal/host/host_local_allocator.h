@@ -21,6 +21,7 @@
 #include "iree/base/status.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
+#include "iree/hal/host/host_memory_pool.h"
 
 namespace iree {
 namespace hal {
@@ -32,11 +33,26 @@ namespace hal {
 // the 'device' in the case of a host-local queue *is* the host. To keep code
 // written initially for a host-local queue working when other queues are used
 // the allocator only works with buffers that are kDeviceVisible.
+//
+// Buffer memory is allocated from a HostMemoryPool such that the transient
+// buffers allocated and freed on each invocation reuse the same blocks.
+// Buffers are zero-filled only if they may be mapped by the host
+// (BufferUsage::kMapping) and are not MemoryType::kTransient; all other buffers
+// have undefined contents and are expected to be fully overwritten by their
+// producer.
+//
+// Existing host allocations may be wrapped directly as the device can access
+// any host memory.
 class HostLocalAllocator : public Allocator {
  public:
   HostLocalAllocator();
+  explicit HostLocalAllocator(HostMemoryPool::Options pool_options);
   ~HostLocalAllocator() override;
 
+  // Pool backing all buffers allocated. Buffers retain the pool such that it
+  // will remain live for as long as any buffers are.
+  HostMemoryPool* memory_pool() const { return memory_pool_.get(); }
+
   bool CanUseBufferLike(Allocator* source_allocator,
                         MemoryTypeBitfield memory_type,
                         BufferUsageBitfield buffer_usage,
@@ -52,6 +68,20 @@ class HostLocalAllocator : public Allocator {
   StatusOr<ref_ptr<Buffer>> Allocate(MemoryTypeBitfield memory_type,
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
+
+  StatusOr<ref_ptr<Buffer>> WrapMutable(MemoryTypeBitfield memory_type,
+                                        MemoryAccessBitfield allowed_access,
+                                        BufferUsageBitfield buffer_usage,
+                                        void* data,
+                                        size_t data_length) override;
+
+  StatusOr<ref_ptr<Buffer>> WrapMutableWithRelease(
+      MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+      BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+      std::function<void()> release_callback) override;
+
+ private:
+  std::shared_ptr<HostMemoryPool> memory_pool_;
 };
 
 }  // namespace hal
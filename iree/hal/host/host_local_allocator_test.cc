@@ -0,0 +1,121 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_local_allocator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+constexpr size_t kBufferSize = 256;
+
+// Allocates a buffer, dirties its contents, and frees it so that the next
+// allocation of the same size reuses the dirty block.
+void AllocateDirtyBlock(HostLocalAllocator* allocator) {
+  ASSERT_OK_AND_ASSIGN(
+      auto buffer, allocator->Allocate(MemoryType::kDeviceLocal,
+                                       BufferUsage::kAll, kBufferSize));
+  ASSERT_OK(buffer->Fill8(0, kWholeBuffer, uint8_t{0xCD}));
+}
+
+// Tests that buffers the host may map are zero-filled even when reused.
+TEST(HostLocalAllocatorTest, MappableBuffersAreZeroFilled) {
+  HostLocalAllocator allocator;
+  AllocateDirtyBlock(&allocator);
+  ASSERT_OK_AND_ASSIGN(
+      auto buffer, allocator.Allocate(MemoryType::kDeviceLocal,
+                                      BufferUsage::kAll, kBufferSize));
+  std::vector<uint8_t> contents(kBufferSize, 0xFF);
+  ASSERT_OK(buffer->ReadData(0, contents.data(), contents.size()));
+  EXPECT_EQ(std::vector<uint8_t>(kBufferSize, 0), contents);
+}
+
+// Tests that buffers only accessed via command buffers are not cleared.
+TEST(HostLocalAllocatorTest, UnmappableBuffersAreNotCleared) {
+  HostLocalAllocator allocator;
+  AllocateDirtyBlock(&allocator);
+  ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      allocator.Allocate(MemoryType::kDeviceLocal,
+                         BufferUsage::kTransfer | BufferUsage::kDispatch,
+                         kBufferSize));
+  std::vector<uint8_t> contents(kBufferSize, 0);
+  ASSERT_OK(buffer->ReadData(0, contents.data(), contents.size()));
+  EXPECT_EQ(std::vector<uint8_t>(kBufferSize, 0xCD), contents);
+}
+
+// Tests that transient buffers are not cleared even when mappable.
+TEST(HostLocalAllocatorTest, TransientBuffersAreNotCleared) {
+  HostLocalAllocator allocator;
+  AllocateDirtyBlock(&allocator);
+  ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      allocator.Allocate(MemoryType::kDeviceLocal | MemoryType::kTransient,
+                         BufferUsage::kAll, kBufferSize));
+  std::vector<uint8_t> contents(kBufferSize, 0);
+  ASSERT_OK(buffer->ReadData(0, contents.data(), contents.size()));
+  EXPECT_EQ(std::vector<uint8_t>(kBufferSize, 0xCD), contents);
+}
+
+// Tests that wrapped memory is used in-place and that the release callback is
+// called once the last reference to the buffer (including subspans) is gone.
+TEST(HostLocalAllocatorTest, WrapMutableWithRelease) {
+  HostLocalAllocator allocator;
+  std::vector<uint8_t> data(kBufferSize, 0xAB);
+  int release_count = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      allocator.WrapMutableWithRelease(
+          MemoryType::kHostLocal | MemoryType::kDeviceVisible,
+          MemoryAccess::kAll, BufferUsage::kAll, data.data(), data.size(),
+          [&release_count]() { ++release_count; }));
+
+  // Reads and writes go directly to the wrapped memory.
+  uint8_t value = 0;
+  ASSERT_OK(buffer->ReadData(8, &value, 1));
+  EXPECT_EQ(0xAB, value);
+  ASSERT_OK(buffer->Fill8(8, 1, uint8_t{0x12}));
+  EXPECT_EQ(0x12, data[8]);
+
+  ASSERT_OK_AND_ASSIGN(auto subspan, Buffer::Subspan(add_ref(buffer), 8, 16));
+  buffer.reset();
+  EXPECT_EQ(0, release_count);
+  subspan.reset();
+  EXPECT_EQ(1, release_count);
+}
+
+// Tests that the release callback is not called if the wrap fails.
+TEST(HostLocalAllocatorTest, WrapMutableWithReleaseFailure) {
+  HostLocalAllocator allocator;
+  std::vector<uint8_t> data(kBufferSize);
+  int release_count = 0;
+  EXPECT_FALSE(allocator
+                   .WrapMutableWithRelease(
+                       MemoryType::kHostLocal, MemoryAccess::kAll,
+                       BufferUsage::kAll, data.data(), data.size(),
+                       [&release_count]() { ++release_count; })
+                   .ok());
+  EXPECT_EQ(0, release_count);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,333 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_memory_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "iree/base/math.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// Used to distinguish pools in thread caches as addresses may be reused.
+std::atomic<uint64_t> next_pool_id{1};
+
+// Set once the thread state of the current thread has been destroyed such that
+// frees issued later during thread exit bypass the thread cache.
+thread_local bool thread_state_destroyed = false;
+
+// Number of size classes per power of two.
+constexpr int kSizeClassesPerPow2Log2 = 2;
+// log2(HostMemoryPool::kMinBlockSize).
+constexpr int kMinBlockSizeLog2 = 6;
+
+// Returns the size class index that can hold |size| bytes.
+// Size class 0 is kMinBlockSize and every subsequent power of two is split
+// into four evenly spaced classes (80, 96, 112, 128, 160, ...).
+int ComputeSizeClass(size_t size) {
+  if (size <= HostMemoryPool::kMinBlockSize) return 0;
+  uint64_t n = static_cast<uint64_t>(size) - 1;
+  int msb = 63 - CountLeadingZeros64(n);
+  int shift = msb - kSizeClassesPerPow2Log2;
+  int sub_class = static_cast<int>(n >> shift) - (1 << kSizeClassesPerPow2Log2);
+  return 1 + ((msb - kMinBlockSizeLog2) << kSizeClassesPerPow2Log2) +
+         sub_class;
+}
+
+void UpdatePeak(std::atomic<int64_t>* peak, int64_t value) {
+  int64_t current = peak->load(std::memory_order_relaxed);
+  while (value > current &&
+         !peak->compare_exchange_weak(current, value,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+constexpr size_t HostMemoryPool::kMinBlockSize;
+
+// Per-thread list of caches for each pool the thread has used. Caches are
+// returned to their pool (if it is still alive) when the thread exits.
+struct HostMemoryPool::ThreadState {
+  struct Entry {
+    uint64_t pool_id;
+    ThreadCache* cache;
+    std::weak_ptr<HostMemoryPool> pool;
+  };
+  std::vector<Entry> entries;
+
+  ~ThreadState() {
+    thread_state_destroyed = true;
+    for (auto& entry : entries) {
+      if (auto pool = entry.pool.lock()) {
+        pool->ReleaseThreadCache(entry.cache);
+      }
+    }
+  }
+};
+
+double HostMemoryPool::Stats::fragmentation() const {
+  int64_t bytes_held = bytes_reserved + bytes_cached;
+  if (bytes_held <= 0) return 0.0;
+  return 1.0 - static_cast<double>(bytes_allocated) / bytes_held;
+}
+
+// static
+std::shared_ptr<HostMemoryPool> HostMemoryPool::Create(Options options) {
+  return std::make_shared<HostMemoryPool>(std::move(options));
+}
+
+HostMemoryPool::HostMemoryPool(Options options)
+    : options_(std::move(options)),
+      pool_id_(next_pool_id.fetch_add(1)),
+      size_class_count_(
+          ComputeSizeClass(std::max(options_.max_pooled_size, kMinBlockSize)) +
+          1) {
+  absl::MutexLock lock(&mutex_);
+  shared_free_lists_.resize(size_class_count_);
+}
+
+HostMemoryPool::~HostMemoryPool() { Trim(); }
+
+HostMemoryPool::Stats HostMemoryPool::stats() const {
+  Stats stats;
+  stats.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+  stats.bytes_reserved = bytes_reserved_.load(std::memory_order_relaxed);
+  stats.bytes_cached = bytes_cached_.load(std::memory_order_relaxed);
+  stats.peak_bytes_allocated =
+      peak_bytes_allocated_.load(std::memory_order_relaxed);
+  stats.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+  stats.allocation_count = allocation_count_.load(std::memory_order_relaxed);
+  stats.cache_hit_count = cache_hit_count_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+int HostMemoryPool::GetSizeClass(size_t size) const {
+  if (size > options_.max_pooled_size) return -1;
+  return ComputeSizeClass(size);
+}
+
+// static
+size_t HostMemoryPool::GetSizeClassBlockSize(int size_class) {
+  if (size_class == 0) return kMinBlockSize;
+  int msb = kMinBlockSizeLog2 + ((size_class - 1) >> kSizeClassesPerPow2Log2);
+  int sub_class = (size_class - 1) & ((1 << kSizeClassesPerPow2Log2) - 1);
+  return static_cast<size_t>((1 << kSizeClassesPerPow2Log2) + 1 + sub_class)
+         << (msb - kSizeClassesPerPow2Log2);
+}
+
+size_t HostMemoryPool::GetBlockSize(size_t size) const {
+  int size_class = GetSizeClass(size);
+  return size_class < 0 ? size : GetSizeClassBlockSize(size_class);
+}
+
+HostMemoryPool::ThreadCache* HostMemoryPool::GetThreadCache() {
+  if (thread_state_destroyed) return nullptr;
+  static thread_local ThreadState thread_state;
+  for (auto& entry : thread_state.entries) {
+    if (entry.pool_id == pool_id_) return entry.cache;
+  }
+
+  // First use of this pool on the thread; drop caches of dead pools while we
+  // are on the slow path.
+  thread_state.entries.erase(
+      std::remove_if(thread_state.entries.begin(), thread_state.entries.end(),
+                     [](const ThreadState::Entry& entry) {
+                       return entry.pool.expired();
+                     }),
+      thread_state.entries.end());
+
+  auto cache = absl::make_unique<ThreadCache>();
+  auto* cache_ptr = cache.get();
+  {
+    absl::MutexLock cache_lock(&cache_ptr->mutex);
+    cache_ptr->free_lists.resize(size_class_count_);
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    thread_caches_.push_back(std::move(cache));
+  }
+  thread_state.entries.push_back({pool_id_, cache_ptr, shared_from_this()});
+  return cache_ptr;
+}
+
+void HostMemoryPool::ReleaseThreadCache(ThreadCache* cache) {
+  std::unique_ptr<ThreadCache> owned_cache;
+  absl::MutexLock lock(&mutex_);
+  for (auto it = thread_caches_.begin(); it != thread_caches_.end(); ++it) {
+    if (it->get() == cache) {
+      owned_cache = std::move(*it);
+      thread_caches_.erase(it);
+      break;
+    }
+  }
+  if (!owned_cache) return;
+
+  // Hand the blocks to other threads where we can.
+  absl::MutexLock cache_lock(&cache->mutex);
+  for (int size_class = 0; size_class < size_class_count_; ++size_class) {
+    size_t block_size = GetSizeClassBlockSize(size_class);
+    auto& free_list = cache->free_lists[size_class];
+    while (!free_list.empty() && shared_cached_bytes_ + block_size <=
+                                     options_.max_shared_cached_bytes) {
+      shared_free_lists_[size_class].push_back(free_list.back());
+      free_list.pop_back();
+      shared_cached_bytes_ += block_size;
+    }
+  }
+  FreeAll(&cache->free_lists);
+  cache->cached_bytes = 0;
+}
+
+void HostMemoryPool::FreeAll(std::vector<std::vector<void*>>* free_lists) {
+  int64_t freed_bytes = 0;
+  for (size_t i = 0; i < free_lists->size(); ++i) {
+    auto& free_list = (*free_lists)[i];
+    for (void* ptr : free_list) {
+      std::free(ptr);
+    }
+    freed_bytes +=
+        free_list.size() * GetSizeClassBlockSize(static_cast<int>(i));
+    free_list.clear();
+  }
+  bytes_cached_.fetch_sub(freed_bytes, std::memory_order_relaxed);
+}
+
+void HostMemoryPool::RecordSystemAllocation(size_t block_size) {
+  // The sum is only approximate when racing with other threads but is good
+  // enough for the statistic.
+  int64_t bytes_held = bytes_reserved_.load(std::memory_order_relaxed) +
+                       bytes_cached_.load(std::memory_order_relaxed) +
+                       block_size;
+  UpdatePeak(&high_water_mark_, bytes_held);
+}
+
+void* HostMemoryPool::Allocate(size_t size, bool zero_fill) {
+  IREE_TRACE_SCOPE0("HostMemoryPool::Allocate");
+  int size_class = GetSizeClass(size);
+  size_t block_size = size_class < 0 ? size : GetSizeClassBlockSize(size_class);
+
+  void* ptr = nullptr;
+  if (size_class >= 0) {
+    auto* cache = GetThreadCache();
+    if (cache) {
+      absl::MutexLock cache_lock(&cache->mutex);
+      auto& free_list = cache->free_lists[size_class];
+      if (!free_list.empty()) {
+        ptr = free_list.back();
+        free_list.pop_back();
+        cache->cached_bytes -= block_size;
+      }
+    }
+    if (!ptr) {
+      absl::MutexLock lock(&mutex_);
+      auto& free_list = shared_free_lists_[size_class];
+      if (!free_list.empty()) {
+        ptr = free_list.back();
+        free_list.pop_back();
+        shared_cached_bytes_ -= block_size;
+      }
+    }
+  }
+
+  if (ptr) {
+    // Reused blocks hold whatever their last user left in them.
+    cache_hit_count_.fetch_add(1, std::memory_order_relaxed);
+    bytes_cached_.fetch_sub(block_size, std::memory_order_relaxed);
+    if (zero_fill) {
+      std::memset(ptr, 0, size);
+    }
+  } else {
+    ptr = zero_fill ? std::calloc(1, block_size) : std::malloc(block_size);
+    if (!ptr) return nullptr;
+    RecordSystemAllocation(block_size);
+  }
+
+#ifndef NDEBUG
+  // Scribble over uninitialized memory so that reads before writes are
+  // obvious when debugging.
+  if (!zero_fill) {
+    std::memset(ptr, 0xCD, size);
+  }
+#endif  // !NDEBUG
+
+  allocation_count_.fetch_add(1, std::memory_order_relaxed);
+  bytes_reserved_.fetch_add(block_size, std::memory_order_relaxed);
+  int64_t bytes_allocated =
+      bytes_allocated_.fetch_add(size, std::memory_order_relaxed) + size;
+  UpdatePeak(&peak_bytes_allocated_, bytes_allocated);
+  return ptr;
+}
+
+void HostMemoryPool::Free(void* ptr, size_t size) {
+  if (!ptr) return;
+  int size_class = GetSizeClass(size);
+  size_t block_size = size_class < 0 ? size : GetSizeClassBlockSize(size_class);
+  bytes_allocated_.fetch_sub(size, std::memory_order_relaxed);
+  bytes_reserved_.fetch_sub(block_size, std::memory_order_relaxed);
+
+  bool cached = false;
+  if (size_class >= 0) {
+    auto* cache = GetThreadCache();
+    if (cache) {
+      absl::MutexLock cache_lock(&cache->mutex);
+      if (cache->cached_bytes + block_size <=
+          options_.max_thread_cached_bytes) {
+        cache->free_lists[size_class].push_back(ptr);
+        cache->cached_bytes += block_size;
+        cached = true;
+      }
+    }
+    if (!cached) {
+      // Our cache is full; spill to the shared cache so that the threads
+      // allocating these blocks can pick them up.
+      absl::MutexLock lock(&mutex_);
+      if (shared_cached_bytes_ + block_size <=
+          options_.max_shared_cached_bytes) {
+        shared_free_lists_[size_class].push_back(ptr);
+        shared_cached_bytes_ += block_size;
+        cached = true;
+      }
+    }
+  }
+
+  if (cached) {
+    bytes_cached_.fetch_add(block_size, std::memory_order_relaxed);
+  } else {
+    std::free(ptr);
+  }
+}
+
+void HostMemoryPool::Trim() {
+  IREE_TRACE_SCOPE0("HostMemoryPool::Trim");
+  absl::MutexLock lock(&mutex_);
+  for (auto& cache : thread_caches_) {
+    absl::MutexLock cache_lock(&cache->mutex);
+    FreeAll(&cache->free_lists);
+    cache->cached_bytes = 0;
+  }
+  FreeAll(&shared_free_lists_);
+  shared_cached_bytes_ = 0;
+}
+
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,156 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_HOST_MEMORY_POOL_H_
+#define IREE_HAL_HOST_HOST_MEMORY_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace iree {
+namespace hal {
+
+// A caching allocator for host memory blocks backing buffers.
+//
+// Requests are rounded up to a size class (four classes per power of two,
+// bounding internal fragmentation to 25%) and freed blocks are retained in
+// per-class free lists for reuse instead of being returned to the system.
+// Each thread has its own set of free lists such that the common case of
+// allocating and freeing transient buffers on the same thread takes no shared
+// locks. Threads that exceed their cache budget spill blocks into a shared
+// cache that other threads will pull from when their own lists are empty.
+// Blocks larger than the largest size class bypass the cache entirely.
+//
+// Pools must be created with Create as they are shared with the buffers they
+// allocate and the threads caching their blocks.
+//
+// Thread-safe.
+class HostMemoryPool final
+    : public std::enable_shared_from_this<HostMemoryPool> {
+ public:
+  struct Options {
+    // Requests larger than this are passed directly to the system allocator.
+    size_t max_pooled_size = 64 * 1024 * 1024;
+    // Maximum total bytes retained by the free lists of a single thread.
+    size_t max_thread_cached_bytes = 32 * 1024 * 1024;
+    // Maximum total bytes retained by the shared free lists.
+    size_t max_shared_cached_bytes = 256 * 1024 * 1024;
+  };
+
+  struct Stats {
+    // Total bytes requested by live allocations.
+    int64_t bytes_allocated = 0;
+    // Total bytes of the blocks backing live allocations.
+    int64_t bytes_reserved = 0;
+    // Total bytes of free blocks retained for reuse.
+    int64_t bytes_cached = 0;
+    // Peak value of bytes_allocated.
+    int64_t peak_bytes_allocated = 0;
+    // Peak total bytes held from the system (reserved + cached).
+    int64_t high_water_mark = 0;
+    // Total number of allocations made from the pool.
+    int64_t allocation_count = 0;
+    // Total number of allocations serviced from a cached block.
+    int64_t cache_hit_count = 0;
+
+    // Returns the fraction of memory held from the system that is not holding
+    // live data, either due to size class rounding or being cached. 0 when
+    // nothing is held.
+    double fragmentation() const;
+  };
+
+  // Smallest block size handed out by the pool.
+  static constexpr size_t kMinBlockSize = 64;
+
+  static std::shared_ptr<HostMemoryPool> Create(Options options);
+  static std::shared_ptr<HostMemoryPool> Create() { return Create(Options()); }
+
+  // Use Create instead.
+  explicit HostMemoryPool(Options options);
+  ~HostMemoryPool();
+
+  HostMemoryPool(const HostMemoryPool&) = delete;
+  HostMemoryPool& operator=(const HostMemoryPool&) = delete;
+
+  const Options& options() const { return options_; }
+
+  // Returns a snapshot of the pool statistics. Counters are updated without
+  // synchronization and may be momentarily inconsistent with each other.
+  Stats stats() const;
+
+  // Returns the size of the block that will back an allocation of |size|.
+  size_t GetBlockSize(size_t size) const;
+
+  // Allocates at least |size| bytes, returning nullptr if the system is out of
+  // memory. If |zero_fill| is false the contents are undefined and callers
+  // must fully overwrite the memory prior to reading it.
+  void* Allocate(size_t size, bool zero_fill);
+
+  // Returns |ptr| allocated with the given |size| to the pool.
+  void Free(void* ptr, size_t size);
+
+  // Releases all cached blocks back to the system.
+  void Trim();
+
+ private:
+  struct ThreadCache {
+    absl::Mutex mutex;
+    std::vector<std::vector<void*>> free_lists ABSL_GUARDED_BY(mutex);
+    size_t cached_bytes ABSL_GUARDED_BY(mutex) = 0;
+  };
+  struct ThreadState;
+
+  int GetSizeClass(size_t size) const;
+  static size_t GetSizeClassBlockSize(int size_class);
+
+  // Returns the cache of the calling thread, creating it if needed, or
+  // nullptr if the thread is exiting.
+  ThreadCache* GetThreadCache();
+  // Moves the blocks in |cache| to the shared cache and deletes it.
+  void ReleaseThreadCache(ThreadCache* cache);
+  // Frees all blocks in |free_lists| back to the system.
+  void FreeAll(std::vector<std::vector<void*>>* free_lists);
+
+  // Adds |block_size| to the system memory held and updates the peak.
+  void RecordSystemAllocation(size_t block_size);
+
+  const Options options_;
+  const uint64_t pool_id_;
+  const int size_class_count_;
+
+  absl::Mutex mutex_;
+  std::vector<std::unique_ptr<ThreadCache>> thread_caches_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<std::vector<void*>> shared_free_lists_ ABSL_GUARDED_BY(mutex_);
+  size_t shared_cached_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> bytes_reserved_{0};
+  std::atomic<int64_t> bytes_cached_{0};
+  std::atomic<int64_t> peak_bytes_allocated_{0};
+  std::atomic<int64_t> high_water_mark_{0};
+  std::atomic<int64_t> allocation_count_{0};
+  std::atomic<int64_t> cache_hit_count_{0};
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_HOST_MEMORY_POOL_H_
@@ -0,0 +1,185 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_memory_pool.h"
+
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Tests that sizes are rounded up to their size classes.
+TEST(HostMemoryPoolTest, BlockSizes) {
+  auto pool = HostMemoryPool::Create();
+  EXPECT_EQ(64, pool->GetBlockSize(0));
+  EXPECT_EQ(64, pool->GetBlockSize(1));
+  EXPECT_EQ(64, pool->GetBlockSize(64));
+  EXPECT_EQ(80, pool->GetBlockSize(65));
+  EXPECT_EQ(96, pool->GetBlockSize(81));
+  EXPECT_EQ(128, pool->GetBlockSize(128));
+  EXPECT_EQ(160, pool->GetBlockSize(129));
+  EXPECT_EQ(1280, pool->GetBlockSize(1025));
+  EXPECT_EQ(pool->options().max_pooled_size,
+            pool->GetBlockSize(pool->options().max_pooled_size));
+  // Unpooled sizes are not rounded.
+  EXPECT_EQ(pool->options().max_pooled_size + 1,
+            pool->GetBlockSize(pool->options().max_pooled_size + 1));
+}
+
+// Tests that freed blocks are reused by subsequent allocations.
+TEST(HostMemoryPoolTest, ReuseFreedBlocks) {
+  auto pool = HostMemoryPool::Create();
+  void* ptr0 = pool->Allocate(1000, /*zero_fill=*/true);
+  ASSERT_NE(nullptr, ptr0);
+  pool->Free(ptr0, 1000);
+  // Same size class.
+  void* ptr1 = pool->Allocate(900, /*zero_fill=*/true);
+  EXPECT_EQ(ptr0, ptr1);
+  pool->Free(ptr1, 900);
+
+  auto stats = pool->stats();
+  EXPECT_EQ(2, stats.allocation_count);
+  EXPECT_EQ(1, stats.cache_hit_count);
+  EXPECT_EQ(0, stats.bytes_allocated);
+  EXPECT_EQ(0, stats.bytes_reserved);
+  EXPECT_EQ(1024, stats.bytes_cached);
+  EXPECT_EQ(1000, stats.peak_bytes_allocated);
+  EXPECT_EQ(1024, stats.high_water_mark);
+}
+
+// Tests that reused blocks are cleared when zero fill is requested.
+TEST(HostMemoryPoolTest, ZeroFillReusedBlocks) {
+  auto pool = HostMemoryPool::Create();
+  auto* ptr = static_cast<uint8_t*>(pool->Allocate(256, /*zero_fill=*/false));
+  ASSERT_NE(nullptr, ptr);
+  std::memset(ptr, 0xFF, 256);
+  pool->Free(ptr, 256);
+  ptr = static_cast<uint8_t*>(pool->Allocate(256, /*zero_fill=*/true));
+  ASSERT_NE(nullptr, ptr);
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(0, ptr[i]);
+  }
+  pool->Free(ptr, 256);
+}
+
+// Tests that allocations larger than the max pooled size bypass the cache.
+TEST(HostMemoryPoolTest, UnpooledAllocations) {
+  HostMemoryPool::Options options;
+  options.max_pooled_size = 1024;
+  auto pool = HostMemoryPool::Create(options);
+  void* ptr = pool->Allocate(4096, /*zero_fill=*/true);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_EQ(4096, pool->stats().bytes_reserved);
+  pool->Free(ptr, 4096);
+  auto stats = pool->stats();
+  EXPECT_EQ(0, stats.bytes_reserved);
+  EXPECT_EQ(0, stats.bytes_cached);
+  EXPECT_EQ(4096, stats.high_water_mark);
+}
+
+// Tests that fragmentation accounts for both rounding and cached blocks.
+TEST(HostMemoryPoolTest, Fragmentation) {
+  auto pool = HostMemoryPool::Create();
+  EXPECT_EQ(0.0, pool->stats().fragmentation());
+  void* ptr0 = pool->Allocate(96, /*zero_fill=*/true);
+  EXPECT_EQ(0.0, pool->stats().fragmentation());
+  void* ptr1 = pool->Allocate(65, /*zero_fill=*/true);
+  // 161 of 176 bytes live.
+  EXPECT_DOUBLE_EQ(1.0 - 161.0 / 176.0, pool->stats().fragmentation());
+  pool->Free(ptr1, 65);
+  // 96 of 176 bytes live.
+  EXPECT_DOUBLE_EQ(1.0 - 96.0 / 176.0, pool->stats().fragmentation());
+  pool->Free(ptr0, 96);
+  EXPECT_EQ(1.0, pool->stats().fragmentation());
+  pool->Trim();
+  EXPECT_EQ(0, pool->stats().bytes_cached);
+  EXPECT_EQ(0.0, pool->stats().fragmentation());
+}
+
+// Tests that blocks beyond the thread cache budget spill to the shared cache
+// and that blocks freed on one thread can be reused on another.
+TEST(HostMemoryPoolTest, CrossThreadReuse) {
+  HostMemoryPool::Options options;
+  options.max_thread_cached_bytes = 0;
+  auto pool = HostMemoryPool::Create(options);
+  void* ptr0 = pool->Allocate(512, /*zero_fill=*/true);
+  std::thread thread([&]() { pool->Free(ptr0, 512); });
+  thread.join();
+  EXPECT_EQ(512, pool->stats().bytes_cached);
+  void* ptr1 = pool->Allocate(512, /*zero_fill=*/true);
+  EXPECT_EQ(ptr0, ptr1);
+  pool->Free(ptr1, 512);
+}
+
+// Tests that thread caches are returned to the pool when threads exit.
+TEST(HostMemoryPoolTest, ThreadExit) {
+  auto pool = HostMemoryPool::Create();
+  void* ptr0 = nullptr;
+  std::thread thread([&]() {
+    ptr0 = pool->Allocate(2048, /*zero_fill=*/true);
+    pool->Free(ptr0, 2048);
+  });
+  thread.join();
+  EXPECT_EQ(2048, pool->stats().bytes_cached);
+  void* ptr1 = pool->Allocate(2048, /*zero_fill=*/true);
+  EXPECT_EQ(ptr0, ptr1);
+  pool->Free(ptr1, 2048);
+}
+
+// Tests concurrent allocation from many threads.
+TEST(HostMemoryPoolTest, ConcurrentAllocations) {
+  auto pool = HostMemoryPool::Create();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&pool, i]() {
+      for (int j = 0; j < 1000; ++j) {
+        size_t size = 64 + (i * 1000 + j) % 4000;
+        auto* ptr =
+            static_cast<uint8_t*>(pool->Allocate(size, /*zero_fill=*/false));
+        ASSERT_NE(nullptr, ptr);
+        std::memset(ptr, i, size);
+        pool->Free(ptr, size);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stats = pool->stats();
+  EXPECT_EQ(4000, stats.allocation_count);
+  EXPECT_EQ(0, stats.bytes_allocated);
+  EXPECT_EQ(0, stats.bytes_reserved);
+}
+
+// Tests that pools may be destroyed while threads still have caches for them
+// and that new pools do not reuse them.
+TEST(HostMemoryPoolTest, RecreatePool) {
+  auto pool = HostMemoryPool::Create();
+  void* ptr = pool->Allocate(128, /*zero_fill=*/true);
+  pool->Free(ptr, 128);
+  pool.reset();
+  pool = HostMemoryPool::Create();
+  ptr = pool->Allocate(128, /*zero_fill=*/true);
+  pool->Free(ptr, 128);
+  EXPECT_EQ(1, pool->stats().allocation_count);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -58,6 +58,10 @@ Status HostBinarySemaphore::EndSignaling() {
   new_state.signal_pending = 0;
   new_state.signaled = 1;
   state_.compare_exchange_strong(old_state, new_state);
+
+  // Wake the queue waiting on us so that it can run the batch we unblocked.
+  absl::MutexLock lock(&waiter_mutex_);
+  if (waiter_) waiter_->OnSemaphoreSignaled();
   return OkStatus();
 }
 
@@ -85,11 +89,20 @@ Status HostBinarySemaphore::EndWaiting() {
   new_state.wait_pending = 0;
   new_state.signaled = 0;
   state_.compare_exchange_strong(old_state, new_state);
+  SetWaiter(nullptr);
   return OkStatus();
 }
 
+void HostBinarySemaphore::SetWaiter(HostSemaphoreWaiter* waiter) {
+  absl::MutexLock lock(&waiter_mutex_);
+  waiter_ = waiter;
+}
+
 HostSubmissionQueue::HostSubmissionQueue() = default;
 
+HostSubmissionQueue::HostSubmissionQueue(HostSemaphoreWaiter* waiter)
+    : waiter_(waiter) {}
+
 HostSubmissionQueue::~HostSubmissionQueue() = default;
 
 bool HostSubmissionQueue::IsBatchReady(const PendingBatch& batch) const {
@@ -128,6 +141,7 @@ Status HostSubmissionQueue::Enqueue(absl::Span<const SubmissionBatch> batches,
         auto* binary_semaphore = reinterpret_cast<HostBinarySemaphore*>(
             absl::get<0>(semaphore_value));
         RETURN_IF_ERROR(binary_semaphore->BeginWaiting());
+        if (waiter_) binary_semaphore->SetWaiter(waiter_);
       } else {
         // TODO(b/140141417): implement timeline semaphores.
         return UnimplementedErrorBuilder(IREE_LOC) << "Timeline semaphores NYI";
@@ -264,6 +278,17 @@ Status HostSubmissionQueue::CompleteSubmission(Submission* submission,
 
   // It's safe to drop any remaining batches - their semaphores will never be
   // signaled but that's fine as we should be the only thing relying on them.
+  // We do need to stop listening for signals on the ones they were waiting on.
+  if (waiter_) {
+    for (auto& batch : submission->pending_batches) {
+      for (auto& semaphore_value : batch.wait_semaphores) {
+        if (semaphore_value.index() == 0) {
+          reinterpret_cast<HostBinarySemaphore*>(absl::get<0>(semaphore_value))
+              ->SetWaiter(nullptr);
+        }
+      }
+    }
+  }
   submission->pending_batches.clear();
 
   // Signal the fence.
@@ -29,6 +29,17 @@ namespace hal {
 
 class HostSubmissionQueue;
 
+// Notified when a semaphore that a queued batch is waiting on is signaled.
+class HostSemaphoreWaiter {
+ public:
+  virtual ~HostSemaphoreWaiter() = default;
+
+  // Called on the signaling thread while the semaphore is locked. This must not
+  // block or acquire queue locks and should only schedule the waiting queue to
+  // process its newly-ready batches.
+  virtual void OnSemaphoreSignaled() = 0;
+};
+
 // Simple host-only binary semaphore implemented with a mutex.
 // To match the expected HAL behavior (mostly dictated by Vulkan) we can only
 // have a single waiter and waits can only occur once a signal has been
@@ -55,6 +66,11 @@ class HostBinarySemaphore final : public BinarySemaphore {
   // Ends a wait operation by resetting the semaphore to the unsignaled state.
   Status EndWaiting();
 
+  // Sets the |waiter| notified when the semaphore is next signaled, or clears
+  // it if nullptr. As there can only be one pending wait there is at most one
+  // waiter.
+  void SetWaiter(HostSemaphoreWaiter* waiter);
+
   // A single 32-bit int for lock-free semaphore behavior. We need to do this
   // extra tracking so that we get consistent behavior across HAL
   // implementations that have strict semaphore semantics.
@@ -64,6 +80,10 @@ class HostBinarySemaphore final : public BinarySemaphore {
     uint32_t signaled : 1;
   };
   std::atomic<State> state_{{0, 0, 0}};
+
+  // Waiter of the pending wait operation, if any.
+  absl::Mutex waiter_mutex_;
+  HostSemaphoreWaiter* waiter_ ABSL_GUARDED_BY(waiter_mutex_) = nullptr;
 };
 
 // Simple host-only timeline semaphore implemented with a mutex.
@@ -90,6 +110,9 @@ class HostSubmissionQueue {
       std::function<Status(absl::Span<CommandBuffer* const> command_buffers)>;
 
   HostSubmissionQueue();
+  // |waiter| will be notified whenever a semaphore that a pending batch waits
+  // on is signaled and must outlive the queue.
+  explicit HostSubmissionQueue(HostSemaphoreWaiter* waiter);
   ~HostSubmissionQueue();
 
   // Returns true if the queue is currently empty.
@@ -144,6 +167,9 @@ class HostSubmissionQueue {
   // Errors that occur during this process are silently ignored.
   void FailAllPending(Status status);
 
+  // Notified when semaphores pending batches wait on are signaled, if any.
+  HostSemaphoreWaiter* waiter_ = nullptr;
+
   // True to exit the thread after all submissions complete.
   bool has_shutdown_ = false;
 
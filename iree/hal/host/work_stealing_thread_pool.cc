@@ -0,0 +1,216 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// The pool and worker index of the current thread, if it is a pool worker.
+thread_local WorkStealingThreadPool* current_pool = nullptr;
+thread_local int current_worker_index = -1;
+
+// Shared state for a single ParallelFor call. Helper tasks may outlive the
+// call itself (if they are dequeued after all indices were claimed) and as
+// such the state is reference counted.
+struct ParallelForState {
+  ParallelForState(int count, const std::function<Status(int index)>& fn)
+      : count(count), fn(fn) {}
+
+  const int count;
+  const std::function<Status(int index)>& fn;
+
+  std::atomic<int> next_index{0};
+  std::atomic<bool> has_failed{false};
+
+  absl::Mutex mutex;
+  int completed_count ABSL_GUARDED_BY(mutex) = 0;
+  Status status ABSL_GUARDED_BY(mutex);
+
+  // Claims and runs indices until none remain.
+  void Run() {
+    int ran_count = 0;
+    Status first_failure;
+    for (int index = next_index.fetch_add(1); index < count;
+         index = next_index.fetch_add(1)) {
+      ++ran_count;
+      if (has_failed.load(std::memory_order_relaxed)) continue;
+      auto index_status = fn(index);
+      if (!index_status.ok()) {
+        has_failed = true;
+        if (first_failure.ok()) first_failure = std::move(index_status);
+      }
+    }
+    if (ran_count == 0) return;
+    absl::MutexLock lock(&mutex);
+    completed_count += ran_count;
+    if (status.ok() && !first_failure.ok()) status = std::move(first_failure);
+  }
+};
+
+}  // namespace
+
+// static
+int WorkStealingThreadPool::DefaultWorkerCount() {
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::string name,
+                                               int worker_count)
+    : name_(std::move(name)) {
+  IREE_TRACE_SCOPE0("WorkStealingThreadPool::ctor");
+  worker_count = std::max(1, worker_count);
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.push_back(absl::make_unique<Worker>());
+  }
+  // Threads are started only after all deques exist as they may steal from
+  // each other immediately.
+  for (int i = 0; i < worker_count; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { WorkerMain(i); });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  IREE_TRACE_SCOPE0("WorkStealingThreadPool::dtor");
+  {
+    // Workers will drain any remaining tasks prior to exiting.
+    absl::MutexLock lock(&pending_mutex_);
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void WorkStealingThreadPool::Schedule(Task task) {
+  int worker_index = 0;
+  if (current_pool == this) {
+    worker_index = current_worker_index;
+  } else {
+    absl::MutexLock lock(&schedule_mutex_);
+    worker_index = next_worker_index_;
+    next_worker_index_ = (next_worker_index_ + 1) % worker_count();
+  }
+
+  // NOTE: the task must be visible in a deque before it is counted as pending
+  // so that a worker reserving it is guaranteed to find it.
+  auto* worker = workers_[worker_index].get();
+  {
+    absl::MutexLock lock(&worker->mutex);
+    worker->tasks.push_back(std::move(task));
+  }
+  absl::MutexLock lock(&pending_mutex_);
+  ++pending_task_count_;
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::PopOrStealTask(
+    int worker_index) {
+  while (true) {
+    // Try our own deque first (newest task, most likely to be cache-hot).
+    {
+      auto* worker = workers_[worker_index].get();
+      absl::MutexLock lock(&worker->mutex);
+      if (!worker->tasks.empty()) {
+        auto task = std::move(worker->tasks.back());
+        worker->tasks.pop_back();
+        return task;
+      }
+    }
+
+    // Steal the oldest task from the other workers.
+    for (int i = 1; i < worker_count(); ++i) {
+      auto* victim = workers_[(worker_index + i) % worker_count()].get();
+      absl::MutexLock lock(&victim->mutex);
+      if (!victim->tasks.empty()) {
+        auto task = std::move(victim->tasks.front());
+        victim->tasks.pop_front();
+        return task;
+      }
+    }
+
+    // A task we reserved was pushed but another worker raced us to it; as
+    // every reservation corresponds to exactly one task there must be another
+    // one available so we retry.
+    std::this_thread::yield();
+  }
+}
+
+void WorkStealingThreadPool::WorkerMain(int worker_index) {
+  // NOTE: the name must outlive the thread as tracing may retain it.
+  std::string thread_name = absl::StrCat(name_, worker_index);
+  IREE_TRACE_THREAD_ENABLE(thread_name.c_str());
+  current_pool = this;
+  current_worker_index = worker_index;
+
+  while (true) {
+    {
+      // Block until there is a task to reserve or we are shutting down.
+      absl::MutexLock lock(&pending_mutex_);
+      pending_mutex_.Await(absl::Condition(
+          +[](WorkStealingThreadPool* pool)
+               ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool->pending_mutex_) {
+                 return pool->pending_task_count_ > 0 || pool->shutdown_;
+               },
+          this));
+      if (pending_task_count_ == 0) {
+        // Shutting down with no work left.
+        break;
+      }
+      --pending_task_count_;
+    }
+
+    auto task = PopOrStealTask(worker_index);
+    task();
+  }
+
+  current_pool = nullptr;
+  current_worker_index = -1;
+}
+
+Status WorkStealingThreadPool::ParallelFor(
+    int count, const std::function<Status(int index)>& fn) {
+  IREE_TRACE_SCOPE0("WorkStealingThreadPool::ParallelFor");
+  if (count <= 0) return OkStatus();
+  if (count == 1) return fn(0);
+
+  // Wake up enough helpers to cover the indices the calling thread won't get
+  // to. Helpers that arrive late find no indices left and exit immediately.
+  auto state = std::make_shared<ParallelForState>(count, fn);
+  int helper_count = std::min(count - 1, worker_count());
+  for (int i = 0; i < helper_count; ++i) {
+    Schedule([state]() { state->Run(); });
+  }
+
+  // Participate ourselves and then wait for any in-flight indices to finish.
+  state->Run();
+  absl::MutexLock lock(&state->mutex);
+  state->mutex.Await(absl::Condition(
+      +[](ParallelForState* state) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+           state->mutex) { return state->completed_count == state->count; },
+      state.get()));
+  return state->status;
+}
+
+}  // namespace hal
+}  // namespace iree
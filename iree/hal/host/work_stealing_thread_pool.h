@@ -0,0 +1,104 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_WORK_STEALING_THREAD_POOL_H_
+#define IREE_HAL_HOST_WORK_STEALING_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+
+namespace iree {
+namespace hal {
+
+// A fixed-size pool of worker threads that execute host tasks.
+//
+// Each worker owns a task deque. Tasks scheduled from a worker thread are
+// pushed onto that worker's own deque and popped LIFO to keep caches warm;
+// tasks scheduled from outside of the pool are distributed round-robin. Idle
+// workers steal from the front (oldest end) of other workers' deques before
+// going to sleep.
+//
+// Thread-safe.
+class WorkStealingThreadPool final {
+ public:
+  using Task = std::function<void()>;
+
+  // Returns a reasonable default worker count for the host machine.
+  static int DefaultWorkerCount();
+
+  // Creates a pool with |worker_count| threads. |name| is used as a prefix for
+  // the thread names shown in traces.
+  WorkStealingThreadPool(std::string name, int worker_count);
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // Schedules |task| for execution on one of the workers.
+  void Schedule(Task task);
+
+  // Runs |fn| for each index in [0, count) and blocks until all have completed.
+  //
+  // The calling thread participates in execution, so this is safe to call from
+  // within a task running on the pool itself and makes progress even if all
+  // workers are busy. Indices are claimed dynamically so uneven work is
+  // balanced across the participating threads.
+  //
+  // Returns the first failure encountered; once a failure is observed the
+  // remaining unclaimed indices are skipped.
+  Status ParallelFor(int count, const std::function<Status(int index)>& fn);
+
+ private:
+  struct Worker {
+    absl::Mutex mutex;
+    std::deque<Task> tasks ABSL_GUARDED_BY(mutex);
+    std::thread thread;
+  };
+
+  // Thread entry point for worker |worker_index|.
+  void WorkerMain(int worker_index);
+
+  // Pops a task from the back of |worker_index|'s deque or steals one from the
+  // front of another worker's deque. Must only be called after a task has been
+  // reserved from |pending_task_count_|.
+  Task PopOrStealTask(int worker_index);
+
+  std::string name_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Round-robin cursor for tasks scheduled from outside of the pool.
+  absl::Mutex schedule_mutex_;
+  int next_worker_index_ ABSL_GUARDED_BY(schedule_mutex_) = 0;
+
+  // Count of tasks that have been pushed onto a deque but not yet reserved by
+  // a worker. Workers sleep while this is zero.
+  absl::Mutex pending_mutex_;
+  int pending_task_count_ ABSL_GUARDED_BY(pending_mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(pending_mutex_) = false;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_WORK_STEALING_THREAD_POOL_H_
@@ -0,0 +1,101 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/work_stealing_thread_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "absl/synchronization/blocking_counter.h"
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Tests that a pool with no work shuts down cleanly.
+TEST(WorkStealingThreadPoolTest, NoOp) {
+  WorkStealingThreadPool pool("test", 4);
+  EXPECT_EQ(4, pool.worker_count());
+}
+
+// Tests that scheduled tasks all execute.
+TEST(WorkStealingThreadPoolTest, Schedule) {
+  WorkStealingThreadPool pool("test", 4);
+  std::atomic<int> run_count{0};
+  absl::BlockingCounter counter(100);
+  for (int i = 0; i < 100; ++i) {
+    pool.Schedule([&]() {
+      ++run_count;
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  EXPECT_EQ(100, run_count);
+}
+
+// Tests that pending tasks are drained when the pool is destroyed.
+TEST(WorkStealingThreadPoolTest, DrainOnShutdown) {
+  std::atomic<int> run_count{0};
+  {
+    WorkStealingThreadPool pool("test", 2);
+    for (int i = 0; i < 32; ++i) {
+      pool.Schedule([&]() { ++run_count; });
+    }
+  }
+  EXPECT_EQ(32, run_count);
+}
+
+// Tests that ParallelFor visits every index exactly once.
+TEST(WorkStealingThreadPoolTest, ParallelForVisitsAll) {
+  WorkStealingThreadPool pool("test", 4);
+  std::vector<std::atomic<int>> visits(1000);
+  EXPECT_OK(pool.ParallelFor(visits.size(), [&](int index) {
+    ++visits[index];
+    return OkStatus();
+  }));
+  for (auto& visit : visits) {
+    EXPECT_EQ(1, visit);
+  }
+}
+
+// Tests that failures in ParallelFor are propagated to the caller.
+TEST(WorkStealingThreadPoolTest, ParallelForFailure) {
+  WorkStealingThreadPool pool("test", 4);
+  auto status = pool.ParallelFor(64, [&](int index) -> Status {
+    if (index == 17) return UnknownErrorBuilder(IREE_LOC);
+    return OkStatus();
+  });
+  EXPECT_TRUE(IsUnknown(status));
+}
+
+// Tests that ParallelFor can be nested within tasks running on the pool
+// without deadlocking, even when every worker is blocked in a ParallelFor.
+TEST(WorkStealingThreadPoolTest, NestedParallelFor) {
+  WorkStealingThreadPool pool("test", 2);
+  std::atomic<int> run_count{0};
+  EXPECT_OK(pool.ParallelFor(8, [&](int outer_index) {
+    return pool.ParallelFor(8, [&](int inner_index) {
+      ++run_count;
+      return OkStatus();
+    });
+  }));
+  EXPECT_EQ(64, run_count);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
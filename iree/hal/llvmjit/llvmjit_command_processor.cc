@@ -45,28 +45,33 @@ Status LLVMJITCommandProcessor::Dispatch(
   auto* executable =
       static_cast<LLVMJITExecutable*>(dispatch_request.executable);
 
-  std::vector<UnrankedMemRefType<uint32_t>*> descriptors(
-      dispatch_request.bindings.size());
-  llvm::SmallVector<void*, 4> args(dispatch_request.bindings.size());
-  for (size_t i = 0; i < dispatch_request.bindings.size(); ++i) {
-    ASSIGN_OR_RETURN(
-        auto memory,
-        dispatch_request.bindings.at(i).buffer->MapMemory<uint32_t>(
-            MemoryAccessBitfield::kWrite));
-    auto data = memory.mutable_data();
-    const std::vector<int64_t> shape(
-        dispatch_request.bindings.at(i).shape.begin(),
-        dispatch_request.bindings.at(i).shape.end());
-    descriptors[i] = allocUnrankedDescriptor<uint32_t>(data, shape);
-    args[i] = descriptors[i]->descriptor;
+  using Descriptor = UnrankedMemRefType<uint32_t>;
+  using DescriptorPtr = std::unique_ptr<Descriptor, void (*)(Descriptor*)>;
+  const auto& bindings = dispatch_request.bindings;
+  std::vector<MappedMemory<uint32_t>> mappings;
+  std::vector<DescriptorPtr> descriptors;
+  llvm::SmallVector<void*, 4> args;
+  mappings.reserve(bindings.size());
+  descriptors.reserve(bindings.size());
+  args.reserve(bindings.size());
+  for (const auto& binding : bindings) {
+    // Constant operands may be backed by read-only buffers (such as module
+    // rodata) and must not be mapped for writing. Mappings are kept alive
+    // until the invocation has completed.
+    ASSIGN_OR_RETURN(auto memory,
+                     binding.buffer->MapMemory<uint32_t>(
+                         binding.access & binding.buffer->allowed_access() &
+                         (MemoryAccess::kRead | MemoryAccess::kWrite)));
+    mappings.push_back(std::move(memory));
+    const std::vector<int64_t> shape(binding.shape.begin(),
+                                     binding.shape.end());
+    descriptors.emplace_back(allocUnrankedDescriptor<uint32_t>(
+                                 mappings.back().unsafe_data(), shape),
+                             &freeUnrankedDescriptor<uint32_t>);
+    args.push_back(descriptors.back()->descriptor);
   }
-  auto status = executable->Invoke(dispatch_request.entry_point, args);
 
-  for (int i = 0; i < descriptors.size(); ++i) {
-    freeUnrankedDescriptor(descriptors[i]);
-  }
-
-  return status;
+  return executable->Invoke(dispatch_request.entry_point, args);
 }
 }  // namespace llvmjit
 }  // namespace hal
@@ -17,6 +17,7 @@
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "iree/base/logging.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/command_buffer_validation.h"
@@ -99,9 +100,11 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
 }  // namespace
 
 LLVMJITDevice::LLVMJITDevice(DeviceInfo device_info,
-                             std::unique_ptr<llvm::orc::LLJIT> execution_engine)
+                             std::unique_ptr<llvm::orc::LLJIT> execution_engine,
+                             std::unique_ptr<LLVMJITObjectCache> object_cache)
     : Device(std::move(device_info)),
-      execution_engine_(std::move(execution_engine)) {
+      execution_engine_(std::move(execution_engine)),
+      object_cache_(std::move(object_cache)) {
   // We currently only expose a single command queue.
   auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
       &allocator_, "cpu0",
@@ -115,17 +118,31 @@ LLVMJITDevice::LLVMJITDevice(DeviceInfo device_info,
 }
 
 StatusOr<ref_ptr<LLVMJITDevice>> LLVMJITDevice::CreateLLVMJITDevice(
-    DeviceInfo device_info) {
+    DeviceInfo device_info, std::string object_cache_path) {
   auto execution_engine = std::move(llvm::orc::LLJITBuilder().create().get());
   if (!execution_engine)
     InternalErrorBuilder(IREE_LOC) << "Can't create LLJIT for llvmjit device";
-  return make_ref<LLVMJITDevice>(device_info, std::move(execution_engine));
+  std::unique_ptr<LLVMJITObjectCache> object_cache;
+  if (!object_cache_path.empty()) {
+    ASSIGN_OR_RETURN(object_cache,
+                     LLVMJITObjectCache::Create(std::move(object_cache_path)));
+  }
+  return make_ref<LLVMJITDevice>(device_info, std::move(execution_engine),
+                                 std::move(object_cache));
 }
 
-LLVMJITDevice::~LLVMJITDevice() = default;
+LLVMJITDevice::~LLVMJITDevice() {
+  if (object_cache_) {
+    auto stats = object_cache_->stats();
+    VLOG(1) << "LLVMJIT object cache '" << object_cache_->cache_path()
+            << "': " << stats.hit_count << " hits, " << stats.miss_count
+            << " misses, " << stats.store_failure_count << " store failures";
+  }
+}
 
 ref_ptr<ExecutableCache> LLVMJITDevice::CreateExecutableCache() {
-  return make_ref<LLVMJITExecutableCache>(&allocator_, execution_engine_.get());
+  return make_ref<LLVMJITExecutableCache>(&allocator_, execution_engine_.get(),
+                                          object_cache_.get());
 }
 
 StatusOr<ref_ptr<CommandBuffer>> LLVMJITDevice::CreateCommandBuffer(
@@ -20,6 +20,7 @@
 #include "iree/base/memory.h"
 #include "iree/hal/device.h"
 #include "iree/hal/host/host_local_allocator.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/LLVMContext.h"
 
@@ -29,12 +30,18 @@ namespace llvmjit {
 
 class LLVMJITDevice final : public Device {
  public:
+  // Creates a device that persists compiled executables to
+  // |object_cache_path|, if not empty.
   static StatusOr<ref_ptr<LLVMJITDevice>> CreateLLVMJITDevice(
-      DeviceInfo device_info);
-  explicit LLVMJITDevice(DeviceInfo device_info,
-                         std::unique_ptr<llvm::orc::LLJIT> execution_engine);
+      DeviceInfo device_info, std::string object_cache_path);
+  LLVMJITDevice(DeviceInfo device_info,
+                std::unique_ptr<llvm::orc::LLJIT> execution_engine,
+                std::unique_ptr<LLVMJITObjectCache> object_cache);
   ~LLVMJITDevice() override;
 
+  // Returns the on-disk object cache, or nullptr if caching is disabled.
+  LLVMJITObjectCache* object_cache() const { return object_cache_.get(); }
+
   Allocator* allocator() const override { return &allocator_; }
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
@@ -67,6 +74,7 @@ class LLVMJITDevice final : public Device {
 
  private:
   std::unique_ptr<llvm::orc::LLJIT> execution_engine_;
+  std::unique_ptr<LLVMJITObjectCache> object_cache_;
   mutable HostLocalAllocator allocator_;
   mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 1> command_queues_;
 };
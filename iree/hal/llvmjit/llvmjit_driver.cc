@@ -15,6 +15,7 @@
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 
 #include <memory>
+#include <utility>
 
 #include "iree/hal/device_info.h"
 #include "iree/hal/llvmjit/llvmjit_device.h"
@@ -38,7 +39,8 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-LLVMJITDriver::LLVMJITDriver() : Driver("llvmjit") {}
+LLVMJITDriver::LLVMJITDriver(Options options)
+    : Driver("llvmjit"), options_(std::move(options)) {}
 
 LLVMJITDriver::~LLVMJITDriver() = default;
 
@@ -54,7 +56,8 @@ StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDevice(
     DriverDeviceID device_id) {
-  return LLVMJITDevice::CreateLLVMJITDevice(GetDefaultDeviceInfo());
+  return LLVMJITDevice::CreateLLVMJITDevice(GetDefaultDeviceInfo(),
+                                            options_.object_cache_path);
 }
 }  // namespace llvmjit
 }  // namespace hal
@@ -15,6 +15,8 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 
+#include <string>
+
 #include "iree/hal/driver.h"
 
 namespace iree {
@@ -23,7 +25,13 @@ namespace llvmjit {
 
 class LLVMJITDriver final : public Driver {
  public:
-  LLVMJITDriver();
+  struct Options {
+    // Directory used to persist compiled executables across runs. Caching is
+    // disabled when empty.
+    std::string object_cache_path;
+  };
+
+  explicit LLVMJITDriver(Options options);
   ~LLVMJITDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +39,9 @@ class LLVMJITDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  Options options_;
 };
 }  // namespace llvmjit
 }  // namespace hal
@@ -14,12 +14,17 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 #include "llvm/Support/TargetSelect.h"
 
+ABSL_FLAG(std::string, llvmjit_object_cache_path, "",
+          "Directory used to cache compiled LLVM executables across runs "
+          "(disabled when empty).");
+
 namespace iree {
 namespace hal {
 namespace llvmjit {
@@ -27,7 +32,9 @@ namespace llvmjit {
 static StatusOr<ref_ptr<Driver>> CreateLLVMJITDriver() {
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
-  return make_ref<LLVMJITDriver>();
+  LLVMJITDriver::Options options;
+  options.object_cache_path = absl::GetFlag(FLAGS_llvmjit_object_cache_path);
+  return make_ref<LLVMJITDriver>(std::move(options));
 }
 }  // namespace llvmjit
 }  // namespace hal
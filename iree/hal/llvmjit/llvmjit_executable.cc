@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "flatbuffers/flatbuffers.h"
+#include "iree/base/logging.h"
 #include "iree/hal/executable.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -33,75 +34,66 @@
 namespace iree {
 namespace hal {
 namespace llvmjit {
-// TODO(ataei): Move this to compile time HAL/Target/LLVM.
-static void CreateInvocationFunc(const std::string& name,
-                                 llvm::Module* module) {
-  auto& ctx = module->getContext();
-  llvm::IRBuilder<> builder(ctx);
-  auto var_func = module->getFunction(name);
-
-  auto new_type = llvm::FunctionType::get(
-      builder.getVoidTy(), builder.getInt8PtrTy()->getPointerTo(),
-      /*isVarArg=*/false);
-
-  auto new_name = "invoke_" + name;
-  auto func_cst = module->getOrInsertFunction(new_name, new_type);
-  llvm::Function* interface_func =
-      llvm::cast<llvm::Function>(func_cst.getCallee());
-
-  auto bb = llvm::BasicBlock::Create(ctx);
-  bb->insertInto(interface_func);
-  builder.SetInsertPoint(bb);
-  llvm::Value* argList = interface_func->arg_begin();
-  llvm::SmallVector<llvm::Value*, 8> args;
-  args.reserve(llvm::size(var_func->args()));
-  for (auto& indexedArg : llvm::enumerate(var_func->args())) {
-    llvm::Value* arg_index = llvm::Constant::getIntegerValue(
-        builder.getInt64Ty(), llvm::APInt(64, indexedArg.index()));
-    llvm::Value* arg_ptr_ptr = builder.CreateGEP(argList, arg_index);
-    llvm::Value* arg_ptr = builder.CreateLoad(arg_ptr_ptr);
-    arg_ptr = builder.CreateBitCast(
-        arg_ptr, indexedArg.value().getType()->getPointerTo());
-    llvm::Value* arg = builder.CreateLoad(arg_ptr);
-    args.push_back(arg);
-  }
-  builder.CreateCall(var_func, args);
-  builder.CreateRetVoid();
-}
 
 // static
 StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
     hal::Allocator* allocator, ExecutableSpec spec,
-    llvm::orc::LLJIT* execution_engine, bool allow_aliasing_data) {
+    llvm::orc::LLJIT* execution_engine, LLVMJITObjectCache* object_cache,
+    bool allow_aliasing_data) {
   auto module_def =
       ::flatbuffers::GetRoot<LLVMIRExecutableDef>(spec.executable_data.data());
-  auto data =
-      reinterpret_cast<const char*>(module_def->llvmir_module()->data());
-  const int size = module_def->llvmir_module()->size();
-  auto mem_buffer = llvm::MemoryBuffer::getMemBufferCopy(
-      llvm::StringRef(data, size), "llvm-ir");
-  auto llvm_context = std::make_unique<llvm::LLVMContext>();
-  llvm::SMDiagnostic sm_diagnostic;
-  auto module = llvm::parseAssembly(*mem_buffer, sm_diagnostic, *llvm_context);
-  if (!module)
-    return InvalidArgumentErrorBuilder(IREE_LOC) << "Can't parse LLVMIR Module";
-  auto dataLayout = module->getDataLayout();
   const auto entry_points = module_def->entry_points();
-  // Create an invocation function for each entry point.
-  for (const auto func_name : *entry_points) {
-    CreateInvocationFunc(func_name->str(), module.get());
+
+  // Try to load a previously compiled object, skipping IR parsing and codegen.
+  std::string cache_key;
+  std::unique_ptr<llvm::MemoryBuffer> object;
+  if (object_cache) {
+    cache_key = object_cache->ComputeKey(spec.executable_data);
+    object = object_cache->Lookup(cache_key);
+  }
+
+  if (!object) {
+    auto data =
+        reinterpret_cast<const char*>(module_def->llvmir_module()->data());
+    const int size = module_def->llvmir_module()->size();
+    auto mem_buffer = llvm::MemoryBuffer::getMemBufferCopy(
+        llvm::StringRef(data, size), "llvm-ir");
+    auto llvm_context = std::make_unique<llvm::LLVMContext>();
+    llvm::SMDiagnostic sm_diagnostic;
+    auto module =
+        llvm::parseAssembly(*mem_buffer, sm_diagnostic, *llvm_context);
+    if (!module)
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Can't parse LLVMIR Module";
+    if (object_cache) {
+      // Compile the module ourselves so that the object can be persisted.
+      ASSIGN_OR_RETURN(object, object_cache->Compile(module.get()));
+      auto store_status = object_cache->Store(cache_key, *object);
+      if (!store_status.ok()) {
+        LOG(WARNING) << "Failed to store LLVMIR executable in object cache: "
+                     << store_status;
+      }
+    } else {
+      llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
+                                                     std::move(llvm_context));
+      llvm::Error err =
+          execution_engine->addIRModule(std::move(thread_safe_module));
+      if (err)
+        return InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Can't add executable module to execution engine";
+    }
+  }
+
+  if (object) {
+    llvm::Error err = execution_engine->addObjectFile(std::move(object));
+    if (err)
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Can't add executable object to execution engine";
   }
-  llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
-                                                 std::move(llvm_context));
-  llvm::Error err =
-      execution_engine->addIRModule(std::move(thread_safe_module));
-  if (err)
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Can't add executable module to execution engine";
 
   auto dylib_serarch_generator =
       llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
-          dataLayout.getGlobalPrefix());
+          execution_engine->getDataLayout().getGlobalPrefix());
 
   if (!dylib_serarch_generator.get())
     return UnavailableErrorBuilder(IREE_LOC)
@@ -22,6 +22,7 @@
 #include "iree/hal/allocator.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_spec.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ExecutionEngine/GenericValue.h"
@@ -40,7 +41,8 @@ class LLVMJITExecutable final : public Executable {
  public:
   static StatusOr<ref_ptr<LLVMJITExecutable>> Load(
       hal::Allocator* allocator, ExecutableSpec spec,
-      llvm::orc::LLJIT* execution_engine, bool allow_aliasing_data);
+      llvm::orc::LLJIT* execution_engine, LLVMJITObjectCache* object_cache,
+      bool allow_aliasing_data);
   LLVMJITExecutable(hal::Allocator* allocator, ExecutableSpec spec,
                     bool allow_aliasing_data);
   ~LLVMJITExecutable() override;
@@ -26,8 +26,11 @@ namespace hal {
 namespace llvmjit {
 
 LLVMJITExecutableCache::LLVMJITExecutableCache(
-    hal::Allocator* allocator, llvm::orc::LLJIT* execution_engine)
-    : allocator_(allocator), execution_engine_(execution_engine) {}
+    hal::Allocator* allocator, llvm::orc::LLJIT* execution_engine,
+    LLVMJITObjectCache* object_cache)
+    : allocator_(allocator),
+      execution_engine_(execution_engine),
+      object_cache_(object_cache) {}
 
 LLVMJITExecutableCache::~LLVMJITExecutableCache() = default;
 
@@ -48,6 +51,7 @@ StatusOr<ref_ptr<Executable>> LLVMJITExecutableCache::PrepareExecutable(
       AllBitsSet(mode, ExecutableCachingMode::kAliasProvidedData);
   ASSIGN_OR_RETURN(auto executable,
                    LLVMJITExecutable::Load(allocator_, spec, execution_engine_,
+                                           object_cache_,
                                            !allow_aliasing_data));
 
   return executable;
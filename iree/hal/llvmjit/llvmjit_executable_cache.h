@@ -18,6 +18,7 @@
 #include "iree/hal/allocator.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 
 namespace iree {
@@ -26,8 +27,11 @@ namespace llvmjit {
 
 class LLVMJITExecutableCache final : public ExecutableCache {
  public:
-  explicit LLVMJITExecutableCache(hal::Allocator* allocator,
-                                  llvm::orc::LLJIT* execution_engine);
+  // |object_cache| is optional and if provided will be used to persist
+  // compiled executables across runs.
+  LLVMJITExecutableCache(hal::Allocator* allocator,
+                         llvm::orc::LLJIT* execution_engine,
+                         LLVMJITObjectCache* object_cache);
   ~LLVMJITExecutableCache() override;
 
   bool CanPrepareFormat(ExecutableFormat format) const override;
@@ -38,6 +42,7 @@ class LLVMJITExecutableCache final : public ExecutableCache {
  private:
   hal::Allocator* allocator_;
   llvm::orc::LLJIT* execution_engine_;
+  LLVMJITObjectCache* object_cache_;
 };
 }  // namespace llvmjit
 }  // namespace hal
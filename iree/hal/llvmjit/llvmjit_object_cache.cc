@@ -0,0 +1,228 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "iree/base/logging.h"
+#include "iree/base/tracing.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+namespace {
+
+// Bump when the layout of cached objects changes (such as the invocation
+// function signature) to invalidate existing caches.
+constexpr char kCacheVersion[] = "1";
+
+// Returns a string uniquely identifying the code generated by
+// |target_machine|.
+std::string GetTargetId(const llvm::TargetMachine& target_machine) {
+  return absl::StrCat(kCacheVersion, ":",
+                      target_machine.getTargetTriple().str(), ":",
+                      target_machine.getTargetCPU().str(), ":",
+                      target_machine.getTargetFeatureString().str());
+}
+
+}  // namespace
+
+// static
+StatusOr<std::unique_ptr<LLVMJITObjectCache>> LLVMJITObjectCache::Create(
+    std::string cache_path) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Create");
+  auto builder_or = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!builder_or) {
+    llvm::consumeError(builder_or.takeError());
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't detect host target machine for object cache";
+  }
+  auto builder = std::move(*builder_or);
+  // Cached objects are keyed by CPU so we can specialize for the host.
+  builder.setCPU(llvm::sys::getHostCPUName());
+  auto target_machine_or = builder.createTargetMachine();
+  if (!target_machine_or) {
+    llvm::consumeError(target_machine_or.takeError());
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create target machine for object cache";
+  }
+  return absl::make_unique<LLVMJITObjectCache>(std::move(cache_path),
+                                               std::move(*target_machine_or));
+}
+
+LLVMJITObjectCache::LLVMJITObjectCache(
+    std::string cache_path, std::unique_ptr<llvm::TargetMachine> target_machine)
+    : cache_path_(std::move(cache_path)),
+      target_id_(GetTargetId(*target_machine)),
+      target_arch_(target_machine->getTargetTriple().getArch()),
+      target_machine_(std::move(target_machine)) {}
+
+LLVMJITObjectCache::~LLVMJITObjectCache() = default;
+
+LLVMJITObjectCache::Stats LLVMJITObjectCache::stats() const {
+  absl::MutexLock lock(&stats_mutex_);
+  return stats_;
+}
+
+std::string LLVMJITObjectCache::ComputeKey(
+    absl::Span<const uint8_t> executable_data) const {
+  llvm::SHA1 hasher;
+  hasher.update(target_id_);
+  hasher.update(llvm::makeArrayRef(executable_data.data(),
+                                   executable_data.size()));
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string LLVMJITObjectCache::GetObjectPath(const std::string& key) const {
+  llvm::SmallString<256> path(cache_path_);
+  llvm::sys::path::append(path, key + ".o");
+  return path.str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::Lookup(
+    const std::string& key) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Lookup");
+  // NOTE: large files will be mapped instead of read.
+  std::string object_path = GetObjectPath(key);
+  auto buffer_or =
+      llvm::MemoryBuffer::getFile(object_path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer_or) {
+    absl::MutexLock lock(&stats_mutex_);
+    ++stats_.miss_count;
+    return nullptr;
+  }
+
+  // Truncated or otherwise corrupt objects (such as those written by tools
+  // outside of the cache) would fail to link. Drop them so that the caller
+  // recompiles and replaces the entry.
+  auto object_or = llvm::object::ObjectFile::createObjectFile(
+      (*buffer_or)->getMemBufferRef());
+  bool is_valid = static_cast<bool>(object_or);
+  if (is_valid) {
+    is_valid = (*object_or)->getArch() == target_arch_;
+  } else {
+    llvm::consumeError(object_or.takeError());
+  }
+  if (!is_valid) {
+    LOG(WARNING) << "Discarding corrupt object cache entry '" << object_path
+                 << "'";
+    llvm::sys::fs::remove(object_path);
+    absl::MutexLock lock(&stats_mutex_);
+    ++stats_.evicted_count;
+    ++stats_.miss_count;
+    return nullptr;
+  }
+
+  absl::MutexLock lock(&stats_mutex_);
+  ++stats_.hit_count;
+  return std::move(*buffer_or);
+}
+
+StatusOr<std::unique_ptr<llvm::MemoryBuffer>> LLVMJITObjectCache::Compile(
+    llvm::Module* module) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Compile");
+  llvm::SmallVector<char, 0> object_data;
+  {
+    absl::MutexLock lock(&compile_mutex_);
+    if (module->getDataLayout().isDefault()) {
+      module->setDataLayout(target_machine_->createDataLayout());
+    }
+    if (module->getTargetTriple().empty()) {
+      module->setTargetTriple(target_machine_->getTargetTriple().str());
+    }
+    llvm::raw_svector_ostream stream(object_data);
+    llvm::legacy::PassManager pass_manager;
+    llvm::MCContext* mc_context = nullptr;
+    if (target_machine_->addPassesToEmitMC(pass_manager, mc_context, stream)) {
+      return InternalErrorBuilder(IREE_LOC)
+             << "Target machine can't emit objects";
+    }
+    pass_manager.run(*module);
+  }
+  return std::unique_ptr<llvm::MemoryBuffer>(
+      absl::make_unique<llvm::SmallVectorMemoryBuffer>(
+          std::move(object_data), module->getModuleIdentifier()));
+}
+
+Status LLVMJITObjectCache::Store(const std::string& key,
+                                 llvm::MemoryBufferRef object) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Store");
+  auto record_failure = [this]() {
+    absl::MutexLock lock(&stats_mutex_);
+    ++stats_.store_failure_count;
+  };
+
+  if (auto error_code = llvm::sys::fs::create_directories(cache_path_)) {
+    record_failure();
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create object cache directory '" << cache_path_
+           << "': " << error_code.message();
+  }
+
+  // Write to a unique temporary file and then rename into place so that
+  // readers never see a partially written object.
+  std::string object_path = GetObjectPath(key);
+  int fd = -1;
+  llvm::SmallString<256> temp_path;
+  if (auto error_code = llvm::sys::fs::createUniqueFile(
+          object_path + ".tmp-%%%%%%", fd, temp_path)) {
+    record_failure();
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create temporary object cache file: "
+           << error_code.message();
+  }
+  {
+    llvm::raw_fd_ostream stream(fd, /*shouldClose=*/true);
+    stream << object.getBuffer();
+    stream.close();
+    if (stream.has_error()) {
+      stream.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      record_failure();
+      return DataLossErrorBuilder(IREE_LOC)
+             << "Failed to write object cache file '" << temp_path.str().str()
+             << "'";
+    }
+  }
+  if (auto error_code = llvm::sys::fs::rename(temp_path, object_path)) {
+    llvm::sys::fs::remove(temp_path);
+    record_failure();
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't move object into cache at '" << object_path
+           << "': " << error_code.message();
+  }
+  return OkStatus();
+}
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
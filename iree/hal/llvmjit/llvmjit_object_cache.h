@@ -0,0 +1,114 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+#define IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Target/TargetMachine.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// A persistent on-disk cache of native objects compiled from LLVM IR
+// executables.
+//
+// Objects are keyed by a hash of the executable data along with the target
+// triple, CPU, and CPU features they were compiled for such that a cache
+// directory may be shared across machines (or CPU upgrades) without ever
+// loading incompatible code. On a hit the object file is mapped directly from
+// disk and handed to the JIT linker, skipping IR parsing and codegen entirely.
+//
+// Thread-safe.
+class LLVMJITObjectCache final {
+ public:
+  struct Stats {
+    // Total number of lookups that found a cached object.
+    int64_t hit_count = 0;
+    // Total number of lookups that required compilation.
+    int64_t miss_count = 0;
+    // Total number of compiled objects that could not be written to the cache.
+    int64_t store_failure_count = 0;
+    // Total number of cached objects that were discarded because they were
+    // corrupt or not loadable on the target machine of the cache.
+    int64_t evicted_count = 0;
+  };
+
+  // Creates a cache storing objects under |cache_path|, compiling for the host
+  // machine. The directory will be created on first use if it does not exist.
+  static StatusOr<std::unique_ptr<LLVMJITObjectCache>> Create(
+      std::string cache_path);
+
+  LLVMJITObjectCache(std::string cache_path,
+                     std::unique_ptr<llvm::TargetMachine> target_machine);
+  ~LLVMJITObjectCache();
+
+  LLVMJITObjectCache(const LLVMJITObjectCache&) = delete;
+  LLVMJITObjectCache& operator=(const LLVMJITObjectCache&) = delete;
+
+  const std::string& cache_path() const { return cache_path_; }
+
+  // Returns a snapshot of the cache statistics.
+  Stats stats() const;
+
+  // Returns the cache key for the given executable data when compiled with
+  // the target machine of the cache.
+  std::string ComputeKey(absl::Span<const uint8_t> executable_data) const;
+
+  // Returns the cached object for |key|, or nullptr if it is not present.
+  // Counts as a hit or miss in the cache statistics. Objects that fail to parse
+  // are removed from the cache and reported as misses so that callers
+  // recompile and store a fresh copy.
+  std::unique_ptr<llvm::MemoryBuffer> Lookup(const std::string& key);
+
+  // Compiles |module| to a native object for the target machine of the cache.
+  // The module data layout and triple will be set if not already specified.
+  StatusOr<std::unique_ptr<llvm::MemoryBuffer>> Compile(llvm::Module* module);
+
+  // Stores |object| in the cache under |key|. The write is atomic such that
+  // concurrent processes sharing the cache never observe partial objects.
+  Status Store(const std::string& key, llvm::MemoryBufferRef object);
+
+ private:
+  std::string GetObjectPath(const std::string& key) const;
+
+  const std::string cache_path_;
+  const std::string target_id_;
+  const llvm::Triple::ArchType target_arch_;
+
+  // TargetMachine codegen is not thread-safe.
+  absl::Mutex compile_mutex_;
+  std::unique_ptr<llvm::TargetMachine> target_machine_
+      ABSL_GUARDED_BY(compile_mutex_);
+
+  mutable absl::Mutex stats_mutex_;
+  Stats stats_ ABSL_GUARDED_BY(stats_mutex_);
+};
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
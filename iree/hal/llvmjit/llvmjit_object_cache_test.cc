@@ -0,0 +1,190 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/testing/gtest.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+namespace {
+
+constexpr char kTestModule[] = R"(
+define i32 @add_one(i32 %x) {
+  %y = add i32 %x, 1
+  ret i32 %y
+}
+)";
+
+// Returns a target machine for the host triple with the given |cpu|.
+std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(
+    const std::string& cpu) {
+  llvm::orc::JITTargetMachineBuilder builder(
+      llvm::Triple(llvm::sys::getProcessTriple()));
+  builder.setCPU(cpu);
+  auto target_machine_or = builder.createTargetMachine();
+  CHECK(target_machine_or) << "Can't create target machine";
+  return std::move(*target_machine_or);
+}
+
+class LLVMJITObjectCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  }
+
+  void SetUp() override {
+    llvm::SmallString<256> path;
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(
+        "llvmjit_object_cache_test", path));
+    cache_path_ = path.str().str();
+    ASSERT_OK_AND_ASSIGN(cache_, LLVMJITObjectCache::Create(cache_path_));
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(cache_path_); }
+
+  // Compiles kTestModule to a native object with the cache target machine.
+  std::unique_ptr<llvm::MemoryBuffer> CompileTestModule() {
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic diagnostic;
+    auto module = llvm::parseAssemblyString(kTestModule, diagnostic, context);
+    CHECK(module) << "Can't parse test module";
+    auto object_or = cache_->Compile(module.get());
+    CHECK_OK(object_or.status());
+    return std::move(object_or.ValueOrDie());
+  }
+
+  // Writes |contents| directly to the cache entry for |key|.
+  void WriteEntry(const std::string& key, llvm::StringRef contents) {
+    ASSERT_FALSE(llvm::sys::fs::create_directories(cache_path_));
+    std::error_code error_code;
+    llvm::raw_fd_ostream stream(EntryPath(key), error_code);
+    ASSERT_FALSE(error_code);
+    stream << contents;
+  }
+
+  std::string EntryPath(const std::string& key) {
+    llvm::SmallString<256> path(cache_path_);
+    llvm::sys::path::append(path, key + ".o");
+    return path.str().str();
+  }
+
+  std::string cache_path_;
+  std::unique_ptr<LLVMJITObjectCache> cache_;
+};
+
+TEST_F(LLVMJITObjectCacheTest, KeyDependsOnExecutableData) {
+  std::vector<uint8_t> data_a = {1, 2, 3, 4};
+  std::vector<uint8_t> data_b = {1, 2, 3, 5};
+  EXPECT_EQ(cache_->ComputeKey(data_a), cache_->ComputeKey(data_a));
+  EXPECT_NE(cache_->ComputeKey(data_a), cache_->ComputeKey(data_b));
+  EXPECT_NE(cache_->ComputeKey(data_a), cache_->ComputeKey({}));
+}
+
+TEST_F(LLVMJITObjectCacheTest, KeyDependsOnTargetMachine) {
+  LLVMJITObjectCache generic_cache(cache_path_, CreateTargetMachine("generic"));
+  LLVMJITObjectCache default_cache(cache_path_, CreateTargetMachine(""));
+  std::vector<uint8_t> data = {1, 2, 3, 4};
+  EXPECT_NE(generic_cache.ComputeKey(data), default_cache.ComputeKey(data));
+}
+
+TEST_F(LLVMJITObjectCacheTest, LookupMissesWhenEmpty) {
+  EXPECT_EQ(nullptr, cache_->Lookup(cache_->ComputeKey({1, 2, 3})));
+  auto stats = cache_->stats();
+  EXPECT_EQ(0, stats.hit_count);
+  EXPECT_EQ(1, stats.miss_count);
+  EXPECT_EQ(0, stats.evicted_count);
+}
+
+TEST_F(LLVMJITObjectCacheTest, StoreThenLookupHits) {
+  std::string key = cache_->ComputeKey({1, 2, 3});
+  auto object = CompileTestModule();
+  ASSERT_NE(0, object->getBufferSize());
+  ASSERT_OK(cache_->Store(key, *object));
+
+  auto cached_object = cache_->Lookup(key);
+  ASSERT_NE(nullptr, cached_object);
+  EXPECT_EQ(object->getBuffer(), cached_object->getBuffer());
+  auto stats = cache_->stats();
+  EXPECT_EQ(1, stats.hit_count);
+  EXPECT_EQ(0, stats.miss_count);
+  EXPECT_EQ(0, stats.store_failure_count);
+
+  // Other keys must not alias the stored entry.
+  EXPECT_EQ(nullptr, cache_->Lookup(cache_->ComputeKey({1, 2, 4})));
+  EXPECT_EQ(1, cache_->stats().miss_count);
+}
+
+TEST_F(LLVMJITObjectCacheTest, StoreReplacesExistingEntry) {
+  std::string key = cache_->ComputeKey({1, 2, 3});
+  auto object = CompileTestModule();
+  ASSERT_OK(cache_->Store(key, *object));
+  ASSERT_OK(cache_->Store(key, *object));
+  auto cached_object = cache_->Lookup(key);
+  ASSERT_NE(nullptr, cached_object);
+  EXPECT_EQ(object->getBuffer(), cached_object->getBuffer());
+}
+
+TEST_F(LLVMJITObjectCacheTest, CorruptEntryIsEvicted) {
+  std::string key = cache_->ComputeKey({1, 2, 3});
+  WriteEntry(key, "not an object file");
+
+  EXPECT_EQ(nullptr, cache_->Lookup(key));
+  EXPECT_FALSE(llvm::sys::fs::exists(EntryPath(key)));
+  auto stats = cache_->stats();
+  EXPECT_EQ(0, stats.hit_count);
+  EXPECT_EQ(1, stats.miss_count);
+  EXPECT_EQ(1, stats.evicted_count);
+
+  // Recompiling and storing must repopulate the entry.
+  auto object = CompileTestModule();
+  ASSERT_OK(cache_->Store(key, *object));
+  auto cached_object = cache_->Lookup(key);
+  ASSERT_NE(nullptr, cached_object);
+  EXPECT_EQ(object->getBuffer(), cached_object->getBuffer());
+}
+
+TEST_F(LLVMJITObjectCacheTest, TruncatedEntryIsEvicted) {
+  std::string key = cache_->ComputeKey({1, 2, 3});
+  auto object = CompileTestModule();
+  WriteEntry(key, object->getBuffer().take_front(object->getBufferSize() / 2));
+
+  EXPECT_EQ(nullptr, cache_->Lookup(key));
+  EXPECT_FALSE(llvm::sys::fs::exists(EntryPath(key)));
+  EXPECT_EQ(1, cache_->stats().evicted_count);
+}
+
+}  // namespace
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
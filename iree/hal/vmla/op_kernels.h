@@ -24,7 +24,9 @@
 // once for the entire Runtime (and stored on RuntimeState) and shared across
 // all fibers. This enables kernels that may require thread pools or device
 // handles to be shared while kernels that require transient storage to be safe
-// to use from multiple fibers concurrently.
+// to use from multiple fibers concurrently. Kernels may also have worker state
+// (stored on WorkerState) that is used by only one fiber at a time and need not
+// be synchronized.
 //
 // All kernels are templated to enable specialization of particular types or
 // type combinations. By default the op_kernels_generic.h will provide C++
@@ -35,6 +37,7 @@
 #define IREE_HAL_VMLA_OP_KERNELS_H_
 
 #include <cstdint>
+#include <memory>
 
 #include "absl/types/span.h"
 #include "iree/base/shape.h"
@@ -324,9 +327,33 @@ struct Convert {
 };
 
 struct MatMul {
+  // Configuration shared by all workers. Immutable and thread-safe.
   struct RuntimeState;
 
-  static std::unique_ptr<RuntimeState> CreateRuntimeState();
+  // Creates runtime state allowing any single matmul to use at most
+  // |max_thread_count| threads.
+  static std::unique_ptr<RuntimeState> CreateRuntimeState(
+      int max_thread_count = 1);
+
+  // Per-worker ruy context and its thread pool. Thread-compatible; each
+  // concurrently executing worker must use its own.
+  struct WorkerState;
+
+  // Creates worker state configured by |runtime_state|.
+  static std::unique_ptr<WorkerState> CreateWorkerState(
+      const RuntimeState* runtime_state);
+
+  // An RHS matrix packed into the internal layout used by the kernel.
+  struct PrepackedRhs;
+
+  // Packed constant RHS matrices keyed by their data pointer and shape.
+  // Thread-safe; entries are immutable once added and may be used by multiple
+  // workers concurrently.
+  class PrepackedRhsCache;
+
+  // Creates an empty cache. Cached data pointers must remain valid and
+  // unchanged for the lifetime of the cache.
+  static std::unique_ptr<PrepackedRhsCache> CreatePrepackedRhsCache();
 
   template <typename T, typename ACC>
   struct Buffers {
@@ -345,10 +372,16 @@ struct MatMul {
     // for per-channel.
     absl::Span<const ACC> multiplier_mantissa_buffer;
     absl::Span<const int32_t> multiplier_exponent_buffer;
+
+    // Optional cache for an RHS that is constant across calls (such as
+    // weights). If the cache has no entry for |rhs_buffer| with |rhs_shape| the
+    // RHS is packed and added, otherwise the packed data is used directly and
+    // |rhs_buffer| is not read.
+    PrepackedRhsCache* prepacked_rhs_cache = nullptr;
   };
 
   template <typename T, typename ACC>
-  static Status Execute(RuntimeState* runtime_state,
+  static Status Execute(WorkerState* worker_state,
                         const Buffers<T, ACC>& buffers);
 
   // Simple 2D transpose, borrowed from TFLite. This is temporary to get RUY
@@ -369,9 +402,37 @@ struct MatMul {
   }
 };
 
+// 2D convolution of an NHWC input with an HWIO filter producing an NHWC
+// result. |padding| contains the (low, high) padding of each spatial dimension
+// and |dilation| the filter (rhs) dilation. Ungrouped convolutions are lowered
+// to matmuls over im2col patches while grouped (such as depthwise)
+// convolutions are computed directly.
+struct Conv2D {
+  template <typename T>
+  static Status Execute(
+      MatMul::WorkerState* worker_state, absl::Span<const T> input_buffer,
+      const Shape& input_shape, absl::Span<const T> filter_buffer,
+      const Shape& filter_shape, absl::Span<T> dst_buffer,
+      const Shape& dst_shape, absl::Span<const int32_t> window_strides,
+      absl::Span<const int32_t> padding, absl::Span<const int32_t> dilation,
+      int32_t feature_group_count,
+      MatMul::PrepackedRhsCache* prepacked_filter_cache);
+};
+
 struct RuntimeState {
-  std::unique_ptr<MatMul::RuntimeState> mat_mul_state =
-      MatMul::CreateRuntimeState();
+  RuntimeState() : RuntimeState(/*max_thread_count=*/1) {}
+  explicit RuntimeState(int max_thread_count)
+      : mat_mul_state(MatMul::CreateRuntimeState(max_thread_count)) {}
+
+  std::unique_ptr<MatMul::RuntimeState> mat_mul_state;
+};
+
+struct WorkerState {
+  explicit WorkerState(const RuntimeState* runtime_state)
+      : mat_mul_state(
+            MatMul::CreateWorkerState(runtime_state->mat_mul_state.get())) {}
+
+  std::unique_ptr<MatMul::WorkerState> mat_mul_state;
 };
 
 struct ReduceSum {
@@ -398,6 +459,42 @@ struct ReduceMax {
                         const Shape& src_shape, const Shape& dst_shape);
 };
 
+// Windowed reductions (pooling) over every dimension of the source.
+// |padding| contains the (low, high) padding of each dimension and padded
+// elements take the value of |init_buffer|.
+struct PoolingSum {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const T> init_buffer,
+                        absl::Span<T> dst_buffer, const Shape& src_shape,
+                        const Shape& dst_shape,
+                        absl::Span<const int32_t> window_dimensions,
+                        absl::Span<const int32_t> window_strides,
+                        absl::Span<const int32_t> padding);
+};
+
+struct PoolingMin {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const T> init_buffer,
+                        absl::Span<T> dst_buffer, const Shape& src_shape,
+                        const Shape& dst_shape,
+                        absl::Span<const int32_t> window_dimensions,
+                        absl::Span<const int32_t> window_strides,
+                        absl::Span<const int32_t> padding);
+};
+
+struct PoolingMax {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const T> init_buffer,
+                        absl::Span<T> dst_buffer, const Shape& src_shape,
+                        const Shape& dst_shape,
+                        absl::Span<const int32_t> window_dimensions,
+                        absl::Span<const int32_t> window_strides,
+                        absl::Span<const int32_t> padding);
+};
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
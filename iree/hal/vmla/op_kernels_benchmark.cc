@@ -0,0 +1,143 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/shape.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace {
+
+template <typename T>
+struct TransposeBenchmarkState {
+  TransposeBenchmarkState(Shape src_shape, std::vector<int32_t> perm)
+      : src_shape(src_shape),
+        perm(std::move(perm)),
+        src_buffer(src_shape.element_count()),
+        dst_buffer(src_shape.element_count()) {
+    std::iota(src_buffer.begin(), src_buffer.end(), static_cast<T>(0));
+  }
+
+  Shape src_shape;
+  std::vector<int32_t> perm;
+  std::vector<T> src_buffer;
+  std::vector<T> dst_buffer;
+};
+
+// 2D transpose of a [N, N] matrix.
+template <typename T>
+static void BM_Transpose2D(benchmark::State& state) {
+  int n = state.range(0);
+  TransposeBenchmarkState<T> bench({n, n}, {1, 0});
+  for (auto _ : state) {
+    Transpose::Execute<T>(bench.src_buffer, absl::MakeSpan(bench.dst_buffer),
+                          bench.src_shape, bench.perm)
+        .IgnoreError();
+    benchmark::DoNotOptimize(bench.dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bench.src_buffer.size() *
+                          sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_Transpose2D, uint8_t)->Arg(64)->Arg(512)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_Transpose2D, uint16_t)->Arg(64)->Arg(512)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_Transpose2D, uint32_t)->Arg(64)->Arg(512)->Arg(2048);
+
+template <typename T>
+static void BM_Transpose2DGeneric(benchmark::State& state) {
+  int n = state.range(0);
+  TransposeBenchmarkState<T> bench({n, n}, {1, 0});
+  for (auto _ : state) {
+    impl::TransposeGeneric<T>(bench.src_buffer,
+                              absl::MakeSpan(bench.dst_buffer),
+                              bench.src_shape, bench.perm);
+    benchmark::DoNotOptimize(bench.dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bench.src_buffer.size() *
+                          sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_Transpose2DGeneric, uint8_t)->Arg(64)->Arg(512);
+BENCHMARK_TEMPLATE(BM_Transpose2DGeneric, uint16_t)->Arg(64)->Arg(512);
+BENCHMARK_TEMPLATE(BM_Transpose2DGeneric, uint32_t)->Arg(64)->Arg(512);
+
+// Attention-style head split [batch, seq, heads, head_dim] ->
+// [batch, heads, seq, head_dim], which keeps head_dim rows contiguous.
+static void BM_TransposeHeads(benchmark::State& state) {
+  TransposeBenchmarkState<uint32_t> bench({4, 128, 12, 64}, {0, 2, 1, 3});
+  for (auto _ : state) {
+    Transpose::Execute<uint32_t>(bench.src_buffer,
+                                 absl::MakeSpan(bench.dst_buffer),
+                                 bench.src_shape, bench.perm)
+        .IgnoreError();
+    benchmark::DoNotOptimize(bench.dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bench.src_buffer.size() *
+                          sizeof(uint32_t));
+}
+BENCHMARK(BM_TransposeHeads);
+
+static void BM_TransposeHeadsGeneric(benchmark::State& state) {
+  TransposeBenchmarkState<uint32_t> bench({4, 128, 12, 64}, {0, 2, 1, 3});
+  for (auto _ : state) {
+    impl::TransposeGeneric<uint32_t>(bench.src_buffer,
+                                     absl::MakeSpan(bench.dst_buffer),
+                                     bench.src_shape, bench.perm);
+    benchmark::DoNotOptimize(bench.dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bench.src_buffer.size() *
+                          sizeof(uint32_t));
+}
+BENCHMARK(BM_TransposeHeadsGeneric);
+
+// Key transpose [batch, heads, seq, head_dim] -> [batch, heads, head_dim, seq]
+// as used ahead of the attention score matmul.
+static void BM_TransposeKeys(benchmark::State& state) {
+  TransposeBenchmarkState<uint32_t> bench({4, 12, 128, 64}, {0, 1, 3, 2});
+  for (auto _ : state) {
+    Transpose::Execute<uint32_t>(bench.src_buffer,
+                                 absl::MakeSpan(bench.dst_buffer),
+                                 bench.src_shape, bench.perm)
+        .IgnoreError();
+    benchmark::DoNotOptimize(bench.dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bench.src_buffer.size() *
+                          sizeof(uint32_t));
+}
+BENCHMARK(BM_TransposeKeys);
+
+static void BM_TransposeKeysGeneric(benchmark::State& state) {
+  TransposeBenchmarkState<uint32_t> bench({4, 12, 128, 64}, {0, 1, 3, 2});
+  for (auto _ : state) {
+    impl::TransposeGeneric<uint32_t>(bench.src_buffer,
+                                     absl::MakeSpan(bench.dst_buffer),
+                                     bench.src_shape, bench.perm);
+    benchmark::DoNotOptimize(bench.dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bench.src_buffer.size() *
+                          sizeof(uint32_t));
+}
+BENCHMARK(BM_TransposeKeysGeneric);
+
+}  // namespace
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -15,11 +15,22 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_GENERIC_H_
 #define IREE_HAL_VMLA_OP_KERNELS_GENERIC_H_
 
+#include <algorithm>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IREE_VMLA_TRANSPOSE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IREE_VMLA_TRANSPOSE_NEON 1
+#endif
+
 namespace iree {
 namespace hal {
 namespace vmla {
@@ -167,11 +178,13 @@ Status Select::Execute(absl::Span<const uint8_t> cond_buffer,
   return OkStatus();
 }
 
+namespace impl {
+
+// Reference transpose computing the source index of each destination element.
+// Kept for testing and benchmarking the tiled implementation.
 template <typename T>
-Status Transpose::Execute(absl::Span<const T> src_buffer,
-                          absl::Span<T> dst_buffer, const Shape& src_shape,
-                          absl::Span<const int32_t> perm) {
-  // This implementation is .... not fast.
+void TransposeGeneric(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer,
+                      const Shape& src_shape, absl::Span<const int32_t> perm) {
   int rank = src_shape.size();
   absl::InlinedVector<int, 8> src_strides(rank);
   absl::InlinedVector<int, 8> dst_strides(rank);
@@ -193,6 +206,261 @@ Status Transpose::Execute(absl::Span<const T> src_buffer,
     }
     dst_buffer[dst_i] = src_buffer[src_i];
   }
+}
+
+// Simplifies a transpose of |src_shape| by |perm| to an equivalent one of
+// lower rank by dropping unit dimensions and merging runs of dimensions that
+// remain adjacent and in order after permutation.
+// For example [A, B, C, D] with perm [2, 3, 0, 1] becomes [A*B, C*D] with
+// perm [1, 0].
+inline void SimplifyTranspose(const Shape& src_shape,
+                              absl::Span<const int32_t> perm,
+                              absl::InlinedVector<size_t, 8>* out_shape,
+                              absl::InlinedVector<int, 8>* out_perm) {
+  int rank = src_shape.size();
+  absl::InlinedVector<int, 8> squeezed_dims(rank, -1);
+  absl::InlinedVector<size_t, 8> squeezed_shape;
+  for (int i = 0; i < rank; ++i) {
+    if (src_shape[i] == 1) continue;
+    squeezed_dims[i] = squeezed_shape.size();
+    squeezed_shape.push_back(src_shape[i]);
+  }
+
+  // Groups of adjacent source dims in destination order.
+  absl::InlinedVector<int, 8> group_first_dims;
+  absl::InlinedVector<size_t, 8> group_sizes;
+  int last_dim = -2;
+  for (int i = 0; i < rank; ++i) {
+    int dim = squeezed_dims[perm[i]];
+    if (dim < 0) continue;
+    if (dim == last_dim + 1) {
+      group_sizes.back() *= squeezed_shape[dim];
+    } else {
+      group_first_dims.push_back(dim);
+      group_sizes.push_back(squeezed_shape[dim]);
+    }
+    last_dim = dim;
+  }
+
+  // Groups are numbered in source order.
+  int group_count = group_first_dims.size();
+  out_shape->resize(group_count);
+  out_perm->resize(group_count);
+  for (int i = 0; i < group_count; ++i) {
+    int src_dim = 0;
+    for (int j = 0; j < group_count; ++j) {
+      if (group_first_dims[j] < group_first_dims[i]) ++src_dim;
+    }
+    (*out_shape)[src_dim] = group_sizes[i];
+    (*out_perm)[i] = src_dim;
+  }
+}
+
+// Calls |fn| with the source and destination offsets of every index in the
+// space of |sizes|, where each dimension advances the offsets by the given
+// strides. The last dimension is iterated fastest.
+template <typename F>
+void ForEachTransposeOffset(absl::Span<const size_t> sizes,
+                            absl::Span<const size_t> src_strides,
+                            absl::Span<const size_t> dst_strides, F fn) {
+  switch (sizes.size()) {
+    case 0:
+      fn(0, 0);
+      return;
+    case 1:
+      for (size_t i = 0; i < sizes[0]; ++i) {
+        fn(i * src_strides[0], i * dst_strides[0]);
+      }
+      return;
+    case 2:
+      for (size_t i = 0; i < sizes[0]; ++i) {
+        for (size_t j = 0; j < sizes[1]; ++j) {
+          fn(i * src_strides[0] + j * src_strides[1],
+             i * dst_strides[0] + j * dst_strides[1]);
+        }
+      }
+      return;
+    default: {
+      int rank = sizes.size();
+      absl::InlinedVector<size_t, 8> indices(rank, 0);
+      size_t src_offset = 0;
+      size_t dst_offset = 0;
+      while (true) {
+        fn(src_offset, dst_offset);
+        int dim = rank - 1;
+        for (; dim >= 0; --dim) {
+          src_offset += src_strides[dim];
+          dst_offset += dst_strides[dim];
+          if (++indices[dim] < sizes[dim]) break;
+          src_offset -= src_strides[dim] * sizes[dim];
+          dst_offset -= dst_strides[dim] * sizes[dim];
+          indices[dim] = 0;
+        }
+        if (dim < 0) return;
+      }
+    }
+  }
+}
+
+// Transposes a kSize x kSize block such that dst[c][r] = src[r][c].
+template <typename T>
+struct TransposeMicroKernel {
+  static constexpr int kSize = 4;
+  static void Run(const T* src, size_t src_stride, T* dst, size_t dst_stride) {
+    for (int r = 0; r < kSize; ++r) {
+      for (int c = 0; c < kSize; ++c) {
+        dst[c * dst_stride + r] = src[r * src_stride + c];
+      }
+    }
+  }
+};
+
+#if defined(IREE_VMLA_TRANSPOSE_SSE2) || defined(IREE_VMLA_TRANSPOSE_NEON)
+template <>
+struct TransposeMicroKernel<uint32_t> {
+  static constexpr int kSize = 4;
+  static void Run(const uint32_t* src, size_t src_stride, uint32_t* dst,
+                  size_t dst_stride) {
+#if defined(IREE_VMLA_TRANSPOSE_SSE2)
+    __m128i r0 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + 0 * src_stride));
+    __m128i r1 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + 1 * src_stride));
+    __m128i r2 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + 2 * src_stride));
+    __m128i r3 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + 3 * src_stride));
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);  // a0 b0 a1 b1
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);  // c0 d0 c1 d1
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);  // a2 b2 a3 b3
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);  // c2 d2 c3 d3
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0 * dst_stride),
+                     _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 1 * dst_stride),
+                     _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * dst_stride),
+                     _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * dst_stride),
+                     _mm_unpackhi_epi64(t2, t3));
+#else
+    uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(src + 0 * src_stride),
+                                 vld1q_u32(src + 1 * src_stride));
+    uint32x4x2_t t23 = vtrnq_u32(vld1q_u32(src + 2 * src_stride),
+                                 vld1q_u32(src + 3 * src_stride));
+    vst1q_u32(dst + 0 * dst_stride, vcombine_u32(vget_low_u32(t01.val[0]),
+                                                 vget_low_u32(t23.val[0])));
+    vst1q_u32(dst + 1 * dst_stride, vcombine_u32(vget_low_u32(t01.val[1]),
+                                                 vget_low_u32(t23.val[1])));
+    vst1q_u32(dst + 2 * dst_stride, vcombine_u32(vget_high_u32(t01.val[0]),
+                                                 vget_high_u32(t23.val[0])));
+    vst1q_u32(dst + 3 * dst_stride, vcombine_u32(vget_high_u32(t01.val[1]),
+                                                 vget_high_u32(t23.val[1])));
+#endif  // IREE_VMLA_TRANSPOSE_SSE2
+  }
+};
+#endif  // IREE_VMLA_TRANSPOSE_SSE2 || IREE_VMLA_TRANSPOSE_NEON
+
+// Transposes a |rows| x |cols| matrix such that dst[c][r] = src[r][c].
+// The matrix is processed in tiles that span one cache line of each source
+// row so that both the reads and writes of a tile stay resident in L1.
+template <typename T>
+void Transpose2DTiled(const T* src, size_t src_stride, T* dst,
+                      size_t dst_stride, size_t rows, size_t cols) {
+  constexpr size_t kTileSize = 64 / sizeof(T);
+  constexpr size_t kBlockSize = TransposeMicroKernel<T>::kSize;
+  for (size_t r0 = 0; r0 < rows; r0 += kTileSize) {
+    size_t r_end = std::min(r0 + kTileSize, rows);
+    for (size_t c0 = 0; c0 < cols; c0 += kTileSize) {
+      size_t c_end = std::min(c0 + kTileSize, cols);
+      size_t r = r0;
+      for (; r + kBlockSize <= r_end; r += kBlockSize) {
+        size_t c = c0;
+        for (; c + kBlockSize <= c_end; c += kBlockSize) {
+          TransposeMicroKernel<T>::Run(src + r * src_stride + c, src_stride,
+                                       dst + c * dst_stride + r, dst_stride);
+        }
+        for (; c < c_end; ++c) {
+          for (size_t rr = r; rr < r + kBlockSize; ++rr) {
+            dst[c * dst_stride + rr] = src[rr * src_stride + c];
+          }
+        }
+      }
+      for (; r < r_end; ++r) {
+        for (size_t c = c0; c < c_end; ++c) {
+          dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace impl
+
+template <typename T>
+Status Transpose::Execute(absl::Span<const T> src_buffer,
+                          absl::Span<T> dst_buffer, const Shape& src_shape,
+                          absl::Span<const int32_t> perm) {
+  if (dst_buffer.empty()) return OkStatus();
+  absl::InlinedVector<size_t, 8> shape;
+  absl::InlinedVector<int, 8> dims;
+  impl::SimplifyTranspose(src_shape, perm, &shape, &dims);
+  int rank = shape.size();
+  if (rank <= 1) {
+    // Only unit dimensions were moved.
+    std::copy(src_buffer.begin(), src_buffer.end(), dst_buffer.begin());
+    return OkStatus();
+  }
+
+  // Strides of each source dimension in the source and destination.
+  absl::InlinedVector<size_t, 8> src_strides(rank);
+  absl::InlinedVector<size_t, 8> dst_strides(rank);
+  size_t src_stride = 1;
+  size_t dst_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    src_strides[i] = src_stride;
+    src_stride *= shape[i];
+    dst_strides[dims[i]] = dst_stride;
+    dst_stride *= shape[dims[i]];
+  }
+
+  const T* src = src_buffer.data();
+  T* dst = dst_buffer.data();
+  int src_inner_dim = rank - 1;
+  int dst_inner_dim = dims[rank - 1];
+
+  // Iterate all dimensions other than the innermost of the source and the
+  // destination in destination order.
+  absl::InlinedVector<size_t, 8> outer_sizes;
+  absl::InlinedVector<size_t, 8> outer_src_strides;
+  absl::InlinedVector<size_t, 8> outer_dst_strides;
+  for (int i = 0; i < rank; ++i) {
+    int dim = dims[i];
+    if (dim == src_inner_dim || dim == dst_inner_dim) continue;
+    outer_sizes.push_back(shape[dim]);
+    outer_src_strides.push_back(src_strides[dim]);
+    outer_dst_strides.push_back(dst_strides[dim]);
+  }
+
+  if (src_inner_dim == dst_inner_dim) {
+    // Rows stay contiguous and can be copied directly.
+    size_t row_length = shape[src_inner_dim];
+    impl::ForEachTransposeOffset(
+        outer_sizes, outer_src_strides, outer_dst_strides,
+        [&](size_t src_offset, size_t dst_offset) {
+          std::copy_n(src + src_offset, row_length, dst + dst_offset);
+        });
+  } else {
+    size_t rows = shape[dst_inner_dim];
+    size_t cols = shape[src_inner_dim];
+    size_t row_stride = src_strides[dst_inner_dim];
+    size_t col_stride = dst_strides[src_inner_dim];
+    impl::ForEachTransposeOffset(
+        outer_sizes, outer_src_strides, outer_dst_strides,
+        [&](size_t src_offset, size_t dst_offset) {
+          impl::Transpose2DTiled(src + src_offset, row_stride,
+                                 dst + dst_offset, col_stride, rows, cols);
+        });
+  }
   return OkStatus();
 }
 
@@ -726,6 +994,190 @@ Status ReduceMax::Execute(absl::Span<const T> src_buffer,
       src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
 }
 
+namespace impl {
+
+template <typename T, typename KernelImpl>
+Status GenericPooling(absl::Span<const T> src_buffer,
+                      absl::Span<const T> init_buffer,
+                      absl::Span<T> dst_buffer, const Shape& src_shape,
+                      const Shape& dst_shape,
+                      absl::Span<const int32_t> window_dimensions,
+                      absl::Span<const int32_t> window_strides,
+                      absl::Span<const int32_t> padding) {
+  const int rank = src_shape.size();
+  if (dst_shape.size() != rank || window_dimensions.size() != rank ||
+      window_strides.size() != rank || padding.size() != rank * 2) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Pooling window must cover all " << rank
+           << " source dimensions";
+  }
+  const T init_value = init_buffer[0];
+
+  // Trailing dimensions that pass through untouched (like channels in NHWC)
+  // are processed as one contiguous block per window element so that the
+  // innermost loop is over adjacent elements.
+  int outer_rank = rank;
+  size_t inner_size = 1;
+  while (outer_rank > 0) {
+    int i = outer_rank - 1;
+    if (window_dimensions[i] != 1 || window_strides[i] != 1 ||
+        padding[i * 2] != 0 || src_shape[i] != dst_shape[i]) {
+      break;
+    }
+    inner_size *= src_shape[i];
+    --outer_rank;
+  }
+
+  absl::InlinedVector<size_t, 8> src_strides(outer_rank);
+  size_t src_stride = inner_size;
+  for (int i = outer_rank - 1; i >= 0; --i) {
+    src_strides[i] = src_stride;
+    src_stride *= src_shape[i];
+  }
+  Shape outer_dst_shape(dst_shape.subspan(0, outer_rank));
+  Shape window_shape(window_dimensions.subspan(0, outer_rank));
+  const size_t window_size = window_shape.element_count();
+
+  absl::InlinedVector<int32_t, 8> dst_indices(outer_rank, 0);
+  absl::InlinedVector<int32_t, 8> window_indices(outer_rank, 0);
+  for (T* dst_ptr = dst_buffer.begin(); dst_ptr < dst_buffer.end();
+       dst_ptr += inner_size) {
+    std::fill_n(dst_ptr, inner_size, init_value);
+    std::fill(window_indices.begin(), window_indices.end(), 0);
+    for (size_t window_i = 0; window_i < window_size; ++window_i) {
+      bool is_padding = false;
+      size_t src_offset = 0;
+      for (int i = 0; i < outer_rank; ++i) {
+        int index = dst_indices[i] * window_strides[i] + window_indices[i] -
+                    padding[i * 2];
+        if (index < 0 || index >= src_shape[i]) {
+          is_padding = true;
+          break;
+        }
+        src_offset += index * src_strides[i];
+      }
+      if (is_padding) {
+        for (size_t i = 0; i < inner_size; ++i) {
+          KernelImpl()(&dst_ptr[i], init_value);
+        }
+      } else {
+        const T* src_ptr = src_buffer.data() + src_offset;
+        for (size_t i = 0; i < inner_size; ++i) {
+          KernelImpl()(&dst_ptr[i], src_ptr[i]);
+        }
+      }
+      IncrementShapeIndex(absl::MakeSpan(window_indices), window_shape);
+    }
+    IncrementShapeIndex(absl::MakeSpan(dst_indices), outer_dst_shape);
+  }
+
+  return OkStatus();
+}
+
+// Direct NHWC/HWIO convolution supporting feature groups. Each output pixel is
+// accumulated as a sum of filter rows scaled by input values such that the
+// innermost loop runs over contiguous output channels.
+template <typename T>
+Status Conv2DDirect(absl::Span<const T> input_buffer, const Shape& input_shape,
+                    absl::Span<const T> filter_buffer,
+                    const Shape& filter_shape, absl::Span<T> dst_buffer,
+                    const Shape& dst_shape,
+                    absl::Span<const int32_t> window_strides,
+                    absl::Span<const int32_t> padding,
+                    absl::Span<const int32_t> dilation,
+                    int32_t feature_group_count) {
+  const int batch_size = input_shape[0];
+  const int input_height = input_shape[1];
+  const int input_width = input_shape[2];
+  const int input_channels = input_shape[3];
+  const int filter_height = filter_shape[0];
+  const int filter_width = filter_shape[1];
+  const int group_input_channels = filter_shape[2];
+  const int output_channels = filter_shape[3];
+  const int output_height = dst_shape[1];
+  const int output_width = dst_shape[2];
+  const int group_output_channels = output_channels / feature_group_count;
+
+  std::fill(dst_buffer.begin(), dst_buffer.end(), T{0});
+  for (int n = 0; n < batch_size; ++n) {
+    for (int oy = 0; oy < output_height; ++oy) {
+      for (int ox = 0; ox < output_width; ++ox) {
+        T* dst_ptr =
+            dst_buffer.data() +
+            ((n * output_height + oy) * output_width + ox) * output_channels;
+        for (int ky = 0; ky < filter_height; ++ky) {
+          int iy = oy * window_strides[0] - padding[0] + ky * dilation[0];
+          if (iy < 0 || iy >= input_height) continue;
+          for (int kx = 0; kx < filter_width; ++kx) {
+            int ix = ox * window_strides[1] - padding[2] + kx * dilation[1];
+            if (ix < 0 || ix >= input_width) continue;
+            const T* input_ptr =
+                input_buffer.data() +
+                ((n * input_height + iy) * input_width + ix) * input_channels;
+            const T* filter_ptr =
+                filter_buffer.data() + (ky * filter_width + kx) *
+                                           group_input_channels *
+                                           output_channels;
+            for (int g = 0; g < feature_group_count; ++g) {
+              for (int ic = 0; ic < group_input_channels; ++ic) {
+                const T value = input_ptr[g * group_input_channels + ic];
+                const T* filter_row = filter_ptr + ic * output_channels +
+                                      g * group_output_channels;
+                T* group_dst_ptr = dst_ptr + g * group_output_channels;
+                for (int oc = 0; oc < group_output_channels; ++oc) {
+                  group_dst_ptr[oc] += value * filter_row[oc];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace impl
+
+template <typename T>
+Status PoolingSum::Execute(absl::Span<const T> src_buffer,
+                           absl::Span<const T> init_buffer,
+                           absl::Span<T> dst_buffer, const Shape& src_shape,
+                           const Shape& dst_shape,
+                           absl::Span<const int32_t> window_dimensions,
+                           absl::Span<const int32_t> window_strides,
+                           absl::Span<const int32_t> padding) {
+  return impl::GenericPooling<T, impl::SumKernel>(
+      src_buffer, init_buffer, dst_buffer, src_shape, dst_shape,
+      window_dimensions, window_strides, padding);
+}
+
+template <typename T>
+Status PoolingMin::Execute(absl::Span<const T> src_buffer,
+                           absl::Span<const T> init_buffer,
+                           absl::Span<T> dst_buffer, const Shape& src_shape,
+                           const Shape& dst_shape,
+                           absl::Span<const int32_t> window_dimensions,
+                           absl::Span<const int32_t> window_strides,
+                           absl::Span<const int32_t> padding) {
+  return impl::GenericPooling<T, impl::MinKernel>(
+      src_buffer, init_buffer, dst_buffer, src_shape, dst_shape,
+      window_dimensions, window_strides, padding);
+}
+
+template <typename T>
+Status PoolingMax::Execute(absl::Span<const T> src_buffer,
+                           absl::Span<const T> init_buffer,
+                           absl::Span<T> dst_buffer, const Shape& src_shape,
+                           const Shape& dst_shape,
+                           absl::Span<const int32_t> window_dimensions,
+                           absl::Span<const int32_t> window_strides,
+                           absl::Span<const int32_t> padding) {
+  return impl::GenericPooling<T, impl::MaxKernel>(
+      src_buffer, init_buffer, dst_buffer, src_shape, dst_shape,
+      window_dimensions, window_strides, padding);
+}
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
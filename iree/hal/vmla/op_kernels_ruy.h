@@ -15,26 +15,109 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 #define IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "tensorflow/lite/experimental/ruy/context.h"
 #include "tensorflow/lite/experimental/ruy/ruy.h"
+#include "tensorflow/lite/experimental/ruy/ruy_advanced.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 namespace kernels {
 
-// TODO(benvanik): something more clever for making this shareable.
-// Maybe a factory fn based on the impl selected?
 struct MatMul::RuntimeState {
-  // TODO(benvanik): share the thread pool but keep context per-fiber?
+  explicit RuntimeState(int max_thread_count)
+      : max_thread_count(max_thread_count) {}
+
+  // Maximum number of threads each worker may use for a single matmul.
+  const int max_thread_count;
+};
+
+inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState(
+    int max_thread_count) {
+  return absl::make_unique<RuntimeState>(std::max(1, max_thread_count));
+}
+
+struct MatMul::WorkerState {
+  // ruy::Context is not thread-safe so each worker has its own. The context
+  // owns the thread pool used by its matmuls and is kept for the lifetime of
+  // the worker so that the pool is not spun up per dispatch.
   ruy::Context context;
 };
 
-inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState() {
-  return absl::make_unique<RuntimeState>();
+inline std::unique_ptr<MatMul::WorkerState> MatMul::CreateWorkerState(
+    const RuntimeState* runtime_state) {
+  auto worker_state = absl::make_unique<WorkerState>();
+  worker_state->context.max_num_threads = runtime_state->max_thread_count;
+  return worker_state;
+}
+
+struct MatMul::PrepackedRhs {
+  // ruy requires packed blocks to be at least this aligned.
+  static constexpr size_t kAlignment = 64;
+
+  // Allocates storage for the packed data that lives as long as this object.
+  void* Allocate(size_t size) {
+    allocations.emplace_back(new uint8_t[size + kAlignment]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(allocations.back().get());
+    return reinterpret_cast<void*>((address + kAlignment - 1) &
+                                   ~(kAlignment - 1));
+  }
+
+  ruy::PrepackedMatrix matrix;
+  std::vector<std::unique_ptr<uint8_t[]>> allocations;
+};
+
+class MatMul::PrepackedRhsCache {
+ public:
+  // Returns the entry for the RHS at |data| with the given row-major shape and
+  // element size or nullptr if it has not been packed.
+  const PrepackedRhs* Lookup(const void* data, int d0, int d1,
+                             size_t element_size) {
+    absl::MutexLock lock(&mutex_);
+    auto it = entries_.find(Key(data, d0, d1, element_size));
+    return it == entries_.end() ? nullptr : it->second.get();
+  }
+
+  // Adds |prepacked_rhs| unless another worker added the same RHS first.
+  // Returns the entry in the cache.
+  const PrepackedRhs* Insert(const void* data, int d0, int d1,
+                             size_t element_size,
+                             std::unique_ptr<PrepackedRhs> prepacked_rhs) {
+    absl::MutexLock lock(&mutex_);
+    auto& entry = entries_[Key(data, d0, d1, element_size)];
+    if (!entry) entry = std::move(prepacked_rhs);
+    return entry.get();
+  }
+
+  // Returns the number of packed entries.
+  size_t size() {
+    absl::MutexLock lock(&mutex_);
+    return entries_.size();
+  }
+
+ private:
+  using Key = std::tuple<const void*, int, int, size_t>;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::unique_ptr<PrepackedRhs>> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+inline std::unique_ptr<MatMul::PrepackedRhsCache>
+MatMul::CreatePrepackedRhsCache() {
+  return absl::make_unique<PrepackedRhsCache>();
 }
 
 template <typename T>
@@ -128,7 +211,7 @@ void MatMul::Transpose2D(int d0, int d1, const T* input_data, T* output_data) {
 }
 
 template <typename T, typename ACC>
-Status MatMul::Execute(RuntimeState* runtime_state,
+Status MatMul::Execute(WorkerState* worker_state,
                        const Buffers<T, ACC>& buffers) {
   // Note that it is important to invoke RUY in RCC mode (LHS=Row Major,
   // RHS=Col Major, Result=Col Major), which necessitates some transposes. This
@@ -146,6 +229,17 @@ Status MatMul::Execute(RuntimeState* runtime_state,
   bool transpose_dst = false;
   T* temp1_buffer = nullptr;
   T* temp2_buffer = nullptr;
+
+  // A constant RHS only needs to be transposed and packed the first time it is
+  // seen; afterward ruy uses the packed data directly.
+  const PrepackedRhs* prepacked_rhs = nullptr;
+  if (buffers.prepacked_rhs_cache) {
+    prepacked_rhs = buffers.prepacked_rhs_cache->Lookup(
+        buffers.rhs_buffer.data(), buffers.rhs_shape[0], buffers.rhs_shape[1],
+        sizeof(T));
+  }
+  bool needs_prepack = buffers.prepacked_rhs_cache && !prepacked_rhs;
+
   {
     // Do (A * B^T)^T
     IREE_TRACE_SCOPE0("MatMul#TransposeRhs");
@@ -156,8 +250,13 @@ Status MatMul::Execute(RuntimeState* runtime_state,
     // B = RHS^T
     b_d0 = buffers.rhs_shape[0];
     b_d1 = buffers.rhs_shape[1];
-    b_data = temp1_buffer = new T[b_d0 * b_d1];
-    Transpose2D(b_d0, b_d1, buffers.rhs_buffer.data(), b_data);
+    if (prepacked_rhs) {
+      // Only the layout is used when multiplying with a packed RHS.
+      b_data = const_cast<T*>(buffers.rhs_buffer.data());
+    } else {
+      b_data = temp1_buffer = new T[b_d0 * b_d1];
+      Transpose2D(b_d0, b_d1, buffers.rhs_buffer.data(), b_data);
+    }
     // R
     transpose_dst = true;
     r_d0 = buffers.dst_shape[0];
@@ -190,8 +289,31 @@ Status MatMul::Execute(RuntimeState* runtime_state,
         buffers.multiplier_exponent_buffer.data();
   }
 
-  ruy::Mul<ruy::kAllPaths>(a_matrix, b_matrix, spec, &runtime_state->context,
-                           &r_matrix);
+  if (needs_prepack) {
+    // Workers racing to pack the same RHS each pack their own copy and all but
+    // the first to be added to the cache are discarded.
+    IREE_TRACE_SCOPE0("MatMul#PrepackRhs");
+    auto new_prepacked_rhs = absl::make_unique<PrepackedRhs>();
+    PrepackedRhs* storage = new_prepacked_rhs.get();
+    ruy::PrePackForMul<ruy::kAllPaths>(
+        a_matrix, b_matrix, spec, &worker_state->context, &r_matrix,
+        /*prepacked_lhs=*/nullptr, &storage->matrix,
+        [storage](size_t size) { return storage->Allocate(size); });
+    prepacked_rhs = buffers.prepacked_rhs_cache->Insert(
+        buffers.rhs_buffer.data(), buffers.rhs_shape[0], buffers.rhs_shape[1],
+        sizeof(T), std::move(new_prepacked_rhs));
+  }
+  if (prepacked_rhs) {
+    // ruy only reads the packed matrix and as such it may be shared by
+    // concurrent workers.
+    ruy::MulWithPrepacked<ruy::kAllPaths>(
+        a_matrix, b_matrix, spec, &worker_state->context, &r_matrix,
+        /*prepacked_lhs=*/nullptr,
+        const_cast<ruy::PrepackedMatrix*>(&prepacked_rhs->matrix));
+  } else {
+    ruy::Mul<ruy::kAllPaths>(a_matrix, b_matrix, spec, &worker_state->context,
+                             &r_matrix);
+  }
 
   if (transpose_dst) {
     IREE_TRACE_SCOPE0("MatMul#TransposeDst");
@@ -205,6 +327,109 @@ Status MatMul::Execute(RuntimeState* runtime_state,
   return OkStatus();
 }
 
+template <typename T>
+Status Conv2D::Execute(
+    MatMul::WorkerState* worker_state, absl::Span<const T> input_buffer,
+    const Shape& input_shape, absl::Span<const T> filter_buffer,
+    const Shape& filter_shape, absl::Span<T> dst_buffer,
+    const Shape& dst_shape, absl::Span<const int32_t> window_strides,
+    absl::Span<const int32_t> padding, absl::Span<const int32_t> dilation,
+    int32_t feature_group_count,
+    MatMul::PrepackedRhsCache* prepacked_filter_cache) {
+  if (input_shape.size() != 4 || filter_shape.size() != 4 ||
+      dst_shape.size() != 4 || window_strides.size() != 2 ||
+      padding.size() != 4 || dilation.size() != 2) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Only 2D convolutions are supported";
+  } else if (feature_group_count < 1 ||
+             input_shape[3] != filter_shape[2] * feature_group_count ||
+             filter_shape[3] % feature_group_count != 0) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Filter shape " << filter_shape
+           << " does not match input shape " << input_shape << " with "
+           << feature_group_count << " feature groups";
+  }
+
+  if (feature_group_count != 1) {
+    IREE_TRACE_SCOPE0("Conv2D#Direct");
+    return impl::Conv2DDirect(input_buffer, input_shape, filter_buffer,
+                              filter_shape, dst_buffer, dst_shape,
+                              window_strides, padding, dilation,
+                              feature_group_count);
+  }
+
+  // The HWIO filter is a row-major [filter_height * filter_width *
+  // input_channels, output_channels] matrix and the NHWC result is a row-major
+  // [output_height * output_width, output_channels] matrix per batch, so the
+  // convolution is a matmul of the filter with the input patches of each
+  // output pixel (im2col).
+  const int batch_size = input_shape[0];
+  const int input_height = input_shape[1];
+  const int input_width = input_shape[2];
+  const int input_channels = input_shape[3];
+  const int filter_height = filter_shape[0];
+  const int filter_width = filter_shape[1];
+  const int output_channels = filter_shape[3];
+  const int output_height = dst_shape[1];
+  const int output_width = dst_shape[2];
+  const int patch_size = filter_height * filter_width * input_channels;
+  const int output_pixels = output_height * output_width;
+
+  MatMul::Buffers<T, T> buffers;
+  buffers.rhs_shape = Shape({patch_size, output_channels});
+  buffers.rhs_buffer = filter_buffer;
+  buffers.prepacked_rhs_cache = prepacked_filter_cache;
+
+  // Pointwise convolutions need no patches as every input pixel already is one.
+  bool is_pointwise = filter_height == 1 && filter_width == 1 &&
+                      window_strides[0] == 1 && window_strides[1] == 1 &&
+                      padding[0] == 0 && padding[1] == 0 && padding[2] == 0 &&
+                      padding[3] == 0;
+  if (is_pointwise) {
+    buffers.lhs_shape = Shape({batch_size * output_pixels, patch_size});
+    buffers.lhs_buffer = input_buffer;
+    buffers.dst_shape = Shape({batch_size * output_pixels, output_channels});
+    buffers.dst_buffer = dst_buffer;
+    return MatMul::Execute(worker_state, buffers);
+  }
+
+  std::vector<T> patches(static_cast<size_t>(output_pixels) * patch_size);
+  buffers.lhs_shape = Shape({output_pixels, patch_size});
+  buffers.lhs_buffer = absl::MakeConstSpan(patches);
+  buffers.dst_shape = Shape({output_pixels, output_channels});
+  for (int n = 0; n < batch_size; ++n) {
+    {
+      IREE_TRACE_SCOPE0("Conv2D#Im2Col");
+      T* patch_ptr = patches.data();
+      for (int oy = 0; oy < output_height; ++oy) {
+        for (int ox = 0; ox < output_width; ++ox) {
+          for (int ky = 0; ky < filter_height; ++ky) {
+            int iy = oy * window_strides[0] - padding[0] + ky * dilation[0];
+            for (int kx = 0; kx < filter_width; ++kx) {
+              int ix = ox * window_strides[1] - padding[2] + kx * dilation[1];
+              if (iy < 0 || iy >= input_height || ix < 0 ||
+                  ix >= input_width) {
+                std::fill_n(patch_ptr, input_channels, T{0});
+              } else {
+                std::copy_n(input_buffer.data() +
+                                ((n * input_height + iy) * input_width + ix) *
+                                    input_channels,
+                            input_channels, patch_ptr);
+              }
+              patch_ptr += input_channels;
+            }
+          }
+        }
+      }
+    }
+    buffers.dst_buffer = dst_buffer.subspan(
+        static_cast<size_t>(n) * output_pixels * output_channels,
+        static_cast<size_t>(output_pixels) * output_channels);
+    RETURN_IF_ERROR(MatMul::Execute(worker_state, buffers));
+  }
+  return OkStatus();
+}
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
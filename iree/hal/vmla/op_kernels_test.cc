@@ -14,6 +14,9 @@
 
 #include "iree/hal/vmla/op_kernels.h"
 
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "iree/base/memory.h"
 #include "iree/base/status_matchers.h"
 #include "iree/testing/gtest.h"
@@ -365,6 +368,62 @@ TEST(Pad, HighRank) {
   EXPECT_EQ(dst_buffer, expected_dst);
 }
 
+TEST(Transpose, 2D) {
+  Shape src_shape = {2, 3};
+  std::vector<int32_t> perm = {1, 0};
+  std::vector<uint32_t> src_buffer = MakeIota<uint32_t>(6);
+  std::vector<uint32_t> dst_buffer(6, 0);
+  std::vector<uint32_t> expected_dst = {1, 4, 2, 5, 3, 6};
+
+  EXPECT_OK(Transpose::Execute<uint32_t>(src_buffer, absl::MakeSpan(dst_buffer),
+                                         src_shape, perm));
+  EXPECT_EQ(dst_buffer, expected_dst);
+}
+
+TEST(Transpose, UnitDims) {
+  Shape src_shape = {1, 4, 1};
+  std::vector<int32_t> perm = {2, 1, 0};
+  std::vector<uint8_t> src_buffer = MakeIota<uint8_t>(4);
+  std::vector<uint8_t> dst_buffer(4, 0);
+
+  EXPECT_OK(Transpose::Execute<uint8_t>(src_buffer, absl::MakeSpan(dst_buffer),
+                                        src_shape, perm));
+  EXPECT_EQ(dst_buffer, src_buffer);
+}
+
+// Compares the tiled transpose against the reference implementation for
+// shapes exercising partial tiles, dimension merging, and contiguous rows.
+template <typename T>
+void TestTransposeMatchesGeneric(Shape src_shape, std::vector<int32_t> perm) {
+  std::vector<T> src_buffer = MakeIota<T>(src_shape.element_count());
+  std::vector<T> dst_buffer(src_buffer.size(), 0);
+  std::vector<T> expected_dst(src_buffer.size(), 0);
+  impl::TransposeGeneric<T>(src_buffer, absl::MakeSpan(expected_dst),
+                            src_shape, perm);
+  EXPECT_OK(Transpose::Execute<T>(src_buffer, absl::MakeSpan(dst_buffer),
+                                  src_shape, perm));
+  EXPECT_EQ(dst_buffer, expected_dst);
+}
+
+template <typename T>
+void TestTransposeShapes() {
+  TestTransposeMatchesGeneric<T>({67, 131}, {1, 0});
+  TestTransposeMatchesGeneric<T>({64, 64}, {1, 0});
+  TestTransposeMatchesGeneric<T>({3, 35, 17}, {0, 2, 1});
+  TestTransposeMatchesGeneric<T>({3, 35, 17}, {2, 0, 1});
+  TestTransposeMatchesGeneric<T>({3, 35, 17}, {1, 0, 2});
+  TestTransposeMatchesGeneric<T>({2, 9, 5, 33}, {0, 2, 1, 3});
+  TestTransposeMatchesGeneric<T>({2, 9, 5, 33}, {0, 2, 3, 1});
+  TestTransposeMatchesGeneric<T>({2, 9, 5, 33}, {2, 3, 0, 1});
+  TestTransposeMatchesGeneric<T>({2, 9, 5, 33}, {3, 2, 1, 0});
+  TestTransposeMatchesGeneric<T>({2, 3, 4, 5, 6}, {4, 2, 0, 3, 1});
+  TestTransposeMatchesGeneric<T>({2, 1, 4, 1, 6}, {4, 3, 2, 1, 0});
+}
+
+TEST(Transpose, MatchesGeneric8) { TestTransposeShapes<uint8_t>(); }
+TEST(Transpose, MatchesGeneric16) { TestTransposeShapes<uint16_t>(); }
+TEST(Transpose, MatchesGeneric32) { TestTransposeShapes<uint32_t>(); }
+
 TEST(ReduceSum, Scalar) {
   Shape src_shape = {5};
   int32_t dimension = 0;
@@ -401,6 +460,325 @@ TEST(ReduceMin, TwoDimensionsToOne) {
   }
 }
 
+TEST(MatMul, Simple) {
+  auto runtime_state = MatMul::CreateRuntimeState();
+  auto worker_state = MatMul::CreateWorkerState(runtime_state.get());
+  Shape lhs_shape = {2, 3};
+  Shape rhs_shape = {3, 2};
+  Shape dst_shape = {2, 2};
+  std::vector<float> lhs_buffer = MakeIota<float>(lhs_shape.element_count());
+  std::vector<float> rhs_buffer = MakeIota<float>(rhs_shape.element_count());
+  std::vector<float> dst_buffer(dst_shape.element_count(), 0.0f);
+  std::vector<float> expected_dst = {22.0f, 28.0f, 49.0f, 64.0f};
+
+  MatMul::Buffers<float, float> buffers;
+  buffers.lhs_shape = lhs_shape;
+  buffers.lhs_buffer = lhs_buffer;
+  buffers.rhs_shape = rhs_shape;
+  buffers.rhs_buffer = rhs_buffer;
+  buffers.dst_shape = dst_shape;
+  buffers.dst_buffer = absl::MakeSpan(dst_buffer);
+  EXPECT_OK(MatMul::Execute(worker_state.get(), buffers));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+}
+
+TEST(MatMul, PrepackedRhs) {
+  auto runtime_state = MatMul::CreateRuntimeState(/*max_thread_count=*/2);
+  auto worker_state = MatMul::CreateWorkerState(runtime_state.get());
+  auto prepacked_rhs_cache = MatMul::CreatePrepackedRhsCache();
+  Shape lhs_shape = {2, 3};
+  Shape rhs_shape = {3, 2};
+  Shape dst_shape = {2, 2};
+  std::vector<float> lhs_buffer = MakeIota<float>(lhs_shape.element_count());
+  std::vector<float> rhs_buffer = MakeIota<float>(rhs_shape.element_count());
+  std::vector<float> dst_buffer(dst_shape.element_count(), 0.0f);
+  std::vector<float> expected_dst = {22.0f, 28.0f, 49.0f, 64.0f};
+
+  MatMul::Buffers<float, float> buffers;
+  buffers.lhs_shape = lhs_shape;
+  buffers.lhs_buffer = lhs_buffer;
+  buffers.rhs_shape = rhs_shape;
+  buffers.rhs_buffer = rhs_buffer;
+  buffers.dst_shape = dst_shape;
+  buffers.dst_buffer = absl::MakeSpan(dst_buffer);
+  buffers.prepacked_rhs_cache = prepacked_rhs_cache.get();
+  EXPECT_OK(MatMul::Execute(worker_state.get(), buffers));
+  ASSERT_EQ(1, prepacked_rhs_cache->size());
+  const auto* first_prepacked_rhs =
+      prepacked_rhs_cache->Lookup(rhs_buffer.data(), 3, 2, sizeof(float));
+  ASSERT_NE(nullptr, first_prepacked_rhs);
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+
+  // The RHS is constant so subsequent calls reuse the packed data.
+  std::fill(dst_buffer.begin(), dst_buffer.end(), 0.0f);
+  EXPECT_OK(MatMul::Execute(worker_state.get(), buffers));
+  EXPECT_EQ(1, prepacked_rhs_cache->size());
+  EXPECT_EQ(first_prepacked_rhs, prepacked_rhs_cache->Lookup(
+                                     rhs_buffer.data(), 3, 2, sizeof(float)));
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+
+  // The same data used with a different shape is packed separately.
+  Shape new_rhs_shape = {3, 1};
+  Shape new_dst_shape = {2, 1};
+  std::vector<float> new_dst_buffer(new_dst_shape.element_count(), 0.0f);
+  std::vector<float> new_expected_dst = {14.0f, 32.0f};
+  buffers.rhs_shape = new_rhs_shape;
+  buffers.rhs_buffer = absl::MakeConstSpan(rhs_buffer.data(), 3);
+  buffers.dst_shape = new_dst_shape;
+  buffers.dst_buffer = absl::MakeSpan(new_dst_buffer);
+  EXPECT_OK(MatMul::Execute(worker_state.get(), buffers));
+  EXPECT_EQ(2, prepacked_rhs_cache->size());
+  EXPECT_NE(nullptr, prepacked_rhs_cache->Lookup(rhs_buffer.data(), 3, 1,
+                                                 sizeof(float)));
+  for (int i = 0; i < new_dst_buffer.size(); ++i) {
+    EXPECT_NEAR(new_expected_dst[i], new_dst_buffer[i], kEpsilon);
+  }
+}
+
+// Workers with their own state must be able to multiply concurrently while
+// sharing the packed RHS cache.
+TEST(MatMul, ConcurrentWorkers) {
+  constexpr int kWorkerCount = 4;
+  constexpr int kIterationCount = 16;
+  auto runtime_state = MatMul::CreateRuntimeState(/*max_thread_count=*/2);
+  auto prepacked_rhs_cache = MatMul::CreatePrepackedRhsCache();
+  Shape lhs_shape = {2, 3};
+  Shape rhs_shape = {3, 2};
+  Shape dst_shape = {2, 2};
+  std::vector<float> lhs_buffer = MakeIota<float>(lhs_shape.element_count());
+  std::vector<float> rhs_buffer = MakeIota<float>(rhs_shape.element_count());
+  std::vector<float> expected_dst = {22.0f, 28.0f, 49.0f, 64.0f};
+
+  std::vector<std::vector<float>> dst_buffers(
+      kWorkerCount, std::vector<float>(dst_shape.element_count()));
+  std::vector<Status> statuses(kWorkerCount);
+  std::vector<std::thread> threads;
+  for (int worker = 0; worker < kWorkerCount; ++worker) {
+    threads.emplace_back([&, worker]() {
+      auto worker_state = MatMul::CreateWorkerState(runtime_state.get());
+      MatMul::Buffers<float, float> buffers;
+      buffers.lhs_shape = lhs_shape;
+      buffers.lhs_buffer = lhs_buffer;
+      buffers.rhs_shape = rhs_shape;
+      buffers.rhs_buffer = rhs_buffer;
+      buffers.dst_shape = dst_shape;
+      buffers.dst_buffer = absl::MakeSpan(dst_buffers[worker]);
+      // Alternate between packed and unpacked RHS to exercise both paths.
+      for (int i = 0; i < kIterationCount && statuses[worker].ok(); ++i) {
+        buffers.prepacked_rhs_cache =
+            i % 2 == 0 ? prepacked_rhs_cache.get() : nullptr;
+        statuses[worker] = MatMul::Execute(worker_state.get(), buffers);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int worker = 0; worker < kWorkerCount; ++worker) {
+    EXPECT_OK(statuses[worker]);
+    for (int i = 0; i < expected_dst.size(); ++i) {
+      EXPECT_NEAR(expected_dst[i], dst_buffers[worker][i], kEpsilon);
+    }
+  }
+  EXPECT_EQ(1, prepacked_rhs_cache->size());
+}
+
+// Reference NHWC/HWIO convolution computed one output element at a time.
+std::vector<float> ReferenceConv2D(const std::vector<float>& input,
+                                   const Shape& input_shape,
+                                   const std::vector<float>& filter,
+                                   const Shape& filter_shape,
+                                   const Shape& dst_shape,
+                                   absl::Span<const int32_t> strides,
+                                   absl::Span<const int32_t> padding,
+                                   absl::Span<const int32_t> dilation,
+                                   int groups) {
+  std::vector<float> dst(dst_shape.element_count(), 0.0f);
+  int group_in = filter_shape[2];
+  int group_out = filter_shape[3] / groups;
+  for (int n = 0; n < dst_shape[0]; ++n) {
+    for (int oy = 0; oy < dst_shape[1]; ++oy) {
+      for (int ox = 0; ox < dst_shape[2]; ++ox) {
+        for (int oc = 0; oc < dst_shape[3]; ++oc) {
+          int g = oc / group_out;
+          float acc = 0.0f;
+          for (int ky = 0; ky < filter_shape[0]; ++ky) {
+            for (int kx = 0; kx < filter_shape[1]; ++kx) {
+              int iy = oy * strides[0] - padding[0] + ky * dilation[0];
+              int ix = ox * strides[1] - padding[2] + kx * dilation[1];
+              if (iy < 0 || iy >= input_shape[1] || ix < 0 ||
+                  ix >= input_shape[2]) {
+                continue;
+              }
+              for (int ic = 0; ic < group_in; ++ic) {
+                acc += input[((n * input_shape[1] + iy) * input_shape[2] + ix) *
+                                 input_shape[3] +
+                             g * group_in + ic] *
+                       filter[((ky * filter_shape[1] + kx) * group_in + ic) *
+                                  filter_shape[3] +
+                              oc];
+              }
+            }
+          }
+          dst[((n * dst_shape[1] + oy) * dst_shape[2] + ox) * dst_shape[3] +
+              oc] = acc;
+        }
+      }
+    }
+  }
+  return dst;
+}
+
+void TestConv2D(const Shape& input_shape, const Shape& filter_shape,
+                const Shape& dst_shape, std::vector<int32_t> strides,
+                std::vector<int32_t> padding, std::vector<int32_t> dilation,
+                int groups) {
+  auto runtime_state = MatMul::CreateRuntimeState();
+  auto worker_state = MatMul::CreateWorkerState(runtime_state.get());
+  auto prepacked_filter_cache = MatMul::CreatePrepackedRhsCache();
+  std::vector<float> input = MakeIota<float>(input_shape.element_count());
+  std::vector<float> filter = MakeIota<float>(filter_shape.element_count());
+  for (auto& value : filter) value = value * 0.25f - 3.0f;
+  std::vector<float> dst(dst_shape.element_count(), -1.0f);
+  EXPECT_OK(Conv2D::Execute<float>(
+      worker_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(dst), dst_shape, strides, padding, dilation, groups,
+      prepacked_filter_cache.get()));
+  auto expected_dst = ReferenceConv2D(input, input_shape, filter, filter_shape,
+                                      dst_shape, strides, padding, dilation,
+                                      groups);
+  for (int i = 0; i < dst.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst[i], std::abs(expected_dst[i]) * 1e-5f)
+        << "at " << i;
+  }
+}
+
+TEST(Conv2D, Valid) {
+  TestConv2D({2, 5, 6, 3}, {3, 3, 3, 4}, {2, 3, 4, 4}, {1, 1}, {0, 0, 0, 0},
+             {1, 1}, 1);
+}
+
+TEST(Conv2D, PaddedStrided) {
+  TestConv2D({1, 7, 7, 2}, {3, 3, 2, 5}, {1, 4, 4, 5}, {2, 2}, {1, 1, 1, 1},
+             {1, 1}, 1);
+}
+
+TEST(Conv2D, Dilated) {
+  TestConv2D({1, 7, 8, 2}, {2, 3, 2, 3}, {1, 5, 4, 3}, {1, 1}, {0, 0, 0, 0},
+             {2, 2}, 1);
+}
+
+TEST(Conv2D, Pointwise) {
+  TestConv2D({2, 3, 4, 5}, {1, 1, 5, 6}, {2, 3, 4, 6}, {1, 1}, {0, 0, 0, 0},
+             {1, 1}, 1);
+}
+
+TEST(Conv2D, Depthwise) {
+  TestConv2D({1, 5, 5, 4}, {3, 3, 1, 8}, {1, 5, 5, 8}, {1, 1}, {1, 1, 1, 1},
+             {1, 1}, 4);
+}
+
+TEST(Conv2D, Grouped) {
+  TestConv2D({1, 4, 4, 6}, {2, 2, 3, 4}, {1, 3, 3, 4}, {1, 1}, {0, 0, 0, 0},
+             {1, 1}, 2);
+}
+
+TEST(Conv2D, MismatchedChannels) {
+  auto runtime_state = MatMul::CreateRuntimeState();
+  auto worker_state = MatMul::CreateWorkerState(runtime_state.get());
+  Shape input_shape = {1, 2, 2, 3};
+  Shape filter_shape = {1, 1, 2, 1};
+  Shape dst_shape = {1, 2, 2, 1};
+  std::vector<float> input(input_shape.element_count());
+  std::vector<float> filter(filter_shape.element_count());
+  std::vector<float> dst(dst_shape.element_count());
+  std::vector<int32_t> strides = {1, 1};
+  std::vector<int32_t> padding = {0, 0, 0, 0};
+  EXPECT_TRUE(IsInvalidArgument(Conv2D::Execute<float>(
+      worker_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(dst), dst_shape, strides, padding, strides, 1,
+      /*prepacked_filter_cache=*/nullptr)));
+}
+
+TEST(PoolingMax, PaddedNHWC) {
+  Shape src_shape = {1, 3, 3, 2};
+  Shape dst_shape = {1, 2, 2, 2};
+  std::vector<float> src_buffer = MakeIota<float>(src_shape.element_count());
+  std::vector<float> init_buffer = {std::numeric_limits<float>::lowest()};
+  std::vector<float> dst_buffer(dst_shape.element_count(), 0.0f);
+  std::vector<int32_t> window_dimensions = {1, 2, 2, 1};
+  std::vector<int32_t> window_strides = {1, 2, 2, 1};
+  std::vector<int32_t> padding = {0, 0, 0, 1, 0, 1, 0, 0};
+  std::vector<float> expected_dst = {9.0f,  10.0f, 11.0f, 12.0f,
+                                     15.0f, 16.0f, 17.0f, 18.0f};
+
+  EXPECT_OK(PoolingMax::Execute<float>(
+      src_buffer, init_buffer, absl::MakeSpan(dst_buffer), src_shape,
+      dst_shape, window_dimensions, window_strides, padding));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+}
+
+TEST(PoolingSum, Overlapping) {
+  Shape src_shape = {4};
+  Shape dst_shape = {3};
+  auto src_buffer = MakeIota<int32_t>(src_shape.element_count());
+  std::vector<int32_t> init_buffer = {100};
+  std::vector<int32_t> dst_buffer(dst_shape.element_count(), 0);
+  std::vector<int32_t> window_dimensions = {2};
+  std::vector<int32_t> window_strides = {1};
+  std::vector<int32_t> padding = {0, 0};
+  std::vector<int32_t> expected_dst = {103, 105, 107};
+
+  EXPECT_OK(PoolingSum::Execute<int32_t>(
+      src_buffer, init_buffer, absl::MakeSpan(dst_buffer), src_shape,
+      dst_shape, window_dimensions, window_strides, padding));
+  EXPECT_EQ(expected_dst, dst_buffer);
+}
+
+TEST(PoolingMin, Padded) {
+  Shape src_shape = {2, 2};
+  Shape dst_shape = {3, 3};
+  auto src_buffer = MakeIota<int32_t>(src_shape.element_count());
+  std::vector<int32_t> init_buffer = {std::numeric_limits<int32_t>::max()};
+  std::vector<int32_t> dst_buffer(dst_shape.element_count(), 0);
+  std::vector<int32_t> window_dimensions = {2, 2};
+  std::vector<int32_t> window_strides = {1, 1};
+  std::vector<int32_t> padding = {1, 1, 1, 1};
+  std::vector<int32_t> expected_dst = {1, 1, 2, 1, 1, 2, 3, 3, 4};
+
+  EXPECT_OK(PoolingMin::Execute<int32_t>(
+      src_buffer, init_buffer, absl::MakeSpan(dst_buffer), src_shape,
+      dst_shape, window_dimensions, window_strides, padding));
+  EXPECT_EQ(expected_dst, dst_buffer);
+}
+
+TEST(PoolingSum, PaddingUsesInitValue) {
+  Shape src_shape = {2, 2};
+  Shape dst_shape = {2, 2};
+  auto src_buffer = MakeIota<int32_t>(src_shape.element_count());
+  std::vector<int32_t> init_buffer = {1};
+  std::vector<int32_t> dst_buffer(dst_shape.element_count(), 0);
+  std::vector<int32_t> window_dimensions = {2, 2};
+  std::vector<int32_t> window_strides = {1, 1};
+  std::vector<int32_t> padding = {1, 0, 1, 0};
+  // The init value is added once initially and once per padded element.
+  std::vector<int32_t> expected_dst = {5, 6, 7, 11};
+
+  EXPECT_OK(PoolingSum::Execute<int32_t>(
+      src_buffer, init_buffer, absl::MakeSpan(dst_buffer), src_shape,
+      dst_shape, window_dimensions, window_strides, padding));
+  EXPECT_EQ(expected_dst, dst_buffer);
+}
+
 }  // namespace
 }  // namespace kernels
 }  // namespace vmla
@@ -30,17 +30,16 @@ namespace vmla {
 namespace {
 
 Status MarshalIO(Interface* interface,
-                 const DispatchRequest& dispatch_request) {
+                 absl::Span<const BufferBinding> bindings) {
   IREE_TRACE_SCOPE0("VMLACommandProcessor::MarshalIO");
-  if (dispatch_request.bindings.size() >= Interface::kMaxBindings) {
+  if (bindings.size() >= Interface::kMaxBindings) {
     return OutOfRangeErrorBuilder(IREE_LOC)
-           << "Too many bindings requested; wanted "
-           << dispatch_request.bindings.size() << " but have a maximum of "
-           << Interface::kMaxBindings;
+           << "Too many bindings requested; wanted " << bindings.size()
+           << " but have a maximum of " << Interface::kMaxBindings;
   }
 
-  for (int i = 0; i < dispatch_request.bindings.size(); ++i) {
-    const auto& binding = dispatch_request.bindings[i];
+  for (int i = 0; i < bindings.size(); ++i) {
+    const auto& binding = bindings[i];
     void* data = static_cast<HostBuffer*>(binding.buffer->allocated_buffer())
                      ->mutable_data();
     data = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(data) +
@@ -58,11 +57,85 @@ Status MarshalIO(Interface* interface,
 
 VMLACommandProcessor::VMLACommandProcessor(
     Allocator* allocator, CommandBufferModeBitfield mode,
-    CommandCategoryBitfield command_categories)
-    : HostLocalCommandProcessor(allocator, mode, command_categories) {}
+    CommandCategoryBitfield command_categories,
+    WorkStealingThreadPool* thread_pool)
+    : HostLocalCommandProcessor(allocator, mode, command_categories),
+      thread_pool_(thread_pool) {}
 
 VMLACommandProcessor::~VMLACommandProcessor() = default;
 
+Status VMLACommandProcessor::End() {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::End();
+}
+
+Status VMLACommandProcessor::ExecutionBarrier(
+    ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::ExecutionBarrier(
+      source_stage_mask, target_stage_mask, memory_barriers, buffer_barriers);
+}
+
+Status VMLACommandProcessor::SignalEvent(
+    Event* event, ExecutionStageBitfield source_stage_mask) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::SignalEvent(event, source_stage_mask);
+}
+
+Status VMLACommandProcessor::ResetEvent(
+    Event* event, ExecutionStageBitfield source_stage_mask) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::ResetEvent(event, source_stage_mask);
+}
+
+Status VMLACommandProcessor::WaitEvents(
+    absl::Span<Event*> events, ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::WaitEvents(
+      events, source_stage_mask, target_stage_mask, memory_barriers,
+      buffer_barriers);
+}
+
+// NOTE: transfer commands are executed inline and may touch buffers used by
+// pending dispatches. We conservatively flush before each of them so that the
+// recorded order is preserved even without explicit barriers.
+
+Status VMLACommandProcessor::FillBuffer(hal::Buffer* target_buffer,
+                                        device_size_t target_offset,
+                                        device_size_t length,
+                                        const void* pattern,
+                                        size_t pattern_length) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::FillBuffer(target_buffer, target_offset,
+                                               length, pattern, pattern_length);
+}
+
+Status VMLACommandProcessor::UpdateBuffer(const void* source_buffer,
+                                          device_size_t source_offset,
+                                          hal::Buffer* target_buffer,
+                                          device_size_t target_offset,
+                                          device_size_t length) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::UpdateBuffer(
+      source_buffer, source_offset, target_buffer, target_offset, length);
+}
+
+Status VMLACommandProcessor::CopyBuffer(hal::Buffer* source_buffer,
+                                        device_size_t source_offset,
+                                        hal::Buffer* target_buffer,
+                                        device_size_t target_offset,
+                                        device_size_t length) {
+  RETURN_IF_ERROR(FlushDispatches());
+  return HostLocalCommandProcessor::CopyBuffer(
+      source_buffer, source_offset, target_buffer, target_offset, length);
+}
+
 Status VMLACommandProcessor::Dispatch(const DispatchRequest& dispatch_request) {
   IREE_TRACE_SCOPE0("VMLACommandProcessor::Dispatch");
 
@@ -72,14 +145,46 @@ Status VMLACommandProcessor::Dispatch(const DispatchRequest& dispatch_request) {
            << "Invalid entry point ordinal " << dispatch_request.entry_point;
   }
 
-  RETURN_IF_ERROR(MarshalIO(executable->interface(), dispatch_request));
-  return FromApiStatus(
-      iree_vm_invoke(
-          executable->context(),
-          executable->entry_functions()[dispatch_request.entry_point],
-          /*policy=*/nullptr, executable->interface_inputs(),
-          /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM),
-      IREE_LOC);
+  PendingDispatch dispatch;
+  dispatch.executable = dispatch_request.executable;
+  dispatch.entry_point = dispatch_request.entry_point;
+  dispatch.bindings = {dispatch_request.bindings.begin(),
+                       dispatch_request.bindings.end()};
+  if (!thread_pool_) {
+    // No concurrency available so there's no reason to defer.
+    return ExecuteDispatch(dispatch);
+  }
+  pending_dispatches_.push_back(std::move(dispatch));
+  return OkStatus();
+}
+
+// static
+Status VMLACommandProcessor::ExecuteDispatch(const PendingDispatch& dispatch) {
+  IREE_TRACE_SCOPE0("VMLACommandProcessor::ExecuteDispatch");
+  auto* executable = static_cast<VMLAExecutable*>(dispatch.executable);
+  ASSIGN_OR_RETURN(auto* state, executable->AcquireInvocationState());
+  auto status = MarshalIO(state->interface, dispatch.bindings);
+  if (status.ok()) {
+    status = FromApiStatus(
+        iree_vm_invoke(state->context,
+                       executable->entry_functions()[dispatch.entry_point],
+                       /*policy=*/nullptr, state->interface_inputs,
+                       /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM),
+        IREE_LOC);
+  }
+  executable->ReleaseInvocationState(state);
+  return status;
+}
+
+Status VMLACommandProcessor::FlushDispatches() {
+  if (pending_dispatches_.empty()) return OkStatus();
+  IREE_TRACE_SCOPE0("VMLACommandProcessor::FlushDispatches");
+  auto status = thread_pool_->ParallelFor(
+      pending_dispatches_.size(), [this](int index) {
+        return ExecuteDispatch(pending_dispatches_[index]);
+      });
+  pending_dispatches_.clear();
+  return status;
 }
 
 }  // namespace vmla
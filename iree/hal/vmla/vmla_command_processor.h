@@ -15,19 +15,85 @@
 #ifndef IREE_HAL_VMLA_VMLA_COMMAND_PROCESSOR_H_
 #define IREE_HAL_VMLA_VMLA_COMMAND_PROCESSOR_H_
 
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
 #include "iree/hal/host/host_local_command_processor.h"
+#include "iree/hal/host/work_stealing_thread_pool.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 
+// Command processor that executes VMLA dispatches.
+//
+// Dispatches recorded between execution barriers have no ordering guarantees
+// relative to each other and are batched up until the next barrier (or any
+// other command that may observe their results) at which point the batch is
+// executed across the provided |thread_pool|. Each concurrently executing
+// dispatch uses its own executable invocation state and Interface bindings.
+//
+// If no |thread_pool| is provided all dispatches execute inline on the calling
+// thread in the order they were recorded.
 class VMLACommandProcessor final : public HostLocalCommandProcessor {
  public:
   VMLACommandProcessor(Allocator* allocator, CommandBufferModeBitfield mode,
-                       CommandCategoryBitfield command_categories);
+                       CommandCategoryBitfield command_categories,
+                       WorkStealingThreadPool* thread_pool);
   ~VMLACommandProcessor() override;
 
+  Status End() override;
+
+  Status ExecutionBarrier(
+      ExecutionStageBitfield source_stage_mask,
+      ExecutionStageBitfield target_stage_mask,
+      absl::Span<const MemoryBarrier> memory_barriers,
+      absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status SignalEvent(Event* event,
+                     ExecutionStageBitfield source_stage_mask) override;
+
+  Status ResetEvent(Event* event,
+                    ExecutionStageBitfield source_stage_mask) override;
+
+  Status WaitEvents(absl::Span<Event*> events,
+                    ExecutionStageBitfield source_stage_mask,
+                    ExecutionStageBitfield target_stage_mask,
+                    absl::Span<const MemoryBarrier> memory_barriers,
+                    absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status FillBuffer(Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length, const void* pattern,
+                    size_t pattern_length) override;
+
+  Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
+                      Buffer* target_buffer, device_size_t target_offset,
+                      device_size_t length) override;
+
+  Status CopyBuffer(Buffer* source_buffer, device_size_t source_offset,
+                    Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length) override;
+
   Status Dispatch(const DispatchRequest& dispatch_request) override;
+
+ private:
+  // A dispatch that has been recorded but not yet executed.
+  // The bindings are copied as the request storage is only valid for the
+  // duration of the Dispatch call.
+  struct PendingDispatch {
+    Executable* executable = nullptr;
+    int entry_point = 0;
+    absl::InlinedVector<BufferBinding, 8> bindings;
+  };
+
+  // Executes a single dispatch on the calling thread.
+  static Status ExecuteDispatch(const PendingDispatch& dispatch);
+
+  // Executes all pending dispatches and waits for them to complete.
+  Status FlushDispatches();
+
+  WorkStealingThreadPool* thread_pool_ = nullptr;
+  std::vector<PendingDispatch> pending_dispatches_;
 };
 
 }  // namespace vmla
@@ -14,9 +14,11 @@
 
 #include "iree/hal/vmla/vmla_device.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/command_buffer_validation.h"
@@ -47,9 +49,11 @@ namespace {
 class UnsynchronizedCommandQueue final : public CommandQueue {
  public:
   UnsynchronizedCommandQueue(Allocator* allocator, std::string name,
-                             CommandCategoryBitfield supported_categories)
+                             CommandCategoryBitfield supported_categories,
+                             WorkStealingThreadPool* thread_pool)
       : CommandQueue(std::move(name), supported_categories),
-        allocator_(allocator) {}
+        allocator_(allocator),
+        thread_pool_(thread_pool) {}
   ~UnsynchronizedCommandQueue() override = default;
 
   Status Submit(absl::Span<const SubmissionBatch> batches,
@@ -86,38 +90,61 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
       VMLACommandProcessor command_processor(allocator_, command_buffer->mode(),
-                                             supported_categories());
+                                             supported_categories(),
+                                             thread_pool_);
       RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
     }
     return OkStatus();
   }
 
   Allocator* const allocator_;
+  WorkStealingThreadPool* const thread_pool_;
 };
 
 }  // namespace
 
 VMLADevice::VMLADevice(DeviceInfo device_info, iree_vm_instance_t* instance,
-                       iree_vm_module_t* vmla_module)
+                       iree_vm_module_t* vmla_module, int worker_count,
+                       int queue_count)
     : Device(std::move(device_info)),
       instance_(instance),
       vmla_module_(vmla_module) {
   iree_vm_instance_retain(instance_);
   iree_vm_module_retain(vmla_module_);
 
-  // We currently only expose a single command queue.
-  auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
-      &allocator_, "cpu0",
-      CommandCategory::kTransfer | CommandCategory::kDispatch);
+  if (worker_count > 0) {
+    thread_pool_ =
+        absl::make_unique<WorkStealingThreadPool>("vmla-worker", worker_count);
+  }
 
-  // TODO(benvanik): allow injection of the wrapper type to support
-  // SyncCommandQueue without always linking in both.
-  auto async_command_queue =
-      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
-  command_queues_.push_back(std::move(async_command_queue));
+  // A single queue keeps its own thread so that submission processing never
+  // competes with dispatch workers; multiple queues share the pool.
+  queue_count = std::max(1, queue_count);
+  bool use_pooled_queues = queue_count > 1 && thread_pool_;
+  for (int i = 0; i < queue_count; ++i) {
+    auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
+        &allocator_, absl::StrCat("cpu", i),
+        CommandCategory::kTransfer | CommandCategory::kDispatch,
+        thread_pool_.get());
+
+    // TODO(benvanik): allow injection of the wrapper type to support
+    // SyncCommandQueue without always linking in both.
+    std::unique_ptr<CommandQueue> async_command_queue;
+    if (use_pooled_queues) {
+      async_command_queue = absl::make_unique<AsyncCommandQueue>(
+          std::move(command_queue), thread_pool_.get());
+    } else {
+      async_command_queue =
+          absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
+    }
+    command_queues_.push_back(std::move(async_command_queue));
+  }
 }
 
 VMLADevice::~VMLADevice() {
+  // Queues may still be using the thread pool so they must be torn down first.
+  command_queues_.clear();
+  thread_pool_.reset();
   iree_vm_module_release(vmla_module_);
   iree_vm_instance_release(instance_);
 }
@@ -20,6 +20,7 @@
 #include "iree/base/memory.h"
 #include "iree/hal/device.h"
 #include "iree/hal/host/host_local_allocator.h"
+#include "iree/hal/host/work_stealing_thread_pool.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
 
@@ -29,8 +30,15 @@ namespace vmla {
 
 class VMLADevice final : public Device {
  public:
-  explicit VMLADevice(DeviceInfo device_info, iree_vm_instance_t* instance,
-                      iree_vm_module_t* vmla_module);
+  // |worker_count| threads will be used to execute independent dispatches
+  // concurrently; if 0 all dispatches execute inline on the queue thread.
+  //
+  // |queue_count| command queues are exposed. When there is more than one and
+  // a worker pool exists the queues process their submissions on the pool
+  // instead of each having its own thread, allowing independent streams of
+  // work to share the device without blocking each other.
+  VMLADevice(DeviceInfo device_info, iree_vm_instance_t* instance,
+             iree_vm_module_t* vmla_module, int worker_count, int queue_count);
   ~VMLADevice() override;
 
   Allocator* allocator() const override { return &allocator_; }
@@ -66,7 +74,10 @@ class VMLADevice final : public Device {
 
  private:
   mutable HostLocalAllocator allocator_;
-  mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 1> command_queues_;
+
+  // Shared by all command queues; must outlive them.
+  std::unique_ptr<WorkStealingThreadPool> thread_pool_;
+  mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
 
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_module_t* vmla_module_ = nullptr;
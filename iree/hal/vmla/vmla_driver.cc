@@ -19,6 +19,7 @@
 #include "iree/base/api_util.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/device_info.h"
+#include "iree/hal/host/work_stealing_thread_pool.h"
 #include "iree/hal/vmla/vmla_device.h"
 #include "iree/hal/vmla/vmla_module.h"
 #include "iree/vm/module.h"
@@ -43,7 +44,7 @@ DeviceInfo GetDefaultDeviceInfo() {
 }  // namespace
 
 // static
-StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
+StatusOr<ref_ptr<Driver>> VMLADriver::Create(Options options) {
   IREE_TRACE_SCOPE0("VMLADriver::Create");
 
   // NOTE: we could use our own allocator here to hide these from any default
@@ -55,20 +56,14 @@ StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
   // TODO(benvanik): move to instance-based registration.
   RETURN_IF_ERROR(ModuleRegisterTypes()) << "VMLA type registration failed";
 
-  iree_vm_module_t* vmla_module = nullptr;
-  RETURN_IF_ERROR(ModuleCreate(IREE_ALLOCATOR_SYSTEM, &vmla_module))
-      << "VMLA shared module creation failed";
-
-  return make_ref<VMLADriver>(instance, vmla_module);
+  return make_ref<VMLADriver>(std::move(options), instance);
 }
 
-VMLADriver::VMLADriver(iree_vm_instance_t* instance,
-                       iree_vm_module_t* vmla_module)
-    : Driver("vmla"), instance_(instance), vmla_module_(vmla_module) {}
+VMLADriver::VMLADriver(Options options, iree_vm_instance_t* instance)
+    : Driver("vmla"), options_(std::move(options)), instance_(instance) {}
 
 VMLADriver::~VMLADriver() {
   IREE_TRACE_SCOPE0("VMLADriver::dtor");
-  iree_vm_module_release(vmla_module_);
   iree_vm_instance_release(instance_);
 }
 
@@ -83,8 +78,28 @@ StatusOr<ref_ptr<Device>> VMLADriver::CreateDefaultDevice() {
 }
 
 StatusOr<ref_ptr<Device>> VMLADriver::CreateDevice(DriverDeviceID device_id) {
+  int worker_count = options_.worker_count;
+  if (worker_count < 0) {
+    worker_count = WorkStealingThreadPool::DefaultWorkerCount();
+  }
+
+  // Each device gets its own VMLA module such that kernel runtime state (like
+  // the matmul configuration) is shared by all executables on the device.
+  ModuleOptions module_options;
+  module_options.matmul_thread_count = options_.matmul_thread_count;
+  if (module_options.matmul_thread_count < 0) {
+    module_options.matmul_thread_count =
+        WorkStealingThreadPool::DefaultWorkerCount();
+  }
+  iree_vm_module_t* vmla_module = nullptr;
+  RETURN_IF_ERROR(ModuleCreate(std::move(module_options), IREE_ALLOCATOR_SYSTEM,
+                               &vmla_module))
+      << "VMLA device module creation failed";
+
   auto device =
-      make_ref<VMLADevice>(GetDefaultDeviceInfo(), instance_, vmla_module_);
+      make_ref<VMLADevice>(GetDefaultDeviceInfo(), instance_, vmla_module,
+                           worker_count, options_.queue_count);
+  iree_vm_module_release(vmla_module);
   return device;
 }
 
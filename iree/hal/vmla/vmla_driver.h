@@ -25,9 +25,27 @@ namespace vmla {
 
 class VMLADriver final : public Driver {
  public:
-  static StatusOr<ref_ptr<Driver>> Create();
+  struct Options {
+    // Number of worker threads each device uses to execute independent
+    // dispatches concurrently. A value of 0 executes all dispatches inline on
+    // the queue thread and a negative value uses one worker per hardware
+    // thread.
+    int worker_count = -1;
 
-  VMLADriver(iree_vm_instance_t* instance, iree_vm_module_t* vmla_module);
+    // Number of command queues each device exposes. Multiple queues let
+    // independent streams of work (such as separate inference requests) run
+    // concurrently on the worker pool without blocking each other.
+    int queue_count = 1;
+
+    // Maximum number of threads used to execute a single matmul. Each
+    // concurrently executing dispatch uses its own matmul thread pool. A
+    // negative value uses one thread per hardware thread.
+    int matmul_thread_count = 1;
+  };
+
+  static StatusOr<ref_ptr<Driver>> Create(Options options);
+
+  VMLADriver(Options options, iree_vm_instance_t* instance);
   ~VMLADriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -37,8 +55,8 @@ class VMLADriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
 
  private:
+  Options options_;
   iree_vm_instance_t* instance_ = nullptr;
-  iree_vm_module_t* vmla_module_ = nullptr;
 };
 
 }  // namespace vmla
@@ -14,17 +14,34 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
 #include "iree/hal/vmla/vmla_driver.h"
 
+ABSL_FLAG(int, vmla_worker_count, -1,
+          "Number of threads used to execute VMLA dispatches concurrently "
+          "(0 to execute inline, -1 for one per hardware thread).");
+ABSL_FLAG(int, vmla_queue_count, 1,
+          "Number of command queues exposed by each VMLA device; multiple "
+          "queues share the worker pool and run independently.");
+ABSL_FLAG(int, vmla_matmul_thread_count, 1,
+          "Maximum number of threads used by a single VMLA matmul; each "
+          "concurrent dispatch has its own (-1 for one per hardware thread).");
+
 namespace iree {
 namespace hal {
 namespace vmla {
 namespace {
 
-StatusOr<ref_ptr<Driver>> CreateVMLADriver() { return VMLADriver::Create(); }
+StatusOr<ref_ptr<Driver>> CreateVMLADriver() {
+  VMLADriver::Options options;
+  options.worker_count = absl::GetFlag(FLAGS_vmla_worker_count);
+  options.queue_count = absl::GetFlag(FLAGS_vmla_queue_count);
+  options.matmul_thread_count = absl::GetFlag(FLAGS_vmla_matmul_thread_count);
+  return VMLADriver::Create(std::move(options));
+}
 
 }  // namespace
 }  // namespace vmla
@@ -14,6 +14,7 @@
 
 #include "iree/hal/vmla/vmla_executable.h"
 
+#include "absl/memory/memory.h"
 #include "iree/base/api_util.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/vmla/vmla_module.h"
@@ -51,9 +52,20 @@ VMLAExecutable::VMLAExecutable(ExecutableSpec spec, bool allow_aliasing_data)
 
 VMLAExecutable::~VMLAExecutable() {
   IREE_TRACE_SCOPE0("VMLAExecutable::dtor");
-  iree_vm_variant_list_free(interface_inputs_);
-  iree_vm_context_release(context_);
-  context_ = nullptr;
+  {
+    absl::MutexLock lock(&invocation_state_mutex_);
+    DCHECK_EQ(free_invocation_states_.size(), invocation_states_.size())
+        << "Executable destroyed while invocations are in-flight";
+    for (auto& state : invocation_states_) {
+      iree_vm_variant_list_free(state->interface_inputs);
+      iree_vm_context_release(state->context);
+    }
+    invocation_states_.clear();
+    free_invocation_states_.clear();
+  }
+  iree_vm_module_release(bytecode_module_);
+  iree_vm_module_release(vmla_module_);
+  iree_vm_instance_release(instance_);
 }
 
 Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
@@ -77,60 +89,120 @@ Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
   }
 
   // Load bytecode module from the executable spec.
-  iree_vm_module_t* bytecode_module = nullptr;
   RETURN_IF_ERROR(FromApiStatus(
       iree_vm_bytecode_module_create(
           iree_const_byte_span_t{reinterpret_cast<const uint8_t*>(
                                      executable_def->bytecode_module()->data()),
                                  executable_def->bytecode_module()->size()},
-          IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &bytecode_module),
+          IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &bytecode_module_),
       IREE_LOC))
       << "Failed to load executable bytecode module";
 
   entry_functions_.resize(
-      iree_vm_module_signature(bytecode_module).export_function_count);
+      iree_vm_module_signature(bytecode_module_).export_function_count);
   for (int i = 0; i < entry_functions_.size(); ++i) {
     RETURN_IF_ERROR(
         FromApiStatus(iree_vm_module_lookup_function_by_ordinal(
-                          bytecode_module, IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
+                          bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
                           &entry_functions_[i]),
                       IREE_LOC));
   }
 
-  // Create context and initialize shared state. Note that each executable here
-  // has its own context (and thus its own vmla.interface instance).
-  std::array<iree_vm_module_t*, 2> modules = {vmla_module, bytecode_module};
+  // Query the function we'll use to get the Interface block of each context.
+  RETURN_IF_ERROR(FromApiStatus(
+      iree_vm_module_lookup_function_by_name(
+          vmla_module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+          iree_make_cstring_view("interface.current"),
+          &interface_current_function_),
+      IREE_LOC));
+
+  instance_ = instance;
+  iree_vm_instance_retain(instance_);
+  vmla_module_ = vmla_module;
+  iree_vm_module_retain(vmla_module_);
+
+  // Eagerly create a single invocation state so that import resolution
+  // failures are reported at load time instead of on first dispatch.
+  ASSIGN_OR_RETURN(auto state, CreateInvocationState());
+  absl::MutexLock lock(&invocation_state_mutex_);
+  free_invocation_states_.push_back(state.get());
+  invocation_states_.push_back(std::move(state));
+
+  return OkStatus();
+}
+
+StatusOr<std::unique_ptr<VMLAExecutable::InvocationState>>
+VMLAExecutable::CreateInvocationState() {
+  IREE_TRACE_SCOPE0("VMLAExecutable::CreateInvocationState");
+
+  // Create context and initialize shared state. Note that each invocation
+  // state has its own context (and thus its own vmla.interface instance).
+  auto state = absl::make_unique<InvocationState>();
+  std::array<iree_vm_module_t*, 2> modules = {vmla_module_, bytecode_module_};
   auto result = FromApiStatus(iree_vm_context_create_with_modules(
-                                  instance, modules.data(), modules.size(),
-                                  IREE_ALLOCATOR_SYSTEM, &context_),
+                                  instance_, modules.data(), modules.size(),
+                                  IREE_ALLOCATOR_SYSTEM, &state->context),
                               IREE_LOC);
   if (!result.ok()) {
-    result = Annotate(result, "Failed resolving imports for executable module");
+    return Annotate(result, "Failed resolving imports for executable module");
   }
-  iree_vm_module_release(bytecode_module);
-  RETURN_IF_ERROR(result);
 
   // Query the Interface block we'll use to set bindings during invocation.
-  iree_vm_function_t current_function;
-  RETURN_IF_ERROR(FromApiStatus(
-      iree_vm_module_lookup_function_by_name(
-          vmla_module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
-          iree_make_cstring_view("interface.current"), &current_function),
-      IREE_LOC));
-  RETURN_IF_ERROR(FromApiStatus(
-      iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &interface_inputs_),
-      IREE_LOC));
-  RETURN_IF_ERROR(FromApiStatus(
-      iree_vm_invoke(context(), current_function,
-                     /*policy=*/nullptr, /*inputs=*/nullptr,
-                     /*outputs=*/interface_inputs_, IREE_ALLOCATOR_SYSTEM),
-      IREE_LOC));
-  auto* output = iree_vm_variant_list_get(interface_inputs_, 0);
-  interface_ = Interface_deref(&output->ref);
+  auto cleanup = [&state]() {
+    iree_vm_variant_list_free(state->interface_inputs);
+    iree_vm_context_release(state->context);
+  };
+  result = FromApiStatus(
+      iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM,
+                                 &state->interface_inputs),
+      IREE_LOC);
+  if (result.ok()) {
+    result = FromApiStatus(
+        iree_vm_invoke(state->context, interface_current_function_,
+                       /*policy=*/nullptr, /*inputs=*/nullptr,
+                       /*outputs=*/state->interface_inputs,
+                       IREE_ALLOCATOR_SYSTEM),
+        IREE_LOC);
+  }
+  if (!result.ok()) {
+    cleanup();
+    return result;
+  }
+  auto* output = iree_vm_variant_list_get(state->interface_inputs, 0);
+  state->interface = Interface_deref(&output->ref);
+  state->interface->set_prepacked_rhs_cache(prepacked_rhs_cache_.get());
   // NOTE: we reuse the output list as the entry point interface inputs for all
-  // invocations into the executable.
+  // invocations using this state.
 
-  return OkStatus();
+  return state;
+}
+
+StatusOr<VMLAExecutable::InvocationState*>
+VMLAExecutable::AcquireInvocationState() {
+  {
+    absl::MutexLock lock(&invocation_state_mutex_);
+    if (!free_invocation_states_.empty()) {
+      auto* state = free_invocation_states_.back();
+      free_invocation_states_.pop_back();
+      return state;
+    }
+  }
+
+  // All existing states are in use; create a new one outside of the lock as
+  // context creation may be expensive.
+  ASSIGN_OR_RETURN(auto state, CreateInvocationState());
+  auto* state_ptr = state.get();
+  absl::MutexLock lock(&invocation_state_mutex_);
+  invocation_states_.push_back(std::move(state));
+  return state_ptr;
+}
+
+void VMLAExecutable::ReleaseInvocationState(InvocationState* state) {
+  // Drop any buffer references from the last invocation so that they don't
+  // keep memory alive while the state is idle.
+  state->interface->Reset();
+  absl::MutexLock lock(&invocation_state_mutex_);
+  free_invocation_states_.push_back(state);
 }
 
 }  // namespace vmla
@@ -15,14 +15,18 @@
 #ifndef IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 #define IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_spec.h"
+#include "iree/hal/vmla/op_kernels.h"
 #include "iree/vm/context.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
@@ -51,31 +55,59 @@ class VMLAExecutable final : public Executable {
     return spec_.executable_data;
   }
 
-  // VM context containing the loaded executable module.
-  iree_vm_context_t* context() const { return context_; }
-
   // Entry point functions in export order.
   absl::Span<const iree_vm_function_t> entry_functions() const {
     return absl::MakeConstSpan(entry_functions_);
   }
 
-  // ABI vmla.interface binding block.
-  Interface* interface() const { return interface_; }
-
-  // Entry point inputs list of a single vmla.interface.
-  iree_vm_variant_list_t* interface_inputs() const { return interface_inputs_; }
+  // VM state used to invoke entry points.
+  // Each invocation state has its own context (and thus its own vmla.interface
+  // instance) so that multiple dispatches against the same executable may run
+  // concurrently so long as each uses its own state.
+  struct InvocationState {
+    // VM context containing the loaded executable module.
+    iree_vm_context_t* context = nullptr;
+    // ABI vmla.interface binding block.
+    Interface* interface = nullptr;
+    // Entry point inputs list of a single vmla.interface.
+    iree_vm_variant_list_t* interface_inputs = nullptr;
+  };
+
+  // Acquires an invocation state for exclusive use by the caller.
+  // States are pooled and created on demand; the total number of states is
+  // bounded by the maximum number of concurrent invocations.
+  StatusOr<InvocationState*> AcquireInvocationState();
+
+  // Returns an invocation state acquired with AcquireInvocationState.
+  void ReleaseInvocationState(InvocationState* state);
 
  private:
   Status Initialize(iree_vm_instance_t* instance,
                     iree_vm_module_t* vmla_module);
 
+  // Creates a new context and queries its vmla.interface.
+  StatusOr<std::unique_ptr<InvocationState>> CreateInvocationState();
+
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
 
-  iree_vm_context_t* context_ = nullptr;
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* vmla_module_ = nullptr;
+  iree_vm_module_t* bytecode_module_ = nullptr;
   absl::InlinedVector<iree_vm_function_t, 4> entry_functions_;
-  Interface* interface_ = nullptr;
-  iree_vm_variant_list_t* interface_inputs_ = nullptr;
+  iree_vm_function_t interface_current_function_;
+
+  // Packed constant matmul RHS and convolution filter values derived from the
+  // executable rodata. Shared by all invocation states (and thus all workers)
+  // as the rodata is shared by all contexts; it must outlive the contexts.
+  std::unique_ptr<kernels::MatMul::PrepackedRhsCache> prepacked_rhs_cache_ =
+      kernels::MatMul::CreatePrepackedRhsCache();
+
+  absl::Mutex invocation_state_mutex_;
+  std::vector<std::unique_ptr<InvocationState>> invocation_states_
+      ABSL_GUARDED_BY(invocation_state_mutex_);
+  std::vector<InvocationState*> free_invocation_states_
+      ABSL_GUARDED_BY(invocation_state_mutex_);
 };
 
 }  // namespace vmla
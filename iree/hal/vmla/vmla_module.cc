@@ -90,6 +90,15 @@ StatusOr<vm::ref<Buffer>> Buffer::WrapMutable(void* data, size_t data_length,
   return std::move(buffer);
 }
 
+// static
+StatusOr<vm::ref<Buffer>> Buffer::WrapConstant(const void* data,
+                                               size_t data_length,
+                                               iree_allocator_t allocator) {
+  ASSIGN_OR_RETURN(auto buffer, Wrap(data, data_length, allocator));
+  buffer->is_constant_ = true;
+  return std::move(buffer);
+}
+
 Buffer::~Buffer() {
   if (!parent_) {
     iree_allocator_free(allocator_, data_);
@@ -170,7 +179,8 @@ class VMLAModuleState final {
                   kernels::RuntimeState* kernel_state)
       : allocator_(allocator),
         interface_(vm::assign_ref(new Interface())),
-        kernel_state_(kernel_state) {}
+        kernel_state_(kernel_state),
+        worker_state_(kernel_state) {}
 
   ~VMLAModuleState() = default;
 
@@ -202,8 +212,8 @@ class VMLAModuleState final {
       vm::assign_ref(reinterpret_cast<iree_vm_ro_byte_buffer_t*>(self)).reset();
       return IREE_STATUS_OK;
     };
-    return Buffer::Wrap(value->data.data, value->data.data_length,
-                        external_allocator);
+    return Buffer::WrapConstant(value->data.data, value->data.data_length,
+                                external_allocator);
   }
 
   StatusOr<vm::ref<Buffer>> BufferAlloc(iree_vmla_size_t byte_length) {
@@ -259,6 +269,9 @@ class VMLAModuleState final {
       vm::assign_ref(reinterpret_cast<Buffer*>(self)).reset();
       return IREE_STATUS_OK;
     };
+    if (src->is_constant()) {
+      return Buffer::WrapConstant(data, data_length, external_allocator);
+    }
     return Buffer::Wrap(data, data_length, external_allocator);
   }
 
@@ -597,10 +610,48 @@ class VMLAModuleState final {
     buffers.rhs_shape = Shape(rhs_shape);
     buffers.dst_buffer = dst->As<float>();
     buffers.dst_shape = Shape(dst_shape);
-    return kernels::MatMul::Execute(kernel_state_->mat_mul_state.get(),
+    if (rhs->is_constant()) {
+      buffers.prepacked_rhs_cache = interface_->prepacked_rhs_cache();
+    }
+    return kernels::MatMul::Execute(worker_state_.mat_mul_state.get(),
                                     buffers);
   }
 
+  //===--------------------------------------------------------------------===//
+  // VMLA Ops: convolution
+  //===--------------------------------------------------------------------===//
+
+  Status ConvF32F32F32(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+                       vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,
+                       vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+                       absl::Span<const int32_t> window_strides,
+                       absl::Span<const int32_t> padding,
+                       absl::Span<const int32_t> lhs_dilation,
+                       absl::Span<const int32_t> rhs_dilation,
+                       int32_t feature_group_count, int32_t batch_group_count) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::ConvF32F32F32");
+    for (int32_t dilation : lhs_dilation) {
+      if (dilation != 1) {
+        return UnimplementedErrorBuilder(IREE_LOC)
+               << "Input (lhs) dilation is not supported";
+      }
+    }
+    if (batch_group_count != 1) {
+      return UnimplementedErrorBuilder(IREE_LOC)
+             << "Batch groups are not supported";
+    }
+    // Constant filters are packed once and reused like constant matmul RHS.
+    kernels::MatMul::PrepackedRhsCache* prepacked_filter_cache = nullptr;
+    if (filter->is_constant()) {
+      prepacked_filter_cache = interface_->prepacked_rhs_cache();
+    }
+    return kernels::Conv2D::Execute<float>(
+        worker_state_.mat_mul_state.get(), input->As<float>(),
+        Shape(input_shape), filter->As<float>(), Shape(filter_shape),
+        dst->As<float>(), Shape(dst_shape), window_strides, padding,
+        rhs_dilation, feature_group_count, prepacked_filter_cache);
+  }
+
   //===--------------------------------------------------------------------===//
   // VMLA Ops: reduction
   //===--------------------------------------------------------------------===//
@@ -628,6 +679,32 @@ class VMLAModuleState final {
   IREE_VMLA_REDUCTION_OP(ReduceMaxI32, kernels::ReduceMax, int32_t);
   IREE_VMLA_REDUCTION_OP(ReduceMaxF32, kernels::ReduceMax, float);
 
+#define IREE_VMLA_POOLING_OP(name, kernel, type)                      \
+  Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,       \
+              vm::ref<Buffer> init, iree_vmla_shape_t init_shape,     \
+              vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,       \
+              absl::Span<const int32_t> window_dimensions,            \
+              absl::Span<const int32_t> window_strides,               \
+              absl::Span<const int32_t> padding) {                    \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                     \
+    return kernel::Execute<type>(src->As<type>(), init->As<type>(),   \
+                                 dst->As<type>(), Shape(src_shape),   \
+                                 Shape(dst_shape), window_dimensions, \
+                                 window_strides, padding);            \
+  }
+  IREE_VMLA_POOLING_OP(PoolingSumI8, kernels::PoolingSum, int8_t);
+  IREE_VMLA_POOLING_OP(PoolingSumI16, kernels::PoolingSum, int16_t);
+  IREE_VMLA_POOLING_OP(PoolingSumI32, kernels::PoolingSum, int32_t);
+  IREE_VMLA_POOLING_OP(PoolingSumF32, kernels::PoolingSum, float);
+  IREE_VMLA_POOLING_OP(PoolingMinI8, kernels::PoolingMin, int8_t);
+  IREE_VMLA_POOLING_OP(PoolingMinI16, kernels::PoolingMin, int16_t);
+  IREE_VMLA_POOLING_OP(PoolingMinI32, kernels::PoolingMin, int32_t);
+  IREE_VMLA_POOLING_OP(PoolingMinF32, kernels::PoolingMin, float);
+  IREE_VMLA_POOLING_OP(PoolingMaxI8, kernels::PoolingMax, int8_t);
+  IREE_VMLA_POOLING_OP(PoolingMaxI16, kernels::PoolingMax, int16_t);
+  IREE_VMLA_POOLING_OP(PoolingMaxI32, kernels::PoolingMax, int32_t);
+  IREE_VMLA_POOLING_OP(PoolingMaxF32, kernels::PoolingMax, float);
+
  private:
   iree_allocator_t allocator_;
 
@@ -635,11 +712,14 @@ class VMLAModuleState final {
   // execution.
   vm::ref<Interface> interface_;
 
-  // NOTE: kernel state must be externally synchronized as it is shared across
-  // all contexts using the VMLA module. This is fine in our current design as
-  // we only ever execute a single context at a time but if we start to allow
-  // concurrency across contexts we'll need to introduce locks.
+  // NOTE: kernel state is shared across all contexts using the VMLA module and
+  // multiple contexts may execute concurrently (one per in-flight dispatch).
+  // Kernels must internally synchronize any mutable runtime state.
   kernels::RuntimeState* kernel_state_ = nullptr;
+
+  // Kernel state used only by this context. Each in-flight dispatch has its own
+  // context and as such kernels can use this without synchronization.
+  kernels::WorkerState worker_state_;
 };
 
 //===----------------------------------------------------------------------===//
@@ -790,8 +870,23 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("reduce.max.i32", &VMLAModuleState::ReduceMaxI32),
     vm::MakeNativeFunction("reduce.max.f32", &VMLAModuleState::ReduceMaxF32),
 
+    vm::MakeNativeFunction("pooling.sum.i8", &VMLAModuleState::PoolingSumI8),
+    vm::MakeNativeFunction("pooling.sum.i16", &VMLAModuleState::PoolingSumI16),
+    vm::MakeNativeFunction("pooling.sum.i32", &VMLAModuleState::PoolingSumI32),
+    vm::MakeNativeFunction("pooling.sum.f32", &VMLAModuleState::PoolingSumF32),
+    vm::MakeNativeFunction("pooling.min.i8", &VMLAModuleState::PoolingMinI8),
+    vm::MakeNativeFunction("pooling.min.i16", &VMLAModuleState::PoolingMinI16),
+    vm::MakeNativeFunction("pooling.min.i32", &VMLAModuleState::PoolingMinI32),
+    vm::MakeNativeFunction("pooling.min.f32", &VMLAModuleState::PoolingMinF32),
+    vm::MakeNativeFunction("pooling.max.i8", &VMLAModuleState::PoolingMaxI8),
+    vm::MakeNativeFunction("pooling.max.i16", &VMLAModuleState::PoolingMaxI16),
+    vm::MakeNativeFunction("pooling.max.i32", &VMLAModuleState::PoolingMaxI32),
+    vm::MakeNativeFunction("pooling.max.f32", &VMLAModuleState::PoolingMaxF32),
+
     vm::MakeNativeFunction("matmul.f32f32.f32",
                            &VMLAModuleState::MatMulF32F32F32),
+
+    vm::MakeNativeFunction("conv.f32f32.f32", &VMLAModuleState::ConvF32F32F32),
 };
 
 // Per-device VMLA module.
@@ -803,9 +898,10 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
 // Thread-safe.
 class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
  public:
-  explicit VMLAModule(iree_allocator_t allocator)
+  VMLAModule(ModuleOptions options, iree_allocator_t allocator)
       : vm::NativeModule<VMLAModuleState>(
-            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)) {}
+            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)),
+        kernel_state_(options.matmul_thread_count) {}
   ~VMLAModule() = default;
 
   Status Initialize() {
@@ -828,13 +924,14 @@ class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
 
 }  // namespace
 
-Status ModuleCreate(iree_allocator_t allocator, iree_vm_module_t** out_module) {
+Status ModuleCreate(ModuleOptions options, iree_allocator_t allocator,
+                    iree_vm_module_t** out_module) {
   if (!out_module) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "out_module must not be null";
   }
   *out_module = nullptr;
-  auto module = std::make_unique<VMLAModule>(allocator);
+  auto module = std::make_unique<VMLAModule>(std::move(options), allocator);
   RETURN_IF_ERROR(module->Initialize());
   *out_module = module.release()->interface();
   return OkStatus();
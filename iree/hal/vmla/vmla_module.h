@@ -26,6 +26,7 @@
 #include "iree/base/memory.h"
 #include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
+#include "iree/hal/vmla/op_kernels.h"
 #include "iree/vm/api.h"
 #include "iree/vm/module_abi_cc.h"
 #include "iree/vm/types.h"
@@ -60,11 +61,20 @@ class Buffer final : public RefObject<Buffer> {
   static StatusOr<vm::ref<Buffer>> WrapMutable(void* data, size_t data_length,
                                                iree_allocator_t allocator);
 
+  // Wraps data that is immutable and remains at the same address for the
+  // lifetime of the executable that created the buffer (such as executable
+  // rodata). Kernels may cache values derived from the contents of constant
+  // buffers in the interface prepacked RHS cache.
+  static StatusOr<vm::ref<Buffer>> WrapConstant(const void* data,
+                                                size_t data_length,
+                                                iree_allocator_t allocator);
+
   ~Buffer();
 
   constexpr const void* data() const { return data_; }
   constexpr void* data() { return data_; }
   constexpr size_t size() const { return data_length_; }
+  constexpr bool is_constant() const { return is_constant_; }
 
   template <typename T>
   absl::Span<const T> As() const {
@@ -92,6 +102,7 @@ class Buffer final : public RefObject<Buffer> {
   vm::ref<Buffer> parent_;
   void* data_ = nullptr;
   size_t data_length_ = 0;
+  bool is_constant_ = false;
   iree_allocator_t allocator_;
 };
 
@@ -114,13 +125,32 @@ class Interface final : public RefObject<Interface> {
   // Sets a binding within a set to the given buffer value (possibly null).
   Status SetBinding(int32_t set, int32_t binding, Binding value);
 
+  // Cache of packed constants shared by all invocations of the executable
+  // using this interface, if any. Not affected by Reset.
+  kernels::MatMul::PrepackedRhsCache* prepacked_rhs_cache() const {
+    return prepacked_rhs_cache_;
+  }
+  // Sets the cache of packed constants. |cache| must outlive the interface.
+  void set_prepacked_rhs_cache(kernels::MatMul::PrepackedRhsCache* cache) {
+    prepacked_rhs_cache_ = cache;
+  }
+
  private:
   std::array<std::array<Binding, kMaxBindings>, kMaxSets> bindings_;
+  kernels::MatMul::PrepackedRhsCache* prepacked_rhs_cache_ = nullptr;
 };
 
 Status ModuleRegisterTypes();
 
-Status ModuleCreate(iree_allocator_t allocator, iree_vm_module_t** out_module);
+struct ModuleOptions {
+  // Maximum number of threads used to execute a single matmul. Each context
+  // using the module has its own pool of up to this many threads so that
+  // concurrent dispatches do not contend for them.
+  int matmul_thread_count = 1;
+};
+
+Status ModuleCreate(ModuleOptions options, iree_allocator_t allocator,
+                    iree_vm_module_t** out_module);
 
 }  // namespace vmla
 }  // namespace hal
@@ -18,7 +18,6 @@
 #include "absl/strings/string_view.h"
 #include "iree/base/api.h"
 #include "iree/base/api_util.h"
-#include "iree/base/file_io.h"
 #include "iree/base/init.h"
 #include "iree/base/source_location.h"
 #include "iree/base/status.h"
@@ -44,16 +43,18 @@ ABSL_FLAG(
 namespace iree {
 namespace {
 
-StatusOr<std::string> GetModuleContentsFromFlags() {
+// Loads the module specified by the input_file flag. Files are mapped and used
+// in place while modules read from stdin are stored in |stdin_contents|, which
+// must outlive the module.
+Status LoadModuleFromFlags(std::string* stdin_contents,
+                           iree_vm_module_t** out_module) {
   auto input_file = absl::GetFlag(FLAGS_input_file);
-  std::string contents;
   if (input_file == "-") {
-    contents = std::string{std::istreambuf_iterator<char>(std::cin),
-                           std::istreambuf_iterator<char>()};
-  } else {
-    ASSIGN_OR_RETURN(contents, file_io::GetFileContents(input_file));
+    *stdin_contents = std::string{std::istreambuf_iterator<char>(std::cin),
+                                  std::istreambuf_iterator<char>()};
+    return LoadBytecodeModule(*stdin_contents, out_module);
   }
-  return contents;
+  return LoadBytecodeModuleFromFile(input_file, out_module);
 }
 
 class CheckModuleTest : public ::testing::Test {
@@ -93,9 +94,9 @@ StatusOr<int> Run() {
       iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance), IREE_LOC))
       << "creating instance";
 
-  ASSIGN_OR_RETURN(auto module_data, GetModuleContentsFromFlags());
+  std::string module_data;
   iree_vm_module_t* input_module = nullptr;
-  RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
+  RETURN_IF_ERROR(LoadModuleFromFlags(&module_data, &input_module));
 
   iree_hal_device_t* device = nullptr;
   RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
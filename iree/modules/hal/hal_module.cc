@@ -14,10 +14,18 @@
 
 #include "iree/modules/hal/hal_module.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <tuple>
+#include <vector>
+
 #include "absl/base/macros.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/api.h"
 #include "iree/base/api_util.h"
@@ -100,19 +108,113 @@ IREE_VM_DEFINE_TYPE_ADAPTERS(iree_hal_executable_layout,
 // Module type definitions
 //===----------------------------------------------------------------------===//
 
+// Constant buffers that alias module rodata in place of copies.
+// Shared by all states of a HAL module such that contexts created from the
+// same module share their constants. Entries are counted by the states that
+// acquired them and dropped once the last of those states is destroyed.
+class ConstantBufferCache final {
+ public:
+  // Identifies a wrapped rodata segment and the parameters it was wrapped
+  // with. The memory type and usage are part of the key as buffers with
+  // different parameters are not interchangeable.
+  using Key = std::tuple<const uint8_t*, iree_host_size_t,
+                         iree_hal_allocator_t*, iree_hal_memory_type_t,
+                         iree_hal_buffer_usage_t>;
+
+  // Returns a buffer aliasing the rodata |value| as described by |key|,
+  // wrapping it on first use. Returns nullptr if |allocator| cannot wrap host
+  // memory with the requested parameters. Each successful acquire must be
+  // balanced with a call to Release.
+  vm::ref<iree_hal_buffer_t> Acquire(const Key& key,
+                                     iree_hal_allocator_t* allocator,
+                                     iree_vm_ro_byte_buffer_t* value) {
+    absl::MutexLock lock(&mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++it->second.use_count;
+      return vm::retain_ref(it->second.buffer.get());
+    }
+
+    // The buffer keeps the rodata reference alive for as long as the memory
+    // may be in use, matching how VMLA wraps constants. Rodata references
+    // outlive the module state that produced them so the entry remains valid
+    // for other contexts after the acquiring context has been destroyed.
+    iree_allocator_t data_allocator = {0};
+    data_allocator.self = vm::retain_ref(value).release();
+    data_allocator.free = +[](void* self, void* ptr) -> iree_status_t {
+      vm::assign_ref(reinterpret_cast<iree_vm_ro_byte_buffer_t*>(self)).reset();
+      return IREE_STATUS_OK;
+    };
+    vm::ref<iree_hal_buffer_t> buffer;
+    iree_status_t status = iree_hal_allocator_wrap_buffer_with_release(
+        allocator, std::get<3>(key), IREE_HAL_MEMORY_ACCESS_READ,
+        std::get<4>(key),
+        iree_byte_span_t{const_cast<uint8_t*>(value->data.data),
+                         value->data.data_length},
+        data_allocator, &buffer);
+    if (!iree_status_is_ok(status)) {
+      // Ownership of the rodata reference remains with us on failure.
+      data_allocator.free(data_allocator.self, nullptr);
+      return {};
+    }
+
+    auto& entry = entries_[key];
+    entry.buffer = vm::retain_ref(buffer.get());
+    entry.use_count = 1;
+    return buffer;
+  }
+
+  // Releases a use of the entry acquired with |key|.
+  void Release(const Key& key) {
+    vm::ref<iree_hal_buffer_t> buffer;
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it = entries_.find(key);
+      if (it == entries_.end() || --it->second.use_count > 0) return;
+      buffer = std::move(it->second.buffer);
+      entries_.erase(it);
+    }
+    // The buffer (and with it the rodata reference) is released outside of
+    // the lock.
+  }
+
+ private:
+  struct Entry {
+    vm::ref<iree_hal_buffer_t> buffer;
+    int use_count = 0;
+  };
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
 class HALModuleState final {
  public:
   HALModuleState(iree_allocator_t allocator, ref_ptr<Device> shared_device,
-                 ref_ptr<ExecutableCache> executable_cache)
+                 ref_ptr<ExecutableCache> executable_cache,
+                 ConstantBufferCache* constant_cache, int queue_ordinal)
       : allocator_(allocator),
         shared_device_(std::move(shared_device)),
-        executable_cache_(std::move(executable_cache)) {}
+        executable_cache_(std::move(executable_cache)),
+        constant_cache_(constant_cache),
+        queue_ordinal_(queue_ordinal) {}
 
   ~HALModuleState() {
-    for (auto& ref : deferred_releases_) {
-      iree_vm_ref_release(&ref);
+    // Resources may still be in use by outstanding submissions.
+    if (submit_fence_ && !in_flight_submissions_.empty()) {
+      submit_device_
+          ->WaitAllFences({{submit_fence_.get(), submit_value_}},
+                          absl::InfiniteFuture())
+          .IgnoreError();
+    }
+    while (!in_flight_submissions_.empty()) {
+      ReleaseRefs(&in_flight_submissions_.front().deferred_releases);
+      in_flight_submissions_.pop_front();
+    }
+    ReleaseRefs(&deferred_releases_);
+    for (const auto& key : acquired_constants_) {
+      constant_cache_->Release(key);
     }
-    deferred_releases_.clear();
   }
 
   //===--------------------------------------------------------------------===//
@@ -179,29 +281,68 @@ class HALModuleState final {
     return OkStatus();
   }
 
-  Status ExSubmitAndWait(vm::ref<iree_hal_device_t> device,
-                         vm::ref<iree_hal_command_buffer_t> command_buffer) {
-    IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWait");
+  // Submits |command_buffer| for execution without waiting for it to complete.
+  // Resources deferred for release since the last submission are retained
+  // until the submission has completed.
+  Status ExSubmit(vm::ref<iree_hal_device_t> device,
+                  vm::ref<iree_hal_command_buffer_t> command_buffer) {
+    IREE_TRACE_SCOPE0("HALModuleState::ExSubmit");
 
     auto* device_ptr = reinterpret_cast<Device*>(device.get());
-    auto* queue = device_ptr->dispatch_queues().front();
-    ASSIGN_OR_RETURN(auto fence, device_ptr->CreateFence(0u));
+    if (!submit_fence_) {
+      ASSIGN_OR_RETURN(submit_fence_, device_ptr->CreateFence(0u));
+      submit_device_ = add_ref(device_ptr);
+    } else if (submit_device_.get() != device_ptr) {
+      return UnimplementedErrorBuilder(IREE_LOC)
+             << "Submissions to multiple devices are not supported";
+    }
+
+    // Release anything that has completed since the last submission to keep
+    // memory usage bounded when the program never waits.
+    RETURN_IF_ERROR(ReleaseCompletedSubmissions());
+
+    // Each context submits to its own queue (when the device has several) so
+    // that independent contexts do not serialize behind each other.
+    auto queues = device_ptr->dispatch_queues();
+    auto* queue = queues[queue_ordinal_ % queues.size()];
     SubmissionBatch batch;
     CommandBuffer* command_buffers[1] = {
         reinterpret_cast<CommandBuffer*>(command_buffer.get())};
     batch.command_buffers = absl::MakeConstSpan(command_buffers);
-    RETURN_IF_ERROR(queue->Submit(batch, {fence.get(), 1u}));
-    RETURN_IF_ERROR(queue->WaitIdle());
-
-    for (auto& ref : deferred_releases_) {
-      iree_vm_ref_release(&ref);
-    }
+    RETURN_IF_ERROR(
+        queue->Submit(batch, {submit_fence_.get(), submit_value_ + 1}));
+    ++submit_value_;
+
+    // Queues do not retain the command buffers they execute.
+    in_flight_submissions_.emplace_back();
+    auto& submission = in_flight_submissions_.back();
+    submission.fence_value = submit_value_;
+    submission.command_buffer = std::move(command_buffer);
+    submission.deferred_releases = std::move(deferred_releases_);
     deferred_releases_.clear();
     bindings_.clear();
 
     return OkStatus();
   }
 
+  // Blocks until all prior submissions have completed and releases their
+  // resources.
+  Status ExWaitIdle(vm::ref<iree_hal_device_t> device) {
+    IREE_TRACE_SCOPE0("HALModuleState::ExWaitIdle");
+    if (in_flight_submissions_.empty()) return OkStatus();
+    RETURN_IF_ERROR(submit_device_->WaitAllFences(
+        {{submit_fence_.get(), submit_value_}}, absl::InfiniteFuture()));
+    return ReleaseCompletedSubmissions();
+  }
+
+  Status ExSubmitAndWait(vm::ref<iree_hal_device_t> device,
+                         vm::ref<iree_hal_command_buffer_t> command_buffer) {
+    IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWait");
+    RETURN_IF_ERROR(ExSubmit(vm::retain_ref(device.get()),
+                             std::move(command_buffer)));
+    return ExWaitIdle(std::move(device));
+  }
+
   //===--------------------------------------------------------------------===//
   // iree::hal::Allocator
   //===--------------------------------------------------------------------===//
@@ -278,6 +419,30 @@ class HALModuleState final {
              << "Constant data is too larger for the minimum allocation size";
     }
 
+    // Host-visible constants that need no padding can alias the rodata
+    // directly. This avoids the copy and, as the module data is often mapped
+    // from a file, keeps the constants out of private memory entirely.
+    if (allocation_size == value->data.data_length &&
+        (memory_types & IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+      ConstantBufferCache::Key key{value->data.data, value->data.data_length,
+                                   allocator.get(), memory_types,
+                                   buffer_usage};
+      auto wrapped_buffer =
+          constant_cache_->Acquire(key, allocator.get(), value.get());
+      if (wrapped_buffer) {
+        // Each state holds a single use of an entry no matter how many times
+        // it allocates the same constant.
+        if (std::find(acquired_constants_.begin(), acquired_constants_.end(),
+                      key) != acquired_constants_.end()) {
+          constant_cache_->Release(key);
+        } else {
+          acquired_constants_.push_back(key);
+        }
+        return wrapped_buffer;
+      }
+      // Fall back to copying if the allocator cannot wrap host memory.
+    }
+
     vm::ref<iree_hal_buffer_t> buffer;
     RETURN_IF_ERROR(FromApiStatus(iree_hal_allocator_allocate_buffer(
                                       allocator.get(), memory_types,
@@ -307,7 +472,15 @@ class HALModuleState final {
       vm::ref<iree_hal_buffer_t> source_buffer, int32_t source_offset,
       int32_t length) {
     IREE_TRACE_SCOPE0("HALModuleState::BufferSubspan");
-    return UnimplementedErrorBuilder(IREE_LOC) << "BufferSubspan";
+    vm::ref<iree_hal_buffer_t> target_buffer;
+    RETURN_IF_ERROR(
+        FromApiStatus(iree_hal_buffer_subspan(source_buffer.get(),
+                                              source_offset, length,
+                                              allocator_, &target_buffer),
+                      IREE_LOC))
+        << "Subspan of buffer (offset=" << source_offset
+        << ", length=" << length << ") failed";
+    return target_buffer;
   }
 
   Status BufferFill(vm::ref<iree_hal_buffer_t> target_buffer,
@@ -666,9 +839,55 @@ class HALModuleState final {
   ref_ptr<Device> shared_device_;
   ref_ptr<ExecutableCache> executable_cache_;
 
+  // Constants shared with other states of the module and the entries this
+  // state holds a use of.
+  ConstantBufferCache* constant_cache_;
+  std::vector<ConstantBufferCache::Key> acquired_constants_;
+
+  // Selects the device dispatch queue this state submits to.
+  int queue_ordinal_;
+
+  // A submission that may still be executing along with the resources it
+  // requires.
+  struct InFlightSubmission {
+    // Value the submission fence will reach when the submission completes.
+    uint64_t fence_value = 0;
+    vm::ref<iree_hal_command_buffer_t> command_buffer;
+    std::vector<iree_vm_ref_t> deferred_releases;
+  };
+
+  static void ReleaseRefs(std::vector<iree_vm_ref_t>* refs) {
+    for (auto& ref : *refs) {
+      iree_vm_ref_release(&ref);
+    }
+    refs->clear();
+  }
+
+  // Releases the resources of all submissions that have completed.
+  Status ReleaseCompletedSubmissions() {
+    if (in_flight_submissions_.empty()) return OkStatus();
+    // Surface asynchronous failures from prior submissions.
+    RETURN_IF_ERROR(submit_fence_->status());
+    ASSIGN_OR_RETURN(uint64_t completed_value, submit_fence_->QueryValue());
+    while (!in_flight_submissions_.empty() &&
+           in_flight_submissions_.front().fence_value <= completed_value) {
+      ReleaseRefs(&in_flight_submissions_.front().deferred_releases);
+      in_flight_submissions_.pop_front();
+    }
+    return OkStatus();
+  }
+
+  // Resources deferred for release until the next submission completes.
   std::vector<iree_vm_ref_t> deferred_releases_;
 
   std::vector<BufferBinding> bindings_;
+
+  // Timeline signaled as submissions complete. Each submission signals the
+  // next value such that submissions complete in order.
+  ref_ptr<Device> submit_device_;
+  ref_ptr<Fence> submit_fence_;
+  uint64_t submit_value_ = 0;
+  std::deque<InFlightSubmission> in_flight_submissions_;
 };
 
 //===----------------------------------------------------------------------===//
@@ -683,6 +902,8 @@ static const vm::NativeFunction<HALModuleState> kHALModuleFunctions[] = {
                            &HALModuleState::ExCacheExecutable),
     vm::MakeNativeFunction("ex.push_binding", &HALModuleState::ExPushBinding),
     vm::MakeNativeFunction("ex.defer_release", &HALModuleState::ExDeferRelease),
+    vm::MakeNativeFunction("ex.submit", &HALModuleState::ExSubmit),
+    vm::MakeNativeFunction("ex.wait_idle", &HALModuleState::ExWaitIdle),
     vm::MakeNativeFunction("ex.submit_and_wait",
                            &HALModuleState::ExSubmitAndWait),
 
@@ -769,7 +990,8 @@ class HALModule final : public vm::NativeModule<HALModuleState> {
       iree_allocator_t allocator) override {
     IREE_TRACE_SCOPE0("HALModule::CreateState");
     auto state = std::make_unique<HALModuleState>(
-        allocator, add_ref(shared_device_), add_ref(executable_cache_));
+        allocator, add_ref(shared_device_), add_ref(executable_cache_),
+        &constant_cache_, next_queue_ordinal_++);
     // TODO(benvanik): allocate context-specific variables (allocator pool,
     // etc).
     return state;
@@ -778,6 +1000,12 @@ class HALModule final : public vm::NativeModule<HALModuleState> {
  private:
   ref_ptr<Device> shared_device_;
   ref_ptr<ExecutableCache> executable_cache_;
+
+  // Must outlive all states; states are freed before their module.
+  ConstantBufferCache constant_cache_;
+
+  // Round-robins states across the device dispatch queues.
+  std::atomic<int> next_queue_ordinal_{0};
 };
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
@@ -0,0 +1,164 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests that invoke the native HAL module functions through the VM.
+
+#include "iree/modules/hal/hal_module.h"
+
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/api.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/ref_cc.h"
+#include "iree/vm/variant_list.h"
+
+namespace iree {
+namespace {
+
+class HALModuleTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+
+    IREE_CHECK_OK(iree_hal_module_register_types());
+    iree_hal_driver_t* hal_driver = nullptr;
+    IREE_CHECK_OK(iree_hal_driver_registry_create_driver(
+        iree_make_cstring_view("interpreter"), IREE_ALLOCATOR_SYSTEM,
+        &hal_driver));
+    IREE_CHECK_OK(iree_hal_driver_create_default_device(
+        hal_driver, IREE_ALLOCATOR_SYSTEM, &device_));
+    IREE_CHECK_OK(
+        iree_hal_module_create(device_, IREE_ALLOCATOR_SYSTEM, &hal_module_));
+    iree_hal_driver_release(hal_driver);
+
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &hal_module_, 1, IREE_ALLOCATOR_SYSTEM, &context_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_module_release(hal_module_);
+    iree_hal_device_release(device_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_function_t LookupFunction(absl::string_view function_name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(hal_module_->lookup_function(
+        hal_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+    return function;
+  }
+
+  // Allocates a host-visible buffer holding the bytes 0..|length|-1.
+  void AllocateSequenceBuffer(iree_device_size_t length,
+                              iree_hal_buffer_t** out_buffer) {
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device_),
+        static_cast<iree_hal_memory_type_t>(
+            IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+            IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE),
+        IREE_HAL_BUFFER_USAGE_ALL, length, out_buffer));
+    std::vector<uint8_t> contents(length);
+    for (iree_device_size_t i = 0; i < length; ++i) {
+      contents[i] = static_cast<uint8_t>(i);
+    }
+    IREE_ASSERT_OK(
+        iree_hal_buffer_write_data(*out_buffer, 0, contents.data(), length));
+  }
+
+  // Invokes hal.buffer.subspan on |source_buffer|.
+  iree_status_t InvokeSubspan(iree_hal_buffer_t* source_buffer,
+                              int32_t source_offset, int32_t length,
+                              iree_hal_buffer_t** out_buffer) {
+    iree_vm_variant_list_t* inputs = nullptr;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_variant_list_alloc(3, IREE_ALLOCATOR_SYSTEM, &inputs));
+    iree_vm_ref_t source_buffer_ref = iree_hal_buffer_retain_ref(source_buffer);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_variant_list_append_ref_move(inputs, &source_buffer_ref));
+    IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_value(
+        inputs, IREE_VM_VALUE_MAKE_I32(source_offset)));
+    IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_value(
+        inputs, IREE_VM_VALUE_MAKE_I32(length)));
+
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+
+    iree_status_t status = iree_vm_invoke(
+        context_, LookupFunction("buffer.subspan"), /*policy=*/nullptr, inputs,
+        outputs, IREE_ALLOCATOR_SYSTEM);
+    if (iree_status_is_ok(status)) {
+      *out_buffer =
+          iree_hal_buffer_deref(&iree_vm_variant_list_get(outputs, 0)->ref);
+      iree_hal_buffer_retain(*out_buffer);
+    }
+    iree_vm_variant_list_free(inputs);
+    iree_vm_variant_list_free(outputs);
+    return status;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_hal_device_t* device_ = nullptr;
+  iree_vm_module_t* hal_module_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+TEST_F(HALModuleTest, BufferSubspan) {
+  vm::ref<iree_hal_buffer_t> source_buffer;
+  AllocateSequenceBuffer(64, &source_buffer);
+
+  vm::ref<iree_hal_buffer_t> subspan_buffer;
+  IREE_ASSERT_OK(InvokeSubspan(source_buffer.get(), 16, 8, &subspan_buffer));
+  ASSERT_NE(nullptr, subspan_buffer.get());
+  EXPECT_EQ(8, iree_hal_buffer_byte_length(subspan_buffer.get()));
+
+  // Reads through the subspan must be relative to its offset.
+  uint8_t contents[8] = {0};
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(subspan_buffer.get(), 0, contents,
+                                           sizeof(contents)));
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(16 + i, contents[i]);
+  }
+
+  // Writes through the subspan must land in the source buffer.
+  uint8_t written_value = 0xFF;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_write_data(subspan_buffer.get(), 2, &written_value, 1));
+  uint8_t read_value = 0;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_read_data(source_buffer.get(), 18, &read_value, 1));
+  EXPECT_EQ(written_value, read_value);
+}
+
+TEST_F(HALModuleTest, BufferSubspanOutOfRange) {
+  vm::ref<iree_hal_buffer_t> source_buffer;
+  AllocateSequenceBuffer(64, &source_buffer);
+
+  vm::ref<iree_hal_buffer_t> subspan_buffer;
+  EXPECT_FALSE(iree_status_is_ok(
+      InvokeSubspan(source_buffer.get(), 60, 8, &subspan_buffer)));
+  EXPECT_EQ(nullptr, subspan_buffer.get());
+}
+
+}  // namespace
+}  // namespace iree
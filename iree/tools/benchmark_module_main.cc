@@ -12,11 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
 #include "absl/flags/flag.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
 #include "iree/base/api_util.h"
-#include "iree/base/file_io.h"
 #include "iree/base/source_location.h"
 #include "iree/base/status.h"
 #include "iree/modules/hal/hal_module.h"
@@ -48,16 +52,54 @@ ABSL_FLAG(std::vector<std::string>, inputs, {},
           "values:\n"
           "2x2xi32=[[1 2][3 4]], 1x2xf32=[[1 2]]");
 
+ABSL_FLAG(bool, print_dispatch_profile, false,
+          "Prints how often each VM bytecode opcode was dispatched while "
+          "running the benchmark. Requires a runtime built with "
+          "IREE_VM_DISPATCH_PROFILING=1.");
+
 namespace iree {
 namespace {
 
-StatusOr<std::string> GetModuleContentsFromFlags() {
+Status LoadModuleFromFlags(iree_vm_module_t** out_module) {
   auto input_file = absl::GetFlag(FLAGS_input_file);
   if (input_file.empty()) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "input_file must be specified";
   }
-  return file_io::GetFileContents(input_file);
+  return LoadBytecodeModuleFromFile(input_file, out_module);
+}
+
+// Prints the opcodes dispatched since the profile was last reset sorted by
+// frequency along with the average count per benchmark iteration.
+Status PrintDispatchProfile(int64_t iteration_count) {
+  iree_vm_bytecode_dispatch_profile_t profile;
+  RETURN_IF_ERROR(FromApiStatus(
+      iree_vm_bytecode_dispatch_profile_capture(&profile), IREE_LOC))
+      << "capturing dispatch profile (is IREE_VM_DISPATCH_PROFILING set?)";
+  std::vector<int> opcodes;
+  int64_t total_count = 0;
+  for (int i = 0; i < IREE_VM_BYTECODE_OPCODE_COUNT; ++i) {
+    if (profile.counts[i] == 0) continue;
+    opcodes.push_back(i);
+    total_count += profile.counts[i];
+  }
+  std::sort(opcodes.begin(), opcodes.end(), [&](int lhs, int rhs) {
+    return profile.counts[lhs] > profile.counts[rhs];
+  });
+
+  iteration_count = std::max(iteration_count, int64_t{1});
+  std::cout << "VM dispatch profile: " << total_count << " ops over "
+            << iteration_count << " iterations\n";
+  for (int opcode : opcodes) {
+    auto name = iree_vm_bytecode_opcode_name(opcode);
+    int64_t count = profile.counts[opcode];
+    std::cout << "  " << std::left << std::setw(24)
+              << absl::string_view(name.data, name.size) << std::right
+              << std::setw(12) << count / iteration_count << " /iter "
+              << std::fixed << std::setprecision(2) << std::setw(6)
+              << (100.0 * count / total_count) << "%\n";
+  }
+  return OkStatus();
 }
 
 Status Run(::benchmark::State& state) {
@@ -68,9 +110,8 @@ Status Run(::benchmark::State& state) {
       iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance), IREE_LOC))
       << "creating instance";
 
-  ASSIGN_OR_RETURN(auto module_data, GetModuleContentsFromFlags());
   iree_vm_module_t* input_module = nullptr;
-  RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
+  RETURN_IF_ERROR(LoadModuleFromFlags(&input_module));
 
   iree_hal_device_t* device = nullptr;
   RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
@@ -121,6 +162,12 @@ Status Run(::benchmark::State& state) {
                     IREE_LOC));
   RETURN_IF_ERROR(FromApiStatus(iree_vm_variant_list_free(outputs), IREE_LOC));
 
+  bool print_dispatch_profile = absl::GetFlag(FLAGS_print_dispatch_profile);
+  if (print_dispatch_profile) {
+    // Only count the ops dispatched by the benchmark iterations.
+    iree_vm_bytecode_dispatch_profile_reset();
+  }
+
   for (auto _ : state) {
     // No status conversions and conditional returns in the benchmarked inner
     // loop.
@@ -131,6 +178,10 @@ Status Run(::benchmark::State& state) {
     IREE_CHECK_OK(iree_vm_variant_list_free(outputs));
   }
 
+  if (print_dispatch_profile) {
+    RETURN_IF_ERROR(PrintDispatchProfile(state.iterations()));
+  }
+
   // TODO(gcmn): Some nice wrappers to make this pattern shorter with generated
   // error messages.
   // Deallocate:
@@ -56,3 +56,49 @@ def iree_bytecode_module(
             visibility = visibility,
             flatten = True,
         )
+
+def iree_c_module(
+        name,
+        src,
+        flags = ["-iree-vm-ir-to-c-module"],
+        translate_tool = "//iree/tools:iree-translate",
+        testonly = False,
+        visibility = None):
+    """Compiles a VM module to C source and wraps it in a cc_library.
+
+    The library exposes `<module name>_c_module_create` in `<name>.h`.
+    """
+    for ext, output_format in [("c", "source"), ("h", "header")]:
+        native.genrule(
+            name = "%s_%s" % (name, ext),
+            srcs = [src],
+            outs = ["%s.%s" % (name, ext)],
+            cmd = " ".join([
+                "$(location %s)" % (translate_tool),
+                " ".join(flags),
+                "-iree-vm-c-module-output-format=%s" % (output_format),
+                "-o $(location %s.%s)" % (name, ext),
+                "$(location %s)" % (src),
+            ]),
+            tools = [translate_tool],
+            message = "Compiling IREE module %s to C..." % (name),
+            output_to_bindir = 1,
+            testonly = testonly,
+        )
+
+    native.cc_library(
+        name = name,
+        srcs = ["%s.c" % (name)],
+        hdrs = ["%s.h" % (name)],
+        deps = [
+            "//iree/base:alignment",
+            "//iree/base:api",
+            "//iree/vm:c_module",
+            "//iree/vm:module",
+            "//iree/vm:ref",
+            "//iree/vm:stack",
+            "//iree/vm:types",
+        ],
+        testonly = testonly,
+        visibility = visibility,
+    )
@@ -101,26 +101,53 @@ StatusOr<iree_vm_variant_list_t*> ParseToVariantList(
     desc.ToString(desc_str);
     switch (desc.type) {
       case RawSignatureParser::Type::kScalar: {
-        if (desc.scalar.type != AbiConstants::ScalarType::kSint32) {
-          return UnimplementedErrorBuilder(IREE_LOC)
-                 << "Unsupported signature scalar type: " << desc_str;
+        absl::string_view type_name;
+        switch (desc.scalar.type) {
+          case AbiConstants::ScalarType::kSint32:
+            type_name = "i32";
+            break;
+          case AbiConstants::ScalarType::kSint64:
+            type_name = "i64";
+            break;
+          case AbiConstants::ScalarType::kIeeeFloat32:
+            type_name = "f32";
+            break;
+          default:
+            return UnimplementedErrorBuilder(IREE_LOC)
+                   << "Unsupported signature scalar type: " << desc_str;
         }
         absl::string_view input_view = absl::StripAsciiWhitespace(input_string);
         input_view = absl::StripPrefix(input_view, "\"");
         input_view = absl::StripSuffix(input_view, "\"");
-        if (!absl::ConsumePrefix(&input_view, "i32=")) {
+        if (!absl::ConsumePrefix(&input_view, type_name) ||
+            !absl::ConsumePrefix(&input_view, "=")) {
           return InvalidArgumentErrorBuilder(IREE_LOC)
-                 << "Parsing '" << input_string
-                 << "'. Has i32 descriptor but does not start with 'i32='";
+                 << "Parsing '" << input_string << "'. Has " << type_name
+                 << " descriptor but does not start with '" << type_name
+                 << "='";
+        }
+        iree_vm_value_t value;
+        bool parsed = false;
+        switch (desc.scalar.type) {
+          case AbiConstants::ScalarType::kSint64:
+            value.type = IREE_VM_VALUE_TYPE_I64;
+            parsed = absl::SimpleAtoi(input_view, &value.i64);
+            break;
+          case AbiConstants::ScalarType::kIeeeFloat32:
+            value.type = IREE_VM_VALUE_TYPE_F32;
+            parsed = absl::SimpleAtof(input_view, &value.f32);
+            break;
+          default:
+            value.type = IREE_VM_VALUE_TYPE_I32;
+            parsed = absl::SimpleAtoi(input_view, &value.i32);
+            break;
         }
-        int32_t val;
-        if (!absl::SimpleAtoi(input_view, &val)) {
+        if (!parsed) {
           return InvalidArgumentErrorBuilder(IREE_LOC)
-                 << "Converting '" << input_view << "' to i32 when parsing '"
-                 << input_string << "'";
+                 << "Converting '" << input_view << "' to " << type_name
+                 << " when parsing '" << input_string << "'";
         }
-        iree_vm_variant_list_append_value(variant_list,
-                                          IREE_VM_VALUE_MAKE_I32(val));
+        iree_vm_variant_list_append_value(variant_list, value);
         break;
       }
       case RawSignatureParser::Type::kBuffer: {
@@ -179,17 +206,38 @@ Status PrintVariantList(absl::Span<const RawSignatureParser::Description> descs,
 
     switch (desc.type) {
       case RawSignatureParser::Type::kScalar: {
-        if (variant->value_type != IREE_VM_VALUE_TYPE_I32) {
+        iree_vm_value_type_t value_type;
+        switch (desc.scalar.type) {
+          case AbiConstants::ScalarType::kSint32:
+            value_type = IREE_VM_VALUE_TYPE_I32;
+            break;
+          case AbiConstants::ScalarType::kSint64:
+            value_type = IREE_VM_VALUE_TYPE_I64;
+            break;
+          case AbiConstants::ScalarType::kIeeeFloat32:
+            value_type = IREE_VM_VALUE_TYPE_F32;
+            break;
+          default:
+            return UnimplementedErrorBuilder(IREE_LOC)
+                   << "Unsupported signature scalar type: " << desc_str;
+        }
+        if (variant->value_type != value_type) {
           return InvalidArgumentErrorBuilder(IREE_LOC)
                  << "variant " << i << " has value type "
                  << static_cast<int>(variant->value_type)
                  << " but descriptor information " << desc_str;
         }
-        if (desc.scalar.type != AbiConstants::ScalarType::kSint32) {
-          return UnimplementedErrorBuilder(IREE_LOC)
-                 << "Unsupported signature scalar type: " << desc_str;
+        switch (value_type) {
+          case IREE_VM_VALUE_TYPE_I64:
+            *os << "i64=" << variant->i64 << "\n";
+            break;
+          case IREE_VM_VALUE_TYPE_F32:
+            *os << "f32=" << variant->f32 << "\n";
+            break;
+          default:
+            *os << "i32=" << variant->i32 << "\n";
+            break;
         }
-        *os << "i32=" << variant->i32 << "\n";
         break;
       }
       case RawSignatureParser::Type::kBuffer: {
@@ -301,4 +349,16 @@ Status LoadBytecodeModule(absl::string_view module_data,
       << "Deserializing module";
   return OkStatus();
 }
+
+Status LoadBytecodeModuleFromFile(const std::string& path,
+                                  iree_vm_module_t** out_module) {
+  RETURN_IF_ERROR(FromApiStatus(
+      iree_vm_bytecode_module_create_from_file(
+          iree_string_view_t{path.data(), path.size()},
+          IREE_VM_BYTECODE_MODULE_FILE_ADVISE_BYTECODE, IREE_ALLOCATOR_SYSTEM,
+          out_module),
+      IREE_LOC))
+      << "Loading module from '" << path << "'";
+  return OkStatus();
+}
 }  // namespace iree
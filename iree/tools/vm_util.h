@@ -17,6 +17,7 @@
 
 #include <iostream>
 #include <ostream>
+#include <string>
 
 #include "absl/types/span.h"
 #include "iree/base/signature_mangle.h"
@@ -82,6 +83,13 @@ Status CreateHalModule(iree_hal_device_t* device,
 Status LoadBytecodeModule(absl::string_view module_data,
                           iree_vm_module_t** out_module);
 
+// Loads a VM bytecode module by memory-mapping the file at |path|.
+// Pages are faulted in on demand with the bytecode read ahead such that load
+// time does not depend on the size of the rodata.
+// The returned |out_module| must be released by the caller.
+Status LoadBytecodeModuleFromFile(const std::string& path,
+                                  iree_vm_module_t** out_module);
+
 }  // namespace iree
 
 #endif  // IREE_TOOLS_VM_UTIL_H_
@@ -72,6 +72,36 @@ TEST_F(VmUtilTest, ParsePrintScalar) {
   IREE_ASSERT_OK(iree_vm_variant_list_free(variant_list));
 }
 
+TEST_F(VmUtilTest, ParsePrintScalarI64) {
+  auto input_string = "i64=-5000000000";
+  RawSignatureParser::Description desc;
+  desc.type = RawSignatureParser::Type::kScalar;
+  desc.scalar.type = AbiConstants::ScalarType::kSint64;
+
+  ASSERT_OK_AND_ASSIGN(auto* variant_list,
+                       ParseToVariantList({desc}, allocator_, {input_string}));
+  std::stringstream os;
+  ASSERT_OK(PrintVariantList({desc}, variant_list, &os));
+  EXPECT_EQ(os.str(), absl::StrCat(input_string, "\n"));
+
+  IREE_ASSERT_OK(iree_vm_variant_list_free(variant_list));
+}
+
+TEST_F(VmUtilTest, ParsePrintScalarF32) {
+  auto input_string = "f32=1.5";
+  RawSignatureParser::Description desc;
+  desc.type = RawSignatureParser::Type::kScalar;
+  desc.scalar.type = AbiConstants::ScalarType::kIeeeFloat32;
+
+  ASSERT_OK_AND_ASSIGN(auto* variant_list,
+                       ParseToVariantList({desc}, allocator_, {input_string}));
+  std::stringstream os;
+  ASSERT_OK(PrintVariantList({desc}, variant_list, &os));
+  EXPECT_EQ(os.str(), absl::StrCat(input_string, "\n"));
+
+  IREE_ASSERT_OK(iree_vm_variant_list_free(variant_list));
+}
+
 TEST_F(VmUtilTest, ParsePrintRank0Buffer) {
   auto buf_string = "i32=42";
   RawSignatureParser::Description desc;
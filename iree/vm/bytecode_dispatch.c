@@ -17,6 +17,7 @@
 
 #include "iree/base/alignment.h"
 #include "iree/base/target_platform.h"
+#include "iree/vm/bytecode_module.h"
 #include "iree/vm/bytecode_module_impl.h"
 #include "iree/vm/bytecode_op_table.h"
 
@@ -35,6 +36,59 @@
 #define IREE_DISPATCH_LOG_CALL(...)
 #endif  // IREE_DISPATCH_LOGGING
 
+// Enable to count how many times each opcode is dispatched across all modules.
+// The counts can be queried with iree_vm_bytecode_dispatch_profile_capture and
+// are useful for identifying hot op sequences that may benefit from fusion.
+#ifndef IREE_VM_DISPATCH_PROFILING
+#define IREE_VM_DISPATCH_PROFILING 0
+#endif  // !IREE_VM_DISPATCH_PROFILING
+
+#if IREE_VM_DISPATCH_PROFILING
+static iree_atomic_intptr_t
+    iree_vm_bytecode_dispatch_counts[IREE_VM_BYTECODE_OPCODE_COUNT];
+#define IREE_DISPATCH_PROFILE_OPCODE(op_name) \
+  iree_atomic_fetch_add(                      \
+      &iree_vm_bytecode_dispatch_counts[IREE_VM_OP_##op_name], 1)
+#else
+#define IREE_DISPATCH_PROFILE_OPCODE(...)
+#endif  // IREE_VM_DISPATCH_PROFILING
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_dispatch_profile_capture(
+    iree_vm_bytecode_dispatch_profile_t* out_profile) {
+  if (!out_profile) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_profile, 0, sizeof(*out_profile));
+#if IREE_VM_DISPATCH_PROFILING
+  for (int i = 0; i < IREE_VM_BYTECODE_OPCODE_COUNT; ++i) {
+    out_profile->counts[i] =
+        iree_atomic_fetch_add(&iree_vm_bytecode_dispatch_counts[i], 0);
+  }
+  return IREE_STATUS_OK;
+#else
+  return IREE_STATUS_UNAVAILABLE;
+#endif  // IREE_VM_DISPATCH_PROFILING
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_bytecode_dispatch_profile_reset(void) {
+#if IREE_VM_DISPATCH_PROFILING
+  for (int i = 0; i < IREE_VM_BYTECODE_OPCODE_COUNT; ++i) {
+    iree_atomic_store(&iree_vm_bytecode_dispatch_counts[i], 0);
+  }
+#endif  // IREE_VM_DISPATCH_PROFILING
+}
+
+IREE_API_EXPORT iree_string_view_t IREE_API_CALL
+iree_vm_bytecode_opcode_name(uint8_t opcode) {
+#define DECLARE_OPCODE_NAME_OPC(ordinal, name) #name,
+#define DECLARE_OPCODE_NAME_RSV(ordinal) "",
+  static const char* kOpcodeNames[IREE_VM_BYTECODE_OPCODE_COUNT] = {
+      IREE_VM_OP_TABLE(DECLARE_OPCODE_NAME_OPC, DECLARE_OPCODE_NAME_RSV)};
+#undef DECLARE_OPCODE_NAME_OPC
+#undef DECLARE_OPCODE_NAME_RSV
+  return iree_make_cstring_view(kOpcodeNames[opcode]);
+}
+
 #if defined(IREE_COMPILER_MSVC) && !defined(IREE_COMPILER_CLANG)
 #define IREE_DISPATCH_MODE_SWITCH 1
 #else
@@ -47,32 +101,40 @@
 #define VMCHECK(expr)
 #endif  // NDEBUG
 
+// Register list split by bank with all i32 registers preceding all ref
+// registers. Used for call arguments such that each bank can be remapped
+// without checking the type of every register.
+// This structure is an overlay for the bytecode that is serialized in a
+// matching format.
+typedef struct {
+  uint8_t size;
+  uint8_t i32_size;
+  uint8_t registers[];
+} iree_vm_register_split_list_t;
+static_assert(iree_alignof(iree_vm_register_split_list_t) == 1,
+              "Expecting byte alignment (to avoid padding)");
+static_assert(offsetof(iree_vm_register_split_list_t, registers) == 2,
+              "Expect no padding in the struct");
+
 // Remaps argument registers from a source list to the 0-N ABI registers.
 static void iree_vm_bytecode_dispatch_remap_argument_registers(
-    iree_vm_registers_t* src_regs, const iree_vm_register_list_t* src_reg_list,
+    iree_vm_registers_t* src_regs,
+    const iree_vm_register_split_list_t* src_reg_list,
     iree_vm_registers_t* dst_regs) {
   // Each bank begins left-aligned at 0 and increments per arg of its type.
-  int i32_reg_offset = 0;
-  int ref_reg_offset = 0;
-  for (int i = 0; i < src_reg_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint8_t src_reg = src_reg_list->registers[i];
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      uint8_t dst_reg = ref_reg_offset++;
-      memset(&dst_regs->ref[dst_reg & IREE_REF_REGISTER_MASK], 0,
-             sizeof(iree_vm_ref_t));
-      iree_vm_ref_retain_or_move(
-          src_reg & IREE_REF_REGISTER_MOVE_BIT,
-          &src_regs->ref[src_reg & IREE_REF_REGISTER_MASK],
-          &dst_regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
-    } else {
-      uint8_t dst_reg = i32_reg_offset++;
-      dst_regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
-          src_regs->i32[src_reg & IREE_I32_REGISTER_MASK];
-    }
+  const uint8_t* i32_src_regs = src_reg_list->registers;
+  for (int i = 0; i < src_reg_list->i32_size; ++i) {
+    dst_regs->i32[i & dst_regs->i32_mask] =
+        src_regs->i32[i32_src_regs[i] & src_regs->i32_mask];
+  }
+  const uint8_t* ref_src_regs = i32_src_regs + src_reg_list->i32_size;
+  int ref_size = src_reg_list->size - src_reg_list->i32_size;
+  for (int i = 0; i < ref_size; ++i) {
+    uint8_t src_reg = ref_src_regs[i];
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &src_regs->ref[src_reg & src_regs->ref_mask],
+                               &dst_regs->ref[i & dst_regs->ref_mask]);
   }
-  dst_regs->ref_register_count = ref_reg_offset;
 }
 
 // Remaps registers from source to destination, possibly across frames.
@@ -89,11 +151,11 @@ static void iree_vm_bytecode_dispatch_remap_registers(
     if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
       iree_vm_ref_retain_or_move(
           src_reg & IREE_REF_REGISTER_MOVE_BIT,
-          &src_regs->ref[src_reg & IREE_REF_REGISTER_MASK],
-          &dst_regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
+          &src_regs->ref[src_reg & src_regs->ref_mask],
+          &dst_regs->ref[dst_reg & dst_regs->ref_mask]);
     } else {
-      dst_regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
-          src_regs->i32[src_reg & IREE_I32_REGISTER_MASK];
+      dst_regs->i32[dst_reg & dst_regs->i32_mask] =
+          src_regs->i32[src_reg & src_regs->i32_mask];
     }
   }
 }
@@ -106,16 +168,18 @@ static void iree_vm_bytecode_dispatch_discard_registers(
     uint8_t reg = reg_list->registers[i];
     if ((reg & (IREE_REF_REGISTER_TYPE_BIT | IREE_REF_REGISTER_MOVE_BIT)) ==
         (IREE_REF_REGISTER_TYPE_BIT | IREE_REF_REGISTER_MOVE_BIT)) {
-      iree_vm_ref_release(&regs->ref[reg & IREE_REF_REGISTER_MASK]);
+      iree_vm_ref_release(&regs->ref[reg & regs->ref_mask]);
     }
   }
 }
 
-// Interleaved src-dst register sets.
+// Interleaved src-dst register sets split by bank with all i32 pairs
+// preceding all ref pairs.
 // This structure is an overlay for the bytecode that is serialized in a
 // matching format.
 typedef struct {
   uint8_t size;
+  uint8_t i32_size;
   struct pair {
     uint8_t src_reg;
     uint8_t dst_reg;
@@ -123,27 +187,92 @@ typedef struct {
 } iree_vm_register_remap_list_t;
 static_assert(iree_alignof(iree_vm_register_remap_list_t) == 1,
               "Expecting byte alignment (to avoid padding)");
-static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 1,
+static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 2,
               "Expect no padding in the struct");
 
+// Total size in bytes of a serialized iree_vm_register_remap_list_t.
+#define IREE_VM_REMAP_LIST_SIZE(remap_list) (2 + (remap_list)->size * 2)
+
 // Remaps registers from a source set to a destination set within the frame.
 static void iree_vm_bytecode_dispatch_remap_branch_registers(
     iree_vm_registers_t* regs,
     const iree_vm_register_remap_list_t* remap_list) {
-  for (int i = 0; i < remap_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
+  int i = 0;
+  for (; i < remap_list->i32_size; ++i) {
+    regs->i32[remap_list->pairs[i].dst_reg & regs->i32_mask] =
+        regs->i32[remap_list->pairs[i].src_reg & regs->i32_mask];
+  }
+  for (; i < remap_list->size; ++i) {
     uint8_t src_reg = remap_list->pairs[i].src_reg;
     uint8_t dst_reg = remap_list->pairs[i].dst_reg;
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
-                                 &regs->ref[src_reg & IREE_REF_REGISTER_MASK],
-                                 &regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
-    } else {
-      regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
-          regs->i32[src_reg & IREE_I32_REGISTER_MASK];
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &regs->ref[src_reg & regs->ref_mask],
+                               &regs->ref[dst_reg & regs->ref_mask]);
+  }
+}
+
+// 64-bit values are stored in two consecutive i32 registers (lo, hi) of the
+// primitive bank. The compiler allocates both as a pair and all register lists
+// include both slots, so only individual ops need to know about the split.
+static inline int64_t iree_vm_bytecode_dispatch_read_i64(
+    const iree_vm_registers_t* regs, uint8_t reg) {
+  uint32_t lo = (uint32_t)regs->i32[reg & regs->i32_mask];
+  uint32_t hi = (uint32_t)regs->i32[(reg + 1) & regs->i32_mask];
+  return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+static inline void iree_vm_bytecode_dispatch_write_i64(
+    iree_vm_registers_t* regs, uint8_t reg, int64_t value) {
+  regs->i32[reg & regs->i32_mask] = (int32_t)(uint32_t)value;
+  regs->i32[(reg + 1) & regs->i32_mask] =
+      (int32_t)(uint32_t)((uint64_t)value >> 32);
+}
+
+// 32-bit floats are stored bit-for-bit in a single i32 register.
+static inline float iree_vm_bytecode_dispatch_read_f32(
+    const iree_vm_registers_t* regs, uint8_t reg) {
+  float value;
+  memcpy(&value, &regs->i32[reg & regs->i32_mask], sizeof(value));
+  return value;
+}
+
+static inline void iree_vm_bytecode_dispatch_write_f32(
+    iree_vm_registers_t* regs, uint8_t reg, float value) {
+  memcpy(&regs->i32[reg & regs->i32_mask], &value, sizeof(value));
+}
+
+// Completes a call into an import by copying its results back to the caller
+// and leaving the callee frame.
+static void iree_vm_bytecode_dispatch_complete_import_call(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* callee_frame,
+    iree_vm_stack_frame_t* caller_frame) {
+  if (callee_frame->return_registers) {
+    iree_vm_bytecode_dispatch_remap_registers(
+        &callee_frame->registers, callee_frame->return_registers,
+        &caller_frame->registers, caller_frame->return_registers);
+  }
+  iree_vm_stack_function_leave(stack);
+}
+
+// Finds the frame execution should resume in for |entry_frame|.
+// Internal calls push frames above the entry frame and a yield may leave any
+// number of them on the stack; execution resumes in the top-most one. If the
+// yield came from within an import |out_import_frame| is set to the bottom-most
+// frame of the import, which must be resumed before continuing in its caller.
+static iree_vm_stack_frame_t* iree_vm_bytecode_dispatch_find_resume_frame(
+    iree_vm_bytecode_module_t* module, iree_vm_stack_t* stack,
+    iree_vm_stack_frame_t* entry_frame,
+    iree_vm_stack_frame_t** out_import_frame) {
+  *out_import_frame = NULL;
+  iree_vm_stack_frame_t* top_frame = iree_vm_stack_current_frame(stack);
+  for (iree_vm_stack_frame_t* frame = top_frame; frame && frame != entry_frame;
+       frame = frame->parent) {
+    if (frame->function.module != &module->interface) {
+      *out_import_frame = frame;
     }
   }
+  if (*out_import_frame) return (*out_import_frame)->parent;
+  return top_frame ? top_frame : entry_frame;
 }
 
 iree_status_t iree_vm_bytecode_dispatch(
@@ -184,6 +313,7 @@ iree_status_t iree_vm_bytecode_dispatch(
 
 #define DISPATCH_OP(op_name, body)                          \
   _dispatch_##op_name : IREE_DISPATCH_LOG_OPCODE(#op_name); \
+  IREE_DISPATCH_PROFILE_OPCODE(op_name);                    \
   body;                                                     \
   goto* kDispatchTable[bytecode_data[offset++]];
 
@@ -203,18 +333,25 @@ iree_status_t iree_vm_bytecode_dispatch(
     VMCHECK(0);              \
     return IREE_STATUS_UNIMPLEMENTED;
 
-#define DISPATCH_OP(op_name, body)      \
-  case IREE_VM_OP_##op_name:            \
-    IREE_DISPATCH_LOG_OPCODE(#op_name); \
-    body;                               \
+#define DISPATCH_OP(op_name, body)         \
+  case IREE_VM_OP_##op_name:               \
+    IREE_DISPATCH_LOG_OPCODE(#op_name);    \
+    IREE_DISPATCH_PROFILE_OPCODE(op_name); \
+    body;                                  \
     break;
 
 #endif  // IREE_DISPATCH_MODE_COMPUTED_GOTO
 
-#define OP_R_I32(i) \
-  regs->i32[bytecode_data[offset + i] & IREE_I32_REGISTER_MASK]
-#define OP_R_REF(i) \
-  regs->ref[bytecode_data[offset + i] & IREE_REF_REGISTER_MASK]
+#define OP_R_I32(i) regs->i32[bytecode_data[offset + i] & regs->i32_mask]
+#define OP_R_I64(i) \
+  iree_vm_bytecode_dispatch_read_i64(regs, bytecode_data[offset + i])
+#define OP_R_I64_SET(i, value) \
+  iree_vm_bytecode_dispatch_write_i64(regs, bytecode_data[offset + i], value)
+#define OP_R_F32(i) \
+  iree_vm_bytecode_dispatch_read_f32(regs, bytecode_data[offset + i])
+#define OP_R_F32_SET(i, value) \
+  iree_vm_bytecode_dispatch_write_f32(regs, bytecode_data[offset + i], value)
+#define OP_R_REF(i) regs->ref[bytecode_data[offset + i] & regs->ref_mask]
 #define OP_R_REF_IS_MOVE(i) \
   (bytecode_data[offset + i] & IREE_REF_REGISTER_MOVE_BIT)
 
@@ -222,6 +359,7 @@ iree_status_t iree_vm_bytecode_dispatch(
 #define OP_I8(i) bytecode_data[offset + i]
 #define OP_I16(i) *((uint16_t*)&bytecode_data[offset + i])
 #define OP_I32(i) *((uint32_t*)&bytecode_data[offset + i])
+#define OP_I64(i) *((uint64_t*)&bytecode_data[offset + i])
 #else
 #define OP_I8(i) bytecode_data[offset + i]
 #define OP_I16(i)                             \
@@ -232,6 +370,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       ((uint32_t)bytecode_data[offset + 1 + i] << 8) |  \
       ((uint32_t)bytecode_data[offset + 2 + i] << 16) | \
       ((uint32_t)bytecode_data[offset + 3 + i] << 24)
+#define OP_I64(i) \
+  ((uint64_t)(OP_I32(i)) | ((uint64_t)(OP_I32(i + 4)) << 32))
 #endif  // IREE_IS_LITTLE_ENDIAN
 
   // Primary dispatch state. This is our 'native stack frame' and really
@@ -241,17 +381,30 @@ iree_status_t iree_vm_bytecode_dispatch(
   // The hope is that the compiler decides to keep these in registers (as
   // they are touched for every instruction executed). The frame will change
   // as we call into different functions.
-  const iree_vm_function_descriptor_t* entry_function_descriptor =
-      &module->function_descriptor_table[entry_frame->function.ordinal];
-  iree_vm_stack_frame_t* current_frame = entry_frame;
+  memset(out_result, 0, sizeof(*out_result));
+
+  // If execution previously yielded we pick up where it left off, first
+  // finishing any import call that was in-flight at the time.
+  iree_vm_stack_frame_t* import_frame = NULL;
+  iree_vm_stack_frame_t* current_frame =
+      iree_vm_bytecode_dispatch_find_resume_frame(module, stack, entry_frame,
+                                                  &import_frame);
+  if (import_frame) {
+    IREE_RETURN_IF_ERROR(import_frame->function.module->execute(
+        import_frame->function.module->self, stack, import_frame, out_result));
+    if (out_result->state == IREE_VM_EXECUTION_YIELDED) {
+      return IREE_STATUS_OK;
+    }
+    iree_vm_bytecode_dispatch_complete_import_call(stack, import_frame,
+                                                   current_frame);
+  }
+
+  const iree_vm_function_descriptor_t* current_function_descriptor =
+      &module->function_descriptor_table[current_frame->function.ordinal];
   const uint8_t* bytecode_data =
-      module->bytecode_data.data + entry_function_descriptor->bytecode_offset;
+      module->bytecode_data.data + current_function_descriptor->bytecode_offset;
   iree_vm_source_offset_t offset = current_frame->offset;
   iree_vm_registers_t* regs = &current_frame->registers;
-  // TODO(benvanik): hide this register initialization logic in the stack enter.
-  regs->ref_register_count = entry_function_descriptor->ref_register_count;
-
-  memset(out_result, 0, sizeof(*out_result));
 
   // NOTE: we should generate this with tblgen, as it has the encoding info.
   // TODO(benvanik): at least generate operand reading/writing and sizes.
@@ -431,6 +584,45 @@ iree_status_t iree_vm_bytecode_dispatch(
       offset += 1;
     });
 
+    DISPATCH_OP(ConstI64, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncIntAttr<"value", type.bitwidth>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_I64_SET(8, (int64_t)OP_I64(0));
+      offset += 8 + 1;
+    });
+
+    DISPATCH_OP(ConstI64Zero, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_ConstI64Zero>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_I64_SET(0, 0);
+      offset += 1;
+    });
+
+    DISPATCH_OP(ConstF32, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncFloatAttr<"value", type.bitwidth>,
+      //   VM_EncResult<"result">,
+      // ];
+      // Floats are encoded bit-for-bit and can be stored directly.
+      OP_R_I32(4) = OP_I32(0);
+      offset += 4 + 1;
+    });
+
+    DISPATCH_OP(ConstF32Zero, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_ConstF32Zero>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_F32_SET(0, 0.0f);
+      offset += 1;
+    });
+
     DISPATCH_OP(ConstRefZero, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_ConstRefZero>,
@@ -447,9 +639,15 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncResult<"value">,
       // ];
       int32_t rodata_ordinal = OP_I32(0);
-      // TODO(benvanik): allow decompression callbacks to run now (if needed).
-      iree_vm_ref_wrap_retain(&module_state->rodata_ref_table[rodata_ordinal],
-                              iree_vm_ro_byte_buffer_type_id(), &OP_R_REF(4));
+      iree_vm_ro_byte_buffer_t* rodata =
+          &module_state->rodata_segment_table[rodata_ordinal].ref;
+      if (!rodata->data.data) {
+        // Compressed or unaligned segments are materialized on first access.
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_state_load_rodata(
+            module_state, rodata_ordinal));
+      }
+      iree_vm_ref_wrap_retain(rodata, iree_vm_ro_byte_buffer_type_id(),
+                              &OP_R_REF(4));
       offset += 4 + 1;
     });
 
@@ -469,6 +667,31 @@ iree_status_t iree_vm_bytecode_dispatch(
       offset += 1 + 1 + 1 + 1;
     });
 
+    DISPATCH_OP(SelectI64, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncOperand<"condition", 0>,
+      //   VM_EncOperand<"true_value", 1>,
+      //   VM_EncOperand<"false_value", 2>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_I64_SET(3, OP_R_I32(0) ? OP_R_I64(1) : OP_R_I64(2));
+      offset += 1 + 1 + 1 + 1;
+    });
+
+    DISPATCH_OP(SelectF32, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncOperand<"condition", 0>,
+      //   VM_EncOperand<"true_value", 1>,
+      //   VM_EncOperand<"false_value", 2>,
+      //   VM_EncResult<"result">,
+      // ];
+      // Floats are moved bit-for-bit and need no conversion.
+      OP_R_I32(3) = OP_R_I32(0) ? OP_R_I32(1) : OP_R_I32(2);
+      offset += 1 + 1 + 1 + 1;
+    });
+
     DISPATCH_OP(SelectRef, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_SelectRef>,
@@ -534,6 +757,51 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_BINARY_ALU_I32(OrI32, uint32_t, |);
     DISPATCH_OP_BINARY_ALU_I32(XorI32, uint32_t, ^);
 
+#define DISPATCH_OP_UNARY_ALU_I64(op_name, type, op)   \
+  DISPATCH_OP(op_name, {                               \
+    OP_R_I64_SET(1, (int64_t)(op((type)OP_R_I64(0)))); \
+    offset += 1 + 1;                                   \
+  });
+
+#define DISPATCH_OP_BINARY_ALU_I64(op_name, type, op)                     \
+  DISPATCH_OP(op_name, {                                                  \
+    OP_R_I64_SET(2, (int64_t)(((type)OP_R_I64(0))op((type)OP_R_I64(1)))); \
+    offset += 1 + 1 + 1;                                                  \
+  });
+
+    DISPATCH_OP_BINARY_ALU_I64(AddI64, int64_t, +);
+    DISPATCH_OP_BINARY_ALU_I64(SubI64, int64_t, -);
+    DISPATCH_OP_BINARY_ALU_I64(MulI64, int64_t, *);
+    DISPATCH_OP_BINARY_ALU_I64(DivI64S, int64_t, /);
+    DISPATCH_OP_BINARY_ALU_I64(DivI64U, uint64_t, /);
+    DISPATCH_OP_BINARY_ALU_I64(RemI64S, int64_t, %);
+    DISPATCH_OP_BINARY_ALU_I64(RemI64U, uint64_t, %);
+    DISPATCH_OP_UNARY_ALU_I64(NotI64, uint64_t, ~);
+    DISPATCH_OP_BINARY_ALU_I64(AndI64, uint64_t, &);
+    DISPATCH_OP_BINARY_ALU_I64(OrI64, uint64_t, |);
+    DISPATCH_OP_BINARY_ALU_I64(XorI64, uint64_t, ^);
+
+    //===------------------------------------------------------------------===//
+    // Native floating-point arithmetic
+    //===------------------------------------------------------------------===//
+
+    // let encoding = [
+    //   VM_EncOpcode<opcode>,
+    //   VM_EncOperand<"lhs", 0>,
+    //   VM_EncOperand<"rhs", 1>,
+    //   VM_EncResult<"result">,
+    // ];
+#define DISPATCH_OP_BINARY_ALU_F32(op_name, op)  \
+  DISPATCH_OP(op_name, {                         \
+    OP_R_F32_SET(2, OP_R_F32(0) op OP_R_F32(1)); \
+    offset += 1 + 1 + 1;                         \
+  });
+
+    DISPATCH_OP_BINARY_ALU_F32(AddF32, +);
+    DISPATCH_OP_BINARY_ALU_F32(SubF32, -);
+    DISPATCH_OP_BINARY_ALU_F32(MulF32, *);
+    DISPATCH_OP_BINARY_ALU_F32(DivF32, /);
+
     //===------------------------------------------------------------------===//
     // Casting and type conversion/emulation
     //===------------------------------------------------------------------===//
@@ -554,6 +822,28 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_CAST_I32(ExtI8I32S, int8_t, int32_t);
     DISPATCH_OP_CAST_I32(ExtI16I32S, int16_t, int32_t);
 
+    DISPATCH_OP(ExtI32I64S, {
+      OP_R_I64_SET(1, (int64_t)OP_R_I32(0));
+      offset += 1 + 1;
+    });
+    DISPATCH_OP(ExtI32I64U, {
+      OP_R_I64_SET(1, (int64_t)(uint32_t)OP_R_I32(0));
+      offset += 1 + 1;
+    });
+    DISPATCH_OP(TruncI64I32, {
+      OP_R_I32(1) = (int32_t)OP_R_I64(0);
+      offset += 1 + 1;
+    });
+    DISPATCH_OP(CastSI32F32, {
+      OP_R_F32_SET(1, (float)OP_R_I32(0));
+      offset += 1 + 1;
+    });
+    DISPATCH_OP(CastF32SI32, {
+      // NOTE: C truncates toward zero, matching the op definition.
+      OP_R_I32(1) = (int32_t)OP_R_F32(0);
+      offset += 1 + 1;
+    });
+
     //===------------------------------------------------------------------===//
     // Native bitwise shifts and rotates
     //===------------------------------------------------------------------===//
@@ -574,6 +864,16 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_SHIFT_I32(ShrI32S, int32_t, >>);
     DISPATCH_OP_SHIFT_I32(ShrI32U, uint32_t, >>);
 
+#define DISPATCH_OP_SHIFT_I64(op_name, type, op)                \
+  DISPATCH_OP(op_name, {                                        \
+    OP_R_I64_SET(2, (int64_t)(((type)OP_R_I64(0))op OP_I8(1))); \
+    offset += 1 + 1 + 1;                                        \
+  });
+
+    DISPATCH_OP_SHIFT_I64(ShlI64, int64_t, <<);
+    DISPATCH_OP_SHIFT_I64(ShrI64S, int64_t, >>);
+    DISPATCH_OP_SHIFT_I64(ShrI64U, uint64_t, >>);
+
     //===------------------------------------------------------------------===//
     // Comparison ops
     //===------------------------------------------------------------------===//
@@ -601,6 +901,38 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_CMP_I32(CmpGTEI32S, int32_t, >=);
     DISPATCH_OP_CMP_I32(CmpGTEI32U, uint32_t, >=);
 
+#define DISPATCH_OP_CMP_I64(op_name, type, op)                        \
+  DISPATCH_OP(op_name, {                                              \
+    OP_R_I32(2) = (((type)OP_R_I64(0))op((type)OP_R_I64(1))) ? 1 : 0; \
+    offset += 1 + 1 + 1;                                              \
+  });
+
+    DISPATCH_OP_CMP_I64(CmpEQI64, int64_t, ==);
+    DISPATCH_OP_CMP_I64(CmpNEI64, int64_t, !=);
+    DISPATCH_OP_CMP_I64(CmpLTI64S, int64_t, <);
+    DISPATCH_OP_CMP_I64(CmpLTI64U, uint64_t, <);
+    DISPATCH_OP_CMP_I64(CmpLTEI64S, int64_t, <=);
+    DISPATCH_OP_CMP_I64(CmpLTEI64U, uint64_t, <=);
+    DISPATCH_OP_CMP_I64(CmpGTI64S, int64_t, >);
+    DISPATCH_OP_CMP_I64(CmpGTI64U, uint64_t, >);
+    DISPATCH_OP_CMP_I64(CmpGTEI64S, int64_t, >=);
+    DISPATCH_OP_CMP_I64(CmpGTEI64U, uint64_t, >=);
+
+    // NOTE: C comparisons are ordered except for != which is unordered,
+    // matching the op definitions.
+#define DISPATCH_OP_CMP_F32(op_name, op)                \
+  DISPATCH_OP(op_name, {                                \
+    OP_R_I32(2) = (OP_R_F32(0) op OP_R_F32(1)) ? 1 : 0; \
+    offset += 1 + 1 + 1;                                \
+  });
+
+    DISPATCH_OP_CMP_F32(CmpEQF32, ==);
+    DISPATCH_OP_CMP_F32(CmpNEF32, !=);
+    DISPATCH_OP_CMP_F32(CmpLTF32, <);
+    DISPATCH_OP_CMP_F32(CmpLTEF32, <=);
+    DISPATCH_OP_CMP_F32(CmpGTF32, >);
+    DISPATCH_OP_CMP_F32(CmpGTEF32, >=);
+
     DISPATCH_OP(CmpEQRef, {
       // let encoding = [
       //   VM_EncOpcode<opcode>,
@@ -650,7 +982,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t block_offset = OP_I32(0);
       const iree_vm_register_remap_list_t* remap_list =
           (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 4];
-      offset += 4 + 1 + remap_list->size * 2;
+      offset += 4 + IREE_VM_REMAP_LIST_SIZE(remap_list);
       offset = block_offset;
       iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
     });
@@ -667,11 +999,11 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t true_block_offset = OP_I32(1);
       const iree_vm_register_remap_list_t* true_remap_list =
           (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 1 + 4];
-      offset += 1 + 4 + 1 + true_remap_list->size * 2;
+      offset += 1 + 4 + IREE_VM_REMAP_LIST_SIZE(true_remap_list);
       int32_t false_block_offset = OP_I32(0);
       const iree_vm_register_remap_list_t* false_remap_list =
           (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 4];
-      offset += 4 + 1 + false_remap_list->size * 2;
+      offset += 4 + IREE_VM_REMAP_LIST_SIZE(false_remap_list);
 
       if (cond_value) {
         offset = true_block_offset;
@@ -683,19 +1015,52 @@ iree_status_t iree_vm_bytecode_dispatch(
       }
     });
 
+    // Fused compare-and-branch superinstructions:
+    // let encoding = [
+    //   VM_EncOpcode<opcode>,
+    //   VM_EncOperand<"lhs", 0>,
+    //   VM_EncOperand<"rhs", 1>,
+    //   VM_EncBranch<"getTrueDest", "getTrueOperands", 0>,
+    //   VM_EncBranch<"getFalseDest", "getFalseOperands", 1>,
+    // ];
+#define DISPATCH_OP_COND_BRANCH_CMP_I32(op_name, type, op)                    \
+  DISPATCH_OP(op_name, {                                                      \
+    int cond_value = ((type)OP_R_I32(0))op((type)OP_R_I32(1));                \
+    int32_t true_block_offset = OP_I32(2);                                    \
+    const iree_vm_register_remap_list_t* true_remap_list =                    \
+        (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 2 + 4]; \
+    offset += 2 + 4 + IREE_VM_REMAP_LIST_SIZE(true_remap_list);               \
+    int32_t false_block_offset = OP_I32(0);                                   \
+    const iree_vm_register_remap_list_t* false_remap_list =                   \
+        (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 4];     \
+    if (cond_value) {                                                         \
+      offset = true_block_offset;                                             \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs,                  \
+                                                       true_remap_list);      \
+    } else {                                                                  \
+      offset = false_block_offset;                                            \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs,                  \
+                                                       false_remap_list);     \
+    }                                                                         \
+  });
+
+    DISPATCH_OP_COND_BRANCH_CMP_I32(CondBranchCmpEQI32, int32_t, ==);
+    DISPATCH_OP_COND_BRANCH_CMP_I32(CondBranchCmpLTI32S, int32_t, <);
+    DISPATCH_OP_COND_BRANCH_CMP_I32(CondBranchCmpLTI32U, uint32_t, <);
+
     DISPATCH_OP(Call, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_Call>,
       //   VM_EncFuncAttr<"callee">,
-      //   VM_EncVariadicOperands<"operands">,
+      //   VM_EncSplitVariadicOperands<"operands">,
       //   VM_EncVariadicResults<"results">,
       // ];
 
       // Get argument and result register lists and flush the caller frame.
       int32_t function_ordinal = OP_I32(0);
-      const iree_vm_register_list_t* src_reg_list =
-          (const iree_vm_register_list_t*)&bytecode_data[offset + 4];
-      offset += 4 + 1 + src_reg_list->size;
+      const iree_vm_register_split_list_t* src_reg_list =
+          (const iree_vm_register_split_list_t*)&bytecode_data[offset + 4];
+      offset += 4 + 2 + src_reg_list->size;
       const iree_vm_register_list_t* dst_reg_list =
           (const iree_vm_register_list_t*)&bytecode_data[offset];
       current_frame->return_registers = dst_reg_list;
@@ -712,9 +1077,13 @@ iree_status_t iree_vm_bytecode_dispatch(
             module_state->import_table[function_ordinal & 0x7FFFFFFFu];
       } else {
         // Internal to the current module.
+        const iree_vm_function_descriptor_t* target_descriptor =
+            &module->function_descriptor_table[function_ordinal];
         target_function.module = &module->interface;
         target_function.linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
         target_function.ordinal = function_ordinal;
+        iree_vm_bytecode_function_set_register_counts(target_descriptor,
+                                                      &target_function);
       }
 
       IREE_DISPATCH_LOG_CALL(target_function);
@@ -738,12 +1107,12 @@ iree_status_t iree_vm_bytecode_dispatch(
           // TODO(benvanik): set execution result to failure/capture stack.
           return call_status;
         }
-        if (callee_frame->return_registers) {
-          iree_vm_bytecode_dispatch_remap_registers(
-              &callee_frame->registers, callee_frame->return_registers,
-              &current_frame->registers, current_frame->return_registers);
+        if (out_result->state == IREE_VM_EXECUTION_YIELDED) {
+          // The call will be completed when execution is resumed.
+          return IREE_STATUS_OK;
         }
-        iree_vm_stack_function_leave(stack);
+        iree_vm_bytecode_dispatch_complete_import_call(stack, callee_frame,
+                                                       current_frame);
       } else {
         // Switch execution to the target function and continue running in the
         // bytecode dispatcher.
@@ -753,12 +1122,6 @@ iree_status_t iree_vm_bytecode_dispatch(
         bytecode_data =
             module->bytecode_data.data + function_descriptor->bytecode_offset;
         regs = &callee_frame->registers;
-        // TODO(benvanik): hide this in the stack.
-        memset(
-            &regs->ref[regs->ref_register_count], 0,
-            sizeof(iree_vm_ref_t) * (function_descriptor->ref_register_count -
-                                     regs->ref_register_count));
-        regs->ref_register_count = function_descriptor->ref_register_count;
         offset = callee_frame->offset;
       }
     });
@@ -768,7 +1131,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncOpcode<VM_OPC_CallVariadic>,
       //   VM_EncFuncAttr<"callee">,
       //   VM_EncIntArrayAttr<"segment_sizes", 8>,
-      //   VM_EncVariadicOperands<"operands">,
+      //   VM_EncSplitVariadicOperands<"operands">,
       //   VM_EncVariadicResults<"results">,
       // ];
 
@@ -781,9 +1144,9 @@ iree_status_t iree_vm_bytecode_dispatch(
       const iree_vm_register_list_t* seg_size_list =
           (const iree_vm_register_list_t*)&bytecode_data[offset];
       offset += 1 + seg_size_list->size;
-      const iree_vm_register_list_t* src_reg_list =
-          (const iree_vm_register_list_t*)&bytecode_data[offset];
-      offset += 1 + src_reg_list->size;
+      const iree_vm_register_split_list_t* src_reg_list =
+          (const iree_vm_register_split_list_t*)&bytecode_data[offset];
+      offset += 2 + src_reg_list->size;
       const iree_vm_register_list_t* dst_reg_list =
           (const iree_vm_register_list_t*)&bytecode_data[offset];
       current_frame->return_registers = dst_reg_list;
@@ -826,12 +1189,12 @@ iree_status_t iree_vm_bytecode_dispatch(
         // TODO(benvanik): set execution result to failure/capture stack.
         return call_status;
       }
-      if (callee_frame->return_registers) {
-        iree_vm_bytecode_dispatch_remap_registers(
-            &callee_frame->registers, callee_frame->return_registers,
-            &current_frame->registers, current_frame->return_registers);
+      if (out_result->state == IREE_VM_EXECUTION_YIELDED) {
+        // The call will be completed when execution is resumed.
+        return IREE_STATUS_OK;
       }
-      iree_vm_stack_function_leave(stack);
+      iree_vm_bytecode_dispatch_complete_import_call(stack, callee_frame,
+                                                     current_frame);
     });
 
     DISPATCH_OP(Return, {
@@ -882,7 +1245,10 @@ iree_status_t iree_vm_bytecode_dispatch(
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_Yield>,
       // ];
-      // TODO(benvanik): yield with execution results.
+      // Store the offset of the next op so that we resume after the yield.
+      // All other state is already in the stack.
+      current_frame->offset = offset;
+      out_result->state = IREE_VM_EXECUTION_YIELDED;
       return IREE_STATUS_OK;
     });
 
@@ -933,7 +1299,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t block_offset = OP_I32(0);
       const iree_vm_register_remap_list_t* remap_list =
           (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 4];
-      offset += 4 + 1 + remap_list->size * 2;
+      offset += 4 + IREE_VM_REMAP_LIST_SIZE(remap_list);
       iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
       offset = block_offset;
     });
@@ -950,7 +1316,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t block_offset = OP_I32(1);
       const iree_vm_register_remap_list_t* remap_list =
           (const iree_vm_register_remap_list_t*)&bytecode_data[offset + 1 + 4];
-      offset += 1 + 4 + 1 + remap_list->size * 2;
+      offset += 1 + 4 + IREE_VM_REMAP_LIST_SIZE(remap_list);
       iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
       offset = block_offset;
     });
@@ -19,7 +19,9 @@
 // that we can't run the full MLIR compiler stack on.
 
 #include "absl/strings/match.h"
+#include "iree/base/file_io.h"
 #include "iree/base/logging.h"
+#include "iree/base/status_matchers.h"
 #include "iree/testing/gtest.h"
 #include "iree/vm/bytecode_dispatch_test_module.h"
 #include "iree/vm/bytecode_module.h"
@@ -27,6 +29,9 @@
 #include "iree/vm/instance.h"
 #include "iree/vm/invocation.h"
 #include "iree/vm/module.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/types.h"
+#include "iree/vm/variant_list.h"
 
 namespace {
 
@@ -64,6 +69,16 @@ std::vector<TestParams> GetModuleTestParams() {
   return function_names;
 }
 
+// Checks the results of a function that completed successfully. Functions
+// returning an i32 as their first result must return a nonzero value to
+// indicate that the values they computed were as expected.
+void ExpectValidResults(iree_vm_variant_list_t* outputs) {
+  if (iree_vm_variant_list_size(outputs) == 0) return;
+  iree_vm_variant_t* result = iree_vm_variant_list_get(outputs, 0);
+  if (result->value_type != IREE_VM_VALUE_TYPE_I32) return;
+  EXPECT_NE(0, result->i32) << "Function returned an unexpected value";
+}
+
 class VMBytecodeDispatchTest
     : public ::testing::Test,
       public ::testing::WithParamInterface<TestParams> {
@@ -100,9 +115,45 @@ class VMBytecodeDispatchTest
         &function))
         << "Exported function '" << function_name << "' not found";
 
-    return iree_vm_invoke(context_, function,
-                          /*policy=*/nullptr, /*inputs=*/nullptr,
-                          /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM);
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_CHECK_OK(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+    iree_status_t status =
+        iree_vm_invoke(context_, function, /*policy=*/nullptr,
+                       /*inputs=*/nullptr, outputs, IREE_ALLOCATOR_SYSTEM);
+    if (iree_status_is_ok(status)) ExpectValidResults(outputs);
+    iree_vm_variant_list_free(outputs);
+    return status;
+  }
+
+  // Runs the function as a resumable invocation, resuming it each time it
+  // yields. |out_yield_count| is set to the number of times it yielded.
+  iree_status_t RunResumableFunction(absl::string_view function_name,
+                                     int* out_yield_count) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(bytecode_module_->lookup_function(
+        bytecode_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, function, /*policy=*/nullptr, /*inputs=*/nullptr,
+        IREE_ALLOCATOR_SYSTEM, &invocation));
+    *out_yield_count = 0;
+    iree_status_t status = iree_vm_invocation_resume(invocation);
+    while (status == IREE_STATUS_UNAVAILABLE) {
+      ++*out_yield_count;
+      status = iree_vm_invocation_resume(invocation);
+    }
+    EXPECT_EQ(status, iree_vm_invocation_query_status(invocation));
+    if (iree_status_is_ok(status)) {
+      ExpectValidResults(const_cast<iree_vm_variant_list_t*>(
+          iree_vm_invocation_output(invocation)));
+    }
+    iree_vm_invocation_release(invocation);
+    return status;
   }
 
   iree_vm_instance_t* instance_ = nullptr;
@@ -131,8 +182,259 @@ TEST_P(VMBytecodeDispatchTest, Check) {
   }
 }
 
+TEST_P(VMBytecodeDispatchTest, CheckResumable) {
+  const auto& test_params = GetParam();
+  bool expect_failure = absl::StartsWith(test_params.function_name, "fail_");
+  bool expect_yield = absl::StartsWith(test_params.function_name, "yield_");
+
+  int yield_count = 0;
+  iree_status_t result =
+      RunResumableFunction(test_params.function_name, &yield_count);
+  EXPECT_EQ(expect_failure, !iree_status_is_ok(result)) << result;
+  EXPECT_EQ(expect_yield, yield_count > 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMBytecodeDispatchTest,
                          ::testing::ValuesIn(GetModuleTestParams()),
                          ::testing::PrintToStringParamName());
 
+// Tests that rodata references returned from multiple contexts remain valid
+// after the contexts and the module that produced them have been released.
+TEST(VMBytecodeModuleStateTest, RodataRefsOutliveContexts) {
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance));
+  const auto* module_file_toc =
+      iree::vm::bytecode_dispatch_test_module_create();
+  iree_vm_module_t* module = nullptr;
+  IREE_ASSERT_OK(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file_toc->data),
+          module_file_toc->size},
+      IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &module));
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(module->lookup_function(
+      module->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      iree_make_cstring_view("rodata_ref"), &function));
+
+  iree_vm_ref_t refs[2];
+  memset(refs, 0, sizeof(refs));
+  for (int i = 0; i < 2; ++i) {
+    iree_vm_context_t* context = nullptr;
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance, &module, 1, IREE_ALLOCATOR_SYSTEM, &context));
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_ASSERT_OK(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+    IREE_ASSERT_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                  /*inputs=*/nullptr, outputs,
+                                  IREE_ALLOCATOR_SYSTEM));
+    iree_vm_ref_retain(&iree_vm_variant_list_get(outputs, 0)->ref, &refs[i]);
+    iree_vm_variant_list_free(outputs);
+    iree_vm_context_release(context);
+  }
+  iree_vm_module_release(module);
+
+  for (int i = 0; i < 2; ++i) {
+    iree_vm_ro_byte_buffer_t* buffer = iree_vm_ro_byte_buffer_deref(&refs[i]);
+    ASSERT_NE(nullptr, buffer);
+    ASSERT_EQ(4, buffer->data.data_length);
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_EQ(j + 1, buffer->data.data[j]);
+    }
+    iree_vm_ref_release(&refs[i]);
+  }
+  iree_vm_instance_release(instance);
+}
+
+// Tests loading the module from a file with each of the file flags. The file is
+// deleted as soon as the module is loaded so that everything after that must
+// come from the mapping, which must remain valid for as long as any rodata
+// reference into it is retained.
+class VMBytecodeModuleFileTest
+    : public ::testing::TestWithParam<iree_vm_bytecode_module_file_flags_t> {
+};
+
+TEST_P(VMBytecodeModuleFileTest, CreateFromFile) {
+  const auto* module_file_toc =
+      iree::vm::bytecode_dispatch_test_module_create();
+  ASSERT_OK_AND_ASSIGN(auto path,
+                       iree::file_io::GetTempFile("bytecode_module"));
+  ASSERT_OK(iree::file_io::SetFileContents(
+      path, std::string(module_file_toc->data, module_file_toc->size)));
+
+  iree_vm_module_t* module = nullptr;
+  IREE_ASSERT_OK(iree_vm_bytecode_module_create_from_file(
+      iree_string_view_t{path.data(), path.size()}, GetParam(),
+      IREE_ALLOCATOR_SYSTEM, &module));
+  ASSERT_OK(iree::file_io::DeleteFile(path));
+
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance));
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+      instance, &module, 1, IREE_ALLOCATOR_SYSTEM, &context));
+
+  // Run a function from the mapped bytecode and check its result.
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(module->lookup_function(module->self,
+                                         IREE_VM_FUNCTION_LINKAGE_EXPORT,
+                                         iree_make_cstring_view("i64_ops"),
+                                         &function));
+  iree_vm_variant_list_t* outputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+  IREE_ASSERT_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                /*inputs=*/nullptr, outputs,
+                                IREE_ALLOCATOR_SYSTEM));
+  ASSERT_EQ(1, iree_vm_variant_list_size(outputs));
+  EXPECT_EQ(1, iree_vm_variant_list_get(outputs, 0)->i32);
+  iree_vm_variant_list_free(outputs);
+
+  // Retain a reference to rodata served from the mapping.
+  IREE_ASSERT_OK(module->lookup_function(module->self,
+                                         IREE_VM_FUNCTION_LINKAGE_EXPORT,
+                                         iree_make_cstring_view("rodata_ref"),
+                                         &function));
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+  IREE_ASSERT_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                /*inputs=*/nullptr, outputs,
+                                IREE_ALLOCATOR_SYSTEM));
+  iree_vm_ref_t ref;
+  memset(&ref, 0, sizeof(ref));
+  iree_vm_ref_retain(&iree_vm_variant_list_get(outputs, 0)->ref, &ref);
+  iree_vm_variant_list_free(outputs);
+
+  iree_vm_context_release(context);
+  iree_vm_module_release(module);
+  iree_vm_instance_release(instance);
+
+  iree_vm_ro_byte_buffer_t* buffer = iree_vm_ro_byte_buffer_deref(&ref);
+  ASSERT_NE(nullptr, buffer);
+  ASSERT_EQ(4, buffer->data.data_length);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i + 1, buffer->data.data[i]);
+  }
+  iree_vm_ref_release(&ref);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FileFlags, VMBytecodeModuleFileTest,
+    ::testing::Values(IREE_VM_BYTECODE_MODULE_FILE_DEFAULT,
+                      IREE_VM_BYTECODE_MODULE_FILE_ADVISE_BYTECODE,
+                      IREE_VM_BYTECODE_MODULE_FILE_PREFAULT_BYTECODE,
+                      IREE_VM_BYTECODE_MODULE_FILE_PREFAULT_ALL));
+
+class VMInvocationAwaitTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+    const auto* module_file_toc =
+        iree::vm::bytecode_dispatch_test_module_create();
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_const_byte_span_t{
+            reinterpret_cast<const uint8_t*>(module_file_toc->data),
+            module_file_toc->size},
+        IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &bytecode_module_))
+        << "Bytecode module failed to load";
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &bytecode_module_, 1, IREE_ALLOCATOR_SYSTEM, &context_));
+
+    // Yields exactly twice before returning 1.
+    iree_vm_function_t function;
+    IREE_CHECK_OK(bytecode_module_->lookup_function(
+        bytecode_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_make_cstring_view("yield_sequence"), &function));
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, function, /*policy=*/nullptr, /*inputs=*/nullptr,
+        IREE_ALLOCATOR_SYSTEM, &invocation_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_invocation_release(invocation_);
+    iree_vm_module_release(bytecode_module_);
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Expects that the invocation completed and returned 1.
+  void ExpectCompleted() {
+    IREE_ASSERT_OK(iree_vm_invocation_query_status(invocation_));
+    const iree_vm_variant_list_t* outputs =
+        iree_vm_invocation_output(invocation_);
+    ASSERT_NE(nullptr, outputs);
+    auto* mutable_outputs = const_cast<iree_vm_variant_list_t*>(outputs);
+    ASSERT_EQ(1, iree_vm_variant_list_size(mutable_outputs));
+    iree_vm_variant_t* result = iree_vm_variant_list_get(mutable_outputs, 0);
+    ASSERT_EQ(IREE_VM_VALUE_TYPE_I32, static_cast<int>(result->value_type));
+    EXPECT_EQ(1, result->i32);
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_module_t* bytecode_module_ = nullptr;
+  iree_vm_invocation_t* invocation_ = nullptr;
+};
+
+TEST_F(VMInvocationAwaitTest, InfiniteFuture) {
+  IREE_ASSERT_OK(
+      iree_vm_invocation_await(invocation_, IREE_TIME_INFINITE_FUTURE));
+  ExpectCompleted();
+}
+
+TEST_F(VMInvocationAwaitTest, FiniteFuture) {
+  iree_time_t deadline = iree_time_now() + 60 * 1000000000ll;
+  IREE_ASSERT_OK(iree_vm_invocation_await(invocation_, deadline));
+  ExpectCompleted();
+}
+
+// Polling resumes once per call so the invocation completes on the call after
+// its second yield.
+TEST_F(VMInvocationAwaitTest, InfinitePastPolls) {
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(IREE_STATUS_DEADLINE_EXCEEDED,
+              iree_vm_invocation_await(invocation_, IREE_TIME_INFINITE_PAST));
+    EXPECT_EQ(IREE_STATUS_UNAVAILABLE,
+              iree_vm_invocation_query_status(invocation_));
+  }
+  IREE_ASSERT_OK(
+      iree_vm_invocation_await(invocation_, IREE_TIME_INFINITE_PAST));
+  ExpectCompleted();
+}
+
+// An elapsed finite deadline must not resume the invocation at all.
+TEST_F(VMInvocationAwaitTest, ElapsedDeadline) {
+  iree_time_t deadline = iree_time_now() - 1;
+  EXPECT_EQ(IREE_STATUS_DEADLINE_EXCEEDED,
+            iree_vm_invocation_await(invocation_, deadline));
+  EXPECT_EQ(IREE_STATUS_UNAVAILABLE,
+            iree_vm_invocation_query_status(invocation_));
+
+  // All yields remain and the invocation can still run to completion.
+  int yield_count = 0;
+  iree_status_t status = iree_vm_invocation_resume(invocation_);
+  while (status == IREE_STATUS_UNAVAILABLE) {
+    ++yield_count;
+    status = iree_vm_invocation_resume(invocation_);
+  }
+  IREE_ASSERT_OK(status);
+  EXPECT_EQ(2, yield_count);
+  ExpectCompleted();
+}
+
+// Awaiting a completed invocation returns its status regardless of deadline.
+TEST_F(VMInvocationAwaitTest, Completed) {
+  IREE_ASSERT_OK(
+      iree_vm_invocation_await(invocation_, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK(iree_vm_invocation_await(invocation_, iree_time_now() - 1));
+  ExpectCompleted();
+}
+
+TEST_F(VMInvocationAwaitTest, Aborted) {
+  IREE_ASSERT_OK(iree_vm_invocation_abort(invocation_));
+  EXPECT_EQ(IREE_STATUS_ABORTED,
+            iree_vm_invocation_await(invocation_, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation_));
+}
+
 }  // namespace
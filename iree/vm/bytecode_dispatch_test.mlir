@@ -1,6 +1,9 @@
 // These test functions are called by the bytecode_dispatch_test.cc runner.
 // The prefix of fail_ can be used to denote that the test is expected to fail
-// (error returned from dispatch).
+// (error returned from dispatch) and yield_ that the test is expected to yield
+// at least once. Functions returning an i32 as their first result must return
+// a nonzero value (such as the result of comparing a computed value against
+// the expected one) for the test to pass.
 vm.module @bytecode_dispatch_test {
   // Tests that an empty function (0 args, 0 results, 0 ops) works.
   vm.export @empty
@@ -8,5 +11,145 @@ vm.module @bytecode_dispatch_test {
     vm.return
   }
 
+  // Tests that i64 values spanning register pairs can be produced, including
+  // a carry from the low into the high half, and passed across calls.
+  vm.export @i64_ops
+  vm.func @i64_ops() -> i32 {
+    %c1 = vm.const.i64 4294967295 : i64
+    %c2 = vm.const.i64 1 : i64
+    %0 = vm.call @i64_add(%c1, %c2) : (i64, i64) -> i64
+    %expected = vm.const.i64 4294967296 : i64
+    %eq = vm.cmp.eq.i64 %0, %expected : i64
+    vm.return %eq : i32
+  }
+  vm.func @i64_add(%a : i64, %b : i64) -> i64 attributes {noinline} {
+    %0 = vm.add.i64 %a, %b : i64
+    vm.return %0 : i64
+  }
+
+  // Tests that swapping i64 block arguments, which are moved as their 32-bit
+  // halves, preserves both values.
+  vm.export @i64_branch_swap
+  vm.func @i64_branch_swap() -> i32 {
+    %c0 = vm.const.i32.zero : i32
+    %c1 = vm.const.i32 1 : i32
+    %c2 = vm.const.i32 2 : i32
+    %a0 = vm.const.i64 4294967297 : i64
+    %b0 = vm.const.i64 8589934594 : i64
+    vm.br ^loop(%c0, %a0, %b0 : i32, i64, i64)
+  ^loop(%i : i32, %a : i64, %b : i64):
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %c2 : i32
+    vm.cond_br %cmp, ^loop(%in, %b, %a : i32, i64, i64),
+                     ^exit(%a, %b : i64, i64)
+  ^exit(%a1 : i64, %b1 : i64):
+    // Swapped once.
+    %a_eq = vm.cmp.eq.i64 %a1, %b0 : i64
+    %b_eq = vm.cmp.eq.i64 %b1, %a0 : i64
+    %eq = vm.and.i32 %a_eq, %b_eq : i32
+    vm.return %eq : i32
+  }
+
+  // Tests that f32 values can be produced and passed across calls.
+  vm.export @f32_ops
+  vm.func @f32_ops() -> i32 {
+    %c1 = vm.const.f32 1.5 : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %0 = vm.call @f32_mul(%c1, %c2) : (f32, f32) -> f32
+    %expected = vm.const.f32 3.0 : f32
+    %eq = vm.cmp.eq.f32 %0, %expected : f32
+    vm.return %eq : i32
+  }
+  vm.func @f32_mul(%a : f32, %b : f32) -> f32 attributes {noinline} {
+    %0 = vm.mul.f32 %a, %b : f32
+    vm.return %0 : f32
+  }
+
+  // Tests that execution resumes after each yield with registers preserved.
+  // Yields exactly twice.
+  vm.export @yield_sequence
+  vm.func @yield_sequence() -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %c3 = vm.const.i32 3 : i32
+    %0 = vm.add.i32 %c1, %c1 : i32
+    vm.yield
+    %1 = vm.add.i32 %0, %c1 : i32
+    vm.yield
+    %eq = vm.cmp.eq.i32 %1, %c3 : i32
+    vm.return %eq : i32
+  }
+
+  // Tests that yields within internal calls resume in the callee and then
+  // return to the caller with the callee results.
+  vm.export @yield_in_call
+  vm.func @yield_in_call() -> i32 {
+    %c41 = vm.const.i32 41 : i32
+    %0 = vm.call @yield_and_add_one(%c41) : (i32) -> i32
+    %c42 = vm.const.i32 42 : i32
+    %eq = vm.cmp.eq.i32 %0, %c42 : i32
+    vm.return %eq : i32
+  }
+  vm.func @yield_and_add_one(%arg0 : i32) -> i32 attributes {noinline} {
+    vm.yield
+    %c1 = vm.const.i32 1 : i32
+    %0 = vm.add.i32 %arg0, %c1 : i32
+    vm.return %0 : i32
+  }
+
+  // Tests that loops using fused compare-and-branch superinstructions (and the
+  // operand/target swapping used to form them) terminate after the expected
+  // number of iterations.
+  vm.export @loop_cmp_branch
+  vm.func @loop_cmp_branch() -> i32 {
+    %c0 = vm.const.i32.zero : i32
+    %c1 = vm.const.i32 1 : i32
+    %c10 = vm.const.i32 10 : i32
+    vm.br ^loop_lt(%c0 : i32)
+  ^loop_lt(%i : i32):
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp_lt = vm.cmp.lt.i32.s %in, %c10 : i32
+    vm.cond_br %cmp_lt, ^loop_lt(%in : i32), ^loop_gte(%c0 : i32)
+  ^loop_gte(%j : i32):
+    %jn = vm.add.i32 %j, %c1 : i32
+    %cmp_gte = vm.cmp.gte.i32.u %jn, %c10 : i32
+    vm.cond_br %cmp_gte, ^loop_ne(%c0 : i32), ^loop_gte(%jn : i32)
+  ^loop_ne(%k : i32):
+    %kn = vm.add.i32 %k, %c1 : i32
+    %cmp_ne = vm.cmp.ne.i32 %kn, %c10 : i32
+    vm.cond_br %cmp_ne, ^loop_ne(%kn : i32), ^exit(%kn : i32)
+  ^exit(%result : i32):
+    %eq = vm.cmp.eq.i32 %result, %c10 : i32
+    vm.return %eq : i32
+  }
+
+  // Tests that calls with interleaved i32 and ref arguments assign each bank
+  // its argument registers in order.
+  vm.export @call_mixed_args
+  vm.func @call_mixed_args() -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %null = vm.const.ref.zero : !vm.ref<?>
+    %c3 = vm.const.i32 3 : i32
+    %0 = vm.call @mixed_args(%c1, %null, %c3, %null) :
+        (i32, !vm.ref<?>, i32, !vm.ref<?>) -> i32
+    // Swapped or misassigned arguments produce -2 or 0.
+    %c2 = vm.const.i32 2 : i32
+    %eq = vm.cmp.eq.i32 %0, %c2 : i32
+    vm.return %eq : i32
+  }
+  vm.func @mixed_args(%a : i32, %r0 : !vm.ref<?>, %b : i32,
+                      %r1 : !vm.ref<?>) -> i32 attributes {noinline} {
+    %0 = vm.sub.i32 %b, %a : i32
+    vm.return %0 : i32
+  }
+
+  // Returns a reference to a rodata segment. The runner checks that the
+  // reference remains valid after the context that produced it is freed.
+  vm.rodata @rodata_segment dense<[1, 2, 3, 4]> : vector<4xi8>
+  vm.export @rodata_ref
+  vm.func @rodata_ref() -> !vm.ref<!iree.byte_buffer> {
+    %0 = vm.const.ref.rodata @rodata_segment : !vm.ref<!iree.byte_buffer>
+    vm.return %0 : !vm.ref<!iree.byte_buffer>
+  }
+
   // TODO(benvanik): more tests.
 }
@@ -16,7 +16,11 @@
 
 #include <string.h>
 
+#include <string>
+
 #include "iree/base/api.h"
+#include "iree/base/api_util.h"
+#include "iree/base/file_mapping.h"
 #include "iree/base/flatbuffer_util.h"
 #include "iree/vm/bytecode_module_impl.h"
 #include "iree/vm/ref.h"
@@ -45,6 +49,10 @@ static iree_vm_type_def_t iree_vm_bytecode_module_resolve_type(
   memset(&result, 0, sizeof(result));
   if (full_name == "i32") {
     result.value_type = IREE_VM_VALUE_TYPE_I32;
+  } else if (full_name == "i64") {
+    result.value_type = IREE_VM_VALUE_TYPE_I64;
+  } else if (full_name == "f32") {
+    result.value_type = IREE_VM_VALUE_TYPE_F32;
   } else if (!full_name.empty() && full_name[0] == '!') {
     full_name.remove_prefix(1);
     const iree_vm_ref_type_descriptor_t* type_descriptor =
@@ -73,6 +81,23 @@ static iree_status_t iree_vm_bytecode_module_resolve_types(
   return IREE_STATUS_OK;
 }
 
+// Verifies that all types referenced by |signature| are in the type table.
+static iree_status_t iree_vm_bytecode_module_verify_signature(
+    const iree::vm::BytecodeModuleDef* module_def,
+    const iree::vm::FunctionSignatureDef* signature) {
+  for (const auto* types :
+       {signature->argument_types(), signature->result_types()}) {
+    if (!types) continue;
+    for (int32_t type_ordinal : *types) {
+      if (type_ordinal < 0 || type_ordinal >= module_def->types()->size()) {
+        LOG(ERROR) << "Out-of-bounds reference to a type in the type table.";
+        return IREE_STATUS_INVALID_ARGUMENT;
+      }
+    }
+  }
+  return IREE_STATUS_OK;
+}
+
 // Verifies the structure of the flatbuffer so that we can avoid doing so during
 // runtime. There are still some conditions we must be aware of (such as omitted
 // names on functions with internal linkage), however we shouldn't need to
@@ -115,6 +140,54 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     return IREE_STATUS_INVALID_ARGUMENT;
   }
 
+  if (module_def->rodata_segments()) {
+    for (int i = 0; i < module_def->rodata_segments()->size(); ++i) {
+      auto* segment = module_def->rodata_segments()->Get(i);
+      if (!segment || !segment->data()) {
+        LOG(ERROR) << "All rodata segments must have data.";
+        return IREE_STATUS_INVALID_ARGUMENT;
+      }
+      uint32_t alignment = segment->alignment();
+      if (alignment > 4096 || (alignment & (alignment - 1)) != 0) {
+        LOG(ERROR) << "Rodata segment alignment must be a power of two no "
+                      "greater than 4096.";
+        return IREE_STATUS_INVALID_ARGUMENT;
+      }
+      switch (segment->compression_type_type()) {
+        case iree::vm::CompressionTypeDef::NONE:
+        case iree::vm::CompressionTypeDef::UncompressedDataDef:
+          break;
+        case iree::vm::CompressionTypeDef::RunLengthEncodedDataDef: {
+          const auto* compression_def =
+              segment->compression_type_as_RunLengthEncodedDataDef();
+          if (!compression_def) {
+            LOG(ERROR) << "Run-length encoded rodata requires a size.";
+            return IREE_STATUS_INVALID_ARGUMENT;
+          }
+          // Each 2 encoded bytes decode to at most 128 bytes. Rejecting sizes
+          // the data could never decode to prevents untrusted modules from
+          // requesting arbitrarily large allocations on first access.
+          uint64_t max_uncompressed_size =
+              (uint64_t)segment->data()->size() *
+              IREE_VM_BYTECODE_RUN_LENGTH_MAX_EXPANSION;
+          if (compression_def->uncompressed_size() > max_uncompressed_size ||
+              compression_def->uncompressed_size() > SIZE_MAX) {
+            LOG(ERROR) << "Run-length encoded rodata uncompressed size "
+                       << compression_def->uncompressed_size()
+                       << " exceeds the maximum of " << max_uncompressed_size
+                       << " for " << segment->data()->size()
+                       << " bytes of encoded data.";
+            return IREE_STATUS_INVALID_ARGUMENT;
+          }
+          break;
+        }
+        default:
+          LOG(ERROR) << "Unsupported rodata compression type.";
+          return IREE_STATUS_INVALID_ARGUMENT;
+      }
+    }
+  }
+
   for (int i = 0; i < module_def->types()->size(); ++i) {
     const auto* type_def = module_def->types()->Get(i);
     if (!type_def) {
@@ -145,6 +218,8 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
         LOG(ERROR) << "All imports require a signature.";
         return IREE_STATUS_INVALID_ARGUMENT;
       }
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_verify_signature(
+          module_def, import_def->signature()));
     }
   }
 
@@ -167,6 +242,8 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
           << "Out-of-bounds reference to a function in the internal table.";
       return IREE_STATUS_INVALID_ARGUMENT;
     }
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_verify_signature(
+        module_def, export_def->signature()));
   }
 
   for (int i = 0; i < module_def->internal_functions()->size(); ++i) {
@@ -178,6 +255,8 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
       LOG(ERROR) << "All functions require a signature.";
       return IREE_STATUS_INVALID_ARGUMENT;
     }
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_verify_signature(
+        module_def, function_def->signature()));
 
     const auto* function_descriptor =
         module_def->function_descriptors()->Get(i);
@@ -201,6 +280,65 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
   return IREE_STATUS_OK;
 }
 
+// Calls |fn| with the signature of every function in the order their calling
+// conventions are stored: imports, then exports, then internal functions.
+template <typename F>
+static void iree_vm_bytecode_module_for_each_signature(
+    const iree::vm::BytecodeModuleDef* module_def, F fn) {
+  if (module_def->imported_functions()) {
+    for (const auto* import_def : *module_def->imported_functions()) {
+      fn(import_def->signature());
+    }
+  }
+  for (const auto* export_def : *module_def->exported_functions()) {
+    fn(export_def->signature());
+  }
+  for (const auto* function_def : *module_def->internal_functions()) {
+    fn(function_def->signature());
+  }
+}
+
+// Returns the length of the calling convention string of |signature|.
+static size_t iree_vm_bytecode_module_calling_convention_size(
+    const iree::vm::FunctionSignatureDef* signature) {
+  size_t argument_count =
+      signature->argument_types() ? signature->argument_types()->size() : 0;
+  size_t result_count =
+      signature->result_types() ? signature->result_types()->size() : 0;
+  return argument_count + 1 + result_count;
+}
+
+// Writes the calling convention of |signature| to |storage| as described by
+// iree_vm_function_signature_t::calling_convention.
+static iree_string_view_t iree_vm_bytecode_module_build_calling_convention(
+    const iree_vm_type_def_t* type_table,
+    const iree::vm::FunctionSignatureDef* signature, char* storage) {
+  char* p = storage;
+  auto append_types = [&](const ::flatbuffers::Vector<int32_t>* types) {
+    if (!types) return;
+    for (int32_t type_ordinal : *types) {
+      switch (type_table[type_ordinal].value_type) {
+        case IREE_VM_VALUE_TYPE_I32:
+          *p++ = 'i';
+          break;
+        case IREE_VM_VALUE_TYPE_I64:
+          *p++ = 'I';
+          break;
+        case IREE_VM_VALUE_TYPE_F32:
+          *p++ = 'f';
+          break;
+        default:
+          *p++ = 'r';
+          break;
+      }
+    }
+  };
+  append_types(signature->argument_types());
+  *p++ = '_';
+  append_types(signature->result_types());
+  return iree_string_view_t{storage, (size_t)(p - storage)};
+}
+
 static iree_status_t iree_vm_bytecode_module_destroy(void* self) {
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
 
@@ -233,6 +371,18 @@ static iree_vm_module_signature_t iree_vm_bytecode_module_signature(
   return signature;
 }
 
+// Populates the frame register requirements of the internal |function| from
+// its function descriptor.
+static void iree_vm_bytecode_module_set_register_counts(
+    iree_vm_bytecode_module_t* module, iree_vm_function_t* function) {
+  if (function->ordinal < 0 ||
+      function->ordinal >= module->function_descriptor_count) {
+    return;
+  }
+  iree_vm_bytecode_function_set_register_counts(
+      &module->function_descriptor_table[function->ordinal], function);
+}
+
 static iree_status_t iree_vm_bytecode_module_get_function(
     void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
     iree_vm_function_t* out_function, iree_string_view_t* out_name,
@@ -253,6 +403,12 @@ static iree_status_t iree_vm_bytecode_module_get_function(
 
   const ::flatbuffers::String* name = nullptr;
   const iree::vm::FunctionSignatureDef* signature = nullptr;
+  // Calling conventions are stored for imports, then exports, then internal
+  // functions.
+  int32_t import_count = module_def->imported_functions()
+                             ? module_def->imported_functions()->size()
+                             : 0;
+  int32_t calling_convention_index = 0;
   if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
     if (!module_def->imported_functions() || ordinal < 0 ||
         ordinal >= module_def->imported_functions()->size()) {
@@ -261,6 +417,7 @@ static iree_status_t iree_vm_bytecode_module_get_function(
     auto* import_def = module_def->imported_functions()->Get(ordinal);
     name = import_def->full_name();
     signature = import_def->signature();
+    calling_convention_index = ordinal;
     if (out_function) {
       out_function->module = &module->interface;
       out_function->linkage = linkage;
@@ -273,10 +430,12 @@ static iree_status_t iree_vm_bytecode_module_get_function(
     auto* export_def = module_def->exported_functions()->Get(ordinal);
     name = export_def->local_name();
     signature = export_def->signature();
+    calling_convention_index = import_count + ordinal;
     if (out_function) {
       out_function->module = &module->interface;
       out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
       out_function->ordinal = export_def->internal_ordinal();
+      iree_vm_bytecode_module_set_register_counts(module, out_function);
     }
   } else {
     if (ordinal < 0 || ordinal >= module_def->internal_functions()->size()) {
@@ -285,10 +444,13 @@ static iree_status_t iree_vm_bytecode_module_get_function(
     auto* function_def = module_def->internal_functions()->Get(ordinal);
     name = function_def->local_name();
     signature = function_def->signature();
+    calling_convention_index =
+        import_count + module_def->exported_functions()->size() + ordinal;
     if (out_function) {
       out_function->module = &module->interface;
       out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
       out_function->ordinal = ordinal;
+      iree_vm_bytecode_module_set_register_counts(module, out_function);
     }
   }
 
@@ -301,6 +463,8 @@ static iree_status_t iree_vm_bytecode_module_get_function(
         signature->argument_types() ? signature->argument_types()->size() : 0;
     out_signature->result_count =
         signature->result_types() ? signature->result_types()->size() : 0;
+    out_signature->calling_convention =
+        module->calling_conventions[calling_convention_index];
   }
 
   return IREE_STATUS_OK;
@@ -390,6 +554,7 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
         out_function->module = &module->interface;
         out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
         out_function->ordinal = export_def->internal_ordinal();
+        iree_vm_bytecode_module_set_register_counts(module, out_function);
         return IREE_STATUS_OK;
       }
     }
@@ -403,6 +568,7 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
         out_function->module = &module->interface;
         out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
         out_function->ordinal = ordinal;
+        iree_vm_bytecode_module_set_register_counts(module, out_function);
         return IREE_STATUS_OK;
       }
     }
@@ -410,6 +576,29 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
   }
 }
 
+// Drops a pin on |state| and destroys it if it was the last.
+static void iree_vm_bytecode_module_state_unpin(
+    iree_vm_bytecode_module_state_t* state) {
+  if (iree_atomic_fetch_sub(&state->pin_count, 1) != 1) return;
+
+  // Free any rodata segments that were materialized.
+  for (int i = 0; i < state->rodata_ref_count; ++i) {
+    void* allocation = state->rodata_segment_table[i].allocation;
+    if (allocation) iree_allocator_free(state->allocator, allocation);
+  }
+
+  iree_vm_bytecode_module_t* module = state->module;
+  state->allocator.free(state->allocator.self, state);
+  iree_vm_module_release(&module->interface);
+}
+
+// Called when the last reference to a rodata segment is released.
+static void iree_vm_bytecode_module_rodata_ref_destroy(void* ptr) {
+  iree_vm_bytecode_rodata_segment_t* segment_info =
+      (iree_vm_bytecode_rodata_segment_t*)ptr;
+  iree_vm_bytecode_module_state_unpin(segment_info->state);
+}
+
 static iree_status_t iree_vm_bytecode_module_alloc_state(
     void* self, iree_allocator_t allocator,
     iree_vm_module_state_t** out_module_state) {
@@ -437,13 +626,16 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   total_state_struct_size += rwdata_storage_capacity;
   total_state_struct_size += global_ref_count * sizeof(iree_vm_ref_t);
   total_state_struct_size +=
-      rodata_ref_count * sizeof(iree_vm_ro_byte_buffer_t);
+      rodata_ref_count * sizeof(iree_vm_bytecode_rodata_segment_t);
   total_state_struct_size += import_function_count * sizeof(iree_vm_function_t);
 
   iree_vm_bytecode_module_state_t* state = NULL;
   IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, total_state_struct_size,
                                              (void**)&state));
   state->allocator = allocator;
+  state->module = module;
+  iree_vm_module_retain(&module->interface);
+  iree_atomic_store(&state->pin_count, 1 + rodata_ref_count);
 
   uint8_t* p = ((uint8_t*)state) + sizeof(iree_vm_bytecode_module_state_t);
   state->rwdata_storage = {p, (iree_host_size_t)rwdata_storage_capacity};
@@ -452,8 +644,8 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   state->global_ref_table = (iree_vm_ref_t*)p;
   p += global_ref_count * sizeof(*state->global_ref_table);
   state->rodata_ref_count = rodata_ref_count;
-  state->rodata_ref_table = (iree_vm_ro_byte_buffer_t*)p;
-  p += rodata_ref_count * sizeof(*state->rodata_ref_table);
+  state->rodata_segment_table = (iree_vm_bytecode_rodata_segment_t*)p;
+  p += rodata_ref_count * sizeof(*state->rodata_segment_table);
   state->import_count = import_function_count;
   state->import_table = (iree_vm_function_t*)p;
   p += import_function_count * sizeof(*state->import_table);
@@ -461,10 +653,33 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   for (int i = 0; i < rodata_ref_count; ++i) {
     const iree::vm::RodataSegmentDef* segment =
         module_def->rodata_segments()->Get(i);
-    iree_vm_ro_byte_buffer_t* ref = &state->rodata_ref_table[i];
+    iree_vm_bytecode_rodata_segment_t* segment_info =
+        &state->rodata_segment_table[i];
+    memset(segment_info, 0, sizeof(*segment_info));
+    segment_info->state = state;
+    iree_vm_ro_byte_buffer_t* ref = &segment_info->ref;
     iree_atomic_store(&ref->ref_object.counter, 1);
+    ref->destroy = iree_vm_bytecode_module_rodata_ref_destroy;
     ref->data.data = segment->data()->Data();
     ref->data.data_length = segment->data()->size();
+    segment_info->encoded_data = ref->data;
+    segment_info->alignment = segment->alignment() ? segment->alignment() : 16;
+    if (segment->compression_type_type() ==
+        iree::vm::CompressionTypeDef::RunLengthEncodedDataDef) {
+      // Decoded on first access.
+      segment_info->is_compressed = 1;
+      ref->data.data = NULL;
+      const auto* compression_def =
+          segment->compression_type_as_RunLengthEncodedDataDef();
+      ref->data.data_length =
+          (iree_host_size_t)compression_def->uncompressed_size();
+    } else if (segment->alignment() &&
+               ((uintptr_t)ref->data.data % segment->alignment()) != 0) {
+      // The module was not loaded at an address aligned enough to satisfy the
+      // segment alignment (such as when not memory-mapped); copied on first
+      // access.
+      ref->data.data = NULL;
+    }
   }
 
   *out_module_state = (iree_vm_module_state_t*)state;
@@ -482,7 +697,84 @@ static iree_status_t iree_vm_bytecode_module_free_state(
     iree_vm_ref_release(&state->global_ref_table[i]);
   }
 
-  return state->allocator.free(state->allocator.self, module_state);
+  // Release the state's own rodata references; the storage of any that are
+  // still retained elsewhere remains live until they are released.
+  for (int i = 0; i < state->rodata_ref_count; ++i) {
+    iree_vm_ref_object_release(&state->rodata_segment_table[i].ref,
+                               iree_vm_ro_byte_buffer_get_descriptor());
+  }
+
+  iree_vm_bytecode_module_state_unpin(state);
+  return IREE_STATUS_OK;
+}
+
+iree_status_t iree_vm_bytecode_rodata_decode_run_length(
+    iree_const_byte_span_t source, iree_byte_span_t target) {
+  const uint8_t* src = source.data;
+  const uint8_t* src_end = source.data + source.data_length;
+  uint8_t* dst = target.data;
+  uint8_t* dst_end = target.data + target.data_length;
+  while (src < src_end) {
+    uint8_t control = *src++;
+    if (control < 128) {
+      // Literal span of control+1 bytes.
+      iree_host_size_t count = control + 1;
+      if (count > (iree_host_size_t)(src_end - src) ||
+          count > (iree_host_size_t)(dst_end - dst)) {
+        return IREE_STATUS_DATA_LOSS;
+      }
+      memcpy(dst, src, count);
+      src += count;
+      dst += count;
+    } else if (control > 128) {
+      // Single byte repeated 257-control times.
+      iree_host_size_t count = 257 - control;
+      if (src == src_end || count > (iree_host_size_t)(dst_end - dst)) {
+        return IREE_STATUS_DATA_LOSS;
+      }
+      memset(dst, *src++, count);
+      dst += count;
+    } else {
+      return IREE_STATUS_DATA_LOSS;
+    }
+  }
+  return dst == dst_end ? IREE_STATUS_OK : IREE_STATUS_DATA_LOSS;
+}
+
+iree_status_t iree_vm_bytecode_module_state_load_rodata(
+    iree_vm_bytecode_module_state_t* module_state, int32_t rodata_ordinal) {
+  if (rodata_ordinal < 0 || rodata_ordinal >= module_state->rodata_ref_count) {
+    return IREE_STATUS_OUT_OF_RANGE;
+  }
+  iree_vm_bytecode_rodata_segment_t* segment_info =
+      &module_state->rodata_segment_table[rodata_ordinal];
+  iree_vm_ro_byte_buffer_t* ref = &segment_info->ref;
+  if (ref->data.data) return IREE_STATUS_OK;
+
+  // Over-allocate so that the contents can be aligned within the allocation.
+  iree_host_size_t alignment = segment_info->alignment;
+  void* allocation = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      module_state->allocator, ref->data.data_length + alignment - 1,
+      &allocation));
+  uint8_t* data = (uint8_t*)(((uintptr_t)allocation + alignment - 1) &
+                             ~(uintptr_t)(alignment - 1));
+
+  if (segment_info->is_compressed) {
+    iree_status_t status = iree_vm_bytecode_rodata_decode_run_length(
+        segment_info->encoded_data,
+        iree_byte_span_t{data, ref->data.data_length});
+    if (!iree_status_is_ok(status)) {
+      iree_allocator_free(module_state->allocator, allocation);
+      return status;
+    }
+  } else {
+    memcpy(data, segment_info->encoded_data.data, ref->data.data_length);
+  }
+
+  segment_info->allocation = allocation;
+  ref->data.data = data;
+  return IREE_STATUS_OK;
 }
 
 static iree_status_t iree_vm_bytecode_module_resolve_import(
@@ -522,13 +814,6 @@ static iree_status_t iree_vm_bytecode_module_execute(
     return IREE_STATUS_INVALID_ARGUMENT;
   }
 
-  const iree_vm_function_descriptor_t* function_descriptor =
-      &module->function_descriptor_table[frame->function.ordinal];
-  iree_vm_registers_t* regs = &frame->registers;
-  memset(&regs->ref[regs->ref_register_count], 0,
-         sizeof(iree_vm_ref_t) * (function_descriptor->ref_register_count -
-                                  regs->ref_register_count));
-
   return iree_vm_bytecode_dispatch(
       module, (iree_vm_bytecode_module_state_t*)frame->module_state, stack,
       frame, out_result);
@@ -561,12 +846,25 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   }
   IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_flatbuffer_verify(module_def));
 
-  size_t type_table_size =
+  // Everything lives in a single allocation:
+  // [module] [calling convention table] [type table] [calling conventions]
+  size_t function_count = 0;
+  size_t calling_conventions_size = 0;
+  iree_vm_bytecode_module_for_each_signature(
+      module_def, [&](const iree::vm::FunctionSignatureDef* signature) {
+        ++function_count;
+        calling_conventions_size +=
+            iree_vm_bytecode_module_calling_convention_size(signature);
+      });
+  size_t type_table_offset = sizeof(iree_vm_bytecode_module_t) +
+                             function_count * sizeof(iree_string_view_t);
+  size_t calling_conventions_offset =
+      type_table_offset +
       module_def->types()->size() * sizeof(iree_vm_type_def_t);
 
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      allocator, sizeof(iree_vm_bytecode_module_t) + type_table_size,
+      allocator, calling_conventions_offset + calling_conventions_size,
       (void**)&module));
   module->allocator = allocator;
 
@@ -582,10 +880,24 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->flatbuffer_allocator = flatbuffer_allocator;
 
   module->type_count = module_def->types()->size();
-  module->type_table = (iree_vm_type_def_t*)((uint8_t*)module +
-                                             sizeof(iree_vm_bytecode_module_t));
+  module->type_table =
+      (iree_vm_type_def_t*)((uint8_t*)module + type_table_offset);
   iree_vm_bytecode_module_resolve_types(module_def, module->type_table);
 
+  module->calling_conventions =
+      (iree_string_view_t*)((uint8_t*)module +
+                            sizeof(iree_vm_bytecode_module_t));
+  iree_string_view_t* calling_convention = module->calling_conventions;
+  char* calling_convention_storage =
+      (char*)module + calling_conventions_offset;
+  iree_vm_bytecode_module_for_each_signature(
+      module_def, [&](const iree::vm::FunctionSignatureDef* signature) {
+        *calling_convention = iree_vm_bytecode_module_build_calling_convention(
+            module->type_table, signature, calling_convention_storage);
+        calling_convention_storage += calling_convention->size;
+        ++calling_convention;
+      });
+
   iree_vm_module_init(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -602,3 +914,48 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   *out_module = &module->interface;
   return IREE_STATUS_OK;
 }
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_create_from_file(
+    iree_string_view_t path, iree_vm_bytecode_module_file_flags_t flags,
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  if (!out_module) {
+    LOG(ERROR) << "Output module argument not set";
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  *out_module = NULL;
+
+  IREE_API_ASSIGN_OR_RETURN(
+      auto file_mapping,
+      iree::FileMapping::OpenRead(std::string(path.data, path.size)));
+  auto file_data = file_mapping->data();
+
+  // The module holds a reference to the mapping through the flatbuffer
+  // allocator and releases it when destroyed.
+  iree_allocator_t flatbuffer_allocator = IREE_ALLOCATOR_NULL;
+  flatbuffer_allocator.self = file_mapping.get();
+  flatbuffer_allocator.free = +[](void* self, void* ptr) -> iree_status_t {
+    reinterpret_cast<iree::FileMapping*>(self)->ReleaseReference();
+    return IREE_STATUS_OK;
+  };
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{file_data.data(), file_data.size()},
+      flatbuffer_allocator, allocator, out_module));
+  iree::FileMapping* mapping = file_mapping.release();
+
+  if (flags & IREE_VM_BYTECODE_MODULE_FILE_PREFAULT_ALL) {
+    mapping->Prefault(0, file_data.size());
+  } else {
+    iree_vm_bytecode_module_t* module =
+        (iree_vm_bytecode_module_t*)(*out_module)->self;
+    size_t bytecode_offset = module->bytecode_data.data - file_data.data();
+    size_t bytecode_length = module->bytecode_data.data_length;
+    if (flags & IREE_VM_BYTECODE_MODULE_FILE_PREFAULT_BYTECODE) {
+      mapping->Prefault(bytecode_offset, bytecode_length);
+    } else if (flags & IREE_VM_BYTECODE_MODULE_FILE_ADVISE_BYTECODE) {
+      mapping->AdviseWillNeed(bytecode_offset, bytecode_length);
+    }
+  }
+
+  return IREE_STATUS_OK;
+}
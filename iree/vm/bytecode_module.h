@@ -33,6 +33,57 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+// Controls how much of a module file is made resident when it is loaded with
+// iree_vm_bytecode_module_create_from_file. By default pages are faulted in
+// lazily on first access, which keeps startup independent of the file size.
+typedef enum {
+  IREE_VM_BYTECODE_MODULE_FILE_DEFAULT = 0,
+  // Hints to the OS that the bytecode will be needed soon so that it may be
+  // read ahead asynchronously. Rodata is still paged in lazily.
+  IREE_VM_BYTECODE_MODULE_FILE_ADVISE_BYTECODE = 1 << 0,
+  // Faults in the bytecode before returning such that the first invocations
+  // do not stall on disk reads. Rodata is still paged in lazily.
+  IREE_VM_BYTECODE_MODULE_FILE_PREFAULT_BYTECODE = 1 << 1,
+  // Faults in the entire file, including all rodata, before returning.
+  IREE_VM_BYTECODE_MODULE_FILE_PREFAULT_ALL = 1 << 2,
+} iree_vm_bytecode_module_file_flags_t;
+
+// Creates a VM module from a ModuleDef FlatBuffer file at |path|.
+// The file is memory-mapped read-only instead of being read into memory and
+// the mapping is kept alive for the lifetime of the module. Rodata is used
+// directly from the mapping such that its pages are shared with any other
+// process mapping the same file.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_create_from_file(
+    iree_string_view_t path, iree_vm_bytecode_module_file_flags_t flags,
+    iree_allocator_t allocator, iree_vm_module_t** out_module);
+
+// Total number of opcodes addressable by the bytecode.
+#define IREE_VM_BYTECODE_OPCODE_COUNT 256
+
+// Number of times each opcode has been dispatched by all bytecode modules in
+// the process, indexed by opcode.
+typedef struct {
+  int64_t counts[IREE_VM_BYTECODE_OPCODE_COUNT];
+} iree_vm_bytecode_dispatch_profile_t;
+
+// Captures the current per-opcode dispatch counts into |out_profile|.
+// Counting adds overhead to every dispatched op and is only performed when the
+// runtime is compiled with IREE_VM_DISPATCH_PROFILING=1 (for example with
+// `--copt=-DIREE_VM_DISPATCH_PROFILING=1`). Returns IREE_STATUS_UNAVAILABLE and
+// zeros |out_profile| otherwise.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_dispatch_profile_capture(
+    iree_vm_bytecode_dispatch_profile_t* out_profile);
+
+// Resets all dispatch counts to zero.
+IREE_API_EXPORT void IREE_API_CALL iree_vm_bytecode_dispatch_profile_reset(
+    void);
+
+// Returns the name of |opcode| or an empty string if the opcode is reserved.
+IREE_API_EXPORT iree_string_view_t IREE_API_CALL
+iree_vm_bytecode_opcode_name(uint8_t opcode);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
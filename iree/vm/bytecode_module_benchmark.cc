@@ -12,15 +12,28 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
+#include "flatbuffers/flatbuffers.h"
 #include "iree/base/api.h"
 #include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/schemas/bytecode_module_def_generated.h"
 #include "iree/vm/bytecode_module.h"
 #include "iree/vm/bytecode_module_benchmark_module.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
 #include "iree/vm/module.h"
+#include "iree/vm/module_abi_cc.h"
+#include "iree/vm/ref.h"
 #include "iree/vm/stack.h"
+#include "iree/vm/variant_list.h"
 
 namespace {
 
@@ -61,7 +74,7 @@ static iree_status_t RunFunction(benchmark::State& state,
 
   iree_vm_module_t import_module;
   import_module.execute = SimpleAddExecute;
-  iree_vm_function_t imported_func;
+  iree_vm_function_t imported_func = {0};
   imported_func.module = &import_module;
   imported_func.linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
   imported_func.ordinal = 0;
@@ -77,7 +90,8 @@ static iree_status_t RunFunction(benchmark::State& state,
       }};
 
   auto stack = std::make_unique<iree_vm_stack_t>();
-  iree_vm_stack_init(state_resolver, stack.get());
+  iree_vm_stack_init(iree_byte_span_t{nullptr, 0}, state_resolver,
+                     IREE_ALLOCATOR_SYSTEM, stack.get());
 
   iree_vm_function_t function;
   IREE_CHECK_OK(module->lookup_function(
@@ -130,6 +144,89 @@ static void BM_ModuleCreate(benchmark::State& state) {
 }
 BENCHMARK(BM_ModuleCreate);
 
+// Maximum number of ref types used by the type registry benchmarks.
+constexpr int kMaxBenchmarkTypeCount = 1024;
+
+// Registers kMaxBenchmarkTypeCount ref types once for the process.
+// Types are named bench.type_N and are never instantiated.
+static void RegisterBenchmarkTypes() {
+  static bool registered = [] {
+    static std::vector<std::string> type_names;
+    static std::vector<iree_vm_ref_type_descriptor_t> descriptors;
+    type_names.reserve(kMaxBenchmarkTypeCount);
+    descriptors.resize(kMaxBenchmarkTypeCount);
+    for (int i = 0; i < kMaxBenchmarkTypeCount; ++i) {
+      type_names.push_back(absl::StrCat("bench.type_", i));
+      auto& descriptor = descriptors[i];
+      descriptor.type_name = iree_string_view_t{type_names.back().data(),
+                                                type_names.back().size()};
+      IREE_CHECK_OK(iree_vm_ref_register_type(&descriptor));
+    }
+    return true;
+  }();
+  (void)registered;
+}
+
+// Builds a minimal module flatbuffer with a type table referencing
+// |type_count| of the benchmark ref types.
+static std::vector<uint8_t> BuildModuleWithTypes(int type_count) {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<iree::vm::TypeDef>> types;
+  for (int i = 0; i < type_count; ++i) {
+    types.push_back(iree::vm::CreateTypeDefDirect(
+        fbb, absl::StrCat("!bench.type_", i).c_str()));
+  }
+  auto signature = iree::vm::CreateFunctionSignatureDef(fbb);
+  std::vector<flatbuffers::Offset<iree::vm::InternalFunctionDef>>
+      internal_functions = {
+          iree::vm::CreateInternalFunctionDefDirect(fbb, "fn", signature)};
+  std::vector<flatbuffers::Offset<iree::vm::ExportFunctionDef>>
+      exported_functions = {iree::vm::CreateExportFunctionDefDirect(
+          fbb, "fn", signature, /*internal_ordinal=*/0)};
+  std::vector<iree::vm::FunctionDescriptor> function_descriptors = {
+      iree::vm::FunctionDescriptor(0, 0, 0, 0)};
+  std::vector<uint8_t> bytecode_data(4);
+  fbb.Finish(iree::vm::CreateBytecodeModuleDefDirect(
+      fbb, "types", &types, /*imported_functions=*/nullptr,
+      &exported_functions, &internal_functions, /*rodata_segments=*/nullptr,
+      /*rwdata_segments=*/nullptr, /*module_state=*/0, &function_descriptors,
+      &bytecode_data));
+  return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+// Measures module load time when the type table references many ref types, as
+// each must be resolved against the type registry by name.
+static void BM_ModuleCreateWithTypes(benchmark::State& state) {
+  RegisterBenchmarkTypes();
+  auto module_data = BuildModuleWithTypes(state.range(0));
+  while (state.KeepRunning()) {
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_const_byte_span_t{module_data.data(), module_data.size()},
+        IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &module))
+        << "Bytecode module failed to load";
+    benchmark::DoNotOptimize(module);
+    module->destroy(module->self);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ModuleCreateWithTypes)->Arg(16)->Arg(256)->Arg(1024);
+
+// Measures the cost of a single ref type name lookup with many types
+// registered.
+static void BM_RefTypeLookup(benchmark::State& state) {
+  RegisterBenchmarkTypes();
+  std::string type_name =
+      absl::StrCat("bench.type_", kMaxBenchmarkTypeCount - 1);
+  iree_string_view_t type_name_view{type_name.data(), type_name.size()};
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(
+        iree_vm_ref_lookup_registered_type(type_name_view));
+  }
+}
+BENCHMARK(BM_RefTypeLookup);
+
 static void BM_ModuleCreateState(benchmark::State& state) {
   const auto* module_file_toc =
       iree::vm::bytecode_module_benchmark_module_create();
@@ -243,7 +340,9 @@ static void BM_CallImportedFuncReference(benchmark::State& state) {
   benchmark::DoNotOptimize(module_ptr);
 
   auto stack = std::make_unique<iree_vm_stack_t>();
+  int32_t i32_registers[1];
   iree_vm_stack_frame_t frame;
+  frame.registers.i32 = i32_registers;
   iree_vm_execution_result_t result;
   while (state.KeepRunningBatch(10)) {
     int value = 100;
@@ -288,4 +387,151 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+// Native module providing the benchmark.imported_func import when running the
+// bytecode module within a full context.
+struct BenchmarkModuleState final {
+  iree::StatusOr<int32_t> ImportedFunc(int32_t value) { return value + 1; }
+};
+
+static const iree::vm::NativeFunction<BenchmarkModuleState>
+    kBenchmarkModuleFunctions[] = {
+        iree::vm::MakeNativeFunction("imported_func",
+                                     &BenchmarkModuleState::ImportedFunc),
+};
+
+class BenchmarkModule final
+    : public iree::vm::NativeModule<BenchmarkModuleState> {
+ public:
+  using iree::vm::NativeModule<BenchmarkModuleState>::NativeModule;
+
+  iree::StatusOr<std::unique_ptr<BenchmarkModuleState>> CreateState(
+      iree_allocator_t allocator) override {
+    return std::make_unique<BenchmarkModuleState>();
+  }
+};
+
+// A context containing the benchmark module (and its imports) used for
+// measuring the overhead of the invocation APIs.
+class InvocationContext {
+ public:
+  explicit InvocationContext(absl::string_view function_name) {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+
+    auto* import_module =
+        (new BenchmarkModule("benchmark", IREE_ALLOCATOR_SYSTEM,
+                             absl::MakeConstSpan(kBenchmarkModuleFunctions)))
+            ->interface();
+
+    const auto* module_file_toc =
+        iree::vm::bytecode_module_benchmark_module_create();
+    iree_vm_module_t* bytecode_module = nullptr;
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_const_byte_span_t{
+            reinterpret_cast<const uint8_t*>(module_file_toc->data),
+            module_file_toc->size},
+        IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &bytecode_module))
+        << "Bytecode module failed to load";
+
+    iree_vm_module_t* modules[] = {import_module, bytecode_module};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, modules, 2, IREE_ALLOCATOR_SYSTEM, &context_));
+    iree_vm_module_release(import_module);
+
+    IREE_CHECK_OK(bytecode_module->lookup_function(
+        bytecode_module->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function_))
+        << "Exported function '" << function_name << "' not found";
+    iree_vm_module_release(bytecode_module);
+  }
+
+  ~InvocationContext() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_context_t* context() const { return context_; }
+  iree_vm_function_t function() const { return function_; }
+
+ private:
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_function_t function_;
+};
+
+// Measures iree_vm_invoke including the per-call list setup a caller has to
+// perform, allocating the stack and lists on each call.
+static void InvokeFunction(benchmark::State& state,
+                           absl::string_view function_name,
+                           absl::InlinedVector<int32_t, 4> i32_args,
+                           int result_count) {
+  InvocationContext invocation_context(function_name);
+  while (state.KeepRunning()) {
+    iree_vm_variant_list_t* inputs = nullptr;
+    IREE_CHECK_OK(iree_vm_variant_list_alloc(
+        i32_args.size(), IREE_ALLOCATOR_SYSTEM, &inputs));
+    for (int32_t arg : i32_args) {
+      iree_vm_value_t value = IREE_VM_VALUE_MAKE_I32(arg);
+      IREE_CHECK_OK(iree_vm_variant_list_append_value(inputs, value));
+    }
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_CHECK_OK(iree_vm_variant_list_alloc(
+        result_count, IREE_ALLOCATOR_SYSTEM, &outputs));
+
+    IREE_CHECK_OK(iree_vm_invoke(
+        invocation_context.context(), invocation_context.function(),
+        /*policy=*/nullptr, inputs, outputs, IREE_ALLOCATOR_SYSTEM));
+    benchmark::DoNotOptimize(iree_vm_variant_list_size(outputs));
+
+    iree_vm_variant_list_free(inputs);
+    iree_vm_variant_list_free(outputs);
+  }
+}
+
+// Measures iree_vm_prepared_call_invoke with inputs updated in-place, which
+// performs no allocations per call.
+static void InvokePreparedCall(benchmark::State& state,
+                               absl::string_view function_name,
+                               absl::InlinedVector<int32_t, 4> i32_args) {
+  InvocationContext invocation_context(function_name);
+  iree_vm_prepared_call_t* call = nullptr;
+  IREE_CHECK_OK(iree_vm_prepared_call_create(
+      invocation_context.context(), invocation_context.function(),
+      /*inputs=*/nullptr, IREE_ALLOCATOR_SYSTEM, &call));
+  iree_vm_variant_list_t* inputs = iree_vm_prepared_call_inputs(call);
+  for (int32_t arg : i32_args) {
+    iree_vm_value_t value = IREE_VM_VALUE_MAKE_I32(arg);
+    IREE_CHECK_OK(iree_vm_variant_list_append_value(inputs, value));
+  }
+  while (state.KeepRunning()) {
+    for (int i = 0; i < i32_args.size(); ++i) {
+      iree_vm_variant_list_get(inputs, i)->i32 = i32_args[i];
+    }
+    IREE_CHECK_OK(iree_vm_prepared_call_invoke(call));
+    benchmark::DoNotOptimize(
+        iree_vm_variant_list_size(iree_vm_prepared_call_outputs(call)));
+  }
+  iree_vm_prepared_call_release(call);
+}
+
+static void BM_InvokeEmptyFunc(benchmark::State& state) {
+  InvokeFunction(state, "empty_func", {}, /*result_count=*/0);
+}
+BENCHMARK(BM_InvokeEmptyFunc);
+
+static void BM_PreparedCallEmptyFunc(benchmark::State& state) {
+  InvokePreparedCall(state, "empty_func", {});
+}
+BENCHMARK(BM_PreparedCallEmptyFunc);
+
+static void BM_InvokeCallImportedFunc(benchmark::State& state) {
+  InvokeFunction(state, "call_imported_func", {100}, /*result_count=*/1);
+}
+BENCHMARK(BM_InvokeCallImportedFunc);
+
+static void BM_PreparedCallCallImportedFunc(benchmark::State& state) {
+  InvokePreparedCall(state, "call_imported_func", {100});
+}
+BENCHMARK(BM_PreparedCallCallImportedFunc);
+
 }  // namespace
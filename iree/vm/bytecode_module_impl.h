@@ -42,10 +42,24 @@ typedef struct {
 typedef struct {
   int32_t bytecode_offset;
   int32_t bytecode_length;
-  int8_t i32_register_count;
-  int8_t ref_register_count;
+  uint16_t i32_register_count;
+  uint16_t ref_register_count;
 } iree_vm_function_descriptor_t;
 
+// Populates the frame register requirements of |function| from its
+// |function_descriptor|. Functions that use no registers at all still declare a
+// single i32 register so that they are not mistaken for functions that don't
+// declare their requirements (which get frames sized for the maximum).
+static inline void iree_vm_bytecode_function_set_register_counts(
+    const iree_vm_function_descriptor_t* function_descriptor,
+    iree_vm_function_t* function) {
+  function->i32_register_count = function_descriptor->i32_register_count;
+  function->ref_register_count = function_descriptor->ref_register_count;
+  if (!function->i32_register_count && !function->ref_register_count) {
+    function->i32_register_count = 1;
+  }
+}
+
 // A loaded bytecode module.
 typedef struct {
   // Interface routing to the bytecode module functions.
@@ -71,13 +85,50 @@ typedef struct {
   // Type table mapping module type IDs to registered VM types.
   int32_t type_count;
   iree_vm_type_def_t* type_table;
+
+  // Calling conventions of all imported, exported, and internal functions (in
+  // that order) as returned in their signatures. The strings are stored in the
+  // same allocation as the module.
+  iree_string_view_t* calling_conventions;
 } iree_vm_bytecode_module_t;
 
+typedef struct iree_vm_bytecode_module_state iree_vm_bytecode_module_state_t;
+
+// A rodata segment and the reference handed out for it.
+// Segments that are compressed or not sufficiently aligned in memory to be used
+// in-place are materialized on first access.
+typedef struct {
+  // Reference to the segment contents. Must be first such that the segment can
+  // be found from the reference when it is destroyed.
+  // Segments that must be materialized before use have a NULL data pointer
+  // (but a valid length) until iree_vm_bytecode_module_state_load_rodata is
+  // called for them.
+  iree_vm_ro_byte_buffer_t ref;
+  // State owning the segment. The state storage is kept alive for as long as
+  // any segment reference is retained, even after the state has been freed.
+  iree_vm_bytecode_module_state_t* state;
+  // Segment data as stored in the module FlatBuffer.
+  iree_const_byte_span_t encoded_data;
+  // Nonzero if |encoded_data| is run-length encoded.
+  int is_compressed;
+  // Required byte alignment of the materialized contents.
+  iree_host_size_t alignment;
+  // Allocation holding the materialized contents (possibly with leading
+  // padding for alignment) or NULL if not yet materialized.
+  void* allocation;
+} iree_vm_bytecode_rodata_segment_t;
+
 // Per-instance module state.
 // This is allocated with a provided allocator as a single flat allocation.
 // This struct is a prefix to the allocation pointing into the dynamic offsets
 // of the allocation storage.
-typedef struct {
+//
+// Rodata segment references may be retained beyond the lifetime of the state
+// (such as by HAL buffers aliasing the rodata). The allocation is pinned by
+// each segment reference and is only freed once the state has been freed and
+// all segment references have been released. As segments point into the
+// module FlatBuffer the state retains the module until then as well.
+struct iree_vm_bytecode_module_state {
   // Combined rwdata storage for the entire module, including globals.
   // Aligned to 16 bytes (128-bits) for SIMD usage.
   iree_byte_span_t rwdata_storage;
@@ -86,12 +137,9 @@ typedef struct {
   int32_t global_ref_count;
   iree_vm_ref_t* global_ref_table;
 
-  // TODO(benvanik): move to iree_vm_bytecode_module_t if always static.
-  // Initialized references to rodata segments.
-  // Right now these don't do much, however we can perform lazy caching and
-  // on-the-fly decompression using this information.
+  // Rodata segments, indexed by rodata ordinal.
   int32_t rodata_ref_count;
-  iree_vm_ro_byte_buffer_t* rodata_ref_table;
+  iree_vm_bytecode_rodata_segment_t* rodata_segment_table;
 
   // Resolved function imports.
   int32_t import_count;
@@ -99,7 +147,29 @@ typedef struct {
 
   // Allocator used for the state itself and any runtime allocations needed.
   iree_allocator_t allocator;
-} iree_vm_bytecode_module_state_t;
+
+  // Module the state was allocated from; retained until the state is
+  // destroyed.
+  iree_vm_bytecode_module_t* module;
+  // One pin for the state itself and one per unreleased segment reference.
+  iree_atomic_intptr_t pin_count;
+};
+
+// Maximum ratio of decoded to encoded size of run-length encoded rodata: a
+// control byte and value byte may decode to 128 repeated bytes.
+#define IREE_VM_BYTECODE_RUN_LENGTH_MAX_EXPANSION 64
+
+// Decodes PackBits run-length encoded |source| data into |target|, which must
+// be exactly the size of the decoded data. Returns IREE_STATUS_DATA_LOSS if
+// |source| is malformed or does not decode to exactly |target| bytes.
+iree_status_t iree_vm_bytecode_rodata_decode_run_length(
+    iree_const_byte_span_t source, iree_byte_span_t target);
+
+// Materializes the rodata segment with the given |rodata_ordinal| by decoding
+// or copying it into an allocation owned by |module_state|. Must only be
+// called when the segment data pointer is NULL.
+iree_status_t iree_vm_bytecode_module_state_load_rodata(
+    iree_vm_bytecode_module_state_t* module_state, int32_t rodata_ordinal);
 
 // Begins (or resumes) execution of the given |entry_frame| and continues until
 // either a yield or return. |out_result| will contain the result status for
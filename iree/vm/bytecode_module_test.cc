@@ -18,10 +18,191 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
 #include "iree/testing/gtest.h"
+#include "iree/vm/bytecode_module_impl.h"
 
 namespace {
 
 // TODO(benvanik): bytecode_module_test.cc for flatbuffer/module implementation.
 
+// Decodes |encoded| into a buffer of |decoded_length| bytes.
+iree_status_t DecodeRunLength(const std::vector<uint8_t>& encoded,
+                              iree_host_size_t decoded_length,
+                              std::vector<uint8_t>* out_decoded) {
+  out_decoded->assign(decoded_length, 0xCD);
+  return iree_vm_bytecode_rodata_decode_run_length(
+      iree_const_byte_span_t{encoded.data(), encoded.size()},
+      iree_byte_span_t{out_decoded->data(), out_decoded->size()});
+}
+
+TEST(RodataRunLengthTest, Empty) {
+  std::vector<uint8_t> decoded;
+  IREE_ASSERT_OK(DecodeRunLength({}, 0, &decoded));
+}
+
+TEST(RodataRunLengthTest, Literal) {
+  std::vector<uint8_t> decoded;
+  IREE_ASSERT_OK(DecodeRunLength({2, 10, 11, 12}, 3, &decoded));
+  EXPECT_EQ(std::vector<uint8_t>({10, 11, 12}), decoded);
+}
+
+TEST(RodataRunLengthTest, Repeat) {
+  std::vector<uint8_t> decoded;
+  IREE_ASSERT_OK(DecodeRunLength({253, 7}, 4, &decoded));
+  EXPECT_EQ(std::vector<uint8_t>({7, 7, 7, 7}), decoded);
+}
+
+TEST(RodataRunLengthTest, MaximumRuns) {
+  std::vector<uint8_t> encoded = {127};
+  std::vector<uint8_t> expected;
+  for (int i = 0; i < 128; ++i) {
+    encoded.push_back(static_cast<uint8_t>(i));
+    expected.push_back(static_cast<uint8_t>(i));
+  }
+  encoded.push_back(129);
+  encoded.push_back(0xAB);
+  expected.insert(expected.end(), 128, 0xAB);
+
+  std::vector<uint8_t> decoded;
+  IREE_ASSERT_OK(DecodeRunLength(encoded, expected.size(), &decoded));
+  EXPECT_EQ(expected, decoded);
+  EXPECT_LE(expected.size(),
+            encoded.size() * IREE_VM_BYTECODE_RUN_LENGTH_MAX_EXPANSION);
+}
+
+TEST(RodataRunLengthTest, MixedRuns) {
+  std::vector<uint8_t> decoded;
+  IREE_ASSERT_OK(
+      DecodeRunLength({255, 0, 1, 1, 2, 254, 3, 0, 4}, 8, &decoded));
+  EXPECT_EQ(std::vector<uint8_t>({0, 0, 1, 2, 3, 3, 3, 4}), decoded);
+}
+
+TEST(RodataRunLengthTest, ReservedControl) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS, DecodeRunLength({128, 1}, 1, &decoded));
+}
+
+TEST(RodataRunLengthTest, TruncatedLiteral) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            DecodeRunLength({3, 10, 11, 12}, 4, &decoded));
+}
+
+TEST(RodataRunLengthTest, TruncatedRepeat) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS, DecodeRunLength({253}, 4, &decoded));
+}
+
+TEST(RodataRunLengthTest, LiteralOverflowsTarget) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            DecodeRunLength({2, 10, 11, 12}, 2, &decoded));
+}
+
+TEST(RodataRunLengthTest, RepeatOverflowsTarget) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS, DecodeRunLength({253, 7}, 3, &decoded));
+}
+
+TEST(RodataRunLengthTest, UnderflowsTarget) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS, DecodeRunLength({253, 7}, 5, &decoded));
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS, DecodeRunLength({}, 1, &decoded));
+}
+
+TEST(RodataRunLengthTest, DataForEmptyTarget) {
+  std::vector<uint8_t> decoded;
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS, DecodeRunLength({0, 1}, 0, &decoded));
+}
+
+// Tests iree_vm_bytecode_module_state_load_rodata on a state holding a single
+// segment that must be materialized.
+class RodataLoadTest : public ::testing::Test {
+ protected:
+  void InitSegment(const uint8_t* encoded_data, iree_host_size_t encoded_length,
+                   iree_host_size_t length, iree_host_size_t alignment,
+                   bool is_compressed) {
+    memset(&state_, 0, sizeof(state_));
+    state_.allocator = IREE_ALLOCATOR_SYSTEM;
+    state_.rodata_ref_count = 1;
+    state_.rodata_segment_table = &segment_;
+    memset(&segment_, 0, sizeof(segment_));
+    segment_.state = &state_;
+    segment_.encoded_data =
+        iree_const_byte_span_t{encoded_data, encoded_length};
+    segment_.is_compressed = is_compressed ? 1 : 0;
+    segment_.alignment = alignment;
+    segment_.ref.data.data = nullptr;
+    segment_.ref.data.data_length = length;
+  }
+
+  void TearDown() override {
+    if (segment_.allocation) {
+      iree_allocator_free(state_.allocator, segment_.allocation);
+    }
+  }
+
+  iree_vm_bytecode_module_state_t state_;
+  iree_vm_bytecode_rodata_segment_t segment_;
+};
+
+TEST_F(RodataLoadTest, OrdinalOutOfRange) {
+  InitSegment(nullptr, 0, 0, 16, false);
+  EXPECT_EQ(IREE_STATUS_OUT_OF_RANGE,
+            iree_vm_bytecode_module_state_load_rodata(&state_, -1));
+  EXPECT_EQ(IREE_STATUS_OUT_OF_RANGE,
+            iree_vm_bytecode_module_state_load_rodata(&state_, 1));
+}
+
+// Uncompressed segments stored at an address that does not satisfy their
+// alignment (such as modules loaded from an unaligned heap buffer) must be
+// copied to an aligned allocation.
+TEST_F(RodataLoadTest, UnalignedCopy) {
+  alignas(64) uint8_t storage[64 + 16];
+  const uint8_t* unaligned_data = storage + 1;
+  for (int i = 0; i < 16; ++i) storage[1 + i] = static_cast<uint8_t>(i + 1);
+  InitSegment(unaligned_data, 16, 16, 64, false);
+
+  IREE_ASSERT_OK(iree_vm_bytecode_module_state_load_rodata(&state_, 0));
+  const uint8_t* data = segment_.ref.data.data;
+  ASSERT_NE(nullptr, data);
+  EXPECT_NE(unaligned_data, data);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(data) % 64);
+  EXPECT_EQ(16, segment_.ref.data.data_length);
+  EXPECT_EQ(0, memcmp(unaligned_data, data, 16));
+
+  // Loading again must reuse the materialized contents.
+  IREE_ASSERT_OK(iree_vm_bytecode_module_state_load_rodata(&state_, 0));
+  EXPECT_EQ(data, segment_.ref.data.data);
+}
+
+TEST_F(RodataLoadTest, Decompress) {
+  const uint8_t encoded[] = {253, 9, 1, 1, 2};
+  InitSegment(encoded, sizeof(encoded), 6, 16, true);
+
+  IREE_ASSERT_OK(iree_vm_bytecode_module_state_load_rodata(&state_, 0));
+  const uint8_t* data = segment_.ref.data.data;
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(data) % 16);
+  const uint8_t expected[] = {9, 9, 9, 9, 1, 2};
+  EXPECT_EQ(0, memcmp(expected, data, sizeof(expected)));
+}
+
+// Corrupt segments must fail to load without leaving a partially decoded
+// segment behind.
+TEST_F(RodataLoadTest, DecompressCorrupt) {
+  const uint8_t encoded[] = {253, 9, 128};
+  InitSegment(encoded, sizeof(encoded), 6, 16, true);
+
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            iree_vm_bytecode_module_state_load_rodata(&state_, 0));
+  EXPECT_EQ(nullptr, segment_.ref.data.data);
+  EXPECT_EQ(nullptr, segment_.allocation);
+}
+
 }  // namespace
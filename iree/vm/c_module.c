@@ -0,0 +1,450 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/c_module.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// A module instantiated from a static C module definition.
+typedef struct {
+  // Interface routing to the C module functions.
+  // Must be first in the struct as we dereference the interface to find our
+  // members below.
+  iree_vm_module_t interface;
+
+  // Static definition emitted by the C target.
+  const iree_vm_c_module_def_t* def;
+
+  // Allocator this module was allocated with and must be freed with.
+  iree_allocator_t allocator;
+} iree_vm_c_module_t;
+
+static iree_status_t iree_vm_c_module_destroy(void* self) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  return iree_allocator_free(module->allocator, module);
+}
+
+static iree_string_view_t iree_vm_c_module_name(void* self) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  return iree_make_cstring_view(module->def->name);
+}
+
+static iree_vm_module_signature_t iree_vm_c_module_signature(void* self) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  iree_vm_module_signature_t signature;
+  signature.import_function_count = module->def->import_count;
+  signature.export_function_count = module->def->export_count;
+  signature.internal_function_count = module->def->function_count;
+  return signature;
+}
+
+// Populates |out_function| with the internal function at |ordinal|.
+static void iree_vm_c_module_make_function(iree_vm_c_module_t* module,
+                                           int32_t ordinal,
+                                           iree_vm_function_t* out_function) {
+  const iree_vm_c_function_def_t* function_def =
+      &module->def->functions[ordinal];
+  out_function->module = &module->interface;
+  out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+  out_function->ordinal = ordinal;
+  out_function->i32_register_count = function_def->i32_register_count;
+  out_function->ref_register_count = function_def->ref_register_count;
+  if (!out_function->i32_register_count && !out_function->ref_register_count) {
+    // Declare at least one register so the frame isn't sized for the maximum.
+    out_function->i32_register_count = 1;
+  }
+}
+
+static iree_status_t iree_vm_c_module_get_function(
+    void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
+    iree_vm_function_t* out_function, iree_string_view_t* out_name,
+    iree_vm_function_signature_t* out_signature) {
+  if (out_function) {
+    memset(out_function, 0, sizeof(iree_vm_function_t));
+  }
+  if (out_name) {
+    out_name->data = NULL;
+    out_name->size = 0;
+  }
+  if (out_signature) {
+    memset(out_signature, 0, sizeof(iree_vm_function_signature_t));
+  }
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_def_t* def = module->def;
+
+  const char* name = NULL;
+  const iree_vm_c_function_def_t* function_def = NULL;
+  if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
+    if (ordinal < 0 || ordinal >= def->import_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    name = def->imports[ordinal].name;
+    if (out_function) {
+      out_function->module = &module->interface;
+      out_function->linkage = linkage;
+      out_function->ordinal = ordinal;
+    }
+  } else if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
+    if (ordinal < 0 || ordinal >= def->export_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    const iree_vm_c_export_def_t* export_def = &def->exports[ordinal];
+    name = export_def->name;
+    function_def = &def->functions[export_def->internal_ordinal];
+    if (out_function) {
+      iree_vm_c_module_make_function(module, export_def->internal_ordinal,
+                                     out_function);
+    }
+  } else {
+    if (ordinal < 0 || ordinal >= def->function_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    function_def = &def->functions[ordinal];
+    name = function_def->name;
+    if (out_function) {
+      iree_vm_c_module_make_function(module, ordinal, out_function);
+    }
+  }
+
+  if (out_name && name) {
+    *out_name = iree_make_cstring_view(name);
+  }
+  if (out_signature && function_def) {
+    out_signature->argument_count = function_def->argument_count;
+    out_signature->result_count = function_def->result_count;
+    if (function_def->calling_convention) {
+      out_signature->calling_convention =
+          iree_make_cstring_view(function_def->calling_convention);
+    }
+  }
+
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_get_function_reflection_attr(
+    void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
+    int32_t index, iree_string_view_t* key, iree_string_view_t* value) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_def_t* def = module->def;
+
+  if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
+    if (ordinal < 0 || ordinal >= def->export_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    ordinal = def->exports[ordinal].internal_ordinal;
+  } else if (linkage != IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
+    return IREE_STATUS_NOT_FOUND;
+  }
+  if (ordinal < 0 || ordinal >= def->function_count) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  const iree_vm_c_function_def_t* function_def = &def->functions[ordinal];
+  if (index < 0 || index >= function_def->reflection_attr_count) {
+    return IREE_STATUS_NOT_FOUND;
+  }
+  const iree_vm_c_reflection_attr_def_t* attr =
+      &function_def->reflection_attrs[index];
+  *key = iree_make_cstring_view(attr->key);
+  *value = iree_make_cstring_view(attr->value);
+  return IREE_STATUS_OK;
+}
+
+static bool iree_vm_c_module_compare_str(const char* lhs,
+                                         iree_string_view_t rhs) {
+  if (!lhs) return false;
+  return iree_string_view_compare(iree_make_cstring_view(lhs), rhs) == 0;
+}
+
+static iree_status_t iree_vm_c_module_lookup_function(
+    void* self, iree_vm_function_linkage_t linkage, iree_string_view_t name,
+    iree_vm_function_t* out_function) {
+  if (!out_function) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_function, 0, sizeof(iree_vm_function_t));
+
+  if (!name.data || !name.size) return IREE_STATUS_INVALID_ARGUMENT;
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_def_t* def = module->def;
+
+  if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
+    for (int ordinal = 0; ordinal < def->import_count; ++ordinal) {
+      if (iree_vm_c_module_compare_str(def->imports[ordinal].name, name)) {
+        out_function->module = &module->interface;
+        out_function->linkage = linkage;
+        out_function->ordinal = ordinal;
+        return IREE_STATUS_OK;
+      }
+    }
+  } else if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
+    for (int ordinal = 0; ordinal < def->export_count; ++ordinal) {
+      const iree_vm_c_export_def_t* export_def = &def->exports[ordinal];
+      if (iree_vm_c_module_compare_str(export_def->name, name)) {
+        iree_vm_c_module_make_function(module, export_def->internal_ordinal,
+                                       out_function);
+        return IREE_STATUS_OK;
+      }
+    }
+  } else {
+    for (int ordinal = 0; ordinal < def->function_count; ++ordinal) {
+      if (iree_vm_c_module_compare_str(def->functions[ordinal].name, name)) {
+        iree_vm_c_module_make_function(module, ordinal, out_function);
+        return IREE_STATUS_OK;
+      }
+    }
+  }
+  return IREE_STATUS_NOT_FOUND;
+}
+
+// Drops a pin on |state| and frees it if it was the last.
+static void iree_vm_c_module_state_unpin(iree_vm_c_module_state_t* state) {
+  if (iree_atomic_fetch_sub(&state->pin_count, 1) != 1) return;
+  iree_allocator_free(state->allocator, state);
+}
+
+// Called when the last reference to a rodata segment is released.
+static void iree_vm_c_module_rodata_ref_destroy(void* ptr) {
+  iree_vm_c_module_rodata_ref_t* rodata_ref =
+      (iree_vm_c_module_rodata_ref_t*)ptr;
+  iree_vm_c_module_state_unpin(rodata_ref->state);
+}
+
+static iree_status_t iree_vm_c_module_alloc_state(
+    void* self, iree_allocator_t allocator,
+    iree_vm_module_state_t** out_module_state) {
+  if (!out_module_state) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_module_state = NULL;
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_def_t* def = module->def;
+
+  iree_host_size_t total_state_struct_size = sizeof(iree_vm_c_module_state_t);
+  total_state_struct_size += def->global_bytes_capacity;
+  total_state_struct_size += def->global_ref_count * sizeof(iree_vm_ref_t);
+  total_state_struct_size +=
+      def->rodata_count * sizeof(iree_vm_c_module_rodata_ref_t);
+  total_state_struct_size += def->import_count * sizeof(iree_vm_function_t);
+
+  iree_vm_c_module_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, total_state_struct_size,
+                                             (void**)&state));
+  state->allocator = allocator;
+  iree_atomic_store(&state->pin_count, 1 + def->rodata_count);
+
+  uint8_t* p = ((uint8_t*)state) + sizeof(iree_vm_c_module_state_t);
+  state->rwdata_storage.data = p;
+  state->rwdata_storage.data_length = def->global_bytes_capacity;
+  p += def->global_bytes_capacity;
+  state->global_ref_count = def->global_ref_count;
+  state->global_ref_table = (iree_vm_ref_t*)p;
+  p += def->global_ref_count * sizeof(*state->global_ref_table);
+  state->rodata_ref_count = def->rodata_count;
+  state->rodata_ref_table = (iree_vm_c_module_rodata_ref_t*)p;
+  p += def->rodata_count * sizeof(*state->rodata_ref_table);
+  state->import_count = def->import_count;
+  state->import_table = (iree_vm_function_t*)p;
+  p += def->import_count * sizeof(*state->import_table);
+
+  for (int i = 0; i < def->rodata_count; ++i) {
+    iree_vm_c_module_rodata_ref_t* rodata_ref = &state->rodata_ref_table[i];
+    memset(rodata_ref, 0, sizeof(*rodata_ref));
+    rodata_ref->state = state;
+    iree_atomic_store(&rodata_ref->ref.ref_object.counter, 1);
+    rodata_ref->ref.data = def->rodata_segments[i];
+    rodata_ref->ref.destroy = iree_vm_c_module_rodata_ref_destroy;
+  }
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_free_state(
+    void* self, iree_vm_module_state_t* module_state) {
+  iree_vm_c_module_state_t* state = (iree_vm_c_module_state_t*)module_state;
+  if (!state) return IREE_STATUS_INVALID_ARGUMENT;
+
+  // Release remaining global references.
+  for (int i = 0; i < state->global_ref_count; ++i) {
+    iree_vm_ref_release(&state->global_ref_table[i]);
+  }
+
+  // Release the state's own rodata references; the state remains live until
+  // any that are still retained elsewhere are released.
+  for (int i = 0; i < state->rodata_ref_count; ++i) {
+    iree_vm_ref_object_release(&state->rodata_ref_table[i].ref,
+                               iree_vm_ro_byte_buffer_get_descriptor());
+  }
+
+  iree_vm_c_module_state_unpin(state);
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_resolve_import(
+    void* self, iree_vm_module_state_t* module_state, int32_t ordinal,
+    iree_vm_function_t function) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  iree_vm_c_module_state_t* state = (iree_vm_c_module_state_t*)module_state;
+  if (!state) return IREE_STATUS_INVALID_ARGUMENT;
+  if (ordinal < 0 || ordinal >= state->import_count) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  // Generated code reads the declared number of results from the callee frame
+  // so the resolved function must match the import declaration.
+  const iree_vm_c_import_def_t* import_def = &module->def->imports[ordinal];
+  iree_vm_function_signature_t signature;
+  IREE_RETURN_IF_ERROR(function.module->get_function(
+      function.module->self, function.linkage, function.ordinal, NULL, NULL,
+      &signature));
+  if (signature.result_count != import_def->result_count ||
+      (!import_def->is_variadic &&
+       signature.argument_count != import_def->argument_count)) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  state->import_table[ordinal] = function;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_execute(
+    void* self, iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    iree_vm_execution_result_t* out_result) {
+  if (!out_result) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+  if (!stack || !frame) return IREE_STATUS_INVALID_ARGUMENT;
+  if (frame->function.linkage != IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
+    IREE_RETURN_IF_ERROR(iree_vm_c_module_get_function(
+        self, frame->function.linkage, frame->function.ordinal,
+        &frame->function, NULL, NULL));
+  }
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  if (frame->function.ordinal < 0 ||
+      frame->function.ordinal >= module->def->function_count) {
+    // Invalid function ordinal.
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  // Native functions always run to completion; see iree_vm_c_module_call_import
+  // for how yields within imports are handled.
+  const iree_vm_c_function_def_t* function_def =
+      &module->def->functions[frame->function.ordinal];
+  return function_def->entry(stack, frame,
+                             (iree_vm_c_module_state_t*)frame->module_state);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_c_module_create(const iree_vm_c_module_def_t* module_def,
+                        iree_allocator_t allocator,
+                        iree_vm_module_t** out_module) {
+  if (!out_module) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_module = NULL;
+  if (!module_def) return IREE_STATUS_INVALID_ARGUMENT;
+
+  iree_vm_c_module_t* module = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, sizeof(iree_vm_c_module_t), (void**)&module));
+  module->def = module_def;
+  module->allocator = allocator;
+
+  iree_vm_module_init(&module->interface, module);
+  module->interface.destroy = iree_vm_c_module_destroy;
+  module->interface.name = iree_vm_c_module_name;
+  module->interface.signature = iree_vm_c_module_signature;
+  module->interface.get_function = iree_vm_c_module_get_function;
+  module->interface.lookup_function = iree_vm_c_module_lookup_function;
+  module->interface.alloc_state = iree_vm_c_module_alloc_state;
+  module->interface.free_state = iree_vm_c_module_free_state;
+  module->interface.resolve_import = iree_vm_c_module_resolve_import;
+  module->interface.execute = iree_vm_c_module_execute;
+  module->interface.get_function_reflection_attr =
+      iree_vm_c_module_get_function_reflection_attr;
+
+  *out_module = &module->interface;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_enter_import(
+    iree_vm_stack_t* stack, iree_vm_c_module_state_t* state,
+    int32_t import_ordinal, iree_vm_stack_frame_t** out_frame) {
+  if (import_ordinal < 0 || import_ordinal >= state->import_count) {
+    return IREE_STATUS_OUT_OF_RANGE;
+  }
+  return iree_vm_stack_function_enter(
+      stack, state->import_table[import_ordinal], out_frame);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_call_import(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    const iree_vm_register_list_t* segment_sizes, int32_t result_count) {
+  // Variadic segment sizes are passed to the callee in the return register
+  // list of its frame, as the bytecode interpreter does.
+  frame->return_registers = segment_sizes;
+
+  iree_vm_module_t* import_module = frame->function.module;
+  iree_vm_execution_result_t result;
+  iree_status_t status;
+  do {
+    status = import_module->execute(import_module->self, stack, frame, &result);
+  } while (iree_status_is_ok(status) &&
+           result.state == IREE_VM_EXECUTION_YIELDED);
+
+  if (iree_status_is_ok(status) && result_count > 0 &&
+      (!frame->return_registers ||
+       frame->return_registers->size < result_count)) {
+    // The import did not produce the results its declaration promised.
+    status = IREE_STATUS_FAILED_PRECONDITION;
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_stack_function_leave(stack);
+  }
+  return status;
+}
+
+IREE_API_EXPORT void IREE_API_CALL iree_vm_c_module_print(
+    const char* message, const char* value_types, ...) {
+  va_list args;
+  va_start(args, value_types);
+  fprintf(stderr, "%s", message);
+  for (const char* type = value_types; *type; ++type) {
+    switch (*type) {
+      case 'i':
+        fprintf(stderr, " %" PRId32, va_arg(args, int32_t));
+        break;
+      case 'l':
+        fprintf(stderr, " %" PRId64, va_arg(args, int64_t));
+        break;
+      case 'f':
+        // Floats are promoted to double when passed through varargs.
+        fprintf(stderr, " %f", va_arg(args, double));
+        break;
+      case 'r': {
+        const iree_vm_ref_t* ref = va_arg(args, const iree_vm_ref_t*);
+        iree_string_view_t type_name = iree_vm_ref_type_name(ref->type);
+        fprintf(stderr, " %.*s<%p>", (int)type_name.size, type_name.data,
+                ref->ptr);
+        break;
+      }
+      default:
+        fprintf(stderr, " ?");
+        break;
+    }
+  }
+  fprintf(stderr, "\n");
+  va_end(args);
+}
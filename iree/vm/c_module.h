@@ -0,0 +1,339 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runtime support for VM modules compiled ahead-of-time to C source.
+//
+// The C target (-iree-vm-ir-to-c-module) translates each vm.func into a native
+// C function and emits a static iree_vm_c_module_def_t describing the module.
+// The module can then be instantiated with iree_vm_c_module_create and used
+// anywhere a bytecode module can be, without any interpreter dispatch.
+//
+// Most of this header is only intended for use by generated code.
+
+#ifndef IREE_VM_C_MODULE_H_
+#define IREE_VM_C_MODULE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/vm/module.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/stack.h"
+#include "iree/vm/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+typedef struct iree_vm_c_module_state iree_vm_c_module_state_t;
+
+// Reference to a rodata segment stored in the module state.
+typedef struct {
+  // Must be first such that the entry can be found from the reference when it
+  // is destroyed.
+  iree_vm_ro_byte_buffer_t ref;
+  // State owning the reference.
+  iree_vm_c_module_state_t* state;
+} iree_vm_c_module_rodata_ref_t;
+
+// Per-context module state shared by all functions in a C module.
+// Matches the layout of the bytecode module state such that globals are stored
+// in the same way: i32 globals at their byte offset within |rwdata_storage| and
+// ref globals at their ordinal within |global_ref_table|.
+//
+// Rodata references may be retained beyond the lifetime of the state (such as
+// by HAL buffers aliasing the rodata). The allocation is pinned by each
+// reference and is only freed once the state has been freed and all rodata
+// references have been released. The rodata contents themselves are static.
+struct iree_vm_c_module_state {
+  // Combined rwdata storage for the entire module, including globals.
+  iree_byte_span_t rwdata_storage;
+
+  // Global ref_ptr values, indexed by global ordinal.
+  int32_t global_ref_count;
+  iree_vm_ref_t* global_ref_table;
+
+  // Initialized references to rodata segments, indexed by rodata ordinal.
+  int32_t rodata_ref_count;
+  iree_vm_c_module_rodata_ref_t* rodata_ref_table;
+
+  // Resolved function imports.
+  int32_t import_count;
+  iree_vm_function_t* import_table;
+
+  // Allocator used for the state itself and any runtime allocations needed.
+  iree_allocator_t allocator;
+
+  // One pin for the state itself and one per unreleased rodata reference.
+  iree_atomic_intptr_t pin_count;
+};
+
+// Entry point of a generated function callable through the module interface.
+// Arguments are read from the |frame| registers (left-aligned within each
+// bank) and results are written back to the |frame| registers along with a
+// frame return register list describing them.
+typedef iree_status_t(IREE_API_PTR* iree_vm_c_function_entry_t)(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    iree_vm_c_module_state_t* state);
+
+// A reflection attribute of a function as a (key, value) pair.
+typedef struct {
+  const char* key;
+  const char* value;
+} iree_vm_c_reflection_attr_def_t;
+
+// Describes an internal function of a C module.
+typedef struct {
+  // Local name of the function, if symbols were not stripped.
+  const char* name;
+  // Entry point unpacking arguments from and packing results into a frame.
+  iree_vm_c_function_entry_t entry;
+  // Number of registers in each bank required to pass the arguments and
+  // results of the function.
+  uint16_t i32_register_count;
+  uint16_t ref_register_count;
+  // Total number of arguments and results of the function.
+  int32_t argument_count;
+  int32_t result_count;
+  // Declared types of the arguments and results as described by
+  // iree_vm_function_signature_t::calling_convention.
+  const char* calling_convention;
+  // Reflection attributes of the function, if symbols were not stripped.
+  int32_t reflection_attr_count;
+  const iree_vm_c_reflection_attr_def_t* reflection_attrs;
+} iree_vm_c_function_def_t;
+
+// Describes an imported function of a C module.
+typedef struct {
+  // Fully-qualified name of the imported function.
+  const char* name;
+  // Total number of arguments and results the import was declared with.
+  int32_t argument_count;
+  int32_t result_count;
+  // True if the import takes variadic arguments. The argument count of the
+  // resolved function is then not checked against |argument_count|.
+  bool is_variadic;
+} iree_vm_c_import_def_t;
+
+// Describes an exported function of a C module.
+typedef struct {
+  // Name the function is exported as.
+  const char* name;
+  // Ordinal of the exported function in the internal function table.
+  int32_t internal_ordinal;
+} iree_vm_c_export_def_t;
+
+// Static description of a C module as emitted by the C target.
+// All pointers must remain valid for the lifetime of any module created from
+// the definition; generated definitions are stored in static memory.
+typedef struct {
+  // Name of the module used during import resolution.
+  const char* name;
+
+  // Imported functions, indexed by import ordinal.
+  int32_t import_count;
+  const iree_vm_c_import_def_t* imports;
+
+  // Exported functions, indexed by export ordinal.
+  int32_t export_count;
+  const iree_vm_c_export_def_t* exports;
+
+  // Internal functions, indexed by function ordinal.
+  int32_t function_count;
+  const iree_vm_c_function_def_t* functions;
+
+  // Read-only data segments, indexed by rodata ordinal.
+  int32_t rodata_count;
+  const iree_const_byte_span_t* rodata_segments;
+
+  // Module state storage requirements.
+  int32_t global_bytes_capacity;
+  int32_t global_ref_count;
+} iree_vm_c_module_def_t;
+
+#ifndef IREE_API_NO_PROTOTYPES
+
+// Creates a VM module from a static |module_def| emitted by the C target.
+// The definition is referenced and not copied and must outlive the module.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_c_module_create(const iree_vm_c_module_def_t* module_def,
+                        iree_allocator_t allocator,
+                        iree_vm_module_t** out_module);
+
+// Enters a new stack frame for the import with the given |import_ordinal|.
+// The caller must populate the argument registers of |out_frame| and then
+// call iree_vm_c_module_call_import.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_enter_import(
+    iree_vm_stack_t* stack, iree_vm_c_module_state_t* state,
+    int32_t import_ordinal, iree_vm_stack_frame_t** out_frame);
+
+// Executes the import in |frame| as entered by iree_vm_c_module_enter_import.
+// |segment_sizes| is an optional register list describing the segments of a
+// variadic call. Imports that yield are resumed until they complete as native
+// frames of the caller cannot be suspended.
+//
+// On success the results are available via iree_vm_c_module_import_result and
+// the caller must leave the frame with iree_vm_stack_function_leave once they
+// have been read. On failure the frame has already been left.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_call_import(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    const iree_vm_register_list_t* segment_sizes, int32_t result_count);
+
+// Prints |message| followed by the variadic values to stderr. Used for
+// vm.print and vm.trace when debug ops are not stripped. |value_types| has one
+// character per value: 'i' (int32_t), 'l' (int64_t), 'f' (float) or 'r'
+// (iree_vm_ref_t*).
+IREE_API_EXPORT void IREE_API_CALL iree_vm_c_module_print(
+    const char* message, const char* value_types, ...);
+
+#endif  // IREE_API_NO_PROTOTYPES
+
+// Returns the register ordinal within its bank of import result |i|.
+static inline uint8_t iree_vm_c_module_import_result(
+    const iree_vm_stack_frame_t* frame, int i) {
+  uint8_t reg = frame->return_registers->registers[i];
+  return (reg & IREE_REF_REGISTER_TYPE_BIT) ? (reg & IREE_REF_REGISTER_MASK)
+                                            : (reg & IREE_I32_REGISTER_MASK);
+}
+
+//===----------------------------------------------------------------------===//
+// Frame register access
+//===----------------------------------------------------------------------===//
+// Used by generated code to marshal values into and out of frames when
+// crossing the module interface boundary. Values within generated functions
+// live in C locals and never touch the frame registers.
+//
+// 64-bit values are stored in two consecutive i32 registers (lo, hi) and 32-bit
+// floats are stored bit-for-bit in a single i32 register, matching the bytecode
+// interpreter.
+
+static inline int32_t iree_vm_c_get_i32(const iree_vm_registers_t* regs,
+                                        int reg) {
+  return regs->i32[reg & regs->i32_mask];
+}
+
+static inline void iree_vm_c_set_i32(iree_vm_registers_t* regs, int reg,
+                                     int32_t value) {
+  regs->i32[reg & regs->i32_mask] = value;
+}
+
+static inline int64_t iree_vm_c_get_i64(const iree_vm_registers_t* regs,
+                                        int reg) {
+  uint32_t lo = (uint32_t)regs->i32[reg & regs->i32_mask];
+  uint32_t hi = (uint32_t)regs->i32[(reg + 1) & regs->i32_mask];
+  return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+static inline void iree_vm_c_set_i64(iree_vm_registers_t* regs, int reg,
+                                     int64_t value) {
+  regs->i32[reg & regs->i32_mask] = (int32_t)(uint32_t)value;
+  regs->i32[(reg + 1) & regs->i32_mask] =
+      (int32_t)(uint32_t)((uint64_t)value >> 32);
+}
+
+static inline float iree_vm_c_get_f32(const iree_vm_registers_t* regs,
+                                      int reg) {
+  float value;
+  memcpy(&value, &regs->i32[reg & regs->i32_mask], sizeof(value));
+  return value;
+}
+
+static inline void iree_vm_c_set_f32(iree_vm_registers_t* regs, int reg,
+                                     float value) {
+  memcpy(&regs->i32[reg & regs->i32_mask], &value, sizeof(value));
+}
+
+// Returns the ref stored in register |reg|.
+static inline iree_vm_ref_t* iree_vm_c_ref_ptr(iree_vm_registers_t* regs,
+                                               int reg) {
+  return &regs->ref[reg & regs->ref_mask];
+}
+
+// Retains the ref in register |reg| into |out_ref|.
+static inline void iree_vm_c_get_ref(iree_vm_registers_t* regs, int reg,
+                                     iree_vm_ref_t* out_ref) {
+  iree_vm_ref_release(out_ref);
+  iree_vm_ref_retain(&regs->ref[reg & regs->ref_mask], out_ref);
+}
+
+// Retains |ref| into register |reg|.
+static inline void iree_vm_c_set_ref(iree_vm_registers_t* regs, int reg,
+                                     iree_vm_ref_t* ref) {
+  iree_vm_ref_t* reg_ref = &regs->ref[reg & regs->ref_mask];
+  iree_vm_ref_release(reg_ref);
+  iree_vm_ref_retain(ref, reg_ref);
+}
+
+//===----------------------------------------------------------------------===//
+// Generated code helpers
+//===----------------------------------------------------------------------===//
+
+// Retains |ref| into |out_ref|, releasing any value |out_ref| previously held.
+// Locals are reassigned each time a loop iterates and must drop their old
+// value even when it is the same object.
+static inline void iree_vm_c_ref_assign(iree_vm_ref_t* ref,
+                                        iree_vm_ref_t* out_ref) {
+  if (ref == out_ref) return;
+  iree_vm_ref_release(out_ref);
+  iree_vm_ref_retain(ref, out_ref);
+}
+
+// Moves |ref| into |out_ref|, releasing any value |out_ref| previously held.
+static inline void iree_vm_c_ref_move(iree_vm_ref_t* ref,
+                                      iree_vm_ref_t* out_ref) {
+  if (ref == out_ref) return;
+  iree_vm_ref_release(out_ref);
+  memcpy(out_ref, ref, sizeof(*out_ref));
+  memset(ref, 0, sizeof(*ref));
+}
+
+// Returns the float with the given IEEE-754 bit pattern. Used for constants so
+// that NaN payloads and signed zeros survive the round-trip through C source.
+static inline float iree_vm_c_f32_from_bits(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Returns the address of the i32 global at |byte_offset| or NULL if the offset
+// is out of range of the module state rwdata.
+static inline int32_t* iree_vm_c_global_i32(iree_vm_c_module_state_t* state,
+                                            int32_t byte_offset) {
+  if (byte_offset < 0 ||
+      byte_offset + sizeof(int32_t) > state->rwdata_storage.data_length) {
+    return NULL;
+  }
+  return (int32_t*)(state->rwdata_storage.data + byte_offset);
+}
+
+// Returns the ref global with |ordinal| or NULL if the ordinal is out of range.
+static inline iree_vm_ref_t* iree_vm_c_global_ref(
+    iree_vm_c_module_state_t* state, int32_t ordinal) {
+  if (ordinal < 0 || ordinal >= state->global_ref_count) return NULL;
+  return &state->global_ref_table[ordinal];
+}
+
+// Assigns |expr| to |status| and jumps to the function cleanup on failure.
+// Generated functions release their ref locals at the |cleanup| label.
+#define IREE_VM_C_CHECK(expr)                \
+  if (!iree_status_is_ok(status = (expr))) { \
+    goto cleanup;                            \
+  }
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_C_MODULE_H_
@@ -0,0 +1,273 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the bytecode_dispatch_test.mlir functions compiled ahead-of-time to C.
+// Each function is also run through the bytecode module compiled from the same
+// source and both must produce the same status and results.
+
+#include "absl/strings/match.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/bytecode_dispatch_test_module.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/c_module.h"
+#include "iree/vm/c_module_test_module.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/module.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/types.h"
+#include "iree/vm/variant_list.h"
+
+namespace {
+
+struct TestParams {
+  std::string function_name;
+};
+
+std::ostream& operator<<(std::ostream& os, const TestParams& params) {
+  return os << params.function_name;
+}
+
+std::vector<TestParams> GetModuleTestParams() {
+  std::vector<TestParams> function_names;
+
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(bytecode_dispatch_test_c_module_create(IREE_ALLOCATOR_SYSTEM,
+                                                       &module))
+      << "C module failed to load";
+  iree_vm_module_signature_t signature = module->signature(module->self);
+  function_names.reserve(signature.export_function_count);
+  for (int i = 0; i < signature.export_function_count; ++i) {
+    iree_string_view_t name;
+    IREE_CHECK_OK(module->get_function(module->self,
+                                       IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
+                                       nullptr, &name, nullptr));
+    function_names.push_back({std::string(name.data, name.size)});
+  }
+  iree_vm_module_release(module);
+
+  return function_names;
+}
+
+// Expects the function results produced by the C module in |c_outputs| to
+// match those produced by the bytecode module in |bytecode_outputs|.
+void ExpectMatchingResults(iree_vm_variant_list_t* bytecode_outputs,
+                           iree_vm_variant_list_t* c_outputs) {
+  ASSERT_EQ(iree_vm_variant_list_size(bytecode_outputs),
+            iree_vm_variant_list_size(c_outputs));
+  for (int i = 0; i < iree_vm_variant_list_size(c_outputs); ++i) {
+    iree_vm_variant_t* expected = iree_vm_variant_list_get(bytecode_outputs, i);
+    iree_vm_variant_t* actual = iree_vm_variant_list_get(c_outputs, i);
+    ASSERT_EQ(static_cast<int>(expected->value_type),
+              static_cast<int>(actual->value_type))
+        << "result " << i;
+    switch (expected->value_type) {
+      case IREE_VM_VALUE_TYPE_I32:
+        EXPECT_EQ(expected->i32, actual->i32) << "result " << i;
+        continue;
+      case IREE_VM_VALUE_TYPE_I64:
+        EXPECT_EQ(expected->i64, actual->i64) << "result " << i;
+        continue;
+      case IREE_VM_VALUE_TYPE_F32:
+        EXPECT_EQ(expected->f32, actual->f32) << "result " << i;
+        continue;
+      default:
+        break;
+    }
+    ASSERT_EQ(static_cast<int>(expected->ref.type),
+              static_cast<int>(actual->ref.type))
+        << "result " << i;
+    if (iree_vm_ro_byte_buffer_isa(&expected->ref)) {
+      // Rodata is stored separately by each module; compare the contents.
+      iree_vm_ro_byte_buffer_t* expected_buffer =
+          iree_vm_ro_byte_buffer_deref(&expected->ref);
+      iree_vm_ro_byte_buffer_t* actual_buffer =
+          iree_vm_ro_byte_buffer_deref(&actual->ref);
+      ASSERT_EQ(expected_buffer == nullptr, actual_buffer == nullptr);
+      if (!expected_buffer) continue;
+      ASSERT_EQ(expected_buffer->data.data_length,
+                actual_buffer->data.data_length);
+      EXPECT_EQ(0, memcmp(expected_buffer->data.data, actual_buffer->data.data,
+                          actual_buffer->data.data_length))
+          << "result " << i;
+    } else {
+      EXPECT_EQ(expected->ref.ptr == nullptr, actual->ref.ptr == nullptr)
+          << "result " << i;
+    }
+  }
+}
+
+// Returns the signature of the export named |function_name| in |module|.
+iree_vm_function_signature_t GetExportSignature(
+    iree_vm_module_t* module, absl::string_view function_name) {
+  iree_vm_module_signature_t module_signature =
+      module->signature(module->self);
+  for (int i = 0; i < module_signature.export_function_count; ++i) {
+    iree_string_view_t name;
+    iree_vm_function_signature_t signature;
+    IREE_CHECK_OK(module->get_function(module->self,
+                                       IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
+                                       nullptr, &name, &signature));
+    if (absl::string_view(name.data, name.size) == function_name) {
+      return signature;
+    }
+  }
+  LOG(FATAL) << "Exported function '" << function_name << "' not found";
+  return {};
+}
+
+class VMCModuleTest : public ::testing::Test,
+                      public ::testing::WithParamInterface<TestParams> {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+
+    IREE_CHECK_OK(bytecode_dispatch_test_c_module_create(IREE_ALLOCATOR_SYSTEM,
+                                                         &c_module_))
+        << "C module failed to load";
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &c_module_, 1, IREE_ALLOCATOR_SYSTEM, &c_context_));
+
+    const auto* module_file_toc =
+        iree::vm::bytecode_dispatch_test_module_create();
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_const_byte_span_t{
+            reinterpret_cast<const uint8_t*>(module_file_toc->data),
+            module_file_toc->size},
+        IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &bytecode_module_))
+        << "Bytecode module failed to load";
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &bytecode_module_, 1, IREE_ALLOCATOR_SYSTEM,
+        &bytecode_context_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(bytecode_context_);
+    iree_vm_module_release(bytecode_module_);
+    iree_vm_context_release(c_context_);
+    iree_vm_module_release(c_module_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Runs |function_name| from |module| in |context|, storing its results in
+  // |outputs|.
+  iree_status_t RunFunction(iree_vm_context_t* context,
+                            iree_vm_module_t* module,
+                            absl::string_view function_name,
+                            iree_vm_variant_list_t* outputs) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(module->lookup_function(
+        module->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+    return iree_vm_invoke(context, function, /*policy=*/nullptr,
+                          /*inputs=*/nullptr, outputs, IREE_ALLOCATOR_SYSTEM);
+  }
+
+  // Runs the C function as a resumable invocation. |out_yield_count| is set to
+  // the number of times it yielded, which is always 0 for C modules as
+  // vm.yield does not suspend native code.
+  iree_status_t RunResumableFunction(absl::string_view function_name,
+                                     int* out_yield_count) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(c_module_->lookup_function(
+        c_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        c_context_, function, /*policy=*/nullptr, /*inputs=*/nullptr,
+        IREE_ALLOCATOR_SYSTEM, &invocation));
+    *out_yield_count = 0;
+    iree_status_t status = iree_vm_invocation_resume(invocation);
+    while (status == IREE_STATUS_UNAVAILABLE) {
+      ++*out_yield_count;
+      status = iree_vm_invocation_resume(invocation);
+    }
+    EXPECT_EQ(status, iree_vm_invocation_query_status(invocation));
+    iree_vm_invocation_release(invocation);
+    return status;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* c_module_ = nullptr;
+  iree_vm_context_t* c_context_ = nullptr;
+  iree_vm_module_t* bytecode_module_ = nullptr;
+  iree_vm_context_t* bytecode_context_ = nullptr;
+};
+
+TEST_P(VMCModuleTest, MatchesBytecode) {
+  const auto& test_params = GetParam();
+  bool expect_failure = absl::StartsWith(test_params.function_name, "fail_");
+
+  iree_vm_variant_list_t* bytecode_outputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(4, IREE_ALLOCATOR_SYSTEM, &bytecode_outputs));
+  iree_vm_variant_list_t* c_outputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(4, IREE_ALLOCATOR_SYSTEM, &c_outputs));
+
+  iree_status_t bytecode_result =
+      RunFunction(bytecode_context_, bytecode_module_,
+                  test_params.function_name, bytecode_outputs);
+  iree_status_t c_result = RunFunction(c_context_, c_module_,
+                                       test_params.function_name, c_outputs);
+  EXPECT_EQ(expect_failure, !iree_status_is_ok(c_result)) << c_result;
+  EXPECT_EQ(bytecode_result, c_result);
+  if (iree_status_is_ok(bytecode_result) && iree_status_is_ok(c_result)) {
+    ExpectMatchingResults(bytecode_outputs, c_outputs);
+  }
+
+  iree_vm_variant_list_free(bytecode_outputs);
+  iree_vm_variant_list_free(c_outputs);
+}
+
+// The C module must declare the same argument and result types as the bytecode
+// module so that callers marshal values identically for both.
+TEST_P(VMCModuleTest, MatchesBytecodeSignature) {
+  const auto& test_params = GetParam();
+  iree_vm_function_signature_t bytecode_signature =
+      GetExportSignature(bytecode_module_, test_params.function_name);
+  iree_vm_function_signature_t c_signature =
+      GetExportSignature(c_module_, test_params.function_name);
+  EXPECT_EQ(bytecode_signature.argument_count, c_signature.argument_count);
+  EXPECT_EQ(bytecode_signature.result_count, c_signature.result_count);
+  EXPECT_EQ(absl::string_view(bytecode_signature.calling_convention.data,
+                              bytecode_signature.calling_convention.size),
+            absl::string_view(c_signature.calling_convention.data,
+                              c_signature.calling_convention.size));
+}
+
+TEST_P(VMCModuleTest, CheckResumable) {
+  const auto& test_params = GetParam();
+  bool expect_failure = absl::StartsWith(test_params.function_name, "fail_");
+
+  int yield_count = 0;
+  iree_status_t result =
+      RunResumableFunction(test_params.function_name, &yield_count);
+  EXPECT_EQ(expect_failure, !iree_status_is_ok(result)) << result;
+  EXPECT_EQ(0, yield_count);
+}
+
+INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMCModuleTest,
+                         ::testing::ValuesIn(GetModuleTestParams()),
+                         ::testing::PrintToStringParamName());
+
+}  // namespace
@@ -95,9 +95,13 @@ static iree_status_t iree_vm_invoke_empty_function(
     return status;
   }
 
+  // Initializers run synchronously and are resumed immediately if they yield.
   iree_vm_execution_result_t result;
-  status = function.module->execute(function.module->self, stack, callee_frame,
-                                    &result);
+  do {
+    status = function.module->execute(function.module->self, stack,
+                                      callee_frame, &result);
+  } while (iree_status_is_ok(status) &&
+           result.state == IREE_VM_EXECUTION_YIELDED);
 
   iree_vm_stack_function_leave(stack);
   return IREE_STATUS_OK;
@@ -210,23 +214,19 @@ static iree_status_t iree_vm_context_destroy(iree_vm_context_t* context) {
   }
 
   if (context->list.count > 0) {
-    // Allocate a scratch stack used for initialization.
-    // If we shrunk the stack (or made it so that it could dynamically grow)
-    // then we could stack-allocate it here and not need the allocator at all.
-    iree_vm_stack_t* stack = NULL;
-    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-        context->allocator, sizeof(iree_vm_stack_t), (void**)&stack));
-    iree_status_t status =
-        iree_vm_stack_init(iree_vm_context_state_resolver(context), stack);
-    if (!iree_status_is_ok(status)) {
-      iree_allocator_free(context->allocator, stack);
-      return status;
-    }
-
-    iree_vm_context_release_modules(context, stack, 0, context->list.count - 1);
-
-    iree_vm_stack_deinit(stack);
-    iree_allocator_free(context->allocator, stack);
+    // Scratch stack used for deinitialization.
+    iree_alignas(16) uint8_t stack_storage[IREE_VM_STACK_DEFAULT_SIZE];
+    iree_byte_span_t stack_storage_span = {stack_storage,
+                                           sizeof(stack_storage)};
+    iree_vm_stack_t stack;
+    IREE_RETURN_IF_ERROR(iree_vm_stack_init(
+        stack_storage_span, iree_vm_context_state_resolver(context),
+        context->allocator, &stack));
+
+    iree_vm_context_release_modules(context, &stack, 0,
+                                    context->list.count - 1);
+
+    iree_vm_stack_deinit(&stack);
   }
 
   // Note: For non-static module lists, it is only dynamically allocated if
@@ -325,18 +325,13 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
     context->list.capacity = new_capacity;
   }
 
-  // Allocate a scratch stack used for initialization.
-  // If we shrunk the stack (or made it so that it could dynamically grow)
-  // then we could stack-allocate it here and not need the allocator at all.
-  iree_vm_stack_t* stack = NULL;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      context->allocator, sizeof(iree_vm_stack_t), (void**)&stack));
-  iree_status_t status =
-      iree_vm_stack_init(iree_vm_context_state_resolver(context), stack);
-  if (!iree_status_is_ok(status)) {
-    iree_allocator_free(context->allocator, stack);
-    return status;
-  }
+  // Scratch stack used for initialization.
+  iree_alignas(16) uint8_t stack_storage[IREE_VM_STACK_DEFAULT_SIZE];
+  iree_byte_span_t stack_storage_span = {stack_storage, sizeof(stack_storage)};
+  iree_vm_stack_t stack;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_init(
+      stack_storage_span, iree_vm_context_state_resolver(context),
+      context->allocator, &stack));
 
   // Retain all modules and allocate their state.
   assert(context->list.capacity >= context->list.count + module_count);
@@ -354,11 +349,10 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
         module->alloc_state(module->self, context->allocator, &module_state);
     if (!iree_status_is_ok(alloc_status)) {
       // NOTE: we need to clean up initialized modules.
-      iree_vm_context_release_modules(context, stack, orig_count,
+      iree_vm_context_release_modules(context, &stack, orig_count,
                                       orig_count + i);
       context->list.count = orig_count;
-      iree_vm_stack_deinit(stack);
-      iree_allocator_free(context->allocator, stack);
+      iree_vm_stack_deinit(&stack);
       return alloc_status;
     }
     context->list.module_states[orig_count + i] = module_state;
@@ -369,11 +363,10 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
         iree_vm_context_resolve_module_imports(context, module, module_state);
     if (!iree_status_is_ok(resolve_status)) {
       // NOTE: we need to clean up initialized modules.
-      iree_vm_context_release_modules(context, stack, orig_count,
+      iree_vm_context_release_modules(context, &stack, orig_count,
                                       orig_count + i);
       context->list.count = orig_count;
-      iree_vm_stack_deinit(stack);
-      iree_allocator_free(context->allocator, stack);
+      iree_vm_stack_deinit(&stack);
       return resolve_status;
     }
 
@@ -387,21 +380,19 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
             module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
             iree_make_cstring_view("__init"), &init_function))) {
       iree_status_t init_status =
-          iree_vm_invoke_empty_function(stack, init_function);
+          iree_vm_invoke_empty_function(&stack, init_function);
       if (!iree_status_is_ok(init_status)) {
         // NOTE: we need to clean up initialized modules.
-        iree_vm_context_release_modules(context, stack, orig_count,
+        iree_vm_context_release_modules(context, &stack, orig_count,
                                         orig_count + i);
         context->list.count = orig_count;
-        iree_vm_stack_deinit(stack);
-        iree_allocator_free(context->allocator, stack);
+        iree_vm_stack_deinit(&stack);
         return init_status;
       }
     }
   }
 
-  iree_vm_stack_deinit(stack);
-  iree_allocator_free(context->allocator, stack);
+  iree_vm_stack_deinit(&stack);
   return IREE_STATUS_OK;
 }
 
@@ -14,12 +14,85 @@
 
 #include "iree/vm/invocation.h"
 
+#include <string.h>
+
+#include "iree/base/atomics.h"
+#include "iree/vm/stack.h"
+
+// Returns the calling convention of |function| or an empty string if the
+// module does not declare one.
+static iree_status_t iree_vm_function_calling_convention(
+    iree_vm_function_t function, iree_string_view_t* out_calling_convention) {
+  iree_vm_function_signature_t signature;
+  memset(&signature, 0, sizeof(signature));
+  IREE_RETURN_IF_ERROR(function.module->get_function(
+      function.module->self, function.linkage, function.ordinal,
+      /*out_function=*/NULL, /*out_name=*/NULL, &signature));
+  *out_calling_convention = signature.calling_convention;
+  return IREE_STATUS_OK;
+}
+
+// Splits |calling_convention| into its argument and result types.
+static void iree_vm_split_calling_convention(
+    iree_string_view_t calling_convention, iree_string_view_t* out_arguments,
+    iree_string_view_t* out_results) {
+  iree_string_view_t empty = IREE_STRING_VIEW_EMPTY;
+  *out_arguments = calling_convention;
+  *out_results = empty;
+  iree_string_view_split(calling_convention, '_', out_arguments, out_results);
+}
+
+// Returns true if |variant| holds a value of the type named by |type_char|.
+static bool iree_vm_variant_matches_type(iree_vm_variant_t* variant,
+                                         char type_char) {
+  switch (type_char) {
+    case 'i':
+      return variant->value_type == IREE_VM_VALUE_TYPE_I32;
+    case 'I':
+      return variant->value_type == IREE_VM_VALUE_TYPE_I64;
+    case 'f':
+      return variant->value_type == IREE_VM_VALUE_TYPE_F32;
+    case 'r':
+      return IREE_VM_VARIANT_IS_REF(variant);
+    default:
+      return false;
+  }
+}
+
 static iree_status_t iree_vm_validate_function_inputs(
-    iree_vm_function_t function, iree_vm_variant_list_t* inputs) {
-  // TODO(benvanik): validate inputs.
+    iree_string_view_t calling_convention, iree_vm_variant_list_t* inputs) {
+  // Without declared types only i32 values and refs can be passed.
+  iree_host_size_t count = inputs ? iree_vm_variant_list_size(inputs) : 0;
+  if (calling_convention.size == 0) {
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      iree_vm_variant_t* variant = iree_vm_variant_list_get(inputs, i);
+      if (IREE_VM_VARIANT_IS_VALUE(variant) &&
+          variant->value_type != IREE_VM_VALUE_TYPE_I32) {
+        return IREE_STATUS_INVALID_ARGUMENT;
+      }
+    }
+    return IREE_STATUS_OK;
+  }
+
+  iree_string_view_t argument_types;
+  iree_string_view_t result_types;
+  iree_vm_split_calling_convention(calling_convention, &argument_types,
+                                   &result_types);
+  if (!inputs) return IREE_STATUS_OK;
+  if (count != argument_types.size) return IREE_STATUS_INVALID_ARGUMENT;
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    if (!iree_vm_variant_matches_type(iree_vm_variant_list_get(inputs, i),
+                                      argument_types.data[i])) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+  }
   return IREE_STATUS_OK;
 }
 
+// Marshals |inputs| into the registers of |callee_frame|. The inputs must have
+// been validated against the calling convention of the callee. i64 values
+// occupy a pair of i32 registers (low bits first) and f32 values are stored
+// bit-for-bit in a single i32 register.
 static iree_status_t iree_vm_marshal_inputs(
     iree_vm_variant_list_t* inputs, iree_vm_stack_frame_t* callee_frame) {
   iree_vm_registers_t* registers = &callee_frame->registers;
@@ -29,42 +102,140 @@ static iree_status_t iree_vm_marshal_inputs(
   for (int i = 0; i < count; ++i) {
     iree_vm_variant_t* variant = iree_vm_variant_list_get(inputs, i);
     if (IREE_VM_VARIANT_IS_REF(variant)) {
+      if (ref_reg > registers->ref_mask) return IREE_STATUS_INVALID_ARGUMENT;
       iree_vm_ref_t* reg_ref = &registers->ref[ref_reg++];
-      memset(reg_ref, 0, sizeof(*reg_ref));
       iree_vm_ref_retain(&variant->ref, reg_ref);
+    } else if (variant->value_type == IREE_VM_VALUE_TYPE_I64) {
+      if (i32_reg + 1 > registers->i32_mask) {
+        return IREE_STATUS_INVALID_ARGUMENT;
+      }
+      uint64_t value = (uint64_t)variant->i64;
+      registers->i32[i32_reg++] = (int32_t)(value & 0xFFFFFFFFu);
+      registers->i32[i32_reg++] = (int32_t)(value >> 32);
+    } else if (variant->value_type == IREE_VM_VALUE_TYPE_F32) {
+      if (i32_reg > registers->i32_mask) return IREE_STATUS_INVALID_ARGUMENT;
+      memcpy(&registers->i32[i32_reg++], &variant->f32, sizeof(float));
     } else {
+      if (i32_reg > registers->i32_mask) return IREE_STATUS_INVALID_ARGUMENT;
       registers->i32[i32_reg++] = variant->i32;
     }
   }
-  registers->ref_register_count = ref_reg;
   return IREE_STATUS_OK;
 }
 
+// Appends the values returned from |callee_frame| to |outputs|, typed by the
+// results of |calling_convention| when it is declared.
 static iree_status_t iree_vm_marshal_outputs(
-    iree_vm_stack_frame_t* callee_frame, iree_vm_variant_list_t* outputs) {
+    iree_string_view_t calling_convention, iree_vm_stack_frame_t* callee_frame,
+    iree_vm_variant_list_t* outputs) {
   iree_vm_registers_t* registers = &callee_frame->registers;
   const iree_vm_register_list_t* return_registers =
       callee_frame->return_registers;
-  for (int i = 0; i < return_registers->size; ++i) {
+  iree_string_view_t argument_types;
+  iree_string_view_t result_types;
+  iree_vm_split_calling_convention(calling_convention, &argument_types,
+                                   &result_types);
+  bool has_result_types = calling_convention.size > 0;
+  int result_ordinal = 0;
+  for (int i = 0; i < return_registers->size; ++i, ++result_ordinal) {
     uint8_t reg = return_registers->registers[i];
     if (reg & IREE_REF_REGISTER_TYPE_BIT) {
       if (reg & IREE_REF_REGISTER_MOVE_BIT) {
         IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_ref_move(
-            outputs, &registers->ref[reg & IREE_REF_REGISTER_MASK]));
+            outputs, &registers->ref[reg & registers->ref_mask]));
       } else {
         IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_ref_retain(
-            outputs, &registers->ref[reg & IREE_REF_REGISTER_MASK]));
+            outputs, &registers->ref[reg & registers->ref_mask]));
       }
-    } else {
-      iree_vm_value_t value;
-      value.type = IREE_VM_VALUE_TYPE_I32;
-      value.i32 = registers->i32[reg & IREE_I32_REGISTER_MASK];
-      IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_value(outputs, value));
+      continue;
+    }
+    char type_char = 'i';
+    if (has_result_types) {
+      if (result_ordinal >= result_types.size) {
+        return IREE_STATUS_FAILED_PRECONDITION;
+      }
+      type_char = result_types.data[result_ordinal];
+    }
+    iree_vm_value_t value;
+    switch (type_char) {
+      case 'I': {
+        // i64 values are returned in a pair of registers, low bits first.
+        if (i + 1 >= return_registers->size) {
+          return IREE_STATUS_FAILED_PRECONDITION;
+        }
+        uint8_t hi_reg = return_registers->registers[++i];
+        uint64_t lo = (uint32_t)registers->i32[reg & registers->i32_mask];
+        uint64_t hi = (uint32_t)registers->i32[hi_reg & registers->i32_mask];
+        value.type = IREE_VM_VALUE_TYPE_I64;
+        value.i64 = (int64_t)(lo | (hi << 32));
+        break;
+      }
+      case 'f':
+        value.type = IREE_VM_VALUE_TYPE_F32;
+        memcpy(&value.f32, &registers->i32[reg & registers->i32_mask],
+               sizeof(float));
+        break;
+      case 'i':
+        value.type = IREE_VM_VALUE_TYPE_I32;
+        value.i32 = registers->i32[reg & registers->i32_mask];
+        break;
+      default:
+        return IREE_STATUS_FAILED_PRECONDITION;
     }
+    IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_value(outputs, value));
   }
   return IREE_STATUS_OK;
 }
 
+// Leaves all frames remaining on |stack|. Frames entered by nested calls remain
+// above the entry frame when execution fails or is aborted within them.
+static void iree_vm_unwind_stack(iree_vm_stack_t* stack) {
+  while (iree_vm_stack_current_frame(stack)) {
+    iree_vm_stack_function_leave(stack);
+  }
+}
+
+// Invokes |function| on |stack| and marshals its inputs and outputs by the
+// |calling_convention| of the function.
+// The stack must be empty and will be empty upon return.
+static iree_status_t iree_vm_invoke_within(
+    iree_vm_stack_t* stack, iree_vm_function_t function,
+    iree_string_view_t calling_convention, iree_vm_variant_list_t* inputs,
+    iree_vm_variant_list_t* outputs) {
+  IREE_RETURN_IF_ERROR(
+      iree_vm_validate_function_inputs(calling_convention, inputs));
+
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_stack_function_enter(stack, function, &callee_frame));
+
+  // Marshal inputs.
+  iree_status_t status = IREE_STATUS_OK;
+  if (inputs) {
+    status = iree_vm_marshal_inputs(inputs, callee_frame);
+  }
+
+  // Perform execution. Synchronous execution immediately resumes the function
+  // each time it yields until it completes.
+  if (iree_status_is_ok(status)) {
+    iree_vm_execution_result_t result;
+    do {
+      status = function.module->execute(function.module->self, stack,
+                                        callee_frame, &result);
+    } while (iree_status_is_ok(status) &&
+             result.state == IREE_VM_EXECUTION_YIELDED);
+  }
+
+  // Marshal outputs.
+  if (iree_status_is_ok(status) && outputs) {
+    status =
+        iree_vm_marshal_outputs(calling_convention, callee_frame, outputs);
+  }
+
+  iree_vm_unwind_stack(stack);
+  return status;
+}
+
 // TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     iree_vm_context_t* context, iree_vm_function_t function,
@@ -73,44 +244,415 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
   // NOTE: it is ok to have no inputs or outputs. If we do have them, though,
   // they must be valid.
   // TODO(benvanik): validate outputs capacity.
-  IREE_RETURN_IF_ERROR(iree_vm_validate_function_inputs(function, inputs));
-
-  // Allocate a stack on the heap and initialize it.
-  // If we shrunk the stack (or made it so that it could dynamically grow)
-  // then we could stack-allocate it here and not need the allocator at all.
-  iree_vm_stack_t* stack = NULL;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, sizeof(iree_vm_stack_t),
-                                             (void**)&stack));
+  iree_string_view_t calling_convention;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_function_calling_convention(function, &calling_convention));
+
+  // Initialize a stack backed by storage on the native stack. Only deep call
+  // chains or very large frames will need to allocate additional blocks.
+  iree_alignas(16) uint8_t stack_storage[IREE_VM_STACK_DEFAULT_SIZE];
+  iree_byte_span_t stack_storage_span = {stack_storage, sizeof(stack_storage)};
+  iree_vm_stack_t stack;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_init(
+      stack_storage_span, iree_vm_context_state_resolver(context), allocator,
+      &stack));
+
+  iree_status_t status = iree_vm_invoke_within(
+      &stack, function, calling_convention, inputs, outputs);
+
+  iree_vm_stack_deinit(&stack);
+  return status;
+}
+
+struct iree_vm_prepared_call {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+  // Declared types of the function arguments and results. Owned by the module.
+  iree_string_view_t calling_convention;
+
+  // Lists stored in the same allocation as the call.
+  iree_vm_variant_list_t* inputs;
+  iree_vm_variant_list_t* outputs;
+
+  // Stack reused across invocations. Its initial storage is stored in the
+  // same allocation as the call and any additional blocks it allocates are
+  // retained until the call is destroyed.
+  iree_vm_stack_t stack;
+};
+
+// Aligns |value| to the 16-byte alignment required by the stack storage.
+static iree_host_size_t iree_vm_align_storage(iree_host_size_t value) {
+  return (value + 15) & ~(iree_host_size_t)15;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_prepared_call_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_variant_list_t* inputs, iree_allocator_t allocator,
+    iree_vm_prepared_call_t** out_call) {
+  if (!out_call) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_call = NULL;
+  if (!context || !function.module) return IREE_STATUS_INVALID_ARGUMENT;
+
+  // Size the lists to the function signature. Inputs provided now may exceed
+  // that if the signature is not available.
+  iree_vm_function_signature_t signature;
+  memset(&signature, 0, sizeof(signature));
+  IREE_RETURN_IF_ERROR(function.module->get_function(
+      function.module->self, function.linkage, function.ordinal,
+      /*out_function=*/NULL, /*out_name=*/NULL, &signature));
+  iree_host_size_t input_capacity = signature.argument_count;
+  if (inputs && iree_vm_variant_list_size(inputs) > input_capacity) {
+    input_capacity = iree_vm_variant_list_size(inputs);
+  }
+  iree_host_size_t output_capacity = signature.result_count;
+
+  // Everything lives in a single allocation:
+  // [call] [stack storage] [input list] [output list]
+  iree_host_size_t stack_storage_offset =
+      iree_vm_align_storage(sizeof(iree_vm_prepared_call_t));
+  iree_host_size_t inputs_offset =
+      stack_storage_offset + IREE_VM_STACK_DEFAULT_SIZE;
+  iree_host_size_t outputs_offset =
+      inputs_offset +
+      iree_vm_align_storage(iree_vm_variant_list_alloc_size(input_capacity));
+  iree_host_size_t total_size =
+      outputs_offset + iree_vm_variant_list_alloc_size(output_capacity);
+  iree_vm_prepared_call_t* call = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, total_size, (void**)&call));
+  iree_atomic_store(&call->ref_count, 1);
+  call->allocator = allocator;
+  call->context = context;
+  iree_vm_context_retain(context);
+  call->function = function;
+  call->calling_convention = signature.calling_convention;
+
+  // The allocation is zeroed so that releasing a partially initialized call
+  // on failure is safe.
+  uint8_t* p = (uint8_t*)call;
+  call->inputs = (iree_vm_variant_list_t*)(p + inputs_offset);
+  call->outputs = (iree_vm_variant_list_t*)(p + outputs_offset);
   iree_status_t status =
-      iree_vm_stack_init(iree_vm_context_state_resolver(context), stack);
+      iree_vm_variant_list_init(call->inputs, input_capacity);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_variant_list_init(call->outputs, output_capacity);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_byte_span_t stack_storage_span = {p + stack_storage_offset,
+                                           IREE_VM_STACK_DEFAULT_SIZE};
+    status = iree_vm_stack_init(stack_storage_span,
+                                iree_vm_context_state_resolver(context),
+                                allocator, &call->stack);
+  }
+
+  // Copy (retaining) any initial inputs.
+  if (iree_status_is_ok(status) && inputs) {
+    iree_vm_variant_list_t* source = (iree_vm_variant_list_t*)inputs;
+    for (iree_host_size_t i = 0;
+         i < iree_vm_variant_list_size(source) && iree_status_is_ok(status);
+         ++i) {
+      iree_vm_variant_t* variant = iree_vm_variant_list_get(source, i);
+      if (IREE_VM_VARIANT_IS_REF(variant)) {
+        status =
+            iree_vm_variant_list_append_ref_retain(call->inputs, &variant->ref);
+      } else {
+        iree_vm_value_t value;
+        value.type = variant->value_type;
+        switch (variant->value_type) {
+          case IREE_VM_VALUE_TYPE_I64:
+            value.i64 = variant->i64;
+            break;
+          case IREE_VM_VALUE_TYPE_F32:
+            value.f32 = variant->f32;
+            break;
+          default:
+            value.i32 = variant->i32;
+            break;
+        }
+        status = iree_vm_variant_list_append_value(call->inputs, value);
+      }
+    }
+  }
+
   if (!iree_status_is_ok(status)) {
-    iree_allocator_free(allocator, stack);
+    iree_vm_prepared_call_release(call);
     return status;
   }
+  *out_call = call;
+  return IREE_STATUS_OK;
+}
 
-  iree_vm_stack_frame_t* callee_frame = NULL;
-  status = iree_vm_stack_function_enter(stack, function, &callee_frame);
+static void iree_vm_prepared_call_destroy(iree_vm_prepared_call_t* call) {
+  iree_vm_stack_deinit(&call->stack);
+  iree_vm_variant_list_clear(call->inputs);
+  iree_vm_variant_list_clear(call->outputs);
+  iree_vm_context_release(call->context);
+  iree_allocator_free(call->allocator, call);
+}
 
-  // Marshal inputs.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_prepared_call_retain(iree_vm_prepared_call_t* call) {
+  if (!call) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_atomic_fetch_add(&call->ref_count, 1);
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_prepared_call_release(iree_vm_prepared_call_t* call) {
+  if (call && iree_atomic_fetch_sub(&call->ref_count, 1) == 1) {
+    iree_vm_prepared_call_destroy(call);
+  }
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_vm_variant_list_t* IREE_API_CALL
+iree_vm_prepared_call_inputs(iree_vm_prepared_call_t* call) {
+  return call ? call->inputs : NULL;
+}
+
+IREE_API_EXPORT iree_vm_variant_list_t* IREE_API_CALL
+iree_vm_prepared_call_outputs(iree_vm_prepared_call_t* call) {
+  return call ? call->outputs : NULL;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_prepared_call_invoke(iree_vm_prepared_call_t* call) {
+  if (!call) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_vm_variant_list_clear(call->outputs);
+  return iree_vm_invoke_within(&call->stack, call->function,
+                               call->calling_convention, call->inputs,
+                               call->outputs);
+}
+
+struct iree_vm_invocation {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+  // Declared types of the function arguments and results. Owned by the module.
+  iree_string_view_t calling_convention;
+
+  // Completion status of the invocation. IREE_STATUS_UNAVAILABLE while the
+  // invocation is still in-flight.
+  iree_atomic_intptr_t status;
+  // Set to 1 when an abort has been requested.
+  iree_atomic_intptr_t abort_requested;
+  // Non-zero while a call to resume is running the invocation.
+  iree_atomic_intptr_t resuming;
+
+  // Output list stored in the same allocation as the invocation.
+  iree_vm_variant_list_t* outputs;
+
+  // Frame of |function| at the bottom of the stack. All execution state,
+  // including any frames entered above this one, lives within the stack.
+  iree_vm_stack_frame_t* entry_frame;
+  iree_vm_stack_t stack;
+};
+
+// Reads an atomic value without modifying it.
+static intptr_t iree_vm_invocation_atomic_read(iree_atomic_intptr_t* value) {
+  return iree_atomic_fetch_add(value, 0);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy,
+    const iree_vm_variant_list_t* inputs, iree_allocator_t allocator,
+    iree_vm_invocation_t** out_invocation) {
+  if (!out_invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_invocation = NULL;
+  if (!context || !function.module) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_vm_function_signature_t signature;
+  memset(&signature, 0, sizeof(signature));
+  IREE_RETURN_IF_ERROR(function.module->get_function(
+      function.module->self, function.linkage, function.ordinal,
+      /*out_function=*/NULL, /*out_name=*/NULL, &signature));
+  IREE_RETURN_IF_ERROR(iree_vm_validate_function_inputs(
+      signature.calling_convention, (iree_vm_variant_list_t*)inputs));
+
+  // Everything lives in a single allocation:
+  // [invocation] [stack storage] [output list]
+  // The stack storage must outlive any single call to resume and as such
+  // cannot live on the native stack as it does with iree_vm_invoke.
+  iree_host_size_t stack_storage_offset =
+      iree_vm_align_storage(sizeof(iree_vm_invocation_t));
+  iree_host_size_t outputs_offset =
+      stack_storage_offset + IREE_VM_STACK_DEFAULT_SIZE;
+  iree_host_size_t total_size =
+      outputs_offset + iree_vm_variant_list_alloc_size(signature.result_count);
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, total_size, (void**)&invocation));
+  iree_atomic_store(&invocation->ref_count, 1);
+  iree_atomic_store(&invocation->status, IREE_STATUS_UNAVAILABLE);
+  iree_atomic_store(&invocation->abort_requested, 0);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->function = function;
+  invocation->calling_convention = signature.calling_convention;
+  invocation->entry_frame = NULL;
+
+  // The allocation is zeroed so that releasing a partially initialized
+  // invocation on failure is safe.
+  uint8_t* p = (uint8_t*)invocation;
+  invocation->outputs = (iree_vm_variant_list_t*)(p + outputs_offset);
+  iree_status_t status =
+      iree_vm_variant_list_init(invocation->outputs, signature.result_count);
+  if (iree_status_is_ok(status)) {
+    iree_byte_span_t stack_storage_span = {p + stack_storage_offset,
+                                           IREE_VM_STACK_DEFAULT_SIZE};
+    status = iree_vm_stack_init(stack_storage_span,
+                                iree_vm_context_state_resolver(context),
+                                allocator, &invocation->stack);
+  }
+
+  // Enter the function and marshal inputs now so that the caller may reuse
+  // the input list immediately.
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_stack_function_enter(&invocation->stack, function,
+                                          &invocation->entry_frame);
+  }
   if (iree_status_is_ok(status) && inputs) {
-    status = iree_vm_marshal_inputs(inputs, callee_frame);
+    status = iree_vm_marshal_inputs((iree_vm_variant_list_t*)inputs,
+                                    invocation->entry_frame);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_vm_invocation_release(invocation);
+    return status;
+  }
+  *out_invocation = invocation;
+  return IREE_STATUS_OK;
+}
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  iree_vm_stack_deinit(&invocation->stack);
+  iree_vm_variant_list_clear(invocation->outputs);
+  iree_vm_context_release(invocation->context);
+  iree_allocator_free(invocation->allocator, invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_atomic_fetch_add(&invocation->ref_count, 1);
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  if (invocation && iree_atomic_fetch_sub(&invocation->ref_count, 1) == 1) {
+    iree_vm_invocation_destroy(invocation);
+  }
+  return IREE_STATUS_OK;
+}
+
+// Completes the invocation with |status|, unwinding any frames that remain on
+// the stack (such as when aborted while yielded).
+static iree_status_t iree_vm_invocation_complete(
+    iree_vm_invocation_t* invocation, iree_status_t status) {
+  iree_vm_unwind_stack(&invocation->stack);
+  invocation->entry_frame = NULL;
+  iree_atomic_store(&invocation->status, status);
+  return status;
+}
+
+// Runs the invocation until it yields or completes. The caller must have
+// exclusive access to the invocation.
+static iree_status_t iree_vm_invocation_resume_exclusive(
+    iree_vm_invocation_t* invocation) {
+  iree_status_t status =
+      (iree_status_t)iree_vm_invocation_atomic_read(&invocation->status);
+  if (status != IREE_STATUS_UNAVAILABLE) return status;
+
+  if (iree_vm_invocation_atomic_read(&invocation->abort_requested)) {
+    return iree_vm_invocation_complete(invocation, IREE_STATUS_ABORTED);
+  }
+
+  // Execution picks up from wherever the stack was left when it last yielded.
+  iree_vm_execution_result_t result;
+  status = invocation->function.module->execute(
+      invocation->function.module->self, &invocation->stack,
+      invocation->entry_frame, &result);
+  if (iree_status_is_ok(status) && result.state == IREE_VM_EXECUTION_YIELDED) {
+    return IREE_STATUS_UNAVAILABLE;
   }
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
   if (iree_status_is_ok(status)) {
-    iree_vm_execution_result_t result;
-    status = function.module->execute(function.module->self, stack,
-                                      callee_frame, &result);
+    status = iree_vm_marshal_outputs(invocation->calling_convention,
+                                     invocation->entry_frame,
+                                     invocation->outputs);
   }
+  return iree_vm_invocation_complete(invocation, status);
+}
 
-  // Marshal outputs.
-  if (iree_status_is_ok(status) && outputs) {
-    status = iree_vm_marshal_outputs(callee_frame, outputs);
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+
+  // Only the caller that takes the count from zero may run the invocation.
+  // Others undo their increment and fail instead of racing on the stack.
+  if (iree_atomic_fetch_add(&invocation->resuming, 1) != 0) {
+    iree_atomic_fetch_sub(&invocation->resuming, 1);
+    return IREE_STATUS_FAILED_PRECONDITION;
+  }
+  iree_status_t status = iree_vm_invocation_resume_exclusive(invocation);
+  iree_atomic_fetch_sub(&invocation->resuming, 1);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  return (iree_status_t)iree_vm_invocation_atomic_read(&invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_variant_list_t* IREE_API_CALL
+iree_vm_invocation_output(iree_vm_invocation_t* invocation) {
+  if (!iree_status_is_ok(iree_vm_invocation_query_status(invocation))) {
+    return NULL;
+  }
+  return invocation->outputs;
+}
+
+// Returns true if |deadline| has elapsed.
+static bool iree_vm_invocation_deadline_elapsed(iree_time_t deadline) {
+  if (deadline == IREE_TIME_INFINITE_FUTURE) return false;
+  if (deadline == IREE_TIME_INFINITE_PAST) return true;
+  return iree_time_now() >= deadline;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_status_t status = iree_vm_invocation_query_status(invocation);
+  if (status != IREE_STATUS_UNAVAILABLE) return status;
+
+  // Polling always makes progress by resuming once, even though the deadline
+  // has already elapsed.
+  if (deadline == IREE_TIME_INFINITE_PAST) {
+    status = iree_vm_invocation_resume(invocation);
+    return status == IREE_STATUS_UNAVAILABLE ? IREE_STATUS_DEADLINE_EXCEEDED
+                                             : status;
   }
 
-  iree_vm_stack_function_leave(stack);
-  iree_vm_stack_deinit(stack);
-  iree_allocator_free(allocator, stack);
+  // There are no wait operations in the VM and a yielded invocation is always
+  // runnable, so the deadline only needs to be checked between resumes.
+  do {
+    if (iree_vm_invocation_deadline_elapsed(deadline)) {
+      return IREE_STATUS_DEADLINE_EXCEEDED;
+    }
+    status = iree_vm_invocation_resume(invocation);
+  } while (status == IREE_STATUS_UNAVAILABLE);
   return status;
 }
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_atomic_store(&invocation->abort_requested, 1);
+  return IREE_STATUS_OK;
+}
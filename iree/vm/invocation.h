@@ -28,6 +28,7 @@ extern "C" {
 
 typedef struct iree_vm_invocation iree_vm_invocation_t;
 typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
+typedef struct iree_vm_prepared_call iree_vm_prepared_call_t;
 
 #ifndef IREE_API_NO_PROTOTYPES
 
@@ -39,17 +40,86 @@ typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
 //
 // |inputs| is used to pass values and objects into the target function and must
 // match the signature defined by the compiled function. List ownership remains
-// with the caller.
+// with the caller. Returns IREE_STATUS_INVALID_ARGUMENT if the input types do
+// not match the calling convention of the function.
 //
 // |outputs| is populated after the function completes execution with the
-// output values and objects of the function. List ownership remains with the
-// caller.
+// output values and objects of the function, typed by the calling convention.
+// List ownership remains with the caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, iree_vm_variant_list_t* inputs,
     iree_vm_variant_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Prepares a synchronous call to |function| that can be invoked repeatedly.
+//
+// All resources required to perform the call are allocated once here: the
+// stack (including frame storage) and the input and output lists sized to the
+// function signature. Subsequent calls to iree_vm_prepared_call_invoke will
+// not allocate unless the call chain exceeds the preallocated stack storage,
+// and even then the additional storage is retained for reuse.
+//
+// |inputs| may optionally be provided to populate the input list. Otherwise
+// callers can populate the list returned by iree_vm_prepared_call_inputs.
+//
+// Prepared calls are thread-compatible: a single call may only be invoked from
+// one thread at a time, though many calls may be prepared for the same
+// function and invoked concurrently.
+//
+// |out_call| must be released by the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_prepared_call_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_variant_list_t* inputs, iree_allocator_t allocator,
+    iree_vm_prepared_call_t** out_call);
+
+// Retains the given |call| for the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_prepared_call_retain(iree_vm_prepared_call_t* call);
+
+// Releases the given |call| from the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_prepared_call_release(iree_vm_prepared_call_t* call);
+
+// Returns the input list of the call. Inputs are preserved across invocations
+// and callers may either update values in-place with iree_vm_variant_list_get
+// or reset the list with iree_vm_variant_list_clear and append new values.
+// The list has capacity for the number of arguments of the function.
+IREE_API_EXPORT iree_vm_variant_list_t* IREE_API_CALL
+iree_vm_prepared_call_inputs(iree_vm_prepared_call_t* call);
+
+// Returns the output list populated by the last invocation of the call.
+// The list is cleared at the start of each invocation and callers must retain
+// any refs they want to outlive the next invocation.
+IREE_API_EXPORT iree_vm_variant_list_t* IREE_API_CALL
+iree_vm_prepared_call_outputs(iree_vm_prepared_call_t* call);
+
+// Synchronously invokes the prepared call with its current inputs.
+// On success the outputs are available via iree_vm_prepared_call_outputs.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_prepared_call_invoke(iree_vm_prepared_call_t* call);
+
+// Creates a resumable invocation of |function| in the VM.
+//
+// Unlike iree_vm_invoke the invocation does not run on creation and does not
+// block when the function yields (such as with vm.yield). Instead it is run
+// in steps with iree_vm_invocation_resume, each step continuing until the
+// function either yields or completes. All execution state is stored within
+// the invocation and it may be resumed from any thread, allowing a single
+// thread to multiplex many in-flight invocations.
+//
+// |policy| is used to schedule the invocation relative to other pending or
+// in-flight invocations. It may be omitted to leave the behavior up to the
+// implementation.
+//
+// |inputs| is used to pass values and objects into the target function and
+// must match the signature defined by the compiled function. List ownership
+// remains with the caller and the inputs are consumed during creation.
+//
+// Only one thread may resume an invocation at a time; resuming an invocation
+// that is already being resumed fails with IREE_STATUS_FAILED_PRECONDITION.
+// Status queries and aborts are thread-safe.
+//
+// |out_invocation| must be released by the caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy,
@@ -64,6 +134,18 @@ iree_vm_invocation_retain(iree_vm_invocation_t* invocation);
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_invocation_release(iree_vm_invocation_t* invocation);
 
+// Runs the invocation until it yields or completes.
+// Returns one of the following:
+//   IREE_STATUS_OK: the invocation completed successfully.
+//   IREE_STATUS_UNAVAILABLE: the invocation yielded and should be resumed.
+//   IREE_STATUS_ABORTED: the invocation was aborted.
+//   IREE_STATUS_FAILED_PRECONDITION: the invocation is being resumed by
+//     another caller.
+//   IREE_STATUS_*: an error occurred during invocation.
+// Resuming a completed invocation returns its completion status.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation);
+
 // Queries the completion status of the invocation.
 // Returns one of the following:
 //   IREE_STATUS_OK: the invocation completed successfully.
@@ -84,14 +166,21 @@ IREE_API_EXPORT const iree_vm_variant_list_t* IREE_API_CALL
 iree_vm_invocation_output(iree_vm_invocation_t* invocation);
 
 // Blocks the caller until the invocation completes (successfully or otherwise).
+// The invocation is resumed on the calling thread each time it yields.
 //
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if |deadline| elapses before the
 // invocation completes and otherwise returns iree_vm_invocation_query_status.
+// The deadline is checked before each resume; an invocation that has not yet
+// completed is not resumed once its deadline has elapsed. A deadline of
+// IREE_TIME_INFINITE_PAST resumes the invocation at most once and can be used
+// to poll. Fails with IREE_STATUS_FAILED_PRECONDITION if the invocation is
+// being resumed by another caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
     iree_vm_invocation_t* invocation, iree_time_t deadline);
 
 // Attempts to abort the invocation if it is in-flight.
-// A no-op if the invocation has already completed.
+// A no-op if the invocation has already completed. The invocation is aborted
+// the next time it is resumed; it is not interrupted if currently running.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_invocation_abort(iree_vm_invocation_t* invocation);
 
@@ -0,0 +1,318 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/invocation.h"
+
+#include <cstring>
+#include <functional>
+#include <utility>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/module.h"
+#include "iree/vm/stack.h"
+#include "iree/vm/variant_list.h"
+
+namespace {
+
+// Native module exporting the functions:
+//   call_nested(%fail : i32) -> i32
+//   swap(%a : i64, %b : f32) -> (f32, i64)
+// call_nested enters a nested frame and, if |fail| is non-zero, fails without
+// leaving it as a callee failing in the middle of execution would. Otherwise it
+// returns 42. The function fails with FAILED_PRECONDITION if it is not entered
+// on an empty stack. An optional callback runs each time the function executes.
+// swap declares its types and returns its arguments in reverse order.
+class NestedCallModule {
+ public:
+  static constexpr int32_t kCallNestedOrdinal = 0;
+  static constexpr int32_t kSwapOrdinal = 1;
+
+  NestedCallModule() {
+    iree_vm_module_init(&interface_, this);
+    interface_.destroy = Destroy;
+    interface_.name = Name;
+    interface_.signature = Signature;
+    interface_.get_function = GetFunction;
+    interface_.lookup_function = LookupFunction;
+    interface_.alloc_state = AllocState;
+    interface_.free_state = FreeState;
+    interface_.execute = Execute;
+  }
+
+  iree_vm_module_t* interface() { return &interface_; }
+
+  void set_on_execute(std::function<void()> on_execute) {
+    on_execute_ = std::move(on_execute);
+  }
+
+  iree_vm_function_t function(int32_t ordinal) {
+    iree_vm_function_t function;
+    std::memset(&function, 0, sizeof(function));
+    function.module = &interface_;
+    function.linkage = IREE_VM_FUNCTION_LINKAGE_EXPORT;
+    function.ordinal = ordinal;
+    function.i32_register_count = ordinal == kSwapOrdinal ? 3 : 1;
+    return function;
+  }
+
+ private:
+  static iree_status_t Destroy(void* self) { return IREE_STATUS_OK; }
+
+  static iree_string_view_t Name(void* self) {
+    return iree_make_cstring_view("nested");
+  }
+
+  static iree_vm_module_signature_t Signature(void* self) {
+    iree_vm_module_signature_t signature;
+    std::memset(&signature, 0, sizeof(signature));
+    signature.export_function_count = 2;
+    return signature;
+  }
+
+  static iree_status_t GetFunction(
+      void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
+      iree_vm_function_t* out_function, iree_string_view_t* out_name,
+      iree_vm_function_signature_t* out_signature) {
+    if (ordinal != kCallNestedOrdinal && ordinal != kSwapOrdinal) {
+      return IREE_STATUS_OUT_OF_RANGE;
+    }
+    auto* module = reinterpret_cast<NestedCallModule*>(self);
+    if (out_function) *out_function = module->function(ordinal);
+    if (out_name) {
+      *out_name = iree_make_cstring_view(
+          ordinal == kSwapOrdinal ? "swap" : "call_nested");
+    }
+    if (out_signature) {
+      std::memset(out_signature, 0, sizeof(*out_signature));
+      if (ordinal == kSwapOrdinal) {
+        out_signature->argument_count = 2;
+        out_signature->result_count = 2;
+        out_signature->calling_convention = iree_make_cstring_view("If_fI");
+      } else {
+        out_signature->argument_count = 1;
+        out_signature->result_count = 1;
+      }
+    }
+    return IREE_STATUS_OK;
+  }
+
+  static iree_status_t LookupFunction(void* self,
+                                      iree_vm_function_linkage_t linkage,
+                                      iree_string_view_t name,
+                                      iree_vm_function_t* out_function) {
+    auto* module = reinterpret_cast<NestedCallModule*>(self);
+    if (iree_string_view_compare(name, iree_make_cstring_view("swap")) == 0) {
+      *out_function = module->function(kSwapOrdinal);
+    } else if (iree_string_view_compare(
+                   name, iree_make_cstring_view("call_nested")) == 0) {
+      *out_function = module->function(kCallNestedOrdinal);
+    } else {
+      return IREE_STATUS_NOT_FOUND;
+    }
+    return IREE_STATUS_OK;
+  }
+
+  static iree_status_t AllocState(void* self, iree_allocator_t allocator,
+                                  iree_vm_module_state_t** out_module_state) {
+    *out_module_state = nullptr;
+    return IREE_STATUS_OK;
+  }
+
+  static iree_status_t FreeState(void* self,
+                                 iree_vm_module_state_t* module_state) {
+    return IREE_STATUS_OK;
+  }
+
+  static iree_status_t Execute(void* self, iree_vm_stack_t* stack,
+                               iree_vm_stack_frame_t* frame,
+                               iree_vm_execution_result_t* out_result) {
+    if (frame->parent) return IREE_STATUS_FAILED_PRECONDITION;
+    std::memset(out_result, 0, sizeof(*out_result));
+    if (frame->function.ordinal == kSwapOrdinal) {
+      // %a occupies registers 0 and 1 (low bits first) and %b register 2.
+      static const uint8_t kSwapReturnRegisters[] = {3, 2, 0, 1};
+      frame->return_registers =
+          reinterpret_cast<const iree_vm_register_list_t*>(
+              kSwapReturnRegisters);
+      out_result->state = IREE_VM_EXECUTION_COMPLETED;
+      return IREE_STATUS_OK;
+    }
+
+    auto* module = reinterpret_cast<NestedCallModule*>(self);
+    if (module->on_execute_) module->on_execute_();
+    iree_vm_stack_frame_t* nested_frame = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+        stack, module->function(kCallNestedOrdinal), &nested_frame));
+    if (frame->registers.i32[0]) return IREE_STATUS_INTERNAL;
+    IREE_RETURN_IF_ERROR(iree_vm_stack_function_leave(stack));
+
+    static const uint8_t kReturnRegisters[] = {1, 0};
+    frame->registers.i32[0] = 42;
+    frame->return_registers =
+        reinterpret_cast<const iree_vm_register_list_t*>(kReturnRegisters);
+    out_result->state = IREE_VM_EXECUTION_COMPLETED;
+    return IREE_STATUS_OK;
+  }
+
+  iree_vm_module_t interface_;
+  std::function<void()> on_execute_;
+};
+
+class VMInvocationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+    iree_vm_module_t* modules[] = {module_.interface()};
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance_, modules, 1, IREE_ALLOCATOR_SYSTEM, &context_));
+  }
+
+  void TearDown() override {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  NestedCallModule module_;
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+// Tests that a prepared call remains usable after failing in a nested call.
+TEST_F(VMInvocationTest, PreparedCallFailureInNestedCall) {
+  iree_vm_prepared_call_t* call = nullptr;
+  IREE_ASSERT_OK(iree_vm_prepared_call_create(
+      context_, module_.function(0), /*inputs=*/nullptr, IREE_ALLOCATOR_SYSTEM,
+      &call));
+  iree_vm_variant_list_t* inputs = iree_vm_prepared_call_inputs(call);
+  iree_vm_value_t fail;
+  fail.type = IREE_VM_VALUE_TYPE_I32;
+  fail.i32 = 1;
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, fail));
+
+  EXPECT_EQ(IREE_STATUS_INTERNAL, iree_vm_prepared_call_invoke(call));
+  EXPECT_EQ(IREE_STATUS_INTERNAL, iree_vm_prepared_call_invoke(call));
+
+  iree_vm_variant_list_get(inputs, 0)->i32 = 0;
+  IREE_EXPECT_OK(iree_vm_prepared_call_invoke(call));
+  iree_vm_variant_list_t* outputs = iree_vm_prepared_call_outputs(call);
+  ASSERT_EQ(1, iree_vm_variant_list_size(outputs));
+  EXPECT_EQ(42, iree_vm_variant_list_get(outputs, 0)->i32);
+
+  iree_vm_prepared_call_release(call);
+}
+
+// Tests that an invocation cannot be resumed while it is already running.
+TEST_F(VMInvocationTest, ResumeWhileRunning) {
+  iree_vm_variant_list_t* inputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &inputs));
+  iree_vm_value_t fail;
+  fail.type = IREE_VM_VALUE_TYPE_I32;
+  fail.i32 = 0;
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, fail));
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(
+      context_, module_.function(0), /*policy=*/nullptr, inputs,
+      IREE_ALLOCATOR_SYSTEM, &invocation));
+  iree_vm_variant_list_free(inputs);
+
+  // Resumes from within execution as a racing thread would.
+  iree_status_t running_status = IREE_STATUS_OK;
+  module_.set_on_execute(
+      [&]() { running_status = iree_vm_invocation_resume(invocation); });
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(IREE_STATUS_FAILED_PRECONDITION, running_status);
+
+  // Once the resume has returned the invocation may be resumed again.
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  const iree_vm_variant_list_t* outputs = iree_vm_invocation_output(invocation);
+  ASSERT_NE(nullptr, outputs);
+  auto* mutable_outputs = const_cast<iree_vm_variant_list_t*>(outputs);
+  ASSERT_EQ(1, iree_vm_variant_list_size(mutable_outputs));
+  EXPECT_EQ(42, iree_vm_variant_list_get(mutable_outputs, 0)->i32);
+
+  iree_vm_invocation_release(invocation);
+}
+
+// Tests that i64 and f32 values are marshaled by their declared types.
+TEST_F(VMInvocationTest, InvokeTypedValues) {
+  iree_vm_variant_list_t* inputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(2, IREE_ALLOCATOR_SYSTEM, &inputs));
+  iree_vm_value_t a;
+  a.type = IREE_VM_VALUE_TYPE_I64;
+  a.i64 = -0x123456789ABCDEFll;
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, a));
+  iree_vm_value_t b;
+  b.type = IREE_VM_VALUE_TYPE_F32;
+  b.f32 = 1.5f;
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, b));
+  iree_vm_variant_list_t* outputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(2, IREE_ALLOCATOR_SYSTEM, &outputs));
+
+  iree_vm_function_t swap =
+      module_.function(NestedCallModule::kSwapOrdinal);
+  IREE_ASSERT_OK(iree_vm_invoke(context_, swap, /*policy=*/nullptr, inputs,
+                                outputs, IREE_ALLOCATOR_SYSTEM));
+  ASSERT_EQ(2, iree_vm_variant_list_size(outputs));
+  iree_vm_variant_t* result_b = iree_vm_variant_list_get(outputs, 0);
+  EXPECT_EQ(IREE_VM_VALUE_TYPE_F32, result_b->value_type);
+  EXPECT_EQ(1.5f, result_b->f32);
+  iree_vm_variant_t* result_a = iree_vm_variant_list_get(outputs, 1);
+  EXPECT_EQ(IREE_VM_VALUE_TYPE_I64, result_a->value_type);
+  EXPECT_EQ(-0x123456789ABCDEFll, result_a->i64);
+
+  iree_vm_variant_list_free(outputs);
+  iree_vm_variant_list_free(inputs);
+}
+
+// Tests that inputs not matching the declared types are rejected.
+TEST_F(VMInvocationTest, InvokeMismatchedTypes) {
+  iree_vm_function_t swap =
+      module_.function(NestedCallModule::kSwapOrdinal);
+  iree_vm_variant_list_t* inputs = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(2, IREE_ALLOCATOR_SYSTEM, &inputs));
+  iree_vm_value_t value;
+  value.type = IREE_VM_VALUE_TYPE_I32;
+  value.i32 = 1;
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, value));
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            iree_vm_invoke(context_, swap, /*policy=*/nullptr, inputs,
+                           /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM));
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, value));
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            iree_vm_invoke(context_, swap, /*policy=*/nullptr, inputs,
+                           /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM));
+  iree_vm_variant_list_free(inputs);
+
+  // Functions without declared types only accept i32 values.
+  iree_vm_function_t call_nested =
+      module_.function(NestedCallModule::kCallNestedOrdinal);
+  IREE_ASSERT_OK(
+      iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &inputs));
+  value.type = IREE_VM_VALUE_TYPE_I64;
+  value.i64 = 0;
+  IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, value));
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            iree_vm_invoke(context_, call_nested, /*policy=*/nullptr, inputs,
+                           /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM));
+  iree_vm_variant_list_free(inputs);
+}
+
+}  // namespace
@@ -49,6 +49,11 @@ typedef struct {
   iree_vm_function_linkage_t linkage;
   // Ordinal within the module in the linkage scope.
   int32_t ordinal;
+  // Number of registers in each bank required by stack frames of the function.
+  // If both are 0 the module does not declare its requirements (such as with
+  // native functions) and frames will reserve the maximum register counts.
+  uint16_t i32_register_count;
+  uint16_t ref_register_count;
 } iree_vm_function_t;
 
 // Describes the expected calling convention and arguments/results of a
@@ -58,6 +63,12 @@ typedef struct {
   int32_t argument_count;
   // Total number of results from the function.
   int32_t result_count;
+  // Declared types of the arguments and results with one character per value:
+  // 'i' (i32), 'I' (i64), 'f' (f32) or 'r' (ref). Arguments are separated from
+  // results by '_', such as "iI_f" for (i32, i64) -> f32.
+  // Empty if the module does not declare types, in which case primitive values
+  // are passed as i32.
+  iree_string_view_t calling_convention;
 } iree_vm_function_signature_t;
 
 // Describes the imports, exports, and capabilities of a module.
@@ -76,14 +87,24 @@ typedef struct {
 // VM functions and accessing this state.
 typedef struct iree_vm_module_state iree_vm_module_state_t;
 
+// Describes how an iree_vm_module_execute request left execution.
+typedef enum {
+  // The frame passed to execute returned and its results are available.
+  IREE_VM_EXECUTION_COMPLETED = 0,
+  // Execution yielded (such as with a vm.yield) and may be resumed by calling
+  // execute again with the same stack and frame. All state required to resume
+  // is stored within the stack, allowing the execution to be resumed from any
+  // thread.
+  IREE_VM_EXECUTION_YIELDED = 1,
+} iree_vm_execution_state_t;
+
 // Results of an iree_vm_module_execute request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
+  // Whether the execution completed or yielded.
+  iree_vm_execution_state_t state;
+  // TODO(benvanik): additional yield modes:
   // - await (with 1+ wait handles)
   // - break
-  int reserved;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -139,6 +160,9 @@ typedef struct iree_vm_module {
   // Asynchronously executes the function specified in the |frame|.
   // This may be called repeatedly for the same frame if the execution
   // previously yielded. The offset within the frame is preserved across calls.
+  // When |out_result| indicates IREE_VM_EXECUTION_YIELDED the frame (and any
+  // frames the execution entered above it) remain on the stack and the caller
+  // must not leave the frame until execution completes.
   iree_status_t(IREE_API_PTR* execute)(void* self, iree_vm_stack_t* stack,
                                        iree_vm_stack_frame_t* frame,
                                        iree_vm_execution_result_t* out_result);
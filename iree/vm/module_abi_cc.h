@@ -151,10 +151,14 @@ class NativeModule {
       out_function->linkage = IREE_VM_FUNCTION_LINKAGE_EXPORT;
       out_function->ordinal = ordinal;
     }
+    const auto& dispatch_function = module->dispatch_table_[ordinal];
     if (out_name) {
-      const auto& dispatch_function = module->dispatch_table_[ordinal];
       *out_name = iree_make_cstring_view(dispatch_function.name);
     }
+    if (out_signature) {
+      out_signature->argument_count = dispatch_function.argument_count;
+      out_signature->result_count = dispatch_function.result_count;
+    }
     return IREE_STATUS_OK;
   }
 
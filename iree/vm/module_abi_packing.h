@@ -317,7 +317,7 @@ struct ResultPack<ref<T>> {
     }
     auto* reg_ptr =
         &result_state->frame->registers.ref[result_state->ref_ordinal++];
-    std::memset(reg_ptr, 0, sizeof(*reg_ptr));
+    iree_vm_ref_release(reg_ptr);
     iree_vm_ref_wrap_assign(value.release(), value.type(), reg_ptr);
   }
 };
@@ -328,7 +328,7 @@ struct ResultPack<absl::optional<ref<T>>> {
                     absl::optional<ref<T>> value) {
     auto* reg_ptr =
         &result_state->frame->registers.ref[result_state->ref_ordinal++];
-    std::memset(reg_ptr, 0, sizeof(*reg_ptr));
+    iree_vm_ref_release(reg_ptr);
     if (value.has_value()) {
       iree_vm_ref_wrap_assign(value.release(), value.type(), reg_ptr);
     }
@@ -377,7 +377,6 @@ struct DispatchFunctor {
                      ParamUnpackState::LoadSequence<Params...>(frame));
 
     frame->return_registers = nullptr;
-    frame->registers.ref_register_count = 0;
 
     auto results_or =
         ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
@@ -420,7 +419,6 @@ struct DispatchFunctorVoid {
                      ParamUnpackState::LoadSequence<Params...>(frame));
 
     frame->return_registers = nullptr;
-    frame->registers.ref_register_count = 0;
 
     return ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
                    std::make_index_sequence<sizeof...(Params)>());
@@ -442,20 +440,26 @@ struct NativeFunction {
   Status (*const call)(void (Owner::*ptr)(), Owner* self,
                        iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
                        iree_vm_execution_result_t* out_result);
+  // Total number of arguments to the function.
+  const int32_t argument_count;
+  // Total number of results from the function, with tuples flattened.
+  const int32_t result_count;
 };
 
 template <typename Owner, typename Result, typename... Params>
 constexpr NativeFunction<Owner> MakeNativeFunction(
     const char* name, StatusOr<Result> (Owner::*fn)(Params...)) {
   return {name, (void (Owner::*)())fn,
-          &packing::DispatchFunctor<Owner, Result, Params...>::Call};
+          &packing::DispatchFunctor<Owner, Result, Params...>::Call,
+          sizeof...(Params), packing::impl::LeafCount<Result>::value};
 }
 
 template <typename Owner, typename... Params>
 constexpr NativeFunction<Owner> MakeNativeFunction(
     const char* name, Status (Owner::*fn)(Params...)) {
   return {name, (void (Owner::*)())fn,
-          &packing::DispatchFunctorVoid<Owner, Params...>::Call};
+          &packing::DispatchFunctorVoid<Owner, Params...>::Call,
+          sizeof...(Params), 0};
 }
 
 }  // namespace vm
@@ -27,9 +27,6 @@
   ((volatile iree_atomic_intptr_t*)(((uintptr_t)ref->ptr) + \
                                     ref->offsetof_counter))
 
-// TODO(benvanik): dynamic, if we care - otherwise keep small.
-#define IREE_VM_MAX_TYPE_ID 64
-
 IREE_API_EXPORT void IREE_API_CALL iree_vm_ref_object_retain(
     void* ptr, const iree_vm_ref_type_descriptor_t* type_descriptor) {
   if (!ptr) return;
@@ -51,57 +48,199 @@ IREE_API_EXPORT void IREE_API_CALL iree_vm_ref_object_release(
   }
 }
 
-// A table of type descriptors registered at startup.
-// These provide quick dereferencing of destruction functions and type names for
-// debugging. Note that this just points to registered descriptors (or NULL) for
-// each type ID in the type range and does not own the descriptors.
+//===----------------------------------------------------------------------===//
+// Type registry
+//===----------------------------------------------------------------------===//
+
+// Type IDs are assigned densely starting at 1 ([0] is always the NULL type).
+// Descriptors are stored in fixed-size pages indexed by type ID that are never
+// moved or freed once allocated so that the (extremely common) lookup of a
+// descriptor by ID is lock-free and O(1). Callers can only have a type ID after
+// the type has been registered and as such the registration happens-before any
+// lookups of it.
 //
-// Note that [0] is always the NULL type and has a NULL descriptor. We don't
-// allow types to be registered there.
-static const iree_vm_ref_type_descriptor_t*
-    iree_vm_ref_type_descriptors[IREE_VM_MAX_TYPE_ID] = {0};
+// Name lookups (used when resolving module types at load time) go through an
+// open-addressing hash table that is rebuilt as it grows. It and type
+// registration are guarded by the registry lock.
+//
+// The registry does not own the descriptors and they must remain valid for the
+// lifetime of the process.
+#define IREE_VM_REF_TYPE_PAGE_CAPACITY 256
+#define IREE_VM_REF_TYPE_MAX_PAGE_COUNT 4096
+#define IREE_VM_REF_TYPE_MAX_COUNT \
+  (IREE_VM_REF_TYPE_PAGE_CAPACITY * IREE_VM_REF_TYPE_MAX_PAGE_COUNT)
+static_assert(IREE_VM_REF_TYPE_MAX_COUNT <= IREE_VM_REF_TYPE_MAX_VALUE,
+              "type IDs must fit in the iree_vm_ref_t type bits");
+
+// Initial capacity of the name table; must be a power of two.
+#define IREE_VM_REF_TYPE_INITIAL_NAME_CAPACITY 64
+
+typedef const iree_vm_ref_type_descriptor_t*
+    iree_vm_ref_type_page_t[IREE_VM_REF_TYPE_PAGE_CAPACITY];
+
+typedef struct {
+  // Allocator used for pages and the name table.
+  iree_allocator_t allocator;
+
+  // Ticket lock guarding registration and the name table.
+  iree_atomic_intptr_t next_ticket;
+  iree_atomic_intptr_t serving_ticket;
+
+  // Total number of type IDs assigned, including the NULL type.
+  iree_host_size_t type_count;
+  // Pages of descriptors indexed by type ID.
+  iree_vm_ref_type_page_t* pages[IREE_VM_REF_TYPE_MAX_PAGE_COUNT];
+
+  // Open-addressing hash table of descriptors keyed by type name.
+  // Capacity is always a power of two and at most half full.
+  iree_host_size_t name_capacity;
+  const iree_vm_ref_type_descriptor_t** name_table;
+} iree_vm_ref_type_registry_t;
+
+static iree_vm_ref_type_registry_t iree_vm_ref_type_registry = {
+    IREE_ALLOCATOR_SYSTEM,
+    IREE_ATOMIC_VAR_INIT(0),
+    IREE_ATOMIC_VAR_INIT(0),
+    1,
+    {0},
+    0,
+    NULL,
+};
+
+static void iree_vm_ref_type_registry_lock(
+    iree_vm_ref_type_registry_t* registry) {
+  intptr_t ticket = iree_atomic_fetch_add(&registry->next_ticket, 1);
+  // NOTE: contention only occurs if types are registered or looked up from
+  // multiple threads at once (such as concurrent module loads) and the
+  // critical sections are short.
+  while (iree_atomic_fetch_add(&registry->serving_ticket, 0) != ticket) {
+  }
+}
+
+static void iree_vm_ref_type_registry_unlock(
+    iree_vm_ref_type_registry_t* registry) {
+  iree_atomic_fetch_add(&registry->serving_ticket, 1);
+}
+
+// FNV-1a over the type name.
+static uint64_t iree_vm_ref_type_name_hash(iree_string_view_t name) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < name.size; ++i) {
+    hash ^= (uint8_t)name.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Returns the slot in |name_table| that either contains the descriptor with
+// |name| or is the empty slot where it should be inserted.
+static const iree_vm_ref_type_descriptor_t** iree_vm_ref_type_name_slot(
+    const iree_vm_ref_type_descriptor_t** name_table,
+    iree_host_size_t name_capacity, iree_string_view_t name) {
+  iree_host_size_t mask = name_capacity - 1;
+  iree_host_size_t i = (iree_host_size_t)iree_vm_ref_type_name_hash(name);
+  for (;; ++i) {
+    const iree_vm_ref_type_descriptor_t** slot = &name_table[i & mask];
+    if (!*slot || iree_string_view_compare((*slot)->type_name, name) == 0) {
+      return slot;
+    }
+  }
+}
+
+// Ensures the name table has room for one more entry, rehashing if needed.
+static iree_status_t iree_vm_ref_type_registry_reserve_name(
+    iree_vm_ref_type_registry_t* registry) {
+  iree_host_size_t name_count = registry->type_count - 1;
+  if ((name_count + 1) * 2 <= registry->name_capacity) {
+    return IREE_STATUS_OK;
+  }
+  iree_host_size_t new_capacity =
+      registry->name_capacity ? registry->name_capacity * 2
+                              : IREE_VM_REF_TYPE_INITIAL_NAME_CAPACITY;
+  const iree_vm_ref_type_descriptor_t** new_table = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      registry->allocator, new_capacity * sizeof(*new_table),
+      (void**)&new_table));
+  for (iree_host_size_t i = 0; i < registry->name_capacity; ++i) {
+    const iree_vm_ref_type_descriptor_t* descriptor = registry->name_table[i];
+    if (!descriptor) continue;
+    *iree_vm_ref_type_name_slot(new_table, new_capacity,
+                                descriptor->type_name) = descriptor;
+  }
+  iree_allocator_free(registry->allocator, (void*)registry->name_table);
+  registry->name_table = new_table;
+  registry->name_capacity = new_capacity;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_ref_type_registry_insert(
+    iree_vm_ref_type_registry_t* registry,
+    iree_vm_ref_type_descriptor_t* descriptor) {
+  if (registry->type_count >= IREE_VM_REF_TYPE_MAX_COUNT) {
+    // Too many user-defined types registered.
+    return IREE_STATUS_RESOURCE_EXHAUSTED;
+  }
+  IREE_RETURN_IF_ERROR(iree_vm_ref_type_registry_reserve_name(registry));
+
+  iree_host_size_t type = registry->type_count;
+  iree_host_size_t page_index = type / IREE_VM_REF_TYPE_PAGE_CAPACITY;
+  if (!registry->pages[page_index]) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        registry->allocator, sizeof(iree_vm_ref_type_page_t),
+        (void**)&registry->pages[page_index]));
+  }
+  (*registry->pages[page_index])[type % IREE_VM_REF_TYPE_PAGE_CAPACITY] =
+      descriptor;
+  registry->type_count = type + 1;
+  descriptor->type = (iree_vm_ref_type_t)type;
+
+  // If multiple types share the same name the first registered wins lookups.
+  const iree_vm_ref_type_descriptor_t** slot = iree_vm_ref_type_name_slot(
+      registry->name_table, registry->name_capacity, descriptor->type_name);
+  if (!*slot) *slot = descriptor;
+  return IREE_STATUS_OK;
+}
 
 // Returns the type descriptor (or NULL) for the given type ID.
 static const iree_vm_ref_type_descriptor_t* iree_vm_ref_get_type_descriptor(
     iree_vm_ref_type_t type) {
-  if (type >= IREE_VM_MAX_TYPE_ID) {
-    return NULL;
-  }
-  return iree_vm_ref_type_descriptors[type];
+  iree_host_size_t page_index = type / IREE_VM_REF_TYPE_PAGE_CAPACITY;
+  if (page_index >= IREE_VM_REF_TYPE_MAX_PAGE_COUNT) return NULL;
+  iree_vm_ref_type_page_t* page = iree_vm_ref_type_registry.pages[page_index];
+  if (!page) return NULL;
+  return (*page)[type % IREE_VM_REF_TYPE_PAGE_CAPACITY];
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_ref_register_type(iree_vm_ref_type_descriptor_t* descriptor) {
-  for (int i = 1; i <= IREE_VM_MAX_TYPE_ID; ++i) {
-    if (!iree_vm_ref_type_descriptors[i]) {
-      iree_vm_ref_type_descriptors[i] = descriptor;
-      descriptor->type = i;
-      return IREE_STATUS_OK;
-    }
-  }
-  // Too many user-defined types registered; need to increase
-  // IREE_VM_MAX_TYPE_ID.
-  return IREE_STATUS_RESOURCE_EXHAUSTED;
+  iree_vm_ref_type_registry_t* registry = &iree_vm_ref_type_registry;
+  iree_vm_ref_type_registry_lock(registry);
+  iree_status_t status = iree_vm_ref_type_registry_insert(registry, descriptor);
+  iree_vm_ref_type_registry_unlock(registry);
+  return status;
 }
 
 IREE_API_EXPORT iree_string_view_t IREE_API_CALL
 iree_vm_ref_type_name(iree_vm_ref_type_t type) {
-  if (type == 0 || type >= IREE_VM_MAX_TYPE_ID) {
+  const iree_vm_ref_type_descriptor_t* descriptor =
+      iree_vm_ref_get_type_descriptor(type);
+  if (!descriptor) {
     return iree_make_cstring_view("");
   }
-  return iree_vm_ref_type_descriptors[type]->type_name;
+  return descriptor->type_name;
 }
 
 IREE_API_EXPORT const iree_vm_ref_type_descriptor_t* IREE_API_CALL
 iree_vm_ref_lookup_registered_type(iree_string_view_t full_name) {
-  for (int i = 1; i <= IREE_VM_MAX_TYPE_ID; ++i) {
-    if (!iree_vm_ref_type_descriptors[i]) break;
-    if (iree_string_view_compare(iree_vm_ref_type_descriptors[i]->type_name,
-                                 full_name) == 0) {
-      return iree_vm_ref_type_descriptors[i];
-    }
+  iree_vm_ref_type_registry_t* registry = &iree_vm_ref_type_registry;
+  iree_vm_ref_type_registry_lock(registry);
+  const iree_vm_ref_type_descriptor_t* descriptor = NULL;
+  if (registry->name_table) {
+    descriptor = *iree_vm_ref_type_name_slot(
+        registry->name_table, registry->name_capacity, full_name);
   }
-  return NULL;
+  iree_vm_ref_type_registry_unlock(registry);
+  return descriptor;
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_ref_wrap_assign(
@@ -134,8 +134,8 @@ IREE_API_EXPORT void IREE_API_CALL iree_vm_ref_object_release(
 // NOTE: the name is not retained and must be kept live by the caller. Ideally
 // it is stored in static read-only memory in the binary.
 //
-// WARNING: this function is not thread-safe and should only be used at startup
-// to register the types. Do not call this while any refs may be alive.
+// Registration is thread-safe and types may be registered at any time prior to
+// use. Returns IREE_STATUS_RESOURCE_EXHAUSTED if the type ID space is full.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_ref_register_type(iree_vm_ref_type_descriptor_t* descriptor);
 
@@ -144,6 +144,7 @@ IREE_API_EXPORT iree_string_view_t IREE_API_CALL
 iree_vm_ref_type_name(iree_vm_ref_type_t type);
 
 // Returns the registered type descriptor for the given type, if found.
+// Lookups are O(1) in the number of registered types and thread-safe.
 IREE_API_EXPORT const iree_vm_ref_type_descriptor_t* IREE_API_CALL
 iree_vm_ref_lookup_registered_type(iree_string_view_t full_name);
 
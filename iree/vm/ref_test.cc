@@ -16,6 +16,8 @@
 
 #include <cstddef>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/base/ref_ptr.h"
@@ -95,6 +97,31 @@ TEST(VMRefTest, TypeRegistration) {
                          iree_make_cstring_view("asodjfaoisdjfaoisdfj")));
 }
 
+// Tests that many types can be registered and each is found by name and ID.
+TEST(VMRefTest, ManyTypeRegistration) {
+  static constexpr int kTypeCount = 1000;
+  static std::vector<std::string> type_names;
+  static std::vector<iree_vm_ref_type_descriptor_t> descriptors(kTypeCount);
+  if (type_names.empty()) {
+    type_names.reserve(kTypeCount);
+    for (int i = 0; i < kTypeCount; ++i) {
+      type_names.push_back("many_types_" + std::to_string(i));
+      descriptors[i].type_name = iree_string_view_t{type_names.back().data(),
+                                                    type_names.back().size()};
+      IREE_ASSERT_OK(iree_vm_ref_register_type(&descriptors[i]));
+    }
+  }
+  for (int i = 0; i < kTypeCount; ++i) {
+    EXPECT_NE(IREE_VM_REF_TYPE_NULL, descriptors[i].type);
+    EXPECT_EQ(&descriptors[i],
+              iree_vm_ref_lookup_registered_type(descriptors[i].type_name));
+    auto type_name = iree_vm_ref_type_name(descriptors[i].type);
+    EXPECT_EQ(type_names[i], std::string(type_name.data, type_name.size));
+  }
+  EXPECT_EQ(nullptr, iree_vm_ref_lookup_registered_type(
+                         iree_make_cstring_view("many_types_")));
+}
+
 // Tests wrapping a simple C struct.
 TEST(VMRefTest, WrappingCStruct) {
   RegisterTypeC();
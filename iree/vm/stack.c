@@ -18,87 +18,254 @@
 
 #include "iree/vm/module.h"
 
+// Alignment of blocks, frames, and register banks within the stack.
+#define IREE_VM_STACK_ALIGNMENT 16
+
+// Header of a block of frame storage. Frames are bump-allocated from the bytes
+// immediately following the header.
+struct iree_vm_stack_block {
+  // Previous block in the chain or NULL if this is the first block.
+  iree_vm_stack_block_t* prev;
+  // Next block in the chain, if one has been allocated.
+  iree_vm_stack_block_t* next;
+  // Total capacity of the block in bytes, excluding the header.
+  iree_host_size_t capacity;
+  // Offset of the first unused byte in the block.
+  iree_host_size_t offset;
+  // 1 if the block was allocated from the stack allocator and must be freed.
+  int is_allocated;
+};
+
+// Internal bookkeeping stored alongside each frame used to restore the stack
+// when the frame is left.
+typedef struct {
+  // Block the frame was allocated from.
+  iree_vm_stack_block_t* block;
+  // Offset of the frame within |block|.
+  iree_host_size_t block_offset;
+  iree_vm_stack_frame_t frame;
+} iree_vm_stack_frame_header_t;
+
+static iree_host_size_t iree_vm_stack_align(iree_host_size_t value) {
+  return (value + (IREE_VM_STACK_ALIGNMENT - 1)) &
+         ~(iree_host_size_t)(IREE_VM_STACK_ALIGNMENT - 1);
+}
+
+static uint8_t* iree_vm_stack_block_data(iree_vm_stack_block_t* block) {
+  return (uint8_t*)block + iree_vm_stack_align(sizeof(iree_vm_stack_block_t));
+}
+
+static iree_vm_stack_frame_header_t* iree_vm_stack_frame_header(
+    iree_vm_stack_frame_t* frame) {
+  return (iree_vm_stack_frame_header_t*)((uint8_t*)frame -
+                                         offsetof(iree_vm_stack_frame_header_t,
+                                                  frame));
+}
+
+// Returns the number of registers to reserve for a bank with |count| used
+// registers, rounded up to a power of two so that it can be indexed by mask.
+static uint16_t iree_vm_stack_bank_size(uint16_t count, uint16_t max_count) {
+  if (count > max_count) count = max_count;
+  uint16_t size = 1;
+  while (size < count) size <<= 1;
+  return size;
+}
+
+// Frees |block| and all blocks following it in the chain.
+static void iree_vm_stack_free_blocks(iree_vm_stack_t* stack,
+                                      iree_vm_stack_block_t* block) {
+  if (block && block->prev) {
+    block->prev->next = NULL;
+  }
+  while (block) {
+    iree_vm_stack_block_t* next_block = block->next;
+    if (block->is_allocated) {
+      iree_allocator_free(stack->allocator, block);
+    }
+    block = next_block;
+  }
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_init(
-    iree_vm_state_resolver_t state_resolver, iree_vm_stack_t* out_stack) {
+    iree_byte_span_t storage, iree_vm_state_resolver_t state_resolver,
+    iree_allocator_t allocator, iree_vm_stack_t* out_stack) {
   memset(out_stack, 0, sizeof(iree_vm_stack_t));
   out_stack->state_resolver = state_resolver;
+  out_stack->allocator = allocator;
+
+  // Carve the first block out of the provided storage, if it is large enough
+  // to be useful. Otherwise all blocks will be allocated on demand.
+  if (storage.data) {
+    iree_host_size_t padding =
+        iree_vm_stack_align((iree_host_size_t)storage.data) -
+        (iree_host_size_t)storage.data;
+    iree_host_size_t header_size =
+        padding + iree_vm_stack_align(sizeof(iree_vm_stack_block_t));
+    if (storage.data_length > header_size) {
+      iree_vm_stack_block_t* block =
+          (iree_vm_stack_block_t*)(storage.data + padding);
+      memset(block, 0, sizeof(*block));
+      block->capacity = storage.data_length - header_size;
+      out_stack->current_block = block;
+    }
+  }
+
   return IREE_STATUS_OK;
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_stack_deinit(iree_vm_stack_t* stack) {
-  while (stack->depth) {
+  while (stack->top) {
     IREE_RETURN_IF_ERROR(iree_vm_stack_function_leave(stack));
   }
+
+  iree_vm_stack_block_t* first_block = stack->current_block;
+  while (first_block && first_block->prev) {
+    first_block = first_block->prev;
+  }
+  iree_vm_stack_free_blocks(stack, first_block);
+  stack->current_block = NULL;
+
   return IREE_STATUS_OK;
 }
 
 IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_current_frame(iree_vm_stack_t* stack) {
-  return stack->depth > 0 ? &stack->frames[stack->depth - 1] : NULL;
+  return stack->top;
 }
 
 IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_parent_frame(iree_vm_stack_t* stack) {
-  return stack->depth > 1 ? &stack->frames[stack->depth - 2] : NULL;
+  return stack->top ? stack->top->parent : NULL;
+}
+
+// Allocates |frame_size| bytes for a new frame from the top of the stack.
+// Moves on to the next block in the chain (allocating it if required) when the
+// current block is exhausted.
+static iree_status_t iree_vm_stack_allocate_frame(
+    iree_vm_stack_t* stack, iree_host_size_t frame_size,
+    iree_vm_stack_frame_header_t** out_header) {
+  iree_vm_stack_block_t* block = stack->current_block;
+  if (!block || block->offset + frame_size > block->capacity) {
+    // Blocks following the current block never contain live frames and can be
+    // reused as-is if they are large enough.
+    iree_vm_stack_block_t* next_block = block ? block->next : NULL;
+    if (next_block && next_block->capacity < frame_size) {
+      iree_vm_stack_free_blocks(stack, next_block);
+      next_block = NULL;
+    }
+    if (!next_block) {
+      iree_host_size_t capacity = frame_size > IREE_VM_STACK_MIN_BLOCK_SIZE
+                                      ? frame_size
+                                      : IREE_VM_STACK_MIN_BLOCK_SIZE;
+      IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+          stack->allocator,
+          iree_vm_stack_align(sizeof(iree_vm_stack_block_t)) + capacity,
+          (void**)&next_block));
+      next_block->prev = block;
+      next_block->next = NULL;
+      next_block->capacity = capacity;
+      next_block->is_allocated = 1;
+      if (block) block->next = next_block;
+    }
+    next_block->offset = 0;
+    block = next_block;
+    stack->current_block = block;
+  }
+
+  iree_vm_stack_frame_header_t* header =
+      (iree_vm_stack_frame_header_t*)(iree_vm_stack_block_data(block) +
+                                      block->offset);
+  header->block = block;
+  header->block_offset = block->offset;
+  block->offset += frame_size;
+  *out_header = header;
+  return IREE_STATUS_OK;
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
     iree_vm_stack_t* stack, iree_vm_function_t function,
     iree_vm_stack_frame_t** out_callee_frame) {
   *out_callee_frame = NULL;
-  if (stack->depth == IREE_MAX_STACK_DEPTH) {
-    return IREE_STATUS_RESOURCE_EXHAUSTED;
-  }
 
   // Try to reuse the same module state if the caller and callee are from the
   // same module. Otherwise, query the state from the registered handler.
-  iree_vm_stack_frame_t* callee_frame = &stack->frames[stack->depth];
-  if (stack->depth > 0) {
-    iree_vm_stack_frame_t* caller_frame = &stack->frames[stack->depth - 1];
-    if (caller_frame->function.module == function.module) {
-      callee_frame->module_state = caller_frame->module_state;
-    }
-  }
-  if (!callee_frame->module_state) {
+  iree_vm_stack_frame_t* caller_frame = stack->top;
+  iree_vm_module_state_t* module_state = NULL;
+  if (caller_frame && caller_frame->function.module == function.module) {
+    module_state = caller_frame->module_state;
+  } else {
     IREE_RETURN_IF_ERROR(stack->state_resolver.query_module_state(
-        stack->state_resolver.self, function.module,
-        &callee_frame->module_state));
+        stack->state_resolver.self, function.module, &module_state));
   }
 
-  ++stack->depth;
+  // Size the register banks based on what the function requires. Functions
+  // that don't declare their requirements get the maximum.
+  uint16_t i32_register_count = function.i32_register_count;
+  uint16_t ref_register_count = function.ref_register_count;
+  if (!i32_register_count && !ref_register_count) {
+    i32_register_count = IREE_I32_REGISTER_COUNT;
+    ref_register_count = IREE_REF_REGISTER_COUNT;
+  }
+  uint16_t i32_bank_size =
+      iree_vm_stack_bank_size(i32_register_count, IREE_I32_REGISTER_COUNT);
+  uint16_t ref_bank_size =
+      iree_vm_stack_bank_size(ref_register_count, IREE_REF_REGISTER_COUNT);
+
+  // Frame layout: [header + frame] [i32 registers] [ref registers]
+  iree_host_size_t header_size =
+      iree_vm_stack_align(sizeof(iree_vm_stack_frame_header_t));
+  iree_host_size_t i32_size =
+      iree_vm_stack_align(i32_bank_size * sizeof(int32_t));
+  iree_host_size_t ref_size =
+      iree_vm_stack_align(ref_bank_size * sizeof(iree_vm_ref_t));
+  iree_vm_stack_frame_header_t* header = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_allocate_frame(
+      stack, header_size + i32_size + ref_size, &header));
 
+  iree_vm_stack_frame_t* callee_frame = &header->frame;
   callee_frame->function = function;
+  callee_frame->module_state = module_state;
   callee_frame->offset = 0;
-  callee_frame->registers.ref_register_count = 0;
   callee_frame->return_registers = NULL;
+  callee_frame->parent = caller_frame;
 
+  iree_vm_registers_t* registers = &callee_frame->registers;
+  registers->i32_mask = i32_bank_size - 1;
+  registers->ref_mask = ref_bank_size - 1;
+  registers->i32 = (int32_t*)((uint8_t*)header + header_size);
+  registers->ref = (iree_vm_ref_t*)((uint8_t*)registers->i32 + i32_size);
+  memset(registers->ref, 0, ref_bank_size * sizeof(iree_vm_ref_t));
 #ifndef NDEBUG
-  memset(callee_frame->registers.i32, 0xCD,
-         sizeof(callee_frame->registers.i32));
-  memset(callee_frame->registers.ref, 0xCD,
-         sizeof(callee_frame->registers.ref));
+  memset(registers->i32, 0xCD, i32_bank_size * sizeof(int32_t));
 #endif  // !NDEBUG
 
+  stack->top = callee_frame;
+  ++stack->depth;
+
   *out_callee_frame = callee_frame;
   return IREE_STATUS_OK;
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_stack_function_leave(iree_vm_stack_t* stack) {
-  if (stack->depth <= 0) {
+  iree_vm_stack_frame_t* callee_frame = stack->top;
+  if (!callee_frame) {
     return IREE_STATUS_FAILED_PRECONDITION;
   }
 
-  iree_vm_stack_frame_t* callee_frame = &stack->frames[stack->depth - 1];
-  --stack->depth;
-  memset(&callee_frame->function, 0, sizeof(callee_frame->function));
-  callee_frame->module_state = NULL;
-
   iree_vm_registers_t* registers = &callee_frame->registers;
-  for (int i = 0; i < registers->ref_register_count; ++i) {
+  for (int i = 0; i <= registers->ref_mask; ++i) {
     iree_vm_ref_release(&registers->ref[i]);
   }
 
+  // Pop the frame storage; the block is retained for reuse.
+  iree_vm_stack_frame_header_t* header =
+      iree_vm_stack_frame_header(callee_frame);
+  stack->current_block = header->block;
+  header->block->offset = header->block_offset;
+  stack->top = callee_frame->parent;
+  --stack->depth;
+
   return IREE_STATUS_OK;
 }
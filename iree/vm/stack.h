@@ -27,8 +27,12 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Maximum stack depth, in frames.
-#define IREE_MAX_STACK_DEPTH 32
+// Default size of the inline storage callers should reserve for a stack.
+// Frames beyond this are allocated from the stack allocator on demand.
+#define IREE_VM_STACK_DEFAULT_SIZE (8 * 1024)
+
+// Minimum size of overflow blocks allocated when inline storage is exhausted.
+#define IREE_VM_STACK_MIN_BLOCK_SIZE (16 * 1024)
 
 // Maximum register count per bank.
 // This determines the bits required to reference registers in the VM bytecode.
@@ -48,14 +52,20 @@ extern "C" {
 typedef int64_t iree_vm_source_offset_t;
 
 // Register banks for use within a stack frame.
+// Banks are sized to the next power of two of the register count required by
+// the function and register ordinals must be masked with the bank mask prior to
+// indexing. This ensures that malformed bytecode can never reach outside of
+// the frame storage.
 typedef struct {
-  // Integer registers.
-  iree_alignas(16) int32_t i32[IREE_I32_REGISTER_COUNT];
-  // Reference counted registers.
-  iree_vm_ref_t ref[IREE_REF_REGISTER_COUNT];
-  // Total number of valid ref registers used by the function.
-  // TODO(benvanik): make the above dynamic and include i32 count.
-  int8_t ref_register_count;
+  // Mask applied to i32 register ordinals; there are i32_mask + 1 registers.
+  uint16_t i32_mask;
+  // Mask applied to ref register ordinals; there are ref_mask + 1 registers.
+  uint16_t ref_mask;
+  // Integer registers, 16-byte aligned.
+  int32_t* i32;
+  // Reference counted registers. All are valid (possibly null) refs for the
+  // lifetime of the frame and are released when the frame is left.
+  iree_vm_ref_t* ref;
 } iree_vm_registers_t;
 
 // A variable-length list of registers.
@@ -79,14 +89,17 @@ typedef struct iree_vm_stack_frame {
   iree_vm_module_state_t* module_state;
   // Offset within the function.
   iree_vm_source_offset_t offset;
-  // Registers used within the frame.
-  // TODO(benvanik): pointer to an arena? avoids fixed overheads.
+  // Registers used within the frame. The register storage is allocated from
+  // the stack immediately following the frame.
   iree_vm_registers_t registers;
 
   // Pointer to a register list where callers can source their return registers.
   // If omitted then the return values are assumed to be left-aligned in the
   // register banks.
   const iree_vm_register_list_t* return_registers;
+
+  // Parent (caller) frame or NULL if this is the bottom-most frame.
+  struct iree_vm_stack_frame* parent;
 } iree_vm_stack_frame_t;
 
 // A state resolver that can allocate or lookup module state.
@@ -97,15 +110,31 @@ typedef struct iree_vm_state_resolver {
       iree_vm_module_state_t** out_module_state);
 } iree_vm_state_resolver_t;
 
+// A block of memory that stack frames are allocated from in LIFO order.
+typedef struct iree_vm_stack_block iree_vm_stack_block_t;
+
 // A fiber stack used for storing stack frame state during execution.
 // All required state is stored within the stack and no host thread-local state
 // is used allowing us to execute multiple fibers on the same host thread.
+//
+// Frames are variable-sized based on the register counts of the function being
+// entered and are bump-allocated from a chain of blocks. The first block is
+// usually caller-provided storage (such as a buffer on the native stack) and
+// additional blocks are allocated from the stack allocator only when the
+// storage is exhausted. Blocks are retained until the stack is deinitialized
+// such that repeated calls reuse the same memory. Frames never move once
+// entered and pointers to them remain valid until they are left.
 typedef struct iree_vm_stack {
   // TODO(benvanik): add globally useful things (instance/device manager?)
   // Depth of the stack, in frames. 0 indicates an empty stack.
   int32_t depth;
-  // [0-depth) valid stack frames.
-  iree_vm_stack_frame_t frames[IREE_MAX_STACK_DEPTH];
+  // Current (top-most) stack frame or NULL if the stack is empty.
+  iree_vm_stack_frame_t* top;
+
+  // Block that |top| was allocated from, or the first block if empty.
+  iree_vm_stack_block_t* current_block;
+  // Allocator used for overflow blocks.
+  iree_allocator_t allocator;
 
   // Resolves a module to a module state within a context.
   // This will be called on function entry whenever module transitions occur.
@@ -113,10 +142,22 @@ typedef struct iree_vm_stack {
 } iree_vm_stack_t;
 
 // Constructs a stack in-place in |out_stack|.
+// |storage| is optional caller-owned memory used for frames before any blocks
+// are allocated from |allocator|. The storage must remain valid until the stack
+// is deinitialized. IREE_VM_STACK_DEFAULT_SIZE is sufficient for most
+// invocations to not require any allocations.
+//
+// Example:
+//   iree_alignas(16) uint8_t stack_storage[IREE_VM_STACK_DEFAULT_SIZE];
+//   iree_byte_span_t storage = {stack_storage, sizeof(stack_storage)};
+//   iree_vm_stack_t stack;
+//   iree_vm_stack_init(storage, state_resolver, IREE_ALLOCATOR_SYSTEM, &stack);
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_init(
-    iree_vm_state_resolver_t state_resolver, iree_vm_stack_t* out_stack);
+    iree_byte_span_t storage, iree_vm_state_resolver_t state_resolver,
+    iree_allocator_t allocator, iree_vm_stack_t* out_stack);
 
-// Destructs |stack|.
+// Destructs |stack|, leaving any remaining frames and freeing all allocated
+// blocks.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_stack_deinit(iree_vm_stack_t* stack);
 
@@ -129,7 +170,10 @@ IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_parent_frame(iree_vm_stack_t* stack);
 
 // Enters into the given |function| and returns the callee stack frame.
+// The frame registers are sized based on the register counts declared by the
+// function and all ref registers are initialized to null.
 // Callers must populate the argument registers as defined by the VM API.
+// Returns IREE_STATUS_RESOURCE_EXHAUSTED if the frame could not be allocated.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
     iree_vm_stack_t* stack, iree_vm_function_t function,
     iree_vm_stack_frame_t** out_callee_frame);
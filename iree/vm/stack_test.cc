@@ -15,6 +15,7 @@
 #include "iree/vm/stack.h"
 
 #include <cstring>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/base/ref_ptr.h"
@@ -49,7 +50,9 @@ static iree_status_t SentinelStateResolver(
 TEST(VMStackTest, Usage) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
   EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
   EXPECT_EQ(nullptr, iree_vm_stack_parent_frame(stack.get()));
@@ -86,7 +89,9 @@ TEST(VMStackTest, Usage) {
 TEST(VMStackTest, DeinitWithRemainingFrames) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
   iree_vm_function_t function_a = {MODULE_A_SENTINEL,
                                    IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
@@ -102,30 +107,105 @@ TEST(VMStackTest, DeinitWithRemainingFrames) {
   EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
 }
 
-// Tests stack overflow detection.
-TEST(VMStackTest, StackOverflow) {
+// Tests that frames are sized based on the function register counts.
+TEST(VMStackTest, FrameRegisterCounts) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
-  EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
-  EXPECT_EQ(nullptr, iree_vm_stack_parent_frame(stack.get()));
-
-  // Fill the entire stack up to the max.
-  iree_vm_function_t function_a = {MODULE_A_SENTINEL,
-                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
-  for (int i = 0; i < IREE_MAX_STACK_DEPTH; ++i) {
-    iree_vm_stack_frame_t* frame_a = nullptr;
-    IREE_EXPECT_OK(
-        iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  // Counts are rounded up to the next power of two.
+  iree_vm_function_t function_a = {
+      MODULE_A_SENTINEL, IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0, 3, 5};
+  iree_vm_stack_frame_t* frame_a = nullptr;
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  EXPECT_EQ(3, frame_a->registers.i32_mask);
+  EXPECT_EQ(7, frame_a->registers.ref_mask);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frame_a->registers.i32) % 16);
+  for (int i = 0; i <= frame_a->registers.ref_mask; ++i) {
+    EXPECT_TRUE(iree_vm_ref_is_null(&frame_a->registers.ref[i]));
   }
 
-  // Try to push on one more frame.
+  // Functions that don't declare their counts get the maximum.
   iree_vm_function_t function_b = {MODULE_B_SENTINEL,
                                    IREE_VM_FUNCTION_LINKAGE_INTERNAL, 1};
   iree_vm_stack_frame_t* frame_b = nullptr;
-  EXPECT_EQ(IREE_STATUS_RESOURCE_EXHAUSTED,
-            iree_vm_stack_function_enter(stack.get(), function_b, &frame_b));
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_b, &frame_b));
+  EXPECT_EQ(IREE_I32_REGISTER_COUNT - 1, frame_b->registers.i32_mask);
+  EXPECT_EQ(IREE_REF_REGISTER_COUNT - 1, frame_b->registers.ref_mask);
+
+  IREE_EXPECT_OK(iree_vm_stack_deinit(stack.get()));
+}
+
+// Tests that deep call chains grow the stack beyond its initial storage and
+// that frames remain stable as it grows.
+TEST(VMStackTest, DeepRecursion) {
+  iree_alignas(16) uint8_t storage[IREE_VM_STACK_DEFAULT_SIZE];
+  auto stack = std::make_unique<iree_vm_stack_t>();
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{storage, sizeof(storage)},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
+
+  // Enough frames to spill over several blocks.
+  constexpr int kDepth = 1000;
+  iree_vm_function_t function_a = {
+      MODULE_A_SENTINEL, IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0, 16, 4};
+  std::vector<iree_vm_stack_frame_t*> frames;
+  for (int i = 0; i < kDepth; ++i) {
+    iree_vm_stack_frame_t* frame = nullptr;
+    IREE_ASSERT_OK(
+        iree_vm_stack_function_enter(stack.get(), function_a, &frame));
+    frame->registers.i32[0] = i;
+    frames.push_back(frame);
+  }
+  EXPECT_EQ(kDepth, stack->depth);
+
+  // Frames in the initial storage and allocated blocks must all be intact.
+  for (int i = kDepth - 1; i >= 0; --i) {
+    EXPECT_EQ(frames[i], iree_vm_stack_current_frame(stack.get()));
+    EXPECT_EQ(i, frames[i]->registers.i32[0]);
+    IREE_EXPECT_OK(iree_vm_stack_function_leave(stack.get()));
+  }
+  EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
+
+  // Re-entering should reuse the same memory.
+  iree_vm_stack_frame_t* frame = nullptr;
+  IREE_EXPECT_OK(iree_vm_stack_function_enter(stack.get(), function_a, &frame));
+  EXPECT_EQ(frames[0], frame);
+
+  IREE_EXPECT_OK(iree_vm_stack_deinit(stack.get()));
+}
+
+// Tests stack overflow detection when the stack cannot grow any further.
+TEST(VMStackTest, StackOverflow) {
+  iree_alignas(16) uint8_t storage[1024];
+  iree_allocator_t failing_allocator = {
+      nullptr,
+      +[](void* self, iree_allocation_mode_t mode, iree_host_size_t byte_length,
+          void** out_ptr) -> iree_status_t {
+        return IREE_STATUS_RESOURCE_EXHAUSTED;
+      },
+      +[](void* self, void* ptr) -> iree_status_t { return IREE_STATUS_OK; }};
+  auto stack = std::make_unique<iree_vm_stack_t>();
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{storage, sizeof(storage)},
+                                    state_resolver, failing_allocator,
+                                    stack.get()));
+
+  // Fill the storage until it runs out.
+  iree_vm_function_t function_a = {
+      MODULE_A_SENTINEL, IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0, 4, 1};
+  iree_vm_stack_frame_t* frame_a = nullptr;
+  iree_status_t status = IREE_STATUS_OK;
+  while (iree_status_is_ok(status)) {
+    status = iree_vm_stack_function_enter(stack.get(), function_a, &frame_a);
+  }
+  EXPECT_EQ(IREE_STATUS_RESOURCE_EXHAUSTED, status);
+  EXPECT_LT(0, stack->depth);
 
   // Should still be frame A.
   EXPECT_EQ(0, iree_vm_stack_current_frame(stack.get())->function.ordinal);
@@ -137,7 +217,9 @@ TEST(VMStackTest, StackOverflow) {
 TEST(VMStackTest, UnbalancedPop) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
   EXPECT_EQ(IREE_STATUS_FAILED_PRECONDITION,
             iree_vm_stack_function_leave(stack.get()));
@@ -149,7 +231,9 @@ TEST(VMStackTest, UnbalancedPop) {
 TEST(VMStackTest, ModuleStateQueries) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
   EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
   EXPECT_EQ(nullptr, iree_vm_stack_parent_frame(stack.get()));
@@ -198,7 +282,9 @@ TEST(VMStackTest, ModuleStateQueryFailure) {
         // NOTE: always failing.
         return IREE_STATUS_INTERNAL;
       }};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
   // Push should fail if we can't query state, status should propagate.
   iree_vm_function_t function_a = {MODULE_A_SENTINEL,
@@ -234,7 +320,9 @@ iree_vm_ref_type_t DummyObject::kTypeID = IREE_VM_REF_TYPE_NULL;
 TEST(VMStackTest, RefRegisterCleanup) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(iree_vm_stack_init(iree_byte_span_t{nullptr, 0},
+                                    state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                    stack.get()));
 
   dummy_object_count = 0;
   DummyObject::RegisterType();
@@ -244,8 +332,6 @@ TEST(VMStackTest, RefRegisterCleanup) {
   iree_vm_stack_frame_t* frame_a = nullptr;
   IREE_EXPECT_OK(
       iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
-  frame_a->registers.ref_register_count = 1;
-  memset(&frame_a->registers.ref[0], 0, sizeof(iree_vm_ref_t));
   IREE_EXPECT_OK(iree_vm_ref_wrap_assign(
       new DummyObject(), DummyObject::kTypeID, &frame_a->registers.ref[0]));
   EXPECT_EQ(1, dummy_object_count);
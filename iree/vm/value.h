@@ -27,6 +27,10 @@ typedef enum {
   IREE_VM_VALUE_TYPE_NONE = 0,
   // int32_t.
   IREE_VM_VALUE_TYPE_I32 = 1,
+  // int64_t.
+  IREE_VM_VALUE_TYPE_I64 = 2,
+  // float.
+  IREE_VM_VALUE_TYPE_F32 = 3,
 } iree_vm_value_type_t;
 
 // A variant value type.
@@ -34,6 +38,8 @@ typedef struct iree_vm_value {
   iree_vm_value_type_t type;
   union {
     int32_t i32;
+    int64_t i64;
+    float f32;
   };
 } iree_vm_value_t;
 
@@ -63,6 +63,17 @@ iree_vm_variant_list_free(iree_vm_variant_list_t* list) {
   return iree_allocator_free(list->allocator, list);
 }
 
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_variant_list_clear(iree_vm_variant_list_t* list) {
+  for (int i = 0; i < list->count; ++i) {
+    if (IREE_VM_VARIANT_IS_REF(&list->values[i])) {
+      iree_vm_ref_release(&list->values[i].ref);
+    }
+  }
+  memset(list->values, 0, sizeof(list->values[0]) * list->count);
+  list->count = 0;
+}
+
 IREE_API_EXPORT iree_host_size_t IREE_API_CALL
 iree_vm_variant_list_size(const iree_vm_variant_list_t* list) {
   return list->count;
@@ -76,7 +87,17 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_variant_list_append_value(
   int i = list->count++;
   list->values[i].value_type = value.type;
   list->values[i].ref_type = IREE_VM_REF_TYPE_NULL;
-  list->values[i].i32 = value.i32;
+  switch (value.type) {
+    case IREE_VM_VALUE_TYPE_I64:
+      list->values[i].i64 = value.i64;
+      break;
+    case IREE_VM_VALUE_TYPE_F32:
+      list->values[i].f32 = value.f32;
+      break;
+    default:
+      list->values[i].i32 = value.i32;
+      break;
+  }
   return IREE_STATUS_OK;
 }
 
@@ -38,6 +38,8 @@ typedef struct {
   iree_vm_ref_type_t ref_type : 24;
   union {
     int32_t i32;
+    int64_t i64;
+    float f32;
     iree_vm_ref_t ref;
   };
 } iree_vm_variant_t;
@@ -72,6 +74,12 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_variant_list_init(
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_variant_list_free(iree_vm_variant_list_t* list);
 
+// Releases all elements in the list and resets its size to 0.
+// The list storage is retained such that it can be repopulated without
+// allocating.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_variant_list_clear(iree_vm_variant_list_t* list);
+
 // Returns the total number of elements added to the list.
 IREE_API_EXPORT iree_host_size_t IREE_API_CALL
 iree_vm_variant_list_size(const iree_vm_variant_list_t* list);